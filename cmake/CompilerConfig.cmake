@@ -22,6 +22,15 @@ elseif(${CMAKE_SYSTEM_NAME} STREQUAL "Linux")
   message(STATUS "Detected Linux")
   add_definitions("-DSYSTEM_NAME_LINUX")
   find_library(DL_LIB dl REQUIRED)
+  # io_uring receive needs multishot receive and provided buffer rings,
+  # which only kernel headers from Linux 6.0 define
+  include(CheckSymbolExists)
+  check_symbol_exists(IORING_RECV_MULTISHOT "linux/io_uring.h" HAVE_IO_URING)
+  if(HAVE_IO_URING)
+    add_definitions("-DHAVE_IO_URING")
+  else()
+    message(STATUS "Kernel headers lack io_uring multishot receive, --rxbackend io_uring disabled")
+  endif()
 else()
   message(FATAL_ERROR "Unknown system")
 endif()
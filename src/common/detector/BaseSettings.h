@@ -25,6 +25,22 @@ struct BaseSettings {
   int32_t  RxSocketBufferSize   {2000000}; // bytes
   int32_t  TxSocketBufferSize   {2000000}; // bytes
   int32_t  SocketRxTimeoutUS    {100000}; // 100000us = 0.1s
+  uint32_t RxBatchSize          {1};       // packets per recvmmsg(), 1 = recvfrom()
+  bool     RxGro                {false};   // UDP generic receive offload
+  std::string   RxBackend            {"socket"}; // socket or io_uring
+  uint32_t RxQueueEntries       {2000};    // packet slots, rounded up to 2^n
+  uint32_t RxPipelines          {1};       // SO_REUSEPORT input/processing pairs
+  bool     NoRxTimestamps       {false};   // disable SO_TIMESTAMPNS
+  uint32_t ReorderDepth         {0};       // packets held per OutputQueue, 0 = off
+  uint32_t ReorderTimeoutUS     {1000};    // max hold time, 1000us = 1ms
+  int32_t  HeaderVersion        {-1};      // ESS readout header version, -1 = detect
+  ///\brief Processing thread idle strategy
+  uint32_t IdleSpinCount        {1000};    // busy spins before yielding
+  uint32_t IdleYieldCount       {100};     // yields before blocking
+  uint32_t IdleWaitUS           {1000};    // max block per wait, 1000us = 1ms
+  ///\brief Thread placement
+  std::string   ThreadAffinity       {""};      // thread:cpu[,thread:cpu], e.g. input:2
+  uint32_t InputPriority        {0};       // SCHED_FIFO priority of input threads, 0 = off
   /// /brief Monitoring
   uint32_t MonitorPeriod        {1000};  // start capturing every 1000 packets
   uint32_t MonitorSamples       {2};     // capture 2 consecutive packets
@@ -10,13 +10,20 @@
 #pragma once
 
 #include <CLI/CLI.hpp>
+#include <algorithm>
 #include <atomic>
+#include <cassert>
 #include <common/Statistics.h>
 #include <common/debug/Trace.h>
 #include <common/detector/BaseSettings.h>
-#include <common/memory/RingBuffer.h>
-#include <common/memory/SPSCFifo.h>
+#include <common/memory/PacketQueue.h>
+#include <common/readout/ess/Parser.h>
+#include <common/system/IdleStrategy.h>
+#include <common/system/IoUringReceiver.h>
 #include <common/system/Socket.h>
+#include <common/time/ProcessingLatency.h>
+#include <common/time/TSCTimer.h>
+#include <cstring>
 #include <functional>
 #include <common/debug/Log.h>
 #include <map>
@@ -24,6 +31,7 @@
 #include <stdio.h>
 #include <string>
 #include <thread>
+#include <vector>
 
 // #undef TRC_LEVEL
 // #define TRC_LEVEL TRC_L_DEB
@@ -36,60 +44,453 @@ struct ThreadInfo {
 
 class Detector {
 public:
-  struct {
+  /// Number of bins in the receive batch size histogram, bin i counts
+  /// receive calls returning between 2^i and 2^(i+1) - 1 packets
+  static constexpr int RxBatchHistBins{7};
+
+  /// Number of bins in the receive queue fill histogram, bin i counts
+  /// samples where the queue was between i/8 and (i+1)/8 full
+  static constexpr int RxQueueFillBins{8};
+
+  /// Minimum time between queue fill samples, reading the fill loads the
+  /// consumer's index
+  static constexpr int RxQueueFillSampleUS{100};
+
+  static constexpr int EthernetBufferSize{9000}; /// bytes
+  static constexpr int KafkaBufferSize{12'400};  /// entries ~ 100kB
+
+  struct InputCounters {
     int64_t RxPackets{0};
     int64_t RxBytes{0};
     int64_t FifoPushErrors{0};
     int64_t RxIdle{0};
-  } ITCounters; // Input Thread Counters
+    int64_t RxBatchSize[RxBatchHistBins]{0};
+    int64_t RxGroCalls{0};
+    int64_t RxGroSegments{0};
+    int64_t RxGroSegmentsAvg{0};
+    int64_t RxGroCopies{0};
+    int64_t RxGroOversize{0}; // datagrams too large for a queue slot
+    int64_t RxQueueBacking{0}; // PacketQueue::Backing
+    int64_t RxQueueBytes{0};
+    int64_t RxQueueLocked{0};
+    int64_t RxQueueHighWater{0}; // max queue slots in use, when sampled
+    int64_t RxQueueFill[RxQueueFillBins]{0};
+    uint64_t RxQueueFillNextTsc{0}; // not a stat, time of next fill sample
+    int64_t RxKernelDrops{0};         // socket buffer overflows (SO_RXQ_OVFL)
+    int64_t RxKernelDropsInterval{0}; // ... during the last update interval
+    int64_t RxKernelDropsPrevious{0}; // not a stat, RxKernelDrops at the
+                                      // start of the interval
+  };
+  InputCounters ITCounters; // Input Thread Counters
 
   using CommandFunction =
       std::function<int(std::vector<std::string>, char *, unsigned int *)>;
   using ThreadList = std::vector<ThreadInfo>;
-  Detector(BaseSettings settings) : EFUSettings(settings), Stats(){};
+  Detector(BaseSettings settings) : EFUSettings(settings), Stats() {
+    ITCounters.RxQueueBacking = InputQueue.getBacking();
+    ITCounters.RxQueueBytes = InputQueue.getAllocatedBytes();
+    ITCounters.RxQueueLocked = InputQueue.isLocked();
+  };
 
   /// Receiving UDP data is now common across all detectors
-  void inputThread() {
-    XTRACE(INPUT, DEB, "Starting inputThread");
+  /// \param Pipeline selects queue and counters, see addPipelines()
+  void inputThread(unsigned int Pipeline = 0) {
+    XTRACE(INPUT, DEB, "Starting inputThread %u", Pipeline);
     Socket::Endpoint local(EFUSettings.DetectorAddress.c_str(),
                            EFUSettings.DetectorPort);
+    auto &Queue = inputQueue(Pipeline);
+    auto &Counters = inputCounters(Pipeline);
+    bool ReusePort = not Pipelines.empty();
+    if ((EFUSettings.RxPipelines > 1) and not ReusePort) {
+      LOG(INIT, Sev::Warning, "Detector has no support for --rxpipelines");
+    }
+
+    if (EFUSettings.RxBackend == "io_uring") {
+      if (ioUringInputLoop(local, ReusePort, Queue, Counters)) {
+        XTRACE(INPUT, ALW, "Stopping input thread.");
+        return;
+      }
+      LOG(INIT, Sev::Warning, "io_uring unavailable, using socket receive");
+    }
 
-    UDPReceiver dataReceiver(local);
+    UDPReceiver dataReceiver(local, ReusePort);
     dataReceiver.setBufferSizes(EFUSettings.TxSocketBufferSize,
                                 EFUSettings.RxSocketBufferSize);
     dataReceiver.printBufferSizes();
     dataReceiver.setRecvTimeout(0, EFUSettings.SocketRxTimeoutUS);
+    if (not EFUSettings.NoRxTimestamps) {
+      dataReceiver.enableTimestamps();
+    }
+    dataReceiver.enableDropCount();
 
     LOG(INIT, Sev::Info, "Detector input thread started on {}:{}", local.IpAddress,
         local.Port);
 
+    if (EFUSettings.RxGro) {
+      if (dataReceiver.enableGRO()) {
+        groInputLoop(dataReceiver, Queue, Counters);
+        XTRACE(INPUT, ALW, "Stopping input thread.");
+        return;
+      }
+      LOG(INIT, Sev::Warning, "UDP GRO unavailable, using regular receive");
+    }
+
+    if (EFUSettings.RxBatchSize > 1) {
+      batchedInputLoop(dataReceiver, Queue, Counters);
+      XTRACE(INPUT, ALW, "Stopping input thread.");
+      return;
+    }
+
+    std::vector<char> DropBuffer(EthernetBufferSize);
+    TSCTimer IntervalTimer(EFUSettings.UpdateIntervalSec * 1000000 * TSC_MHZ);
     while (runThreads) {
+      updateKernelDrops(dataReceiver, IntervalTimer, Counters);
       int readSize;
-      unsigned int rxBufferIndex = RxRingbuffer.getDataIndex();
+      int64_t ArrivalNs;
+      bool QueueFull = (Queue.writable() == 0);
+      unsigned int rxBufferIndex = Queue.getWriteIndex();
+      char *Buffer = QueueFull ? DropBuffer.data()
+                               : Queue.getDataBuffer(rxBufferIndex);
 
-      RxRingbuffer.setDataLength(rxBufferIndex, 0);
-      if ((readSize =
-               dataReceiver.receive(RxRingbuffer.getDataBuffer(rxBufferIndex),
-                                    RxRingbuffer.getMaxBufSize())) > 0) {
-        RxRingbuffer.setDataLength(rxBufferIndex, readSize);
+      if ((readSize = dataReceiver.receive(Buffer, EthernetBufferSize,
+                                           ArrivalNs)) > 0) {
         XTRACE(INPUT, DEB, "Received an udp packet of length %d bytes",
                readSize);
-        ITCounters.RxPackets++;
-        ITCounters.RxBytes += readSize;
+        Counters.RxPackets++;
+        Counters.RxBytes += readSize;
 
-        if (InputFifo.push(rxBufferIndex) == false) {
-          ITCounters.FifoPushErrors++;
+        if (QueueFull) {
+          Counters.FifoPushErrors++;
         } else {
-          RxRingbuffer.getNextBuffer();
+          Queue.setDataLength(rxBufferIndex, readSize);
+          Queue.setArrivalTime(rxBufferIndex, ArrivalNs);
+          Queue.push();
+          updateQueueFill(Queue, Counters);
         }
       } else {
-        ITCounters.RxIdle++;
+        Counters.RxIdle++;
       }
     }
     XTRACE(INPUT, ALW, "Stopping input thread.");
     return;
   }
 
+  /// \brief Batched receive, fills up to EFUSettings.RxBatchSize free queue
+  /// slots per system call and pushes them to the processing thread. When
+  /// the queue is full a single packet is received and dropped.
+  void batchedInputLoop(UDPReceiver &dataReceiver,
+                        PacketQueue<EthernetBufferSize> &Queue,
+                        InputCounters &Counters) {
+    int BatchSize = std::min(EFUSettings.RxBatchSize,
+                             (uint32_t)Socket::MaxBatchSize);
+    std::vector<char> DropBuffer(EthernetBufferSize);
+    char *Buffers[Socket::MaxBatchSize];
+    int Lengths[Socket::MaxBatchSize];
+    int64_t Timestamps[Socket::MaxBatchSize];
+    unsigned int Indexes[Socket::MaxBatchSize];
+
+    LOG(INIT, Sev::Info, "Batched receive, up to {} packets per call",
+        BatchSize);
+
+    TSCTimer IntervalTimer(EFUSettings.UpdateIntervalSec * 1000000 * TSC_MHZ);
+    while (runThreads) {
+      updateKernelDrops(dataReceiver, IntervalTimer, Counters);
+      int Slots = Queue.writable(BatchSize);
+      if (Slots == 0) {
+        if (dataReceiver.receive(DropBuffer.data(), EthernetBufferSize) > 0) {
+          Counters.RxPackets++;
+          Counters.FifoPushErrors++;
+        } else {
+          Counters.RxIdle++;
+        }
+        continue;
+      }
+
+      for (int i = 0; i < Slots; i++) {
+        Indexes[i] = Queue.getWriteIndex(i);
+        Buffers[i] = Queue.getDataBuffer(Indexes[i]);
+      }
+
+      int Packets = dataReceiver.receiveBatch(Buffers, EthernetBufferSize,
+                                              Lengths, Slots, Timestamps);
+      if (Packets <= 0) {
+        Counters.RxIdle++;
+        continue;
+      }
+      XTRACE(INPUT, DEB, "Received a batch of %d udp packets", Packets);
+      Counters.RxBatchSize[std::min(31 - __builtin_clz(Packets),
+                                      RxBatchHistBins - 1)]++;
+
+      for (int i = 0; i < Packets; i++) {
+        Queue.setDataLength(Indexes[i], Lengths[i]);
+        Queue.setArrivalTime(Indexes[i], Timestamps[i]);
+      }
+      queuePackets(Queue, Counters, Indexes, Packets);
+    }
+  }
+
+  /// \brief GRO receive, a single read can return up to 64 coalesced
+  /// datagrams which are split into one queue slot each. The scatter
+  /// length is adapted to the observed segment size so that datagrams
+  /// normally land at the start of their own slot without copying. Reads
+  /// are dropped unless 64 slots are free.
+  void groInputLoop(UDPReceiver &dataReceiver,
+                    PacketQueue<EthernetBufferSize> &Queue,
+                    InputCounters &Counters) {
+    static constexpr int MaxGroBytes{65535};
+    std::vector<char> Staging(MaxGroBytes);
+    char *Buffers[Socket::MaxBatchSize];
+    unsigned int Indexes[Socket::MaxBatchSize];
+    int IovLen = EthernetBufferSize;
+
+    LOG(INIT, Sev::Info, "UDP GRO receive enabled");
+
+    TSCTimer IntervalTimer(EFUSettings.UpdateIntervalSec * 1000000 * TSC_MHZ);
+    while (runThreads) {
+      updateKernelDrops(dataReceiver, IntervalTimer, Counters);
+      int Slots = (MaxGroBytes + IovLen - 1) / IovLen;
+      bool QueueFull = (Queue.writable(Socket::MaxBatchSize) <
+                        (unsigned int)Socket::MaxBatchSize);
+      if (QueueFull) {
+        Buffers[0] = Staging.data();
+        Slots = 1;
+      } else {
+        for (int i = 0; i < Socket::MaxBatchSize; i++) {
+          Indexes[i] = Queue.getWriteIndex(i);
+          Buffers[i] = Queue.getDataBuffer(Indexes[i]);
+        }
+      }
+
+      int SegmentSize{0};
+      int64_t ArrivalNs{0};
+      ssize_t ReadSize =
+          dataReceiver.receiveScatter(Buffers, QueueFull ? MaxGroBytes : IovLen,
+                                      Slots, SegmentSize, &ArrivalNs);
+      if (ReadSize <= 0) {
+        Counters.RxIdle++;
+        continue;
+      }
+
+      if (QueueFull) {
+        int Segments = (SegmentSize > 0)
+                           ? (ReadSize + SegmentSize - 1) / SegmentSize
+                           : 1;
+        Counters.RxPackets += Segments;
+        Counters.FifoPushErrors += Segments;
+        continue;
+      }
+
+      int Packets = splitSegments(Queue, Counters, Indexes, IovLen, ReadSize,
+                                  SegmentSize, Staging.data());
+      if (Packets == 0) {
+        continue;
+      }
+      XTRACE(INPUT, DEB, "GRO read of %d bytes, %d segments", ReadSize,
+             Packets);
+      Counters.RxGroCalls++;
+      Counters.RxGroSegments += Packets;
+      Counters.RxGroSegmentsAvg =
+          Counters.RxGroSegments / Counters.RxGroCalls;
+      for (int i = 0; i < Packets; i++) {
+        Queue.setArrivalTime(Indexes[i], ArrivalNs);
+      }
+
+      // Fall back to full size entries if 64 segments can't hold 64 KB
+      if ((SegmentSize > 0) and (SegmentSize != IovLen)) {
+        IovLen = (SegmentSize * Socket::MaxBatchSize >= MaxGroBytes)
+                     ? SegmentSize
+                     : EthernetBufferSize;
+      }
+
+      queuePackets(Queue, Counters, Indexes, Packets);
+    }
+  }
+
+  /// \brief Split Bytes of received data, scattered over consecutive
+  /// queue slots with IovLen bytes in each, into one slot per
+  /// datagram of SegmentSize bytes (the last one may be shorter). Data is
+  /// already in place when SegmentSize equals IovLen, otherwise it is
+  /// rearranged through the Staging buffer. Datagrams larger than a queue
+  /// slot are dropped and counted in RxGroOversize.
+  /// \return number of datagrams, their lengths are set in the queue
+  int splitSegments(PacketQueue<EthernetBufferSize> &Queue,
+                    InputCounters &Counters, unsigned int Indexes[],
+                    int IovLen, int Bytes, int SegmentSize, char *Staging) {
+    if ((SegmentSize <= 0) or (SegmentSize > Bytes)) {
+      SegmentSize = Bytes;
+    }
+    // Kernel coalesces at most 64 datagrams (UDP_GRO_CNT_MAX)
+    int Segments = std::min((Bytes + SegmentSize - 1) / SegmentSize,
+                            Socket::MaxBatchSize);
+
+    if (SegmentSize > EthernetBufferSize) {
+      XTRACE(INPUT, WAR, "Dropping %d datagrams of %d bytes", Segments,
+             SegmentSize);
+      Counters.RxPackets += Segments;
+      Counters.RxGroOversize += Segments;
+      return 0;
+    }
+
+    if ((SegmentSize != IovLen) and (Bytes > SegmentSize or Bytes > IovLen)) {
+      Counters.RxGroCopies++;
+      for (int Offset = 0, i = 0; Offset < Bytes; Offset += IovLen, i++) {
+        std::memcpy(Staging + Offset, Queue.getDataBuffer(Indexes[i]),
+                    std::min(IovLen, Bytes - Offset));
+      }
+      for (int i = 0; i < Segments; i++) {
+        std::memcpy(Queue.getDataBuffer(Indexes[i]),
+                    Staging + i * SegmentSize,
+                    std::min(SegmentSize, Bytes - i * SegmentSize));
+      }
+    }
+
+    for (int i = 0; i < Segments; i++) {
+      Queue.setDataLength(Indexes[i],
+                                 std::min(SegmentSize, Bytes - i * SegmentSize));
+    }
+    return Segments;
+  }
+
+  /// \brief io_uring receive, the kernel writes datagrams directly into
+  /// free queue slots handed to it through a provided buffer ring. Slots are
+  /// provided and consumed in queue order, so each completion fills the next
+  /// slot to be pushed. When the queue is full no slots are provided and
+  /// the kernel drops packets instead.
+  /// \return false if io_uring is unavailable, nothing has been received
+  bool ioUringInputLoop(Socket::Endpoint &Local, bool ReusePort,
+                        PacketQueue<EthernetBufferSize> &Queue,
+                        InputCounters &Counters) {
+    static constexpr unsigned int KernelEntries{Socket::MaxBatchSize};
+    if (Queue.getMaxElements() > 0x10000) {
+      LOG(INIT, Sev::Warning, "io_uring buffer ids are 16 bit, queue too big");
+      return false;
+    }
+
+    IoUringReceiver dataReceiver(Local, ReusePort);
+    dataReceiver.setBufferSizes(EFUSettings.TxSocketBufferSize,
+                                EFUSettings.RxSocketBufferSize);
+    dataReceiver.printBufferSizes();
+    if (not dataReceiver.setup(KernelEntries)) {
+      return false;
+    }
+
+    LOG(INIT, Sev::Info, "Detector input thread (io_uring) started on {}:{}",
+        Local.IpAddress, Local.Port);
+
+    // Slots [write index, write index + KernelOwned) are owned by the kernel
+    unsigned int KernelOwned{0};
+    auto provideFreeSlots = [&]() {
+      unsigned int Free = Queue.writable(KernelEntries);
+      while (KernelOwned < Free) {
+        unsigned int Index = Queue.getWriteIndex(KernelOwned);
+        dataReceiver.provideBuffer(Queue.getDataBuffer(Index),
+                                   EthernetBufferSize, Index);
+        KernelOwned++;
+      }
+      dataReceiver.commitBuffers();
+    };
+
+    provideFreeSlots();
+    if (not dataReceiver.armReceive()) {
+      return false;
+    }
+
+    IoUringReceiver::Completion Completions[Socket::MaxBatchSize];
+    TSCTimer IntervalTimer(EFUSettings.UpdateIntervalSec * 1000000 * TSC_MHZ);
+    while (runThreads) {
+      // No control messages with multishot recv, poll the socket instead
+      if (IntervalTimer.timeout()) {
+        Counters.RxKernelDrops = dataReceiver.readKernelDrops();
+        Counters.RxKernelDropsInterval =
+            Counters.RxKernelDrops - Counters.RxKernelDropsPrevious;
+        Counters.RxKernelDropsPrevious = Counters.RxKernelDrops;
+      }
+      provideFreeSlots();
+      if (not dataReceiver.isArmed() and (KernelOwned > 0) and
+          not dataReceiver.armReceive()) {
+        LOG(INPUT, Sev::Error, "Unable to rearm io_uring receive, stopping");
+        return true;
+      }
+
+      int Count = dataReceiver.waitCompletions(
+          Completions, Socket::MaxBatchSize, EFUSettings.SocketRxTimeoutUS);
+      if (Count == 0) {
+        Counters.RxIdle++;
+        continue;
+      }
+      Counters.RxBatchSize[std::min(31 - __builtin_clz(Count),
+                                      RxBatchHistBins - 1)]++;
+
+      // Multishot recv has no control messages, use the completion time
+      int64_t ArrivalNs = EFUSettings.NoRxTimestamps
+                              ? 0
+                              : ProcessingLatency::realtimeNs();
+      unsigned int Filled{0};
+      for (int i = 0; i < Count; i++) {
+        unsigned int Index = Completions[i].BufferId;
+        if (Index == IoUringReceiver::NoBuffer) {
+          continue;
+        }
+        assert(Index == Queue.getWriteIndex(Filled));
+        KernelOwned--;
+        Filled++;
+
+        // An empty datagram still used its slot, it is pushed with length 0
+        int ReadSize = std::max(Completions[i].Result, 0);
+        Queue.setDataLength(Index, ReadSize);
+        Queue.setArrivalTime(Index, ArrivalNs);
+        Counters.RxPackets++;
+        Counters.RxBytes += ReadSize;
+      }
+      if (Filled > 0) {
+        Queue.push(Filled);
+      }
+      updateQueueFill(Queue, Counters);
+    }
+    return true;
+  }
+
+  /// \brief Publish Packets consecutive queue slots to the processing thread
+  void queuePackets(PacketQueue<EthernetBufferSize> &Queue,
+                    InputCounters &Counters, unsigned int Indexes[],
+                    int Packets) {
+    for (int i = 0; i < Packets; i++) {
+      Counters.RxPackets++;
+      Counters.RxBytes += Queue.getDataLength(Indexes[i]);
+    }
+    Queue.push(Packets);
+    updateQueueFill(Queue, Counters);
+  }
+
+  /// \brief Sample the number of queue slots in use into the high water
+  /// mark and fill histogram, called by the input thread after pushing.
+  /// Samples are taken at most every RxQueueFillSampleUS.
+  void updateQueueFill(PacketQueue<EthernetBufferSize> &Queue,
+                       InputCounters &Counters) {
+    uint64_t Now = rdtsc();
+    if (Now < Counters.RxQueueFillNextTsc) {
+      return;
+    }
+    Counters.RxQueueFillNextTsc = Now + RxQueueFillSampleUS * TSC_MHZ;
+
+    int64_t Used = Queue.occupancy();
+    Counters.RxQueueHighWater = std::max(Counters.RxQueueHighWater, Used);
+    int Bin = Used * RxQueueFillBins / Queue.getMaxElements();
+    Counters.RxQueueFill[std::min(Bin, RxQueueFillBins - 1)]++;
+  }
+
+  /// \brief Copy the kernel drop count of the socket, as reported with the
+  /// last datagram, and update the per interval count on timeout
+  void updateKernelDrops(Socket &Receiver, TSCTimer &IntervalTimer,
+                         InputCounters &Counters) {
+    Counters.RxKernelDrops = Receiver.getKernelDrops();
+    if (IntervalTimer.timeout()) {
+      Counters.RxKernelDropsInterval =
+          Counters.RxKernelDrops - Counters.RxKernelDropsPrevious;
+      Counters.RxKernelDropsPrevious = Counters.RxKernelDrops;
+    }
+  }
+
   virtual ~Detector() = default;
 
   /// \brief returns the number of runtime counters (efustats)
@@ -135,17 +536,113 @@ public:
   Statistics Stats;
 
 public:
-  /// \todo figure out the right size  of EthernetBufferMaxEntries
-  static constexpr int EthernetBufferMaxEntries{2000};
-  static constexpr int EthernetBufferSize{9000}; /// bytes
-  static constexpr int KafkaBufferSize{12'400};  /// entries ~ 100kB
+  /// Packet slots shared between input_thread and processing_thread
+  PacketQueue<EthernetBufferSize> InputQueue{EFUSettings.RxQueueEntries};
 
-  /// Shared between input_thread and processing_thread
-  memory_sequential_consistent::CircularFifo<unsigned int,
-                                             EthernetBufferMaxEntries>
-      InputFifo;
-  /// \todo the number 11 is a workaround
-  RingBuffer<EthernetBufferSize> RxRingbuffer{EthernetBufferMaxEntries + 11};
+  /// Processing latency stages of the thread draining InputQueue, see
+  /// createLatencyStats()
+  ProcessingLatency Latency;
+
+  /// \brief register percentile stats for the stages of Latency
+  void createLatencyStats() {
+    // Calibrate the TSC now rather than when the first packet is processed
+    TSCTimer::nsPerTick();
+    auto Create = [this](std::string Stage, LatencyHistogram &Histogram) {
+      auto &Stat = Histogram.Stats;
+      Stats.create("latency." + Stage + ".count", Stat.Count);
+      Stats.create("latency." + Stage + ".p50_ns", Stat.P50);
+      Stats.create("latency." + Stage + ".p90_ns", Stat.P90);
+      Stats.create("latency." + Stage + ".p99_ns", Stat.P99);
+      Stats.create("latency." + Stage + ".p999_ns", Stat.P999);
+      Stats.create("latency." + Stage + ".max_ns", Stat.Max);
+    };
+    Create("arrival_dequeue", Latency.ArrivalDequeue);
+    Create("dequeue_parsed", Latency.DequeueParsed);
+    Create("parsed_serialized", Latency.ParsedSerialized);
+    Create("serialized_delivered", Latency.SerializedDelivered);
+  }
+
+  /// \brief Get the next packet from InputQueue to process. When the
+  /// reorder window of Parser is enabled packets are returned in sequence
+  /// number order per OutputQueue, slots waiting for a gap to be filled are
+  /// held in the queue.
+  /// \return false if there is no packet to process
+  bool popInOrder(ESSReadout::Parser &Parser, unsigned int &Index) {
+    auto &Window = Parser.Reorder;
+    if (not Window.enabled()) {
+      return InputQueue.pop(Index);
+    }
+    while (not Window.next(Index)) {
+      if (not InputQueue.pop(Index)) {
+        Window.expire(rdtsc());
+        if (not Window.next(Index)) {
+          return false;
+        }
+        break;
+      }
+      InputQueue.hold(Index);
+      uint64_t Now = rdtsc();
+      Parser.reorder(InputQueue.getDataBuffer(Index),
+                     InputQueue.getDataLength(Index), Index, Now);
+      Window.expire(Now);
+    }
+    InputQueue.release(Index);
+    return true;
+  }
+
+  /// Idle strategy of the processing thread draining InputQueue
+  IdleStrategy Idle{EFUSettings.IdleSpinCount,
+                    EFUSettings.IdleYieldCount,
+                    EFUSettings.IdleWaitUS};
+
+  /// Receive pipelines added by addPipelines(), pipeline 0 is InputQueue
+  /// and ITCounters
+  struct InputPipeline {
+    explicit InputPipeline(unsigned int Entries) : Queue(Entries) {}
+    PacketQueue<EthernetBufferSize> Queue;
+    InputCounters Counters;
+  };
+  std::vector<std::unique_ptr<InputPipeline>> Pipelines;
+
+  /// \brief packet queue of receive pipeline
+  PacketQueue<EthernetBufferSize> &inputQueue(unsigned int Pipeline) {
+    return (Pipeline == 0) ? InputQueue : Pipelines[Pipeline - 1]->Queue;
+  }
+
+  /// \brief input thread counters of receive pipeline
+  InputCounters &inputCounters(unsigned int Pipeline) {
+    return (Pipeline == 0) ? ITCounters : Pipelines[Pipeline - 1]->Counters;
+  }
+
+  /// \brief Add EFUSettings.RxPipelines - 1 receive pipelines. Each has its
+  /// own SO_REUSEPORT socket and input thread feeding its own queue, which
+  /// is drained by a thread running ProcessingFunc(Pipeline). The kernel
+  /// distributes packets by source address and port, so all packets from
+  /// one readout source stay in order within one pipeline.
+  void addPipelines(std::function<void(unsigned int)> ProcessingFunc) {
+    for (unsigned int i = 1; i < EFUSettings.RxPipelines; i++) {
+      Pipelines.emplace_back(
+          std::make_unique<InputPipeline>(EFUSettings.RxQueueEntries));
+      auto &Counters = Pipelines.back()->Counters;
+      Stats.create(fmt::format("pipeline.{:02}.receive.packets", i),
+                   Counters.RxPackets);
+      Stats.create(fmt::format("pipeline.{:02}.receive.bytes", i),
+                   Counters.RxBytes);
+      Stats.create(fmt::format("pipeline.{:02}.receive.dropped", i),
+                   Counters.FifoPushErrors);
+      Stats.create(fmt::format("pipeline.{:02}.receive.kernel_drops", i),
+                   Counters.RxKernelDrops);
+      Stats.create(fmt::format("pipeline.{:02}.receive.queue_high_water", i),
+                   Counters.RxQueueHighWater);
+
+      std::function<void()> InputFunc = [this, i]() { inputThread(i); };
+      AddThreadFunction(InputFunc, fmt::format("input_{:02}", i));
+      std::function<void()> Processing = [ProcessingFunc, i]() {
+        ProcessingFunc(i);
+      };
+      AddThreadFunction(Processing, fmt::format("processing_{:02}", i));
+    }
+  }
 
   // Ideally should match the CPU speed, but as this varies across
   // CPU versions we just select something in the 'middle'. This is
@@ -10,6 +10,7 @@
 #include <common/Version.h>
 #include <common/debug/Log.h>
 #include <common/detector/EFUArgs.h>
+#include <common/system/IoUringReceiver.h>
 #include <cstdio>
 #include <fstream>
 #include <regex>
@@ -96,6 +97,85 @@ EFUArgs::EFUArgs() {
                   "Transmit to detector buffer size.")
       ->group("EFU Options")->default_str("9216");
 
+  CLIParser.add_option("--rxbatch", EFUSettings.RxBatchSize,
+                  "Max UDP packets per receive call (1 disables batching).")
+      ->group("EFU Options")->default_str("1");
+
+  CLIParser.add_flag("--rxgro", EFUSettings.RxGro,
+                  "Receive UDP GRO coalesced datagrams (overrides --rxbatch).")
+      ->group("EFU Options");
+
+  CLIParser.add_option("--rxbackend", EFUSettings.RxBackend,
+                  "UDP receive backend: socket or io_uring (Linux >= 6.0).")
+      ->group("EFU Options")->default_str("socket")
+      ->check(CLI::IsMember({"socket", "io_uring"}))
+      ->check([](const std::string &Backend) {
+            if ((Backend == "io_uring") and not IoUringReceiver::Supported) {
+              return "io_uring receive is not supported by this build "
+                     "(kernel headers older than Linux 6.0)"s;
+            }
+            return ""s;
+          });
+
+  CLIParser.add_option("--rxqueue", EFUSettings.RxQueueEntries,
+                  "Number of packet slots between input and processing threads.")
+      ->group("EFU Options")->default_str("2000")
+      ->check(CLI::Range(1U, 1U << 20));
+
+  CLIParser.add_option("--rxpipelines", EFUSettings.RxPipelines,
+                  "Number of SO_REUSEPORT sockets, each with its own input "
+                  "and processing thread (where supported by the detector).")
+      ->group("EFU Options")->default_str("1")
+      ->check(CLI::Range(1U, 16U));
+
+  CLIParser.add_flag("--norxtimestamps", EFUSettings.NoRxTimestamps,
+                  "Do not request kernel receive timestamps (SO_TIMESTAMPNS), "
+                  "disables the latency.arrival_dequeue stats")
+      ->group("EFU Options");
+
+  CLIParser.add_option("--reorderdepth", EFUSettings.ReorderDepth,
+                  "Hold up to this many packets per OutputQueue to deliver "
+                  "them in sequence number order (VMM3 detectors), 0 is off")
+      ->group("EFU Options")->default_str("0")
+      ->check(CLI::Range(0U, 64U));
+
+  CLIParser.add_option("--reordertimeoutus", EFUSettings.ReorderTimeoutUS,
+                  "Max time (us) a packet is held waiting for a missing "
+                  "sequence number")
+      ->group("EFU Options")->default_str("1000");
+
+  CLIParser.add_option("--headerversion", EFUSettings.HeaderVersion,
+                  "ESS readout header version sent by the FENs (0 or 1), "
+                  "selects a faster header check. -1 detects it per packet")
+      ->group("EFU Options")->default_str("-1")
+      ->check(CLI::Range(-1, 1));
+
+  CLIParser.add_option("--idlespin", EFUSettings.IdleSpinCount,
+                  "Processing thread: empty queue polls spent busy spinning")
+      ->group("EFU Options")->default_str("1000");
+
+  CLIParser.add_option("--idleyield", EFUSettings.IdleYieldCount,
+                  "Processing thread: empty queue polls spent yielding, "
+                  "after spinning and before blocking")
+      ->group("EFU Options")->default_str("100");
+
+  CLIParser.add_option("--idlewaitus", EFUSettings.IdleWaitUS,
+                  "Processing thread: max time (us) to block waiting for "
+                  "packets, the input thread wakes it up on arrival")
+      ->group("EFU Options")->default_str("1000")
+      ->check(CLI::Range(1U, 1000000U));
+
+  CLIParser.add_option("--affinity", EFUSettings.ThreadAffinity,
+                  "Pin threads to cpus, comma separated thread:cpu list, "
+                  "e.g. input:2,processing:3,input_01:4,processing_01:5")
+      ->group("EFU Options")->default_str("");
+
+  CLIParser.add_option("--inputpriority", EFUSettings.InputPriority,
+                  "Run input threads with SCHED_FIFO at this priority "
+                  "(needs CAP_SYS_NICE), 0 for the normal scheduler")
+      ->group("EFU Options")->default_str("0")
+      ->check(CLI::Range(0U, 99U));
+
   //
   CLIParser.add_option("-f,--file", EFUSettings.ConfigFile,
                   "Detector configuration file (JSON)")
@@ -0,0 +1,172 @@
+// Copyright (C) 2024 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Implementation of per pulse ev44 merge stage
+///
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cinttypes>
+#include <common/debug/Trace.h>
+#include <common/kafka/EV44Merger.h>
+#include <limits>
+
+// #undef TRC_LEVEL
+// #define TRC_LEVEL TRC_L_DEB
+
+// Inputs are idle until they first advance
+EV44Merger::EV44Merger(unsigned int Inputs)
+    : CurrentPulse(Inputs, std::numeric_limits<int64_t>::min()),
+      Seen(Inputs, false), Idle(Inputs, true),
+      NewestPulse(std::numeric_limits<int64_t>::min()) {}
+
+void EV44Merger::setOutput(EV44Serializer *Serializer) { Output = Serializer; }
+
+void EV44Merger::advance(unsigned int Input, int64_t ReferenceTime) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  CurrentPulse[Input] = ReferenceTime;
+  Seen[Input] = true;
+  Idle[Input] = false;
+  NewestPulse = std::max(NewestPulse, ReferenceTime);
+  if (not Pending.empty() and (Pending.begin()->first < completeBefore())) {
+    Ready.store(true, std::memory_order_relaxed);
+  }
+}
+
+void EV44Merger::submit(unsigned int Input, int64_t ReferenceTime,
+                        std::vector<int32_t> &Times,
+                        std::vector<int32_t> &Pixels) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  Seen[Input] = true;
+  auto &Pulse = Pending[ReferenceTime];
+  if (Pulse.Times.empty()) {
+    Pulse.Times.swap(Times);
+    Pulse.Pixels.swap(Pixels);
+  } else {
+    Pulse.Times.insert(Pulse.Times.end(), Times.begin(), Times.end());
+    Pulse.Pixels.insert(Pulse.Pixels.end(), Pixels.begin(), Pixels.end());
+  }
+  Times.clear();
+  Pixels.clear();
+  // Late events of a pulse that is already complete
+  if (ReferenceTime < completeBefore()) {
+    Ready.store(true, std::memory_order_relaxed);
+  }
+}
+
+size_t EV44Merger::produce() {
+  if ((Output == nullptr) or not Ready.load(std::memory_order_relaxed)) {
+    return 0;
+  }
+
+  PulseMap Pulses;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Ready.store(false, std::memory_order_relaxed);
+    takeBefore(completeBefore(), Pulses);
+  }
+  return write(Pulses);
+}
+
+size_t EV44Merger::produceTimeout() {
+  PulseMap Pulses;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    bool AllIdle{true};
+    for (size_t i = 0; i < Seen.size(); i++) {
+      Idle[i] = not Seen[i];
+      Seen[i] = false;
+      AllIdle = AllIdle and Idle[i];
+    }
+    if (Output == nullptr) {
+      return 0;
+    }
+    takeBefore(AllIdle ? std::numeric_limits<int64_t>::max() : NewestPulse,
+               Pulses);
+  }
+  return write(Pulses);
+}
+
+size_t EV44Merger::produceAll() {
+  if (Output == nullptr) {
+    return 0;
+  }
+
+  PulseMap Pulses;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    takeBefore(std::numeric_limits<int64_t>::max(), Pulses);
+  }
+  return write(Pulses);
+}
+
+size_t EV44Merger::pendingPulses() {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return Pending.size();
+}
+
+int64_t EV44Merger::completeBefore() {
+  int64_t Complete{std::numeric_limits<int64_t>::max()};
+  bool Active{false};
+  for (size_t i = 0; i < CurrentPulse.size(); i++) {
+    if (not Idle[i]) {
+      Complete = std::min(Complete, CurrentPulse[i]);
+      Active = true;
+    }
+  }
+  return Active ? Complete : std::numeric_limits<int64_t>::min();
+}
+
+void EV44Merger::takeBefore(int64_t ReferenceTime, PulseMap &Pulses) {
+  auto End = Pending.lower_bound(ReferenceTime);
+  while (Pending.begin() != End) {
+    Pulses.insert(Pending.extract(Pending.begin()));
+  }
+}
+
+size_t EV44Merger::write(PulseMap &Pulses) {
+  size_t Bytes{0};
+  for (auto &Pulse : Pulses) {
+    XTRACE(OUTPUT, DEB, "Merged pulse %" PRIi64 ", %zu events", Pulse.first,
+           Pulse.second.Times.size());
+    Bytes += Output->checkAndSetReferenceTime(Pulse.first);
+    for (size_t i = 0; i < Pulse.second.Times.size(); i++) {
+      Bytes += Output->addEvent(Pulse.second.Times[i], Pulse.second.Pixels[i]);
+    }
+    Bytes += Output->produce();
+  }
+  return Bytes;
+}
+
+EV44MergeInput::EV44MergeInput(EV44Merger &Merger, unsigned int Input,
+                               size_t MaxEvents)
+    : EV44Serializer(1, "merge"), Merger(Merger), Input(Input),
+      MaxEvents(MaxEvents) {
+  Times.reserve(MaxEvents);
+  Pixels.reserve(MaxEvents);
+}
+
+void EV44MergeInput::setReferenceTime(int64_t Time) {
+  EV44Serializer::setReferenceTime(Time);
+  Merger.advance(Input, Time);
+}
+
+size_t EV44MergeInput::addEvent(int32_t Time, int32_t Pixel) {
+  Times.push_back(Time);
+  Pixels.push_back(Pixel);
+  if (Times.size() >= MaxEvents) {
+    ProduceCauseMaxEventsReached++;
+    return produce();
+  }
+  return 0;
+}
+
+size_t EV44MergeInput::produce() {
+  ProduceTimer.reset();
+  if (not Times.empty()) {
+    Merger.submit(Input, referenceTime(), Times, Pixels);
+  }
+  return 0;
+}
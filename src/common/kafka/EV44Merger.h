@@ -0,0 +1,117 @@
+// Copyright (C) 2024 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Combine ev44 events from several processing pipelines per pulse
+///
+/// Each pipeline gets an EV44MergeInput in place of its EV44Serializer. It
+/// buffers the events of the current pulse and hands them to the shared
+/// EV44Merger on pulse change, max events or produce(). A pulse is complete
+/// once every active pipeline has moved on to a later pulse. Pipelines only
+/// collect events under the lock, complete pulses are written to the output
+/// serializer, and produced, by the thread owning it (pipeline 0) through
+/// the EV44Merger::produce functions.
+///
+/// Pipelines that have not been seen between two calls of produceTimeout()
+/// are idle and no longer hold back pulses until they advance again. On
+/// timeout all pulses before the newest one are produced.
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <common/kafka/EV44Serializer.h>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+class EV44Merger {
+public:
+  /// \brief merger for events from Inputs pipelines
+  EV44Merger(unsigned int Inputs);
+
+  /// \brief set serializer receiving the combined events, pulses completed
+  /// before this are kept pending. The produce functions must be called
+  /// from the thread using Serializer.
+  void setOutput(EV44Serializer *Serializer);
+
+  /// \brief Input has moved on to pulse ReferenceTime, earlier pulses are
+  /// complete when all active inputs have done so
+  void advance(unsigned int Input, int64_t ReferenceTime);
+
+  /// \brief Add events of Input for pulse ReferenceTime, the vectors are
+  /// emptied
+  void submit(unsigned int Input, int64_t ReferenceTime,
+              std::vector<int32_t> &Times, std::vector<int32_t> &Pixels);
+
+  /// \brief Write and produce complete pulses, cheap when there are none
+  /// \return bytes produced
+  size_t produce();
+
+  /// \brief Mark inputs not seen since the previous call as idle, then write
+  /// and produce all pulses before the newest one, or all pulses if every
+  /// input is idle
+  /// \return bytes produced
+  size_t produceTimeout();
+
+  /// \brief Write and produce all pending pulses
+  /// \return bytes produced
+  size_t produceAll();
+
+  /// \brief number of pulses not yet written to the output
+  size_t pendingPulses();
+
+private:
+  struct PulseEvents {
+    std::vector<int32_t> Times;
+    std::vector<int32_t> Pixels;
+  };
+  using PulseMap = std::map<int64_t, PulseEvents>;
+
+  /// \brief earliest pulse not yet moved on from by all active inputs,
+  /// caller must hold Mutex
+  int64_t completeBefore();
+
+  /// \brief move pending pulses before ReferenceTime to Pulses, caller must
+  /// hold Mutex
+  void takeBefore(int64_t ReferenceTime, PulseMap &Pulses);
+
+  /// \brief write and produce Pulses, called without holding Mutex
+  size_t write(PulseMap &Pulses);
+
+  std::mutex Mutex;
+  EV44Serializer *Output{nullptr};
+  PulseMap Pending;
+  std::vector<int64_t> CurrentPulse;
+  std::vector<bool> Seen; ///< advanced or submitted since last timeout
+  std::vector<bool> Idle; ///< not seen during the last timeout interval
+  int64_t NewestPulse;
+  std::atomic<bool> Ready{false}; ///< Pending holds complete pulses
+};
+
+/// \brief Stand-in for the EV44Serializer of one pipeline, forwards events
+/// to an EV44Merger rather than producing messages itself
+class EV44MergeInput : public EV44Serializer {
+public:
+  /// \param Merger shared merge stage
+  /// \param Input pipeline number, 0 to Inputs - 1
+  /// \param MaxEvents events buffered before submitting to the merger
+  EV44MergeInput(EV44Merger &Merger, unsigned int Input, size_t MaxEvents);
+
+  void setReferenceTime(int64_t Time) override;
+
+  size_t addEvent(int32_t Time, int32_t Pixel) override;
+
+  /// \brief submit buffered events to the merger
+  /// \return 0, the merger produces the messages
+  size_t produce() override;
+
+private:
+  EV44Merger &Merger;
+  unsigned int Input;
+  size_t MaxEvents;
+  std::vector<int32_t> Times;
+  std::vector<int32_t> Pixels;
+};
@@ -58,8 +58,9 @@ public:
   size_t eventCount() const;
 
   /// \brief serializes and sends to producer
+  /// Function is virtual to allow merging output of several pipelines
   /// \returns bytes transmitted
-  size_t produce();
+  virtual size_t produce();
 
   // \todo make private?
   /// \brief serializes buffer
@@ -12,6 +12,7 @@
 #include <common/debug/Trace.h>
 #include <common/kafka/Producer.h>
 #include <common/system/gccintel.h>
+#include <common/time/TSCTimer.h>
 #include <nlohmann/json.hpp>
 
 // #undef TRC_LEVEL
@@ -61,11 +62,26 @@ void Producer::event_cb(RdKafka::Event &event) {
   }
 }
 
+///
+void Producer::dr_cb(RdKafka::Message &Message) {
+  if (Message.err() != RdKafka::ERR_NO_ERROR) {
+    stats.dr_errors++;
+  } else {
+    stats.dr_noerrors++;
+  }
+
+  // msg_opaque holds the TSC at produce()
+  if ((DeliveryLatency != nullptr) and (Message.msg_opaque() != nullptr)) {
+    uint64_t Ticks = rdtsc() - (uintptr_t)Message.msg_opaque();
+    DeliveryLatency->add(Ticks * TSCTimer::nsPerTick());
+  }
+}
 
 ///
 Producer::Producer(std::string Broker, std::string Topic,
                    std::vector<std::pair<std::string, std::string>> &Configs)
-    : ProducerBase(), TopicName(Topic) {
+    : ProducerBase(), TopicName(Topic),
+      PollTimer(PollIntervalNs / TSCTimer::nsPerTick()) {
 
   Config.reset(RdKafka::Conf::create(RdKafka::Conf::CONF_GLOBAL));
   TopicConfig.reset(RdKafka::Conf::create(RdKafka::Conf::CONF_TOPIC));
@@ -86,13 +102,15 @@ Producer::Producer(std::string Broker, std::string Topic,
     setConfig(Config.first, Config.second);
   }
 
-  if (Config->set("event_cb", this, ErrorMessage) != RdKafka::Conf::CONF_OK) {
+  if (Config->set("event_cb", static_cast<RdKafka::EventCb *>(this),
+                  ErrorMessage) != RdKafka::Conf::CONF_OK) {
     LOG(KAFKA, Sev::Error, "Kafka: unable to set event_cb");
   }
 
-  // if (conf->set("dr_cb", this, ErrorMessage) != RdKafka::Conf::CONF_OK) {
-  //   LOG(KAFKA, Sev::Error, "Kafka: unable to set dr_cb");
-  // }
+  if (Config->set("dr_cb", static_cast<RdKafka::DeliveryReportCb *>(this),
+                  ErrorMessage) != RdKafka::Conf::CONF_OK) {
+    LOG(KAFKA, Sev::Error, "Kafka: unable to set dr_cb");
+  }
 
   KafkaProducer.reset(RdKafka::Producer::create(Config.get(), ErrorMessage));
   if (!KafkaProducer) {
@@ -108,6 +126,14 @@ Producer::Producer(std::string Broker, std::string Topic,
   }
 }
 
+///
+void Producer::poll() {
+  if ((KafkaProducer == nullptr) or not PollTimer.timeout()) {
+    return;
+  }
+  KafkaProducer->poll(0);
+}
+
 // called to actually send data to Kafka cluster
 int Producer::produce(nonstd::span<const std::uint8_t> Buffer,
                       std::int64_t MessageTimestampMS) {
@@ -115,10 +141,12 @@ int Producer::produce(nonstd::span<const std::uint8_t> Buffer,
     return RdKafka::ERR_UNKNOWN;
   }
 
+  void *ProduceTime = (DeliveryLatency != nullptr) ? (void *)(uintptr_t)rdtsc()
+                                                    : nullptr;
   RdKafka::ErrorCode resp = KafkaProducer->produce(
       TopicName, -1, RdKafka::Producer::RK_MSG_COPY,
       const_cast<std::uint8_t *>(Buffer.data()), Buffer.size_bytes(), NULL, 0,
-      MessageTimestampMS, NULL);
+      MessageTimestampMS, ProduceTime);
 
   stats.produce_calls++;
 
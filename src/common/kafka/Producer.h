@@ -15,6 +15,8 @@
 #pragma GCC diagnostic pop
 
 #include <common/memory/Buffer.h>
+#include <common/time/LatencyHistogram.h>
+#include <common/time/TSCTimer.h>
 #include <functional>
 #include <memory>
 #include <common/memory/span.hpp>
@@ -38,7 +40,9 @@ public:
                       std::int64_t MessageTimestampMS) = 0;
 };
 
-class Producer : public ProducerBase, public RdKafka::EventCb {
+class Producer : public ProducerBase,
+                 public RdKafka::EventCb,
+                 public RdKafka::DeliveryReportCb {
 public:
   /// \brief Construct a producer object.
   /// \param Broker 'URL' specifying host and port, example "127.0.0.1:9009"
@@ -62,6 +66,24 @@ public:
   /// \brief Kafka callback function for events
   void event_cb(RdKafka::Event &event) override;
 
+  /// \brief Kafka callback function for delivery reports, called from
+  /// produce() and poll()
+  void dr_cb(RdKafka::Message &Message) override;
+
+  /// \brief Serve delivery reports and events if PollIntervalNs has passed
+  /// since the last call. Called from the processing loop so that delivery
+  /// reports are handled also when no messages are produced.
+  void poll();
+
+  /// \brief record the time from produce() to the delivery report of each
+  /// message in Histogram, nullptr to stop. The delivery time is accurate to
+  /// the interval at which poll() is called.
+  void setDeliveryLatency(LatencyHistogram *Histogram) {
+    DeliveryLatency = Histogram;
+  }
+
+  static constexpr uint64_t PollIntervalNs{1'000'000};
+
   struct ProducerStats {
     int64_t config_errors;
     int64_t ev_errors;
@@ -87,6 +109,8 @@ protected:
   std::unique_ptr<RdKafka::Conf> TopicConfig;
   std::unique_ptr<RdKafka::Topic> KafkaTopic;
   std::unique_ptr<RdKafka::Producer> KafkaProducer;
+  LatencyHistogram *DeliveryLatency{nullptr};
+  TSCTimer PollTimer;
 };
 
 using ProducerCallback =
@@ -0,0 +1,166 @@
+// Copyright (C) 2024 European Spallation Source ERIC
+
+#include <common/kafka/EV44Merger.h>
+#include <common/testutils/TestBase.h>
+#include <tuple>
+#include <vector>
+
+/// Output serializer recording the (pulse, time, pixel) of merged events
+class RecordingSerializer : public EV44Serializer {
+public:
+  RecordingSerializer(ProducerCallback Callback)
+      : EV44Serializer(100, "merged", Callback) {}
+
+  size_t addEvent(int32_t Time, int32_t Pixel) override {
+    Events.push_back({referenceTime(), Time, Pixel});
+    return EV44Serializer::addEvent(Time, Pixel);
+  }
+
+  std::vector<std::tuple<int64_t, int32_t, int32_t>> Events;
+};
+
+class EV44MergerTest : public TestBase {
+protected:
+  void SetUp() override {}
+  void TearDown() override {}
+
+  int Produced{0};
+  RecordingSerializer Output{
+      [this](nonstd::span<const uint8_t>, int64_t) { Produced++; }};
+  EV44Merger Merger{2};
+  EV44MergeInput Input0{Merger, 0, 100};
+  EV44MergeInput Input1{Merger, 1, 100};
+};
+
+TEST_F(EV44MergerTest, PulseProducedWhenAllInputsMovedOn) {
+  Merger.setOutput(&Output);
+  Input0.checkAndSetReferenceTime(1000);
+  Input1.checkAndSetReferenceTime(1000);
+  Input0.addEvent(10, 1);
+  Input1.addEvent(20, 2);
+  Input0.addEvent(11, 3);
+
+  Input0.checkAndSetReferenceTime(2000);
+  Input0.addEvent(12, 4);
+  ASSERT_EQ(Produced, 0);
+  ASSERT_EQ(Merger.pendingPulses(), 1);
+
+  Merger.produce();
+  ASSERT_EQ(Produced, 0);
+
+  Input1.checkAndSetReferenceTime(2000);
+  ASSERT_EQ(Produced, 0);
+  Merger.produce();
+  ASSERT_EQ(Produced, 1);
+  ASSERT_EQ(Output.Events.size(), 3);
+  for (auto &Event : Output.Events) {
+    ASSERT_EQ(std::get<0>(Event), 1000);
+  }
+  ASSERT_EQ(Merger.pendingPulses(), 0);
+
+  // Pulse 2000 is still being filled by Input0
+  Input0.produce();
+  ASSERT_EQ(Merger.pendingPulses(), 1);
+  Merger.produce();
+  ASSERT_EQ(Produced, 1);
+  Merger.produceAll();
+  ASSERT_EQ(Produced, 2);
+  ASSERT_EQ(Output.Events.size(), 4);
+  ASSERT_EQ(Output.Events.back(), std::make_tuple(2000, 12, 4));
+}
+
+TEST_F(EV44MergerTest, PendingUntilOutputSet) {
+  Input0.checkAndSetReferenceTime(1000);
+  Input1.checkAndSetReferenceTime(1000);
+  Input1.addEvent(20, 2);
+  Input0.checkAndSetReferenceTime(2000);
+  Input1.checkAndSetReferenceTime(2000);
+  Merger.produce();
+  ASSERT_EQ(Merger.pendingPulses(), 1);
+  ASSERT_EQ(Produced, 0);
+
+  Merger.setOutput(&Output);
+  Merger.produce();
+  ASSERT_EQ(Produced, 1);
+  ASSERT_EQ(Output.Events.size(), 1);
+}
+
+TEST_F(EV44MergerTest, IdleInputExcluded) {
+  Merger.setOutput(&Output);
+  Input0.checkAndSetReferenceTime(1000);
+  Input1.checkAndSetReferenceTime(1000);
+  Merger.produceTimeout();
+
+  // Input1 receives nothing from here on
+  for (int64_t Pulse = 1000; Pulse < 4000; Pulse += 1000) {
+    Input0.checkAndSetReferenceTime(Pulse);
+    Input0.addEvent(1, 1);
+  }
+  Input0.produce();
+  Merger.produce();
+  ASSERT_EQ(Produced, 0);
+  ASSERT_EQ(Merger.pendingPulses(), 3);
+
+  // Input1 was seen during the last interval
+  Merger.produceTimeout();
+  ASSERT_EQ(Produced, 2);
+  ASSERT_EQ(Merger.pendingPulses(), 1);
+
+  // Input1 is idle now
+  Input0.checkAndSetReferenceTime(4000);
+  Merger.produce();
+  ASSERT_EQ(Produced, 3);
+
+  // and no longer once it moves on
+  Input0.addEvent(1, 1);
+  Input0.checkAndSetReferenceTime(5000);
+  Input1.checkAndSetReferenceTime(4000);
+  Merger.produce();
+  ASSERT_EQ(Produced, 3);
+  Input1.checkAndSetReferenceTime(5000);
+  Merger.produce();
+  ASSERT_EQ(Produced, 4);
+}
+
+TEST_F(EV44MergerTest, TimeoutKeepsNewestPulse) {
+  Merger.setOutput(&Output);
+  Input0.checkAndSetReferenceTime(1000);
+  Input1.checkAndSetReferenceTime(1000);
+  Input1.addEvent(1, 1);
+  Input1.produce();
+  Input0.checkAndSetReferenceTime(2000);
+  Input0.addEvent(2, 2);
+  Input0.produce();
+
+  Merger.produceTimeout();
+  ASSERT_EQ(Produced, 1);
+  ASSERT_EQ(Merger.pendingPulses(), 1);
+
+  // Events for pulse 2000 may still arrive from Input0
+  Input0.addEvent(3, 3);
+  Input0.produce();
+  Merger.produceTimeout();
+  ASSERT_EQ(Produced, 1);
+
+  // Both inputs idle
+  Merger.produceTimeout();
+  ASSERT_EQ(Produced, 2);
+  ASSERT_EQ(Output.Events.size(), 3);
+  ASSERT_EQ(Merger.pendingPulses(), 0);
+}
+
+TEST_F(EV44MergerTest, MaxEventsSubmits) {
+  EV44MergeInput SmallInput(Merger, 0, 2);
+  Merger.setOutput(&Output);
+  SmallInput.checkAndSetReferenceTime(1000);
+  SmallInput.addEvent(1, 1);
+  ASSERT_EQ(Merger.pendingPulses(), 0);
+  SmallInput.addEvent(2, 2);
+  ASSERT_EQ(Merger.pendingPulses(), 1);
+  ASSERT_EQ(SmallInput.ProduceCauseMaxEventsReached, 1);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
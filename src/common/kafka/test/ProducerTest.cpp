@@ -6,12 +6,14 @@
 //===----------------------------------------------------------------------===//
 
 #include "KafkaMocks.h"
+#include <chrono>
 #include <common/kafka/KafkaConfig.h>
 #include <common/kafka/Producer.h>
 #include <common/testutils/TestBase.h>
 #include <cstring>
 #include <dlfcn.h>
 #include <librdkafka/rdkafkacpp.h>
+#include <thread>
 #include <trompeloeil.hpp>
 
 KafkaConfig KafkaCfg{""};
@@ -124,6 +126,17 @@ TEST_F(ProducerTest, ProducerSuccess) {
   ASSERT_EQ(prod.stats.produce_errors, 0);
 }
 
+TEST_F(ProducerTest, PollOnInterval) {
+  ProducerStandIn prod{"nobroker", "notopic"};
+  auto *TempProducer = new MockProducer;
+  REQUIRE_CALL(*TempProducer, poll(_)).TIMES(1).RETURN(0);
+  prod.KafkaProducer.reset(TempProducer);
+  std::this_thread::sleep_for(
+      std::chrono::nanoseconds(2 * Producer::PollIntervalNs));
+  prod.poll();
+  prod.poll(); // within the interval
+}
+
 TEST_F(ProducerTest, ProducerFailDueToSize) {
   KafkaConfig KafkaCfg2("");
   ASSERT_EQ(KafkaCfg2.CfgParms.size(), 5);
@@ -0,0 +1,326 @@
+// Copyright (C) 2024 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Single producer single consumer queue of fixed size packet slots
+///
+/// Combines the packet buffers and the queue of buffer indices into one
+/// structure. The producer (input thread) writes directly into free slots
+/// and publishes them with push(), the consumer (processing thread) gets
+/// them in order with pop(). A popped slot stays owned by the consumer
+/// until the next call to pop(), so it can never be overwritten while it is
+/// being processed.
+///
+/// The number of slots is a power of two so indices are masked rather than
+/// wrapped with modulus. Producer and consumer indices live on separate
+/// cache lines, each side keeps a cached copy of the other side's index and
+/// only reloads it (acquire) when the cached value says the queue is
+/// full/empty.
+///
+/// Slot memory is allocated with mmap(), from 2 MB huge pages when the
+/// system has them reserved, otherwise with a transparent huge page hint,
+/// and is locked in memory when permitted. bindToNode() moves it to the
+/// NUMA node of the threads using the queue.
+///
+/// The consumer can hold() a popped slot past the next pop(), e.g. while
+/// it waits for an earlier packet. Slots are released in order, so a held
+/// slot also keeps the slots popped after it from the producer until it is
+/// release()d.
+///
+/// An idle consumer can block in waitForData(), push() wakes it through a
+/// futex but only when the consumer has announced that it is waiting, so
+/// the cost on the producer side is a fence and a load per push(). Batched
+/// producers publish all slots of a batch with a single push(Count). The
+/// waiting flag has a cache line of its own so that checking it does not
+/// pull in the consumer's indices.
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <sys/mman.h>
+
+#ifdef SYSTEM_NAME_LINUX
+#include <ctime>
+#include <linux/futex.h>
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
+#include <unistd.h>
+
+template <const unsigned int N> class PacketQueue {
+  static constexpr size_t CacheLineSize{64};
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                "futex word must be a plain 32 bit integer");
+
+public:
+  static constexpr size_t HugePageSize{2 * 1024 * 1024};
+
+  /// Type of memory backing the slots
+  enum Backing { Pages = 0, TransparentHugePages = 1, HugePages = 2 };
+
+  struct alignas(CacheLineSize) Slot {
+    char Buffer[N];
+    int Length{0};
+    int64_t ArrivalNs{0}; // receive time, ns since epoch, 0 if unknown
+    bool Held{false};     // kept by the consumer past the next pop()
+  };
+
+  /// \brief construct a queue with at least MinEntries slots, the number of
+  /// slots is rounded up to a power of two
+  PacketQueue(unsigned int MinEntries) {
+    while (Entries < MinEntries) {
+      Entries <<= 1;
+    }
+    Mask = Entries - 1;
+    allocate(Entries * sizeof(Slot));
+    for (unsigned int i = 0; i < Entries; i++) {
+      new (&Slots[i]) Slot;
+    }
+  }
+
+  ~PacketQueue() {
+    if (Locked) {
+      munlock(Slots, AllocatedBytes);
+    }
+    munmap(Slots, AllocatedBytes);
+  }
+
+  PacketQueue(const PacketQueue &) = delete;
+  PacketQueue &operator=(const PacketQueue &) = delete;
+
+  /// \brief Number of free slots, at most Wanted. The consumer index is only
+  /// reloaded when the cached copy shows fewer than Wanted free slots.
+  /// Only called by Producer.
+  unsigned int writable(unsigned int Wanted = 1) {
+    uint64_t Free = Entries - (WriteIndex - CachedReadIndex);
+    if (Free < Wanted) {
+      CachedReadIndex = ReadIndex.load(std::memory_order_acquire);
+      Free = Entries - (WriteIndex - CachedReadIndex);
+    }
+    return (Free < Wanted) ? Free : Wanted;
+  }
+
+  /// \brief Number of slots pushed and not yet released by the consumer.
+  /// Reloads the consumer index, so also refreshes the cached copy used by
+  /// writable(). Only called by Producer.
+  unsigned int occupancy() {
+    CachedReadIndex = ReadIndex.load(std::memory_order_acquire);
+    return WriteIndex - CachedReadIndex;
+  }
+
+  /// \brief Index of the slot Offset entries after the next slot to be
+  /// pushed. Only called by Producer, for slots reported by writable().
+  unsigned int getWriteIndex(unsigned int Offset = 0) {
+    return (WriteIndex + Offset) & Mask;
+  }
+
+  /// \brief Publish the Count next slots to the consumer, these must have
+  /// been reported free by writable(). Only called by Producer.
+  void push(unsigned int Count = 1) {
+    assert(WriteIndex + Count - CachedReadIndex <= Entries);
+    WriteIndex += Count;
+    PublishedWriteIndex.store(WriteIndex, std::memory_order_release);
+    // Pairs with the fence in waitForData(): either the consumer sees the
+    // new write index or we see that it is waiting
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ConsumerWaiting.load(std::memory_order_relaxed)) {
+      wakeConsumer();
+    }
+  }
+
+  /// \brief Release the previously popped slots, up to the first one
+  /// held, and get the index of the next one. Only called by Consumer.
+  /// \return false if the queue is empty
+  bool pop(unsigned int &Index) {
+    uint64_t Released = ReleasedIndex;
+    while (Released != ConsumerIndex and not Slots[Released & Mask].Held) {
+      Released++;
+    }
+    if (Released != ReleasedIndex) {
+      ReleasedIndex = Released;
+      ReadIndex.store(Released, std::memory_order_release);
+    }
+    if (ConsumerIndex == CachedWriteIndex) {
+      CachedWriteIndex = PublishedWriteIndex.load(std::memory_order_acquire);
+      if (ConsumerIndex == CachedWriteIndex) {
+        return false;
+      }
+    }
+    Index = ConsumerIndex & Mask;
+    ConsumerIndex++;
+    return true;
+  }
+
+  /// \brief Keep popped slot Index from being released by the following
+  /// pop() calls. Only called by Consumer.
+  void hold(unsigned int Index) {
+    assert(Index < Entries);
+    Slots[Index].Held = true;
+  }
+
+  /// \brief Let a held slot be released by the next pop(). Only called by
+  /// Consumer.
+  void release(unsigned int Index) {
+    assert(Index < Entries);
+    Slots[Index].Held = false;
+  }
+
+  /// \brief true if pop() will return a slot. Only called by Consumer.
+  bool readable() {
+    return ConsumerIndex != CachedWriteIndex or
+           ConsumerIndex != PublishedWriteIndex.load(std::memory_order_acquire);
+  }
+
+  /// \brief Block until the producer pushes or TimeoutUS has passed. Only
+  /// called by Consumer. Without futex support this sleeps for at most
+  /// TimeoutUS.
+  /// \return true if pop() will return a slot
+  bool waitForData(unsigned int TimeoutUS) {
+    if (readable()) {
+      return true;
+    }
+#ifdef SYSTEM_NAME_LINUX
+    uint32_t Expected = WakeCount.load(std::memory_order_relaxed);
+    ConsumerWaiting.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (not readable()) {
+      struct timespec Timeout;
+      Timeout.tv_sec = TimeoutUS / 1000000;
+      Timeout.tv_nsec = (TimeoutUS % 1000000) * 1000;
+      syscall(SYS_futex, reinterpret_cast<uint32_t *>(&WakeCount),
+              FUTEX_WAIT_PRIVATE, Expected, &Timeout, nullptr, 0);
+    }
+    ConsumerWaiting.store(0, std::memory_order_relaxed);
+#else
+    usleep(TimeoutUS);
+#endif
+    return readable();
+  }
+
+  /// \brief snapshot, true when all pushed slots have been released by the
+  /// consumer. Used by tests and monitoring
+  bool wasEmpty() const {
+    return ReadIndex.load(std::memory_order_acquire) ==
+           PublishedWriteIndex.load(std::memory_order_acquire);
+  }
+
+  /// \brief Get pointer to data for specified slot
+  char *getDataBuffer(unsigned int Index) {
+    assert(Index < Entries);
+    return Slots[Index].Buffer;
+  }
+
+  /// \brief Set length of data in specified slot, only called by Producer
+  void setDataLength(unsigned int Index, unsigned int Length) {
+    assert(Length <= N);
+    assert(Index < Entries);
+    Slots[Index].Length = Length;
+  }
+
+  /// \brief Get length of data in specified slot
+  int getDataLength(unsigned int Index) {
+    assert(Index < Entries);
+    return Slots[Index].Length;
+  }
+
+  /// \brief Set receive time (ns since epoch) of the packet in specified
+  /// slot, only called by Producer
+  void setArrivalTime(unsigned int Index, int64_t ArrivalNs) {
+    assert(Index < Entries);
+    Slots[Index].ArrivalNs = ArrivalNs;
+  }
+
+  /// \brief Get receive time (ns since epoch) of the packet in specified
+  /// slot, 0 if unknown
+  int64_t getArrivalTime(unsigned int Index) {
+    assert(Index < Entries);
+    return Slots[Index].ArrivalNs;
+  }
+
+  int getMaxBufSize() { return N; }         ///< return slot size in bytes
+  int getMaxElements() { return Entries; } ///< return number of slots
+
+  /// \brief Place slot memory on NUMA Node, moving pages already faulted
+  /// in. Called before the producer and consumer threads are started.
+  /// \return false if the memory could not be bound
+  bool bindToNode(int Node) {
+#ifdef SYSTEM_NAME_LINUX
+    if (Node < 0 or Node >= 64) {
+      return false;
+    }
+    unsigned long NodeMask = 1UL << Node;
+    return syscall(SYS_mbind, Slots, AllocatedBytes, MPOL_PREFERRED,
+                   &NodeMask, sizeof(NodeMask) * 8, MPOL_MF_MOVE) == 0;
+#else
+    (void)Node;
+    return false;
+#endif
+  }
+
+  Backing getBacking() { return MemoryBacking; } ///< type of slot memory
+  size_t getAllocatedBytes() { return AllocatedBytes; } ///< slot memory size
+  bool isLocked() { return Locked; } ///< slot memory locked with mlock()
+
+private:
+  /// \brief wake a consumer blocked in waitForData()
+  void wakeConsumer() {
+    WakeCount.fetch_add(1, std::memory_order_relaxed);
+#ifdef SYSTEM_NAME_LINUX
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&WakeCount),
+            FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#endif
+  }
+
+  /// \brief map Bytes of slot memory, rounded up to whole huge pages
+  void allocate(size_t Bytes) {
+    AllocatedBytes = (Bytes + HugePageSize - 1) & ~(HugePageSize - 1);
+    void *Memory{MAP_FAILED};
+#ifdef MAP_HUGETLB
+    Memory = mmap(nullptr, AllocatedBytes, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    MemoryBacking = HugePages;
+#endif
+    if (Memory == MAP_FAILED) {
+      Memory = mmap(nullptr, AllocatedBytes, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (Memory == MAP_FAILED) {
+        throw std::bad_alloc();
+      }
+      MemoryBacking = Pages;
+#ifdef MADV_HUGEPAGE
+      if (madvise(Memory, AllocatedBytes, MADV_HUGEPAGE) == 0) {
+        MemoryBacking = TransparentHugePages;
+      }
+#endif
+    }
+    Locked = (mlock(Memory, AllocatedBytes) == 0);
+    Slots = static_cast<Slot *>(Memory);
+  }
+
+  Slot *Slots{nullptr};
+  unsigned int Entries{1};
+  unsigned int Mask{0};
+  size_t AllocatedBytes{0};
+  Backing MemoryBacking{Pages};
+  bool Locked{false};
+
+  // Producer cache line
+  alignas(CacheLineSize) uint64_t WriteIndex{0};
+  uint64_t CachedReadIndex{0};
+  std::atomic<uint64_t> PublishedWriteIndex{0};
+  std::atomic<uint32_t> WakeCount{0}; // futex word
+
+  // Consumer cache line
+  alignas(CacheLineSize) uint64_t ConsumerIndex{0};
+  uint64_t CachedWriteIndex{0};
+  uint64_t ReleasedIndex{0}; // consumer copy of ReadIndex
+  std::atomic<uint64_t> ReadIndex{0};
+
+  // Written by an idle consumer only, read by every push()
+  alignas(CacheLineSize) std::atomic<uint32_t> ConsumerWaiting{0};
+};
@@ -8,6 +8,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <arpa/inet.h>
+#include <common/debug/Log.h>
 #include <common/debug/Trace.h>
 #include <common/readout/ess/Parser.h>
 #include <cstring>
@@ -23,6 +24,14 @@ namespace ESSReadout {
 Parser::Parser() { std::memset(NextSeqNum, 0, sizeof(NextSeqNum)); }
 
 int Parser::validate(const char *Buffer, uint32_t Size, uint8_t ExpectedType) {
+  if (FastValidate != nullptr and ExpectedType == FastType) {
+    return (this->*FastValidate)(Buffer, Size);
+  }
+  return validateAny(Buffer, Size, ExpectedType);
+}
+
+int Parser::validateAny(const char *Buffer, uint32_t Size,
+                        uint8_t ExpectedType) {
 
   HeaderVersion hVersion = HeaderVersion::V0;
 
@@ -155,10 +164,10 @@ int Parser::validate(const char *Buffer, uint32_t Size, uint8_t ExpectedType) {
     return -Parser::EHEADER;
   }
 
-  Packet.Time.setReference(
-      ESSTime(Packet.HeaderPtr.getPulseHigh(), Packet.HeaderPtr.getPulseLow()));
-  Packet.Time.setPrevReference(ESSTime(Packet.HeaderPtr.getPrevPulseHigh(),
-                                       Packet.HeaderPtr.getPrevPulseLow()));
+  Packet.Time.setReferences(
+      ESSTime(Packet.HeaderPtr.getPulseHigh(), Packet.HeaderPtr.getPulseLow()),
+      ESSTime(Packet.HeaderPtr.getPrevPulseHigh(),
+              Packet.HeaderPtr.getPrevPulseLow()));
 
   XTRACE(DATA, DEB, "PulseTime     (0x%08x,0x%08x)",
          Packet.HeaderPtr.getPulseHigh(), Packet.HeaderPtr.getPulseLow());
@@ -203,4 +212,143 @@ int Parser::validate(const char *Buffer, uint32_t Size, uint8_t ExpectedType) {
 
   return Parser::OK;
 }
+
+template <Parser::HeaderVersion Version, Parser::DetectorType Type>
+int Parser::validate(const char *Buffer, uint32_t Size) {
+  using Header = std::conditional_t<Version == HeaderVersion::V1,
+                                    PacketHeaderV1, PacketHeaderV0>;
+  // Padding0, Version, 'E', 'S', 'S' and Type in the first six bytes
+  constexpr uint64_t Expected = (uint64_t)Version << 8 | 0x535345ULL << 16 |
+                                (uint64_t)Type << 40;
+  constexpr uint64_t Mask{0xffffffffffffULL};
+
+  if (Buffer == nullptr or Size < sizeof(Header) or Size > MaxUdpDataSize) {
+    return validateAny(Buffer, Size, Type);
+  }
+
+  uint64_t First;
+  std::memcpy(&First, Buffer, sizeof(First));
+  if ((First & Mask) != Expected) {
+    return validateAny(Buffer, Size, Type);
+  }
+
+  auto Hdr = (const Header *)Buffer;
+  Packet.HeaderPtr = PacketHeader((Header *)Buffer);
+  if constexpr (Version == HeaderVersion::V1) {
+    Stats.Version1Header++;
+  } else {
+    Stats.Version0Header++;
+  }
+
+  if (Size != Hdr->TotalLength) {
+    XTRACE(PROCESS, WAR, "Data length mismatch, expected %u, got %u",
+           Hdr->TotalLength, Size);
+    Stats.ErrorSize++;
+    return -Parser::ESIZE;
+  }
+
+  uint8_t OutputQueue = Hdr->OutputQueue;
+  if (OutputQueue >= MaxOutputQueues) {
+    XTRACE(PROCESS, WAR, "Output queue %u exceeds max size %u", OutputQueue,
+           MaxOutputQueues);
+    Stats.ErrorOutputQueue++;
+    return -Parser::EHEADER;
+  }
+
+  Stats.OQRxPackets[OutputQueue]++;
+
+  uint32_t SeqNum = Hdr->SeqNum;
+  if (NextSeqNum[OutputQueue] != SeqNum) {
+    XTRACE(PROCESS, WAR, "Bad sequence number for OQ %u (expected %u, got %u)",
+           OutputQueue, NextSeqNum[OutputQueue], SeqNum);
+    Stats.ErrorSeqNum++;
+  }
+  NextSeqNum[OutputQueue] = (uint64_t)SeqNum + 1;
+
+  Packet.DataPtr = (char *)(Buffer + sizeof(Header));
+  Packet.DataLength = Size - sizeof(Header);
+
+  uint32_t PulseHigh = Hdr->PulseHigh;
+  uint32_t PulseLow = Hdr->PulseLow;
+  uint32_t PrevPulseHigh = Hdr->PrevPulseHigh;
+  uint32_t PrevPulseLow = Hdr->PrevPulseLow;
+  if (PulseLow > MaxFracTimeCount or PrevPulseLow > MaxFracTimeCount) {
+    XTRACE(PROCESS, WAR, "Pulse time low (%u, prev %u) exceeds max (%u)",
+           PulseLow, PrevPulseLow, MaxFracTimeCount);
+    Stats.ErrorTimeFrac++;
+    return -Parser::EHEADER;
+  }
+
+  Packet.Time.setReferences(ESSTime(PulseHigh, PulseLow),
+                            ESSTime(PrevPulseHigh, PrevPulseLow));
+
+  if (Packet.Time.getRefTimeNS() - Packet.Time.getPrevRefTimeNS() >
+      MaxPulseTimeDiffNS) {
+    XTRACE(DATA, WAR, "PulseTime and PrevPulseTime too far apart");
+    Stats.ErrorTimeHigh++;
+    return -Parser::EHEADER;
+  }
+
+  if (Size == sizeof(Header)) {
+    XTRACE(PROCESS, DEB, "Heartbeat packet (pulse time only)");
+    Stats.HeartBeats++;
+  }
+
+  return Parser::OK;
+}
+
+// Fast paths for all header versions and detector types
+#define ESS_DETECTOR_TYPES(X)                                                  \
+  X(CBM) X(LOKI) X(BIFROST) X(MIRACLES) X(CSPEC) X(NMX) X(FREIA) X(TREX)       \
+      X(DREAM) X(MAGIC)
+
+#define ESS_INSTANTIATE_VALIDATE(Type)                                         \
+  template int Parser::validate<Parser::V0, Parser::Type>(const char *,        \
+                                                          uint32_t);           \
+  template int Parser::validate<Parser::V1, Parser::Type>(const char *,        \
+                                                          uint32_t);
+ESS_DETECTOR_TYPES(ESS_INSTANTIATE_VALIDATE)
+
+bool Parser::setHeaderVersion(int Version, uint8_t Type) {
+  FastValidate = nullptr;
+  FastType = Reserved;
+  if (Version < 0) {
+    return false;
+  }
+  if (Version != V0 and Version != V1) {
+    LOG(INIT, Sev::Warning,
+        "Unknown header version {}, detecting the version per packet",
+        Version);
+    return false;
+  }
+
+#define ESS_SELECT_VALIDATE(DetType)                                           \
+  case DetType:                                                                \
+    FastValidate = (Version == V1) ? &Parser::validate<V1, DetType>            \
+                                   : &Parser::validate<V0, DetType>;           \
+    break;
+
+  switch (Type) {
+    ESS_DETECTOR_TYPES(ESS_SELECT_VALIDATE)
+  default:
+    LOG(INIT, Sev::Warning,
+        "No fast header validation for detector type {:#04x}, detecting the "
+        "version per packet",
+        Type);
+    return false;
+  }
+  FastType = Type;
+  return true;
+}
+
+void Parser::reorder(const char *Buffer, uint32_t Size, unsigned int Index,
+                     uint64_t Now) {
+  if (Buffer == nullptr or Size < sizeof(PacketHeaderV0) or
+      ((*(uint32_t *)(Buffer + 2)) & 0xffffff) != 0x535345) {
+    Reorder.pass(Index);
+    return;
+  }
+  auto Header = (PacketHeaderV0 *)Buffer;
+  Reorder.insert(Header->OutputQueue, Header->SeqNum, Index, Now);
+}
 } // namespace ESSReadout
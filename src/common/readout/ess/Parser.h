@@ -10,6 +10,7 @@
 #pragma once
 
 #include <cinttypes>
+#include <common/readout/ess/ReorderWindow.h>
 #include <common/time/ESSTime.h>
 #include <cstddef>
 #include <cstdint>
@@ -163,6 +164,33 @@ public:
   /// \return on success return 0, else < 0
   int validate(const char *Buffer, uint32_t Size, uint8_t Type);
 
+  /// \brief validate a readout buffer with header version and detector type
+  /// known at compile time. Pad, version, cookie and type are checked with
+  /// a single compare and the header fields are read directly. Packets not
+  /// matching Version and Type are passed on to the runtime checks, so
+  /// results and counters are the same as for validate(Buffer, Size, Type)
+  /// \return on success return 0, else < 0
+  template <HeaderVersion Version, DetectorType Type>
+  int validate(const char *Buffer, uint32_t Size);
+
+  /// \brief make validate(Buffer, Size, Type) use the fast path for
+  /// packets of the given detector type
+  /// \param[in] Version header version sent by the FENs, < 0 to detect the
+  /// version per packet
+  /// \param[in] Type detector type of the instrument
+  /// \return false if there is no fast path for Version and Type
+  bool setHeaderVersion(int Version, uint8_t Type);
+
+  /// \brief add a readout buffer to the reorder window, packets with an
+  /// unrecognised header are passed through for validate() to reject
+  /// \param[in] Buffer pointer to data
+  /// \param[in] Size length of buffer in bytes
+  /// \param[in] Index queue slot holding the buffer, returned by
+  /// Reorder.next() when the packet is due
+  /// \param[in] Now current time in the unit of the reorder timeout
+  void reorder(const char *Buffer, uint32_t Size, unsigned int Index,
+               uint64_t Now);
+
   // Counters(for Grafana)
   struct ESSHeaderStats Stats;
   // Maximum allowed separation between PulseTime and PrevPulseTime
@@ -170,5 +198,16 @@ public:
   /// 71428571 in ns, but for now we set max pt to 0 and require
   /// setting this in the config file.
   TimeDurationNano MaxPulseTimeDiffNS{0};
+
+  // Per OutputQueue reordering of packets before validate(), off by default
+  ReorderWindow Reorder;
+
+private:
+  /// \brief runtime version detecting checks
+  int validateAny(const char *Buffer, uint32_t Size, uint8_t Type);
+
+  // Selected by setHeaderVersion()
+  int (Parser::*FastValidate)(const char *, uint32_t){nullptr};
+  uint8_t FastType{Reserved};
 };
 } // namespace ESSReadout
@@ -162,6 +162,25 @@ TEST_F(ReadoutTest, SeqNumbers) {
   ASSERT_EQ(RdOut.Stats.ErrorSeqNum, 2);
 }
 
+TEST_F(ReadoutTest, ReorderSeqNumbers) {
+  RdOut.Reorder.configure(4, 1000);
+  RdOut.reorder((char *)&OkVersionV0[0], OkVersionV0.size(), 0, 0);
+  RdOut.reorder((char *)&ErrPad[0], ErrPad.size(), 1, 0);
+  // seq 8 expected, 9 is held
+  auto Later = OkVersionNextSeq;
+  Later[26] = 0x09;
+  RdOut.reorder((char *)&Later[0], Later.size(), 2, 0);
+  RdOut.reorder((char *)&OkVersionNextSeq[0], OkVersionNextSeq.size(), 3, 0);
+
+  std::vector<unsigned int> Released;
+  unsigned int Index;
+  while (RdOut.Reorder.next(Index)) {
+    Released.push_back(Index);
+  }
+  ASSERT_EQ(Released, std::vector<unsigned int>({0, 1, 3, 2}));
+  ASSERT_EQ(RdOut.Reorder.Stats.Reordered, 1);
+}
+
 TEST_F(ReadoutTest, BadReadoutTypev0) {
   auto Res = RdOut.validate((char *)&OkThreeLokiReadoutsV0[0],
                             OkThreeLokiReadoutsV0.size(), 0xff);
@@ -256,6 +275,49 @@ TEST_F(ReadoutTest, InvalidCookie) {
   ASSERT_EQ(RdOut.Stats.ErrorCookie, 1);
 }
 
+TEST_F(ReadoutTest, SetHeaderVersion) {
+  ASSERT_TRUE(RdOut.setHeaderVersion(Parser::V0, Parser::LOKI));
+  ASSERT_TRUE(RdOut.setHeaderVersion(Parser::V1, Parser::DREAM));
+  ASSERT_FALSE(RdOut.setHeaderVersion(-1, Parser::LOKI));
+  ASSERT_FALSE(RdOut.setHeaderVersion(2, Parser::LOKI));
+  ASSERT_FALSE(RdOut.setHeaderVersion(Parser::V0, 0x31));
+}
+
+// The fast path must give the same results and counters as the runtime
+// checks, for every packet and for truncated packets
+TEST_F(ReadoutTest, FastPathMatchesRuntime) {
+  std::vector<std::vector<uint8_t> *> Packets{
+      &ErrCookie, &ErrVersion, &ErrPad, &ErrMaxOutputQueue,
+      &OkVersionV0, &OkVersionV1, &OkVersionNextSeq,
+      &OkThreeLokiReadoutsV0, &OkThreeLokiReadoutsV1,
+      &ErrPulseTimeFracV0, &ErrPulseTimeFracV1,
+      &ErrPrevPulseTimeFracV0, &ErrPrevPulseTimeFracV1,
+      &ErrMaxPulseTimeV0, &ErrMaxPulseTimeV1};
+
+  for (int Version : {Parser::V0, Parser::V1}) {
+    Parser Fast;
+    Parser Runtime;
+    ASSERT_TRUE(Fast.setHeaderVersion(Version, DataType));
+    for (auto Packet : Packets) {
+      for (uint32_t Size = 0; Size <= Packet->size(); Size++) {
+        for (uint8_t Type : {(uint8_t)DataType, (uint8_t)Parser::DREAM}) {
+          auto Data = (char *)Packet->data();
+          ASSERT_EQ(Fast.validate(Data, Size, Type),
+                    Runtime.validate(Data, Size, Type));
+          ASSERT_EQ(memcmp(&Fast.Stats, &Runtime.Stats, sizeof(Fast.Stats)),
+                    0);
+          ASSERT_EQ(memcmp(Fast.NextSeqNum, Runtime.NextSeqNum,
+                           sizeof(Fast.NextSeqNum)),
+                    0);
+          ASSERT_EQ(Fast.Packet.DataPtr, Runtime.Packet.DataPtr);
+          ASSERT_EQ(Fast.Packet.DataLength, Runtime.Packet.DataLength);
+        }
+      }
+    }
+    ASSERT_GT(Fast.Stats.Version0Header + Fast.Stats.Version1Header, 0);
+  }
+}
+
 } // namespace ESSReadout
 
 int main(int argc, char **argv) {
@@ -0,0 +1,237 @@
+// Copyright (C) 2024 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Compile time description of ESS readout formats
+///
+/// A readout schema names the packed readout struct, the stats struct and
+/// the checks each readout must pass. Each check names the readout field,
+/// its valid range and the counter to increment when it fails. The parse
+/// functions below are generated from the schema, so the checks are
+/// inlined and unrolled with the limits as constants.
+///
+/// Schema members used by parseStream()
+///   Readout, Stats        - packed readout and counter structs
+///   Header                - Fields<> checked before DataHeaders is counted
+///   Body                  - Fields<> checked after DataLength is validated
+///   HeaderSizeErrors      - counter, less than a data header left
+///   BufferErrors          - counter, DataLength beyond the end of buffer
+///   DataHeaders           - counter, data headers passing Header
+///   DataLenErrors         - counter, DataLength != sizeof(Readout)
+///   Readouts              - counter, readouts passing all checks
+///
+/// parseFixed() uses Readout, Stats, Header, Body and Readouts.
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <common/readout/ess/Parser.h>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace ESSReadout {
+namespace Schema {
+
+/// \brief compare integers of different signedness (std::cmp_less in C++20)
+template <typename A, typename B> constexpr bool cmpLess(A a, B b) {
+  if constexpr (std::is_signed_v<A> == std::is_signed_v<B>) {
+    return a < b;
+  } else if constexpr (std::is_signed_v<A>) {
+    return a < 0 or std::make_unsigned_t<A>(a) < b;
+  } else {
+    return b >= 0 and a < std::make_unsigned_t<B>(b);
+  }
+}
+
+/// \brief reject the readout if Member is outside [Min, Max]
+template <auto Member, auto Min, auto Max, auto ErrorCounter> struct Range {
+  static constexpr auto Counter{ErrorCounter};
+
+  template <typename R, typename S>
+  static inline bool check(const R &Readout, S &Stats) {
+    using T = std::remove_cv_t<std::remove_reference_t<decltype(Readout.*
+                                                                Member)>>;
+    static_assert(not cmpLess(Max, Min), "empty range");
+    const T Value = Readout.*Member;
+    bool Valid{true};
+    // bounds covering the whole field type are not checked
+    if constexpr (cmpLess(std::numeric_limits<T>::min(), Min)) {
+      Valid = not cmpLess(Value, Min);
+    }
+    if constexpr (cmpLess(Max, std::numeric_limits<T>::max())) {
+      Valid = Valid and not cmpLess(Max, Value);
+    }
+    if (not Valid) {
+      (Stats.*Counter)++;
+    }
+    return Valid;
+  }
+
+  template <typename R> static void makeValid(R &Readout) {
+    Readout.*Member = Min;
+  }
+
+  /// \return false if the field type cannot hold an invalid value
+  template <typename R> static bool makeInvalid(R &Readout) {
+    using T = std::remove_cv_t<std::remove_reference_t<decltype(Readout.*
+                                                                Member)>>;
+    if constexpr (cmpLess(Max, std::numeric_limits<T>::max())) {
+      Readout.*Member = Max + 1;
+      return true;
+    } else if constexpr (cmpLess(std::numeric_limits<T>::min(), Min)) {
+      Readout.*Member = Min - 1;
+      return true;
+    }
+    return false;
+  }
+};
+
+/// \brief reject the readout if Member is not Value
+template <auto Member, auto Value, auto ErrorCounter>
+using Equal = Range<Member, Value, Value, ErrorCounter>;
+
+/// \brief reject the readout if Valid(Readout) is false
+template <auto Valid, auto ErrorCounter> struct Check {
+  static constexpr auto Counter{ErrorCounter};
+
+  template <typename R, typename S>
+  static inline bool check(const R &Readout, S &Stats) {
+    if (not Valid(Readout)) {
+      (Stats.*Counter)++;
+      return false;
+    }
+    return true;
+  }
+
+  template <typename R> static void makeValid(R &) {}
+  template <typename R> static bool makeInvalid(R &) { return false; }
+};
+
+/// \brief count the readout if Valid(Readout) is false, but keep it
+template <auto Valid, auto ErrorCounter> struct Warn {
+  static constexpr auto Counter{ErrorCounter};
+
+  template <typename R, typename S>
+  static inline bool check(const R &Readout, S &Stats) {
+    if (not Valid(Readout)) {
+      (Stats.*Counter)++;
+    }
+    return true;
+  }
+
+  template <typename R> static void makeValid(R &) {}
+  template <typename R> static bool makeInvalid(R &) { return false; }
+};
+
+/// \brief checks applied in order, stopping at the first failing one
+template <typename... Field> struct Fields {
+  static constexpr size_t Size{sizeof...(Field)};
+
+  template <typename R, typename S>
+  static inline bool check(const R &Readout, S &Stats) {
+    return (Field::check(Readout, Stats) and ...);
+  }
+
+  /// \brief set all range checked fields to valid values
+  template <typename R> static void makeValid(R &Readout) {
+    (Field::template makeValid<R>(Readout), ...);
+  }
+
+  /// \brief call Fn with a default constructed object of each field type,
+  /// used for generating tests from a schema
+  template <typename Fn> static void forEach(Fn &&Function) {
+    (Function(Field{}), ...);
+  }
+};
+
+/// \brief parse back to back readouts, each starting with an ESS data
+/// header, stopping at the first error
+/// \return number of valid readouts, these are contiguous from Buffer
+template <typename Schema>
+unsigned int parseStream(const char *Buffer, unsigned int Size,
+                         typename Schema::Stats &Stats) {
+  using Readout = typename Schema::Readout;
+  unsigned int ParsedReadouts{0};
+  unsigned int BytesLeft{Size};
+  const char *DataPtr{Buffer};
+
+  while (BytesLeft) {
+    if (BytesLeft < sizeof(Parser::DataHeader)) {
+      (Stats.*Schema::HeaderSizeErrors)++;
+      return ParsedReadouts;
+    }
+
+    auto Data = (const Readout *)DataPtr;
+
+    if (BytesLeft < Data->DataLength) {
+      (Stats.*Schema::BufferErrors)++;
+      return ParsedReadouts;
+    }
+
+    if (not Schema::Header::check(*Data, Stats)) {
+      return ParsedReadouts;
+    }
+    (Stats.*Schema::DataHeaders)++;
+
+    if (Data->DataLength != sizeof(Readout)) {
+      (Stats.*Schema::DataLenErrors)++;
+      return ParsedReadouts;
+    }
+
+    if (not Schema::Body::check(*Data, Stats)) {
+      return ParsedReadouts;
+    }
+
+    ParsedReadouts++;
+    (Stats.*Schema::Readouts)++;
+    BytesLeft -= sizeof(Readout);
+    DataPtr += sizeof(Readout);
+  }
+  return ParsedReadouts;
+}
+
+/// \brief check Count readouts of fixed size starting at Buffer, skipping
+/// the invalid ones and calling Accept for each valid one
+template <typename Schema, typename AcceptFn>
+void parseFixed(const char *Buffer, unsigned int Count,
+                typename Schema::Stats &Stats, AcceptFn &&Accept) {
+  using Readout = typename Schema::Readout;
+  auto Readouts = (const Readout *)Buffer;
+
+  for (unsigned int i = 0; i < Count; i++) {
+    (Stats.*Schema::Readouts)++;
+    const Readout &Data = Readouts[i];
+    if (Schema::Header::check(Data, Stats) and
+        Schema::Body::check(Data, Stats)) {
+      Accept(Data);
+    }
+  }
+}
+
+/// \brief readout passing all range checks of Schema, for tests
+template <typename Schema> typename Schema::Readout validReadout() {
+  typename Schema::Readout Readout{};
+  Readout.DataLength = sizeof(Readout);
+  Schema::Header::makeValid(Readout);
+  Schema::Body::makeValid(Readout);
+  return Readout;
+}
+
+/// \brief for each field of FieldList that can hold an invalid value, call
+/// Fn(Readout, Counter) with a copy of Valid failing on that field only
+template <typename FieldList, typename R, typename Fn>
+void forEachInvalid(const R &Valid, Fn &&Function) {
+  FieldList::forEach([&](auto Field) {
+    using F = decltype(Field);
+    R Readout = Valid;
+    if (F::makeInvalid(Readout)) {
+      Function(Readout, F::Counter);
+    }
+  });
+}
+
+} // namespace Schema
+} // namespace ESSReadout
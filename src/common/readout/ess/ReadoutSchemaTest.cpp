@@ -0,0 +1,184 @@
+// Copyright (C) 2024 European Spallation Source ERIC
+
+#include <common/readout/ess/ReadoutSchema.h>
+#include <common/testutils/ReadoutSchemaUtil.h>
+#include <common/testutils/TestBase.h>
+#include <vector>
+
+using namespace ESSReadout::Schema;
+
+struct TestReadout {
+  uint8_t FiberId;
+  uint8_t FENId;
+  uint16_t DataLength;
+  uint32_t TimeHigh;
+  uint32_t TimeLow;
+  int16_t Amplitude;
+  uint8_t Type;
+  uint8_t Anything;
+} __attribute__((__packed__));
+
+struct TestStats {
+  int64_t HeaderSizeErrors{0};
+  int64_t BufferErrors{0};
+  int64_t DataHeaders{0};
+  int64_t DataLenErrors{0};
+  int64_t Readouts{0};
+  int64_t FiberErrors{0};
+  int64_t FENErrors{0};
+  int64_t AmplitudeErrors{0};
+  int64_t TypeErrors{0};
+  int64_t TypeWarnings{0};
+  int64_t AnythingErrors{0};
+};
+
+bool typeIsSet(const TestReadout &Readout) { return Readout.Type != 0; }
+bool typeIsNotThree(const TestReadout &Readout) { return Readout.Type != 3; }
+
+struct TestSchema {
+  using Readout = TestReadout;
+  using Stats = TestStats;
+
+  using Header =
+      Fields<Range<&Readout::FiberId, 0, 23, &Stats::FiberErrors>,
+             Range<&Readout::FENId, 0, 12, &Stats::FENErrors>>;
+  using Body =
+      Fields<Range<&Readout::Amplitude, -100, 100, &Stats::AmplitudeErrors>,
+             Check<&typeIsSet, &Stats::TypeErrors>,
+             Warn<&typeIsNotThree, &Stats::TypeWarnings>,
+             Range<&Readout::Anything, 0, 255, &Stats::AnythingErrors>>;
+
+  static constexpr auto HeaderSizeErrors{&Stats::HeaderSizeErrors};
+  static constexpr auto BufferErrors{&Stats::BufferErrors};
+  static constexpr auto DataHeaders{&Stats::DataHeaders};
+  static constexpr auto DataLenErrors{&Stats::DataLenErrors};
+  static constexpr auto Readouts{&Stats::Readouts};
+};
+
+class ReadoutSchemaTest : public TestBase {
+protected:
+  TestStats Stats;
+  TestReadout Good;
+  std::vector<TestReadout> Readouts;
+
+  void SetUp() override {
+    Good = validReadout<TestSchema>();
+    Good.Type = 1;
+    Readouts.assign(4, Good);
+  }
+  void TearDown() override {}
+
+  unsigned int parse(unsigned int Size) {
+    return parseStream<TestSchema>((const char *)Readouts.data(), Size, Stats);
+  }
+};
+
+TEST_F(ReadoutSchemaTest, CompareMixedSigns) {
+  ASSERT_TRUE(cmpLess(-1, 0u));
+  ASSERT_FALSE(cmpLess(0u, -1));
+  ASSERT_TRUE(cmpLess(1u, 2));
+  ASSERT_FALSE(cmpLess(2, 2u));
+}
+
+TEST_F(ReadoutSchemaTest, ValidReadout) {
+  ASSERT_EQ(Good.DataLength, sizeof(TestReadout));
+  ASSERT_EQ(Good.Amplitude, -100);
+  ASSERT_TRUE(TestSchema::Header::check(Good, Stats));
+  ASSERT_TRUE(TestSchema::Body::check(Good, Stats));
+}
+
+TEST_F(ReadoutSchemaTest, SignedRange) {
+  using Amplitude =
+      Range<&TestReadout::Amplitude, -100, 100, &TestStats::AmplitudeErrors>;
+  for (int16_t Value : {-101, -100, 0, 100, 101}) {
+    Good.Amplitude = Value;
+    ASSERT_EQ(Amplitude::check(Good, Stats), Value >= -100 and Value <= 100);
+  }
+  ASSERT_EQ(Stats.AmplitudeErrors, 2);
+}
+
+TEST_F(ReadoutSchemaTest, FullWidthRangeNeverFails) {
+  using Anything =
+      Range<&TestReadout::Anything, 0, 255, &TestStats::AnythingErrors>;
+  ASSERT_FALSE(Anything::makeInvalid(Good));
+  for (unsigned int Value = 0; Value < 256; Value++) {
+    Good.Anything = Value;
+    ASSERT_TRUE(Anything::check(Good, Stats));
+  }
+  ASSERT_EQ(Stats.AnythingErrors, 0);
+}
+
+TEST_F(ReadoutSchemaTest, CheckAndWarn) {
+  Good.Type = 0;
+  ASSERT_FALSE(TestSchema::Body::check(Good, Stats));
+  ASSERT_EQ(Stats.TypeErrors, 1);
+  Good.Type = 3;
+  ASSERT_TRUE(TestSchema::Body::check(Good, Stats));
+  ASSERT_EQ(Stats.TypeWarnings, 1);
+}
+
+TEST_F(ReadoutSchemaTest, ParseStreamAll) {
+  ASSERT_EQ(parse(4 * sizeof(TestReadout)), 4);
+  ASSERT_EQ(Stats.DataHeaders, 4);
+  ASSERT_EQ(Stats.Readouts, 4);
+}
+
+TEST_F(ReadoutSchemaTest, ParseStreamStopsAtFirstError) {
+  Readouts[2].FENId = 13;
+  ASSERT_EQ(parse(4 * sizeof(TestReadout)), 2);
+  ASSERT_EQ(Stats.FENErrors, 1);
+  ASSERT_EQ(Stats.DataHeaders, 2);
+
+  Readouts[2] = Good;
+  Readouts[1].Type = 0;
+  ASSERT_EQ(parse(4 * sizeof(TestReadout)), 1);
+  ASSERT_EQ(Stats.TypeErrors, 1);
+  ASSERT_EQ(Stats.DataHeaders, 4);
+  ASSERT_EQ(Stats.Readouts, 3);
+}
+
+TEST_F(ReadoutSchemaTest, ParseStreamSizeErrors) {
+  ASSERT_EQ(parse(sizeof(TestReadout) + 3), 1);
+  ASSERT_EQ(Stats.HeaderSizeErrors, 1);
+
+  ASSERT_EQ(parse(sizeof(TestReadout) + 8), 1);
+  ASSERT_EQ(Stats.BufferErrors, 1);
+
+  Readouts[0].DataLength = 8;
+  ASSERT_EQ(parse(4 * sizeof(TestReadout)), 0);
+  ASSERT_EQ(Stats.DataLenErrors, 1);
+  ASSERT_EQ(Stats.DataHeaders, 3);
+}
+
+TEST_F(ReadoutSchemaTest, ParseFixedSkipsInvalid) {
+  Readouts[0].FiberId = 24;
+  Readouts[2].Amplitude = 101;
+  Readouts[3].Type = 3;
+  std::vector<const TestReadout *> Accepted;
+  parseFixed<TestSchema>((const char *)Readouts.data(), 4, Stats,
+                         [&](const TestReadout &Readout) {
+                           Accepted.push_back(&Readout);
+                         });
+  ASSERT_EQ(Accepted.size(), 2);
+  ASSERT_EQ(Accepted[0], &Readouts[1]);
+  ASSERT_EQ(Accepted[1], &Readouts[3]);
+  ASSERT_EQ(Stats.Readouts, 4);
+  ASSERT_EQ(Stats.FiberErrors, 1);
+  ASSERT_EQ(Stats.AmplitudeErrors, 1);
+  ASSERT_EQ(Stats.TypeWarnings, 1);
+}
+
+TEST_F(ReadoutSchemaTest, GeneratedFieldErrors) {
+  checkFieldErrors<TestSchema>(
+      Good, Stats,
+      [&](const TestReadout &Readout) {
+        return parseStream<TestSchema>((const char *)&Readout, sizeof(Readout),
+                                       Stats);
+      },
+      3);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,158 @@
+// Copyright (C) 2024 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Per OutputQueue reorder window implementation
+///
+//===----------------------------------------------------------------------===//
+
+#include <common/debug/Trace.h>
+#include <common/readout/ess/ReorderWindow.h>
+
+// #undef TRC_LEVEL
+// #define TRC_LEVEL TRC_L_DEB
+
+namespace ESSReadout {
+
+ReorderWindow::ReorderWindow() { Ready.reserve(MaxQueues * MaxDepth + 1); }
+
+void ReorderWindow::configure(unsigned int NewDepth, uint64_t NewTimeout) {
+  flush();
+  Depth = (NewDepth > MaxDepth) ? MaxDepth : NewDepth;
+  Slots = 1;
+  while (Slots < Depth) {
+    Slots *= 2;
+  }
+  Timeout = NewTimeout;
+  for (auto &Q : Queues) {
+    Q.Synced = false;
+  }
+}
+
+void ReorderWindow::insert(uint8_t OutputQueue, uint32_t SeqNum,
+                           unsigned int Index, uint64_t Now) {
+  if (Depth == 0 or OutputQueue >= MaxQueues) {
+    pass(Index);
+    return;
+  }
+
+  Queue &Q = Queues[OutputQueue];
+  if (not Q.Synced) {
+    Q.Expected = SeqNum;
+    Q.Synced = true;
+  }
+
+  int32_t Ahead = (int32_t)(SeqNum - Q.Expected);
+  if (Ahead == 0) {
+    if (Q.Held != 0) {
+      XTRACE(PROCESS, DEB, "OQ %u seqnum %u fills gap", OutputQueue, SeqNum);
+      Stats.Reordered++;
+    }
+    pass(Index);
+    Q.Expected++;
+    drain(Q);
+    return;
+  }
+
+  if (Ahead < 0) { // late or duplicate, validate() counts the error
+    pass(Index);
+    return;
+  }
+
+  if (Ahead >= (int32_t)Depth) {
+    XTRACE(PROCESS, DEB, "OQ %u seqnum %u beyond window (expected %u)",
+           OutputQueue, SeqNum, Q.Expected);
+    while (Q.Held != 0) {
+      Stats.Timeouts += skipGap(Q);
+    }
+    pass(Index);
+    Q.Expected = SeqNum + 1;
+    return;
+  }
+
+  Entry &E = entry(Q, SeqNum);
+  if (E.Valid) { // duplicate of a held packet
+    pass(Index);
+    return;
+  }
+  E.Index = Index;
+  E.Time = Now;
+  E.Valid = true;
+  Q.Held++;
+  TotalHeld++;
+  if ((int64_t)Q.Held > Stats.MaxDepth) {
+    Stats.MaxDepth = Q.Held;
+  }
+}
+
+void ReorderWindow::expire(uint64_t Now) {
+  if (TotalHeld == 0) {
+    return;
+  }
+  for (auto &Q : Queues) {
+    while (Q.Held != 0) {
+      uint64_t Oldest{Now};
+      for (unsigned int i = 0; i < Slots; i++) {
+        if (Q.Entries[i].Valid and Q.Entries[i].Time < Oldest) {
+          Oldest = Q.Entries[i].Time;
+        }
+      }
+      if (Now - Oldest < Timeout) {
+        break;
+      }
+      Stats.Timeouts += skipGap(Q);
+    }
+  }
+}
+
+void ReorderWindow::flush() {
+  for (auto &Q : Queues) {
+    while (Q.Held != 0) {
+      skipGap(Q);
+    }
+  }
+}
+
+bool ReorderWindow::next(unsigned int &Index) {
+  if (ReadyPos == Ready.size()) {
+    if (ReadyPos != 0) {
+      Ready.clear();
+      ReadyPos = 0;
+    }
+    return false;
+  }
+  Index = Ready[ReadyPos++];
+  return true;
+}
+
+unsigned int ReorderWindow::drain(Queue &Q) {
+  unsigned int Released{0};
+  while (Q.Held != 0) {
+    Entry &E = entry(Q, Q.Expected);
+    if (not E.Valid) {
+      break;
+    }
+    pass(E.Index);
+    E.Valid = false;
+    Q.Held--;
+    TotalHeld--;
+    Q.Expected++;
+    Released++;
+  }
+  return Released;
+}
+
+unsigned int ReorderWindow::skipGap(Queue &Q) {
+  for (unsigned int i = 0; i < Depth; i++) {
+    if (entry(Q, Q.Expected + i).Valid) {
+      XTRACE(PROCESS, DEB, "Skipping seqnum %u to %u", Q.Expected,
+             Q.Expected + i);
+      Q.Expected += i;
+      break;
+    }
+  }
+  return drain(Q);
+}
+
+} // namespace ESSReadout
@@ -0,0 +1,112 @@
+// Copyright (C) 2024 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Per OutputQueue reorder window for ESS readout packets
+///
+/// Packets are inserted with their OutputQueue, sequence number and the
+/// index of the queue slot holding them, and are returned by next() in
+/// sequence number order. A packet arriving ahead of a gap is held until
+/// the gap is filled, until it has been held for longer than the timeout,
+/// or until the gap is wider than the window depth. Late and duplicate
+/// packets, and packets the caller could not classify (pass()), are
+/// returned immediately.
+///
+/// Times are supplied by the caller, in any monotonic unit matching the
+/// timeout (normally TSC ticks).
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ESSReadout {
+
+struct ReorderStats {
+  int64_t Reordered{0}; // late packets put back in sequence order
+  int64_t Timeouts{0};  // held packets released with the gap unfilled
+  int64_t MaxDepth{0};  // max packets held for one OutputQueue
+};
+
+class ReorderWindow {
+public:
+  static constexpr unsigned int MaxQueues{12};
+  static constexpr unsigned int MaxDepth{64};
+  static_assert((MaxDepth & (MaxDepth - 1)) == 0, "MaxDepth must be 2^n");
+
+  ReorderWindow();
+
+  /// \brief set window depth (packets held per OutputQueue, 0 disables
+  /// reordering) and the max time a packet is held. Packets currently held
+  /// are released first.
+  void configure(unsigned int Depth, uint64_t Timeout);
+
+  /// \brief true if packets are being reordered
+  bool enabled() const { return Depth != 0; }
+
+  /// \brief add packet in slot Index with sequence number SeqNum from
+  /// OutputQueue received at time Now
+  void insert(uint8_t OutputQueue, uint32_t SeqNum, unsigned int Index,
+              uint64_t Now);
+
+  /// \brief add packet in slot Index for immediate release
+  void pass(unsigned int Index) { Ready.push_back(Index); }
+
+  /// \brief release packets held for longer than the timeout at time Now,
+  /// skipping the gaps in front of them
+  void expire(uint64_t Now);
+
+  /// \brief release all held packets in sequence order
+  void flush();
+
+  /// \brief get the next released packet
+  /// \return false if there is none
+  bool next(unsigned int &Index);
+
+  /// \brief number of packets held waiting for a gap to be filled
+  unsigned int held() const { return TotalHeld; }
+
+  struct ReorderStats Stats;
+
+private:
+  struct Entry {
+    unsigned int Index{0};
+    uint64_t Time{0};
+    bool Valid{false};
+  };
+
+  struct Queue {
+    uint32_t Expected{0}; // next sequence number to release
+    bool Synced{false};   // Expected is set from the first packet
+    unsigned int Held{0};
+    Entry Entries[MaxDepth];
+  };
+
+  /// \brief release held packets from Expected on until the next gap
+  /// \return number of packets released
+  unsigned int drain(Queue &Q);
+
+  /// \brief move Expected to the first held packet and release from there
+  /// \return number of packets released
+  unsigned int skipGap(Queue &Q);
+
+  /// Slots are indexed by the low bits of SeqNum. Slots is a power of two,
+  /// so a window of Depth sequence numbers never shares a slot, also when
+  /// SeqNum wraps around
+  Entry &entry(Queue &Q, uint32_t SeqNum) {
+    return Q.Entries[SeqNum & (Slots - 1)];
+  }
+
+  unsigned int Depth{0};
+  unsigned int Slots{1}; // Depth rounded up to a power of two
+  uint64_t Timeout{0};
+  unsigned int TotalHeld{0};
+  Queue Queues[MaxQueues];
+  std::vector<unsigned int> Ready;
+  size_t ReadyPos{0};
+};
+
+} // namespace ESSReadout
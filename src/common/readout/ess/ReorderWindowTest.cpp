@@ -0,0 +1,140 @@
+// Copyright (C) 2024 European Spallation Source ERIC
+
+#include <common/readout/ess/ReorderWindow.h>
+#include <common/testutils/TestBase.h>
+#include <vector>
+
+namespace ESSReadout {
+
+class ReorderWindowTest : public TestBase {
+protected:
+  ReorderWindow Window;
+  void SetUp() override { Window.configure(4, 100); }
+  void TearDown() override {}
+
+  std::vector<unsigned int> released() {
+    std::vector<unsigned int> Indices;
+    unsigned int Index;
+    while (Window.next(Index)) {
+      Indices.push_back(Index);
+    }
+    return Indices;
+  }
+};
+
+TEST_F(ReorderWindowTest, DisabledPassesThrough) {
+  Window.configure(0, 100);
+  ASSERT_FALSE(Window.enabled());
+  Window.insert(0, 5, 1, 0);
+  Window.insert(0, 3, 2, 0);
+  ASSERT_EQ(released(), std::vector<unsigned int>({1, 2}));
+  ASSERT_EQ(Window.held(), 0);
+}
+
+TEST_F(ReorderWindowTest, InOrder) {
+  ASSERT_TRUE(Window.enabled());
+  for (unsigned int i = 0; i < 10; i++) {
+    Window.insert(3, 100 + i, i, 0);
+  }
+  ASSERT_EQ(released().size(), 10);
+  ASSERT_EQ(Window.Stats.Reordered, 0);
+  ASSERT_EQ(Window.Stats.MaxDepth, 0);
+}
+
+TEST_F(ReorderWindowTest, SwappedPair) {
+  Window.insert(0, 10, 0, 0);
+  Window.insert(0, 12, 1, 0);
+  Window.insert(0, 13, 2, 0);
+  ASSERT_EQ(released(), std::vector<unsigned int>({0}));
+  ASSERT_EQ(Window.held(), 2);
+
+  Window.insert(0, 11, 3, 0);
+  ASSERT_EQ(released(), std::vector<unsigned int>({3, 1, 2}));
+  ASSERT_EQ(Window.held(), 0);
+  ASSERT_EQ(Window.Stats.Reordered, 1);
+  ASSERT_EQ(Window.Stats.MaxDepth, 2);
+  ASSERT_EQ(Window.Stats.Timeouts, 0);
+}
+
+TEST_F(ReorderWindowTest, OutputQueuesIndependent) {
+  Window.insert(0, 10, 0, 0);
+  Window.insert(1, 50, 1, 0);
+  Window.insert(0, 12, 2, 0);
+  Window.insert(1, 51, 3, 0);
+  ASSERT_EQ(released(), std::vector<unsigned int>({0, 1, 3}));
+  Window.insert(0, 11, 4, 0);
+  ASSERT_EQ(released(), std::vector<unsigned int>({4, 2}));
+}
+
+TEST_F(ReorderWindowTest, Timeout) {
+  Window.insert(0, 10, 0, 0);
+  Window.insert(0, 12, 1, 10);
+  Window.insert(0, 14, 2, 50);
+  released();
+
+  Window.expire(109);
+  ASSERT_EQ(released().size(), 0);
+  Window.expire(110);
+  ASSERT_EQ(released(), std::vector<unsigned int>({1}));
+  ASSERT_EQ(Window.held(), 1);
+  Window.expire(150);
+  ASSERT_EQ(released(), std::vector<unsigned int>({2}));
+  ASSERT_EQ(Window.Stats.Timeouts, 2);
+
+  // late packet for a skipped gap is passed straight through
+  Window.insert(0, 11, 3, 200);
+  Window.insert(0, 15, 4, 200);
+  ASSERT_EQ(released(), std::vector<unsigned int>({3, 4}));
+}
+
+TEST_F(ReorderWindowTest, BeyondWindow) {
+  Window.insert(0, 10, 0, 0);
+  Window.insert(0, 12, 1, 0);
+  Window.insert(0, 13, 2, 0);
+  Window.insert(0, 15, 3, 0); // 4 ahead of 11, outside depth 4
+  ASSERT_EQ(released(), std::vector<unsigned int>({0, 1, 2, 3}));
+  ASSERT_EQ(Window.Stats.Timeouts, 2);
+  Window.insert(0, 16, 4, 0);
+  ASSERT_EQ(released(), std::vector<unsigned int>({4}));
+}
+
+TEST_F(ReorderWindowTest, DuplicatesAndFlush) {
+  Window.insert(0, 10, 0, 0);
+  Window.insert(0, 12, 1, 0);
+  Window.insert(0, 12, 2, 0);
+  Window.insert(0, 9, 3, 0);
+  ASSERT_EQ(released(), std::vector<unsigned int>({0, 2, 3}));
+  Window.flush();
+  ASSERT_EQ(released(), std::vector<unsigned int>({1}));
+  ASSERT_EQ(Window.held(), 0);
+}
+
+TEST_F(ReorderWindowTest, SeqNumWrap) {
+  Window.insert(2, 0xfffffffe, 0, 0);
+  Window.insert(2, 0x00000000, 1, 0);
+  Window.insert(2, 0xffffffff, 2, 0);
+  ASSERT_EQ(released(), std::vector<unsigned int>({0, 2, 1}));
+  ASSERT_EQ(Window.Stats.Reordered, 1);
+}
+
+TEST_F(ReorderWindowTest, SeqNumWrapDepthNotPowerOfTwo) {
+  // 0xffffffff and 0 are in the same slot for SeqNum % 3
+  Window.configure(3, 100);
+  Window.insert(1, 0xfffffffd, 0, 0);
+  Window.insert(1, 0xffffffff, 1, 0);
+  Window.insert(1, 0x00000000, 2, 0);
+  ASSERT_EQ(released(), std::vector<unsigned int>({0}));
+  ASSERT_EQ(Window.held(), 2);
+
+  Window.insert(1, 0xfffffffe, 3, 0);
+  ASSERT_EQ(released(), std::vector<unsigned int>({3, 1, 2}));
+  ASSERT_EQ(Window.held(), 0);
+  ASSERT_EQ(Window.Stats.Timeouts, 0);
+}
+
+} // namespace ESSReadout
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
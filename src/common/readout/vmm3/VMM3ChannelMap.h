@@ -0,0 +1,101 @@
+// Copyright (C) 2024 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Precomputed channel mapping for VMM3 based instruments
+///
+/// Built once from the instrument configuration, the map holds for every
+/// (Ring, FEN, VMM, Channel) the coordinate, plane, event builder and
+/// minimum ADC of its readouts. Processing a readout then takes a single
+/// lookup instead of hybrid lookups and geometry calls.
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cinttypes>
+#include <common/readout/vmm3/Hybrid.h>
+#include <common/readout/vmm3/VMM3Config.h>
+#include <vector>
+
+namespace ESSReadout {
+
+class VMM3ChannelMap {
+public:
+  /// \brief result of mapping a channel
+  enum Status : uint8_t { Unconfigured, InvalidCoord, Valid };
+
+  /// \brief everything needed to add a readout of the channel to an event
+  /// builder, packed so that eight channels share a cache line
+  struct Entry {
+    uint16_t Coord{0};
+    uint16_t MinADC{0};
+    uint16_t Builder{0};
+    uint8_t Plane{0};
+    Status State{Unconfigured};
+  };
+  static_assert(sizeof(Entry) == 8, "VMM3ChannelMap entry size error");
+
+  static constexpr int NumVMMs{2 * (VMM3Config::MaxHybrid + 1)};
+  static constexpr int NumChannels{64};
+
+  VMM3ChannelMap() : Entries(Size) {}
+
+  /// \brief fill in the channels of all configured hybrids, other channels
+  /// are Unconfigured
+  /// \param Mapping called as Mapping(Ring, FEN, HybridId, Asic, Channel,
+  /// Hybrid) for each channel, returning its Entry
+  template <typename MappingFn>
+  void build(VMM3Config &Conf, MappingFn &&Mapping) {
+    std::fill(Entries.begin(), Entries.end(), Entry{});
+    for (uint8_t Ring = 0; Ring <= VMM3Config::MaxRing; Ring++) {
+      for (uint8_t FEN = 0; FEN <= VMM3Config::MaxFEN; FEN++) {
+        for (uint8_t HybridId = 0; HybridId <= VMM3Config::MaxHybrid;
+             HybridId++) {
+          Hybrid &Hybrid = Conf.getHybrid(Ring, FEN, HybridId);
+          if (not Hybrid.Initialised) {
+            continue;
+          }
+          for (uint8_t Asic = 0; Asic < 2; Asic++) {
+            for (uint8_t Channel = 0; Channel < NumChannels; Channel++) {
+              Entries[index(Ring, FEN, 2 * HybridId + Asic, Channel)] =
+                  Mapping(Ring, FEN, HybridId, Asic, Channel, Hybrid);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /// \brief mapping of a readout channel, Unconfigured for channels outside
+  /// of the configurable range
+  const Entry &lookup(uint8_t Ring, uint8_t FEN, uint8_t VMM,
+                      uint8_t Channel) const {
+    if ((Ring > VMM3Config::MaxRing) or (FEN > VMM3Config::MaxFEN) or
+        (VMM >= NumVMMs) or (Channel >= NumChannels)) {
+      return Unmapped;
+    }
+    return Entries[index(Ring, FEN, VMM, Channel)];
+  }
+
+  /// \brief memory used by the map in bytes
+  size_t getMemoryBytes() const { return Entries.size() * sizeof(Entry); }
+
+private:
+  static constexpr size_t Size{(VMM3Config::MaxRing + 1) *
+                               (VMM3Config::MaxFEN + 1) * NumVMMs *
+                               NumChannels};
+
+  static size_t index(uint8_t Ring, uint8_t FEN, uint8_t VMM,
+                      uint8_t Channel) {
+    return ((Ring * (VMM3Config::MaxFEN + 1) + FEN) * NumVMMs + VMM) *
+               NumChannels +
+           Channel;
+  }
+
+  std::vector<Entry> Entries;
+  const Entry Unmapped{};
+};
+
+} // namespace ESSReadout
@@ -8,10 +8,16 @@
 /// Stat counters accumulate
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <common/debug/Trace.h>
 #include <common/memory/span.hpp>
 #include <common/readout/vmm3/VMM3Parser.h>
 
+#if defined(__x86_64__) and (defined(__GNUC__) or defined(__clang__))
+#define VMM3PARSER_AVX2
+#include <immintrin.h>
+#endif
+
 namespace ESSReadout {
 
   using namespace esstime;
@@ -19,6 +25,175 @@ namespace ESSReadout {
 // #undef TRC_LEVEL
 // #define TRC_LEVEL TRC_L_DEB
 
+namespace {
+/// Limits of the checks in VMM3Parser::checkBlock()
+struct CheckLimits {
+  uint32_t Fiber;
+  uint32_t FEN;
+  uint32_t DataLength;
+  uint32_t BC;
+  uint32_t ADC; // 0x7fff for monitors, which have no ADC check
+  uint32_t VMM;
+  uint32_t Channel;
+};
+
+/// \brief one byte per bit of Bits, 1 if the bit is set
+uint64_t spreadBits(uint8_t Bits) {
+  uint64_t Bytes = (Bits * 0x0101010101010101ULL) & 0x8040201008040201ULL;
+  return ((Bytes + 0x7f7f7f7f7f7f7f7fULL) >> 7) & 0x0101010101010101ULL;
+}
+
+/// \brief number of bits set, without the libgcc call that popcount becomes
+/// when building without -mpopcnt
+int countBits(uint8_t Bits) {
+  return (spreadBits(Bits) * 0x0101010101010101ULL) >> 56;
+}
+
+#ifdef VMM3PARSER_AVX2
+/// Lane indices moving the lanes of each 8 bit mask to the front, one byte
+/// per lane
+struct CompactTable {
+  uint64_t Lanes[256]{};
+  constexpr CompactTable() {
+    for (unsigned int Mask = 0; Mask < 256; Mask++) {
+      unsigned int Pos{0};
+      for (unsigned int Lane = 0; Lane < 8; Lane++) {
+        if (Mask & (1 << Lane)) {
+          Lanes[Mask] |= (uint64_t)Lane << (8 * Pos++);
+        }
+      }
+    }
+  }
+};
+constexpr CompactTable Compact;
+
+/// \brief check all full blocks of eight readouts, as in
+/// VMM3Parser::parseBlocks(). Fields of the 20 byte readouts are loaded as
+/// 32 bit words with gathers, readouts passing the pre TOF checks are
+/// compacted with a lane permutation.
+/// \return number of Candidates, TimeHigh and TimeLow written
+__attribute__((target("avx2,popcnt"))) unsigned int
+checkBlocksAVX2(const VMM3Parser::VMM3Data *Data, unsigned int Blocks,
+                const CheckLimits &Limits, VMM3ParserStats &Stats,
+                uint32_t *Candidates, uint32_t *TimeHigh, uint32_t *TimeLow) {
+  const __m256i Index = _mm256_setr_epi32(0, 5, 10, 15, 20, 25, 30, 35);
+  const __m256i LaneIndex =
+      _mm256_setr_epi32(0, 1 << 8, 2 << 8, 3 << 8, 4 << 8, 5 << 8, 6 << 8,
+                        7 << 8);
+  const __m256i Ones = _mm256_set1_epi32(-1);
+  const __m256i Byte = _mm256_set1_epi32(0xff);
+  const __m256i Word = _mm256_set1_epi32(0xffff);
+  const __m256i Zero = _mm256_setzero_si256();
+  const __m256i MaxFiber = _mm256_set1_epi32(Limits.Fiber);
+  const __m256i MaxFEN = _mm256_set1_epi32(Limits.FEN);
+  const __m256i DataLength = _mm256_set1_epi32(Limits.DataLength);
+  const __m256i MaxTimeLow = _mm256_set1_epi32(MaxFracTimeCount);
+  const __m256i MaxBC = _mm256_set1_epi32(Limits.BC);
+  const __m256i MaxADC = _mm256_set1_epi32(Limits.ADC);
+  const __m256i ADCMask = _mm256_set1_epi32(0x7fff);
+  const __m256i OverThreshold = _mm256_set1_epi32(0x8000);
+  const __m256i Calib = _mm256_set1_epi32(0x80);
+  const __m256i MaxVMM = _mm256_set1_epi32(Limits.VMM);
+  const __m256i MaxChannel = _mm256_set1_epi32(Limits.Channel);
+  int64_t ErrorFiber{0}, ErrorFEN{0}, ErrorDataLength{0}, ErrorTimeFrac{0};
+  unsigned int Count{0};
+
+  for (unsigned int Block = 0; Block < Blocks; Block++) {
+    const int *Words = (const int *)(Data + 8 * Block);
+    // FiberId, FENId, DataLength
+    __m256i W0 = _mm256_i32gather_epi32(Words, Index, 4);
+    __m256i High = _mm256_i32gather_epi32(Words + 1, Index, 4);
+    __m256i Low = _mm256_i32gather_epi32(Words + 2, Index, 4);
+    // BC, OTADC
+    __m256i W3 = _mm256_i32gather_epi32(Words + 3, Index, 4);
+    // GEO, TDC, VMM, Channel
+    __m256i W4 = _mm256_i32gather_epi32(Words + 4, Index, 4);
+
+    // Checks before TOF, each readout fails its first failing check only
+    __m256i Fiber = _mm256_cmpgt_epi32(_mm256_and_si256(W0, Byte), MaxFiber);
+    __m256i FEN = _mm256_cmpgt_epi32(
+        _mm256_and_si256(_mm256_srli_epi32(W0, 8), Byte), MaxFEN);
+    __m256i Length = _mm256_xor_si256(
+        _mm256_cmpeq_epi32(_mm256_srli_epi32(W0, 16), DataLength), Ones);
+    __m256i Time = _mm256_xor_si256(
+        _mm256_cmpeq_epi32(_mm256_max_epu32(Low, MaxTimeLow), MaxTimeLow),
+        Ones);
+    __m256i Failed = Fiber;
+    FEN = _mm256_andnot_si256(Failed, FEN);
+    Failed = _mm256_or_si256(Failed, FEN);
+    Length = _mm256_andnot_si256(Failed, Length);
+    Failed = _mm256_or_si256(Failed, Length);
+    Time = _mm256_andnot_si256(Failed, Time);
+    Failed = _mm256_or_si256(Failed, Time);
+    ErrorFiber += _mm_popcnt_u32(_mm256_movemask_ps(_mm256_castsi256_ps(Fiber)));
+    ErrorFEN += _mm_popcnt_u32(_mm256_movemask_ps(_mm256_castsi256_ps(FEN)));
+    ErrorDataLength +=
+        _mm_popcnt_u32(_mm256_movemask_ps(_mm256_castsi256_ps(Length)));
+    ErrorTimeFrac +=
+        _mm_popcnt_u32(_mm256_movemask_ps(_mm256_castsi256_ps(Time)));
+    int Pending = _mm256_movemask_ps(_mm256_castsi256_ps(Failed)) ^ 0xff;
+
+    // Checks after TOF, the first failing one goes into the Candidate
+    __m256i BC = _mm256_cmpgt_epi32(_mm256_and_si256(W3, Word), MaxBC);
+    __m256i OTADC = _mm256_srli_epi32(W3, 16);
+    __m256i ADC = _mm256_cmpgt_epi32(_mm256_and_si256(OTADC, ADCMask), MaxADC);
+    __m256i VMM = _mm256_cmpgt_epi32(
+        _mm256_and_si256(_mm256_srli_epi32(W4, 16), Byte), MaxVMM);
+    __m256i Channel = _mm256_cmpgt_epi32(_mm256_srli_epi32(W4, 24), MaxChannel);
+    __m256i NotOT =
+        _mm256_cmpeq_epi32(_mm256_and_si256(OTADC, OverThreshold), Zero);
+    __m256i NotCalib = _mm256_cmpeq_epi32(_mm256_and_si256(W4, Calib), Zero);
+    Failed = BC;
+    ADC = _mm256_andnot_si256(Failed, ADC);
+    Failed = _mm256_or_si256(Failed, ADC);
+    VMM = _mm256_andnot_si256(Failed, VMM);
+    Failed = _mm256_or_si256(Failed, VMM);
+    Channel = _mm256_andnot_si256(Failed, Channel);
+    Failed = _mm256_or_si256(Failed, Channel);
+    __m256i Valid = _mm256_xor_si256(Failed, Ones);
+
+    __m256i Code = _mm256_add_epi32(LaneIndex, _mm256_set1_epi32(Block << 11));
+    Code = _mm256_or_si256(Code, _mm256_and_si256(BC, _mm256_set1_epi32(1)));
+    Code = _mm256_or_si256(Code, _mm256_and_si256(ADC, _mm256_set1_epi32(2)));
+    Code = _mm256_or_si256(Code, _mm256_and_si256(VMM, _mm256_set1_epi32(4)));
+    Code =
+        _mm256_or_si256(Code, _mm256_and_si256(Channel, _mm256_set1_epi32(8)));
+    Code = _mm256_or_si256(Code, _mm256_and_si256(Valid, _mm256_set1_epi32(16)));
+    Code = _mm256_or_si256(
+        Code, _mm256_andnot_si256(NotOT, _mm256_and_si256(
+                                             Valid, _mm256_set1_epi32(32))));
+    Code = _mm256_or_si256(
+        Code, _mm256_and_si256(NotCalib, _mm256_and_si256(
+                                             Valid, _mm256_set1_epi32(64))));
+    Code = _mm256_or_si256(
+        Code, _mm256_andnot_si256(NotCalib, _mm256_and_si256(
+                                                Valid, _mm256_set1_epi32(128))));
+
+    __m256i Permute = _mm256_cvtepu8_epi32(
+        _mm_loadl_epi64((const __m128i *)&Compact.Lanes[Pending]));
+    _mm256_storeu_si256((__m256i *)(Candidates + Count),
+                        _mm256_permutevar8x32_epi32(Code, Permute));
+    _mm256_storeu_si256((__m256i *)(TimeHigh + Count),
+                        _mm256_permutevar8x32_epi32(High, Permute));
+    _mm256_storeu_si256((__m256i *)(TimeLow + Count),
+                        _mm256_permutevar8x32_epi32(Low, Permute));
+    Count += _mm_popcnt_u32(Pending);
+  }
+
+  Stats.ErrorFiber += ErrorFiber;
+  Stats.ErrorFEN += ErrorFEN;
+  Stats.ErrorDataLength += ErrorDataLength;
+  Stats.ErrorTimeFrac += ErrorTimeFrac;
+  return Count;
+}
+
+bool haveAVX2() {
+  static const bool Supported = __builtin_cpu_supports("avx2");
+  return Supported;
+}
+#endif
+} // namespace
+
 // Assume we start after the Common PacketHeader
 int VMM3Parser::parse(Parser::PacketDataV0 &PacketData) {
   Result.clear();
@@ -41,8 +216,18 @@ int VMM3Parser::parse(Parser::PacketDataV0 &PacketData) {
     return GoodReadouts;
   }
 
-  VMM3Parser::VMM3Data *DataPtr = (struct VMM3Data *)Buffer;
-  for (unsigned int i = 0; i < Size / DataLength; i++) {
+  const VMM3Data *DataPtr = (const struct VMM3Data *)Buffer;
+  if (Vectorised) {
+    return parseBlocks(DataPtr, Size / DataLength, TimeRef);
+  }
+  return parseScalar(DataPtr, Size / DataLength, TimeRef);
+}
+
+int VMM3Parser::parseScalar(const VMM3Data *DataPtr, unsigned int Readouts,
+                            ESSReferenceTime &TimeRef) {
+  uint32_t GoodReadouts{0};
+  TOFs.clear();
+  for (unsigned int i = 0; i < Readouts; i++) {
     Stats.Readouts++;
     VMM3Parser::VMM3Data Readout = DataPtr[i];
     if (Readout.FiberId > MaxFiberId) {
@@ -73,10 +258,18 @@ int VMM3Parser::parse(Parser::PacketDataV0 &PacketData) {
       continue;
     }
 
-    // Check for negative TOFs
-    ///\todo Missing TDC correction
-    auto TimeOfFlight =
-        TimeRef.getTOF(ESSTime(Readout.TimeHigh, Readout.TimeLow));
+    TOFs.add(Readout.TimeHigh, Readout.TimeLow);
+    Result.push_back(Readout);
+  }
+
+  // Check for negative TOFs, for all readouts of the packet at once
+  ///\todo Missing TDC correction
+  TOFs.calculate(TimeRef);
+
+  size_t Kept{0};
+  for (size_t i = 0; i < Result.size(); i++) {
+    VMM3Parser::VMM3Data Readout = Result[i];
+    auto TimeOfFlight = TOFs.TOF[i];
     XTRACE(DATA, DEB, "PulseTime     %" PRIu64 ", TimeStamp %" PRIu64 " ",
            TimeRef.getRefTimeUInt64(), TimeOfFlight);
 
@@ -130,12 +323,128 @@ int VMM3Parser::parse(Parser::PacketDataV0 &PacketData) {
     }
 
     GoodReadouts++;
-    Result.push_back(Readout);
+    Result[Kept++] = Readout;
   }
+  Result.resize(Kept);
 
   return GoodReadouts;
 }
 
+void VMM3Parser::checkBlock(const VMM3Data *Data, unsigned int Lanes,
+                            BlockMasks &M) const {
+  uint16_t MaxADC = IsMonitor ? ADCMask : MaxADCValue;
+  M = {};
+  for (unsigned int j = 0; j < Lanes; j++) {
+    const VMM3Data &Readout = Data[j];
+    uint8_t Bit = 1 << j;
+    M.Fiber |= (Readout.FiberId > MaxFiberId) ? Bit : 0;
+    M.FEN |= (Readout.FENId > MaxFENId) ? Bit : 0;
+    M.DataLength |= (Readout.DataLength != DataLength) ? Bit : 0;
+    M.TimeLow |= (Readout.TimeLow > MaxFracTimeCount) ? Bit : 0;
+    M.BC |= (Readout.BC > MaxBCValue) ? Bit : 0;
+    M.ADC |= ((Readout.OTADC & ADCMask) > MaxADC) ? Bit : 0;
+    M.VMM |= (Readout.VMM > MaxVMMValue) ? Bit : 0;
+    M.Channel |= (Readout.Channel > MaxChannelValue) ? Bit : 0;
+    M.OverThreshold |= (Readout.OTADC & OverThresholdMask) ? Bit : 0;
+    M.Calib |= (Readout.GEO & 0x80) ? Bit : 0;
+  }
+}
+
+int VMM3Parser::parseBlocks(const VMM3Data *DataPtr, unsigned int Readouts,
+                            ESSReferenceTime &TimeRef) {
+  Stats.Readouts += Readouts;
+
+  // Readouts passing the checks before TOF are compacted into Candidates
+  // as readout index << 8 | post TOF checks: bits 0 - 3 first failing check
+  // (BC, ADC, VMM, Channel), bit 4 valid, bit 5 over threshold, bit 6 data
+  // and bit 7 calibration readout. Their times go into TOFs.
+  Candidates.resize(Readouts);
+  TOFs.reserve(Readouts);
+  unsigned int Count{0};
+  unsigned int Block{0};
+#ifdef VMM3PARSER_AVX2
+  if (haveAVX2()) {
+    CheckLimits Limits{MaxFiberId,  MaxFENId,
+                       DataLength,  MaxBCValue,
+                       IsMonitor ? ADCMask : MaxADCValue,
+                       MaxVMMValue, MaxChannelValue};
+    Block = Readouts / 8;
+    Count = checkBlocksAVX2(DataPtr, Block, Limits, Stats, Candidates.data(),
+                            TOFs.TimeHigh.data(), TOFs.TimeLow.data());
+  }
+#endif
+
+  for (; Block < (Readouts + 7) / 8; Block++) {
+    BlockMasks M;
+    unsigned int Lanes = std::min(8U, Readouts - 8 * Block);
+    checkBlock(DataPtr + 8 * Block, Lanes, M);
+
+    // A readout only counts for its first failing check
+    uint8_t Pending = (1U << Lanes) - 1;
+    Stats.ErrorFiber += countBits(M.Fiber & Pending);
+    Pending &= ~M.Fiber;
+    Stats.ErrorFEN += countBits(M.FEN & Pending);
+    Pending &= ~M.FEN;
+    Stats.ErrorDataLength += countBits(M.DataLength & Pending);
+    Pending &= ~M.DataLength;
+    Stats.ErrorTimeFrac += countBits(M.TimeLow & Pending);
+    Pending &= ~M.TimeLow;
+
+    uint8_t ADC = M.ADC & ~M.BC;
+    uint8_t VMM = M.VMM & ~(M.BC | M.ADC);
+    uint8_t Channel = M.Channel & ~(M.BC | M.ADC | M.VMM);
+    uint8_t Valid = ~(M.BC | M.ADC | M.VMM | M.Channel);
+    uint64_t Codes = spreadBits(M.BC) | spreadBits(ADC) << 1 |
+                     spreadBits(VMM) << 2 | spreadBits(Channel) << 3 |
+                     spreadBits(Valid) << 4 |
+                     spreadBits(M.OverThreshold & Valid) << 5 |
+                     spreadBits(~M.Calib & Valid) << 6 |
+                     spreadBits(M.Calib & Valid) << 7;
+
+    for (unsigned int j = 0; j < Lanes; j++) {
+      const VMM3Data &Readout = DataPtr[8 * Block + j];
+      Candidates[Count] = (8 * Block + j) << 8 | ((Codes >> (8 * j)) & 0xff);
+      TOFs.TimeHigh[Count] = Readout.TimeHigh;
+      TOFs.TimeLow[Count] = Readout.TimeLow;
+      Count += (Pending >> j) & 1;
+    }
+  }
+
+  ///\todo Missing TDC correction
+  TOFs.Count = Count;
+  TOFs.calculate(TimeRef);
+
+  // Readouts with invalid TOF are not counted by the post TOF checks. The
+  // checks bits are summed in one byte each, for up to 255 readouts.
+  int64_t Counts[8]{};
+  unsigned int Kept{0};
+  Result.resize(Count);
+  for (unsigned int Start = 0; Start < Count; Start += 255) {
+    unsigned int End = std::min(Count, Start + 255);
+    uint64_t Sums{0};
+    for (unsigned int i = Start; i < End; i++) {
+      uint8_t ValidTOF = -(uint8_t)(TOFs.TOF[i] != TimeRef.InvalidTOF);
+      uint8_t Code = Candidates[i] & ValidTOF;
+      Sums += spreadBits(Code);
+      Result[Kept] = DataPtr[Candidates[i] >> 8];
+      Kept += (Code >> 4) & 1;
+    }
+    for (int Bit = 0; Bit < 8; Bit++) {
+      Counts[Bit] += (Sums >> (8 * Bit)) & 0xff;
+    }
+  }
+  Result.resize(Kept);
+
+  Stats.ErrorBC += Counts[0];
+  Stats.ErrorADC += Counts[1];
+  Stats.ErrorVMM += Counts[2];
+  Stats.ErrorChannel += Counts[3];
+  Stats.OverThreshold += Counts[5];
+  Stats.DataReadouts += Counts[6];
+  Stats.CalibReadouts += Counts[7];
+  return Kept;
+}
+
 void VMM3Parser::dumpReadoutToFile(
     const VMM3Data &Data, const ESSReadout::Parser ESSReadoutParser,
     std::shared_ptr<VMM3::ReadoutFile> DumpFile) {
@@ -61,7 +61,11 @@ public:
   static_assert(sizeof(VMM3Parser::VMM3Data) == (VMM3DATASIZE),
                 "Wrong header size (update assert or check packing)");
 
-  VMM3Parser() { Result.reserve(MaxReadoutsInPacket); };
+  VMM3Parser() {
+    Result.reserve(MaxReadoutsInPacket);
+    TOFs.reserve(MaxReadoutsInPacket);
+    Candidates.reserve(MaxReadoutsInPacket);
+  };
 
   /// \brief VMM readout is used as monitor
   /// this mainly affects parsing of the ADC field which
@@ -69,6 +73,26 @@ public:
   /// a monitor
   void setMonitor(bool Monitor) { IsMonitor = Monitor; };
 
+  /// \brief check readouts eight at a time into bitmasks (default) or one
+  /// at a time. Both give the same Result and Stats, the scalar version
+  /// traces each invalid readout.
+  void setVectorised(bool Enable) { Vectorised = Enable; };
+
+  /// \brief Check results of up to eight consecutive readouts, one bit per
+  /// readout for each check
+  struct BlockMasks {
+    uint8_t Fiber;
+    uint8_t FEN;
+    uint8_t DataLength;
+    uint8_t TimeLow;
+    uint8_t BC;
+    uint8_t ADC;
+    uint8_t VMM;
+    uint8_t Channel;
+    uint8_t OverThreshold;
+    uint8_t Calib;
+  };
+
   ~VMM3Parser(){};
 
   //
@@ -85,6 +109,20 @@ public:
   struct VMM3ParserStats Stats;
 
 private:
+  /// \brief check and copy readouts one at a time
+  int parseScalar(const VMM3Data *Data, unsigned int Readouts,
+                  esstime::ESSReferenceTime &TimeRef);
+
+  /// \brief check eight readouts at a time, with AVX2 when supported, count
+  /// errors from popcounts and compact the valid readouts without branching
+  /// on readout values
+  int parseBlocks(const VMM3Data *Data, unsigned int Readouts,
+                  esstime::ESSReferenceTime &TimeRef);
+
+  /// \brief set the masks of Lanes (up to eight) readouts without SIMD
+  void checkBlock(const VMM3Data *Data, unsigned int Lanes,
+                  BlockMasks &Masks) const;
+
   const uint16_t DataLength{20};
   const uint16_t MaxBCValue{4095};
   const uint16_t MaxADCValue{1023};
@@ -93,5 +131,8 @@ private:
   const uint16_t OverThresholdMask{0x8000};
   const uint16_t ADCMask{0x7fff};
   bool IsMonitor{false};
+  bool Vectorised{true};
+  TOFBatch TOFs; // times of readouts passing the checks before TOF
+  std::vector<uint32_t> Candidates; // readouts passing the pre TOF checks
 };
 } // namespace ESSReadout
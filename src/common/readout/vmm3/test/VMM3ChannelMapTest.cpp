@@ -0,0 +1,114 @@
+// Copyright (C) 2024 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Unit tests for VMM3ChannelMap class
+///
+//===----------------------------------------------------------------------===//
+
+#include <common/readout/vmm3/VMM3ChannelMap.h>
+#include <common/testutils/TestBase.h>
+
+namespace ESSReadout {
+
+class VMM3 : public VMM3Config {
+  void applyConfig() override {}
+};
+
+class VMM3ChannelMapTest : public TestBase {
+protected:
+  VMM3 Conf;
+  VMM3ChannelMap ChannelMap;
+
+  void SetUp() override {
+    Conf.getHybrid(1, 2, 3).Initialised = true;
+    Conf.getHybrid(1, 2, 3).MinADC = 42;
+    Conf.getHybrid(VMM3Config::MaxRing, VMM3Config::MaxFEN,
+                   VMM3Config::MaxHybrid)
+        .Initialised = true;
+  }
+  void TearDown() override {}
+
+  /// \brief coordinate from all arguments, invalid for channel 63
+  static VMM3ChannelMap::Entry mapping(uint8_t Ring, uint8_t FEN,
+                                       uint8_t HybridId, uint8_t Asic,
+                                       uint8_t Channel, Hybrid &Hybrid) {
+    VMM3ChannelMap::Entry Entry;
+    Entry.Coord = Ring * 10000 + FEN * 1000 + HybridId * 100 + Asic * 64 +
+                  Channel;
+    Entry.MinADC = Hybrid.MinADC;
+    Entry.Builder = Ring;
+    Entry.Plane = Asic;
+    Entry.State = (Channel == 63) ? VMM3ChannelMap::InvalidCoord
+                                  : VMM3ChannelMap::Valid;
+    return Entry;
+  }
+};
+
+TEST_F(VMM3ChannelMapTest, Unconfigured) {
+  ASSERT_EQ(ChannelMap.lookup(1, 2, 6, 0).State,
+            VMM3ChannelMap::Unconfigured);
+  ChannelMap.build(Conf, mapping);
+  ASSERT_EQ(ChannelMap.lookup(0, 0, 0, 0).State,
+            VMM3ChannelMap::Unconfigured);
+  ASSERT_EQ(ChannelMap.lookup(1, 2, 5, 0).State,
+            VMM3ChannelMap::Unconfigured);
+  ASSERT_EQ(ChannelMap.lookup(1, 2, 8, 0).State,
+            VMM3ChannelMap::Unconfigured);
+}
+
+TEST_F(VMM3ChannelMapTest, OutOfRange) {
+  ChannelMap.build(Conf, mapping);
+  ASSERT_EQ(ChannelMap.lookup(VMM3Config::MaxRing + 1, 2, 6, 0).State,
+            VMM3ChannelMap::Unconfigured);
+  ASSERT_EQ(ChannelMap.lookup(1, VMM3Config::MaxFEN + 1, 6, 0).State,
+            VMM3ChannelMap::Unconfigured);
+  ASSERT_EQ(ChannelMap.lookup(1, 2, VMM3ChannelMap::NumVMMs, 0).State,
+            VMM3ChannelMap::Unconfigured);
+  ASSERT_EQ(ChannelMap.lookup(1, 2, 6, 64).State,
+            VMM3ChannelMap::Unconfigured);
+}
+
+TEST_F(VMM3ChannelMapTest, Mapping) {
+  ChannelMap.build(Conf, mapping);
+  for (uint8_t VMM = 6; VMM < 8; VMM++) {
+    for (uint8_t Channel = 0; Channel < 63; Channel++) {
+      auto &Entry = ChannelMap.lookup(1, 2, VMM, Channel);
+      ASSERT_EQ(Entry.State, VMM3ChannelMap::Valid);
+      ASSERT_EQ(Entry.Coord, 12300 + (VMM & 1) * 64 + Channel);
+      ASSERT_EQ(Entry.MinADC, 42);
+      ASSERT_EQ(Entry.Builder, 1);
+      ASSERT_EQ(Entry.Plane, VMM & 1);
+    }
+    ASSERT_EQ(ChannelMap.lookup(1, 2, VMM, 63).State,
+              VMM3ChannelMap::InvalidCoord);
+  }
+
+  uint8_t LastVMM = VMM3ChannelMap::NumVMMs - 1;
+  auto &Last = ChannelMap.lookup(VMM3Config::MaxRing, VMM3Config::MaxFEN,
+                                 LastVMM, 62);
+  ASSERT_EQ(Last.State, VMM3ChannelMap::Valid);
+  ASSERT_EQ(Last.Builder, VMM3Config::MaxRing);
+}
+
+TEST_F(VMM3ChannelMapTest, Rebuild) {
+  ChannelMap.build(Conf, mapping);
+  Conf.getHybrid(1, 2, 3).Initialised = false;
+  ChannelMap.build(Conf, mapping);
+  ASSERT_EQ(ChannelMap.lookup(1, 2, 6, 0).State,
+            VMM3ChannelMap::Unconfigured);
+}
+
+TEST_F(VMM3ChannelMapTest, MemoryBytes) {
+  ASSERT_EQ(ChannelMap.getMemoryBytes(),
+            (VMM3Config::MaxRing + 1) * (VMM3Config::MaxFEN + 1) *
+                VMM3ChannelMap::NumVMMs * VMM3ChannelMap::NumChannels * 8);
+}
+
+} // namespace ESSReadout
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
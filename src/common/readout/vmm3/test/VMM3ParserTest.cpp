@@ -11,6 +11,8 @@
 #include <common/readout/vmm3/VMM3Parser.h>
 #include <common/readout/vmm3/test/VMM3ParserTestData.h>
 #include <common/testutils/TestBase.h>
+#include <cstring>
+#include <random>
 
 namespace ESSReadout {
 
@@ -163,6 +165,65 @@ TEST_F(VMM3ParserTest, GoodCalib1) {
   ASSERT_EQ(VMMParser.Stats.CalibReadouts, 2);
 }
 
+// Random readouts near the check limits, parsed one at a time and eight at
+// a time, must give the same Result and Stats
+TEST_F(VMM3ParserTest, VectorisedMatchesScalar) {
+  std::mt19937 Gen(42);
+  auto Pick = [&Gen](uint32_t Good, uint32_t Bad) {
+    return (Gen() % 8 == 0) ? Bad : Good;
+  };
+
+  for (bool Monitor : {false, true}) {
+    VMM3Parser Scalar;
+    VMM3Parser Vectorised;
+    Scalar.setVectorised(false);
+    Scalar.setMonitor(Monitor);
+    Vectorised.setMonitor(Monitor);
+    Parser::PacketDataV0 ScalarData;
+    Parser::PacketDataV0 VectorisedData;
+
+    for (int Packet = 0; Packet < 200; Packet++) {
+      int Readouts = Gen() % 60;
+      std::vector<VMM3Parser::VMM3Data> Data(Readouts);
+      for (auto &Readout : Data) {
+        Readout.FiberId = Pick(Gen() % 24, 24 + Gen() % 232);
+        Readout.FENId = Pick(Gen() % 24, 24 + Gen() % 232);
+        Readout.DataLength = Pick(20, Gen() % 64);
+        Readout.TimeHigh = Gen() % 4;
+        Readout.TimeLow = Pick(Gen() % 88052500, 88052499 + Gen() % 2);
+        Readout.BC = Pick(Gen() % 4096, 4095 + Gen() % 100);
+        Readout.OTADC = Gen() % 2 * 0x8000 + Pick(Gen() % 1024, Gen() % 0x8000);
+        Readout.GEO = Gen();
+        Readout.TDC = Gen();
+        Readout.VMM = Pick(Gen() % 16, 15 + Gen() % 3);
+        Readout.Channel = Pick(Gen() % 64, 63 + Gen() % 3);
+      }
+
+      ESSTime Ref(1 + Gen() % 2, Gen() % 88052500);
+      ESSTime PrevRef(Ref.getTimeHigh() - 1, Gen() % 88052500);
+      for (auto *PacketData : {&ScalarData, &VectorisedData}) {
+        PacketData->DataPtr = (char *)Data.data();
+        PacketData->DataLength = Readouts * sizeof(VMM3Parser::VMM3Data);
+        PacketData->Time.setReferences(Ref, PrevRef);
+      }
+
+      ASSERT_EQ(Scalar.parse(ScalarData), Vectorised.parse(VectorisedData));
+      ASSERT_EQ(Scalar.Result.size(), Vectorised.Result.size());
+      ASSERT_EQ(memcmp(Scalar.Result.data(), Vectorised.Result.data(),
+                       Scalar.Result.size() * sizeof(VMM3Parser::VMM3Data)),
+                0);
+      ASSERT_EQ(memcmp(&Scalar.Stats, &Vectorised.Stats, sizeof(Scalar.Stats)),
+                0);
+      ASSERT_EQ(memcmp(&ScalarData.Time.Stats, &VectorisedData.Time.Stats,
+                       sizeof(ScalarData.Time.Stats)),
+                0);
+    }
+    ASSERT_GT(Scalar.Stats.ErrorChannel, 0);
+    ASSERT_GT(Scalar.Stats.DataReadouts, 0);
+    ASSERT_GT(ScalarData.Time.Stats.PrevTofCount, 0);
+  }
+}
+
 } // namespace ESSReadout
 
 int main(int argc, char **argv) {
@@ -0,0 +1,114 @@
+// Copyright (C) 2024 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Escalating idle strategy for threads consuming a PacketQueue
+///
+/// Each call to idle() is one step of: busy spin with a cpu pause hint for
+/// SpinCount calls, then std::this_thread::yield() for YieldCount calls,
+/// then block in PacketQueue::waitForData() for at most WaitUS per call
+/// until the producer pushes. reset() is called when the consumer has
+/// found data and starts the escalation over.
+///
+/// The time spent in each phase is accumulated in Stats, the clock is only
+/// read on phase changes and around each blocking wait.
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+class IdleStrategy {
+public:
+  struct IdleStats {
+    int64_t SpinNs{0};
+    int64_t YieldNs{0};
+    int64_t WaitNs{0};
+    int64_t Waits{0};       // calls to waitForData()
+    int64_t WaitWakeups{0}; // waits ending with data available
+  };
+
+  /// \param SpinCount idle() calls spent busy spinning
+  /// \param YieldCount idle() calls spent yielding after spinning
+  /// \param WaitUS max time to block in each later idle() call
+  IdleStrategy(uint32_t SpinCount, uint32_t YieldCount, uint32_t WaitUS)
+      : SpinCount(SpinCount), YieldEnd(uint64_t(SpinCount) + YieldCount),
+        WaitUS(WaitUS) {}
+
+  /// \brief one idle step, called each time Queue is found empty
+  template <typename Queue> void idle(Queue &Q) {
+    if (Calls == 0) {
+      PhaseStart = Clock::now();
+    }
+
+    if (Calls < SpinCount) {
+      cpuRelax();
+      Calls++;
+      return;
+    }
+
+    if (Calls < YieldEnd) {
+      if (Calls == SpinCount) {
+        endPhase(Stats.SpinNs);
+      }
+      std::this_thread::yield();
+      Calls++;
+      return;
+    }
+
+    if (Calls == YieldEnd) {
+      endPhase((SpinCount == YieldEnd) ? Stats.SpinNs : Stats.YieldNs);
+      Calls++;
+    }
+    Stats.Waits++;
+    if (Q.waitForData(WaitUS)) {
+      Stats.WaitWakeups++;
+    }
+    endPhase(Stats.WaitNs);
+  }
+
+  /// \brief data was found, account the current phase and start over
+  void reset() {
+    if (Calls == 0) {
+      return;
+    }
+    if (Calls <= SpinCount) {
+      endPhase(Stats.SpinNs);
+    } else if (Calls <= YieldEnd) {
+      endPhase(Stats.YieldNs);
+    } else {
+      endPhase(Stats.WaitNs);
+    }
+    Calls = 0;
+  }
+
+  IdleStats Stats;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  void endPhase(int64_t &PhaseNs) {
+    auto Now = Clock::now();
+    PhaseNs +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Now - PhaseStart)
+            .count();
+    PhaseStart = Now;
+  }
+
+  static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+  }
+
+  const uint64_t SpinCount;
+  const uint64_t YieldEnd;
+  const uint32_t WaitUS;
+  uint64_t Calls{0};
+  Clock::time_point PhaseStart;
+};
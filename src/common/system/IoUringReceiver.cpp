@@ -0,0 +1,247 @@
+// Copyright (C) 2024 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Implementation of io_uring based UDP receiver
+///
+/// Uses the raw io_uring system calls, see io_uring(7) for the ring layout
+//===----------------------------------------------------------------------===//
+
+#include <common/debug/Log.h>
+#include <common/debug/Trace.h>
+#include <common/system/IoUringReceiver.h>
+#include <cstring>
+
+#ifdef HAVE_IO_URING
+#include <algorithm>
+#include <cerrno>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+
+// #undef TRC_LEVEL
+// #define TRC_LEVEL TRC_L_DEB
+
+#ifndef HAVE_IO_URING
+
+IoUringReceiver::~IoUringReceiver() {}
+
+bool IoUringReceiver::setup(unsigned int) {
+  LOG(IPC, Sev::Warning, "io_uring receive is not supported by this build");
+  return false;
+}
+
+void IoUringReceiver::provideBuffer(char *, unsigned int, unsigned int) {}
+
+void IoUringReceiver::commitBuffers() {}
+
+bool IoUringReceiver::armReceive() { return false; }
+
+int IoUringReceiver::waitCompletions(Completion[], int, int) { return 0; }
+
+#else
+
+namespace {
+/// Submission ring entries, only a single (multishot) request is outstanding
+constexpr unsigned int SqEntries{4};
+/// Completion ring entries, one completion per received datagram
+constexpr unsigned int CqEntries{4096};
+
+template <typename T> T loadAcquire(T *Ptr) {
+  return __atomic_load_n(Ptr, __ATOMIC_ACQUIRE);
+}
+
+template <typename T> void storeRelease(T *Ptr, T Value) {
+  __atomic_store_n(Ptr, Value, __ATOMIC_RELEASE);
+}
+
+void *mapRing(int Fd, size_t Size, off_t Offset) {
+  void *Ptr = mmap(nullptr, Size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, Fd, Offset);
+  return (Ptr == MAP_FAILED) ? nullptr : Ptr;
+}
+} // namespace
+
+IoUringReceiver::~IoUringReceiver() {
+  if (BufRing != nullptr) {
+    munmap(BufRing, BufRingSize);
+  }
+  if (Sqes != nullptr) {
+    munmap(Sqes, SqesSize);
+  }
+  if ((CqRing != nullptr) and (CqRing != SqRing)) {
+    munmap(CqRing, CqRingSize);
+  }
+  if (SqRing != nullptr) {
+    munmap(SqRing, SqRingSize);
+  }
+  if (RingFd >= 0) {
+    close(RingFd);
+  }
+}
+
+bool IoUringReceiver::setup(unsigned int BufferRingEntries) {
+  struct io_uring_params Params;
+  std::memset(&Params, 0, sizeof(Params));
+  Params.flags = IORING_SETUP_CQSIZE;
+  Params.cq_entries = CqEntries;
+
+  RingFd = syscall(__NR_io_uring_setup, SqEntries, &Params);
+  if (RingFd < 0) {
+    LOG(IPC, Sev::Warning, "io_uring_setup() failed: {}", strerror(errno));
+    return false;
+  }
+
+  if (not(Params.features & IORING_FEAT_EXT_ARG)) {
+    LOG(IPC, Sev::Warning, "io_uring lacks IORING_FEAT_EXT_ARG (Linux < 5.11)");
+    return false;
+  }
+
+  SqRingSize = Params.sq_off.array + Params.sq_entries * sizeof(unsigned int);
+  CqRingSize =
+      Params.cq_off.cqes + Params.cq_entries * sizeof(struct io_uring_cqe);
+  if (Params.features & IORING_FEAT_SINGLE_MMAP) {
+    SqRingSize = std::max(SqRingSize, CqRingSize);
+    CqRingSize = SqRingSize;
+  }
+
+  SqRing = mapRing(RingFd, SqRingSize, IORING_OFF_SQ_RING);
+  if (SqRing == nullptr) {
+    LOG(IPC, Sev::Warning, "mmap() of io_uring submission ring failed");
+    return false;
+  }
+  if (Params.features & IORING_FEAT_SINGLE_MMAP) {
+    CqRing = SqRing;
+  } else {
+    CqRing = mapRing(RingFd, CqRingSize, IORING_OFF_CQ_RING);
+    if (CqRing == nullptr) {
+      LOG(IPC, Sev::Warning, "mmap() of io_uring completion ring failed");
+      return false;
+    }
+  }
+  SqesSize = Params.sq_entries * sizeof(struct io_uring_sqe);
+  Sqes = mapRing(RingFd, SqesSize, IORING_OFF_SQES);
+  if (Sqes == nullptr) {
+    LOG(IPC, Sev::Warning, "mmap() of io_uring submission entries failed");
+    return false;
+  }
+
+  char *Sq = static_cast<char *>(SqRing);
+  char *Cq = static_cast<char *>(CqRing);
+  SqTail = reinterpret_cast<unsigned int *>(Sq + Params.sq_off.tail);
+  SqMask = reinterpret_cast<unsigned int *>(Sq + Params.sq_off.ring_mask);
+  SqArray = reinterpret_cast<unsigned int *>(Sq + Params.sq_off.array);
+  CqHead = reinterpret_cast<unsigned int *>(Cq + Params.cq_off.head);
+  CqTail = reinterpret_cast<unsigned int *>(Cq + Params.cq_off.tail);
+  CqMask = reinterpret_cast<unsigned int *>(Cq + Params.cq_off.ring_mask);
+  Cqes = Cq + Params.cq_off.cqes;
+
+  // Buffer ring size must be a power of two
+  unsigned int Entries{1};
+  while (Entries < BufferRingEntries) {
+    Entries <<= 1;
+  }
+  BufRingMask = Entries - 1;
+  BufRingSize = Entries * sizeof(struct io_uring_buf);
+  BufRing = mmap(nullptr, BufRingSize, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (BufRing == MAP_FAILED) {
+    BufRing = nullptr;
+    LOG(IPC, Sev::Warning, "mmap() of io_uring buffer ring failed");
+    return false;
+  }
+
+  struct io_uring_buf_reg Reg;
+  std::memset(&Reg, 0, sizeof(Reg));
+  Reg.ring_addr = reinterpret_cast<uint64_t>(BufRing);
+  Reg.ring_entries = Entries;
+  Reg.bgid = BufferGroup;
+  if (syscall(__NR_io_uring_register, RingFd, IORING_REGISTER_PBUF_RING, &Reg,
+              1) < 0) {
+    LOG(IPC, Sev::Warning, "io_uring buffer ring registration failed: {}",
+        strerror(errno));
+    return false;
+  }
+
+  LOG(IPC, Sev::Info, "io_uring receiver ready, {} provided buffers", Entries);
+  return true;
+}
+
+void IoUringReceiver::provideBuffer(char *Buffer, unsigned int Length,
+                                    unsigned int BufferId) {
+  auto *Buf = static_cast<struct io_uring_buf *>(BufRing) +
+              (BufRingTail & BufRingMask);
+  Buf->addr = reinterpret_cast<uint64_t>(Buffer);
+  Buf->len = Length;
+  Buf->bid = BufferId;
+  BufRingTail++;
+}
+
+// struct io_uring_buf_ring is not used as its flexible array member gets a
+// different offset in C++. The ring tail overlays resv of the first entry.
+void IoUringReceiver::commitBuffers() {
+  auto *Bufs = static_cast<struct io_uring_buf *>(BufRing);
+  storeRelease(&Bufs[0].resv, BufRingTail);
+}
+
+bool IoUringReceiver::armReceive() {
+  unsigned int Tail = *SqTail;
+  unsigned int Index = Tail & *SqMask;
+  auto *Sqe = static_cast<struct io_uring_sqe *>(Sqes) + Index;
+
+  std::memset(Sqe, 0, sizeof(*Sqe));
+  Sqe->opcode = IORING_OP_RECV;
+  Sqe->fd = getFileDescriptor();
+  Sqe->ioprio = IORING_RECV_MULTISHOT;
+  Sqe->flags = IOSQE_BUFFER_SELECT;
+  Sqe->buf_group = BufferGroup;
+  SqArray[Index] = Index;
+  storeRelease(SqTail, Tail + 1);
+
+  int Res = syscall(__NR_io_uring_enter, RingFd, 1, 0, 0, nullptr, 0);
+  if (Res != 1) {
+    LOG(IPC, Sev::Warning, "io_uring_enter() submit failed: {}",
+        strerror(errno));
+    return false;
+  }
+  Armed = true;
+  return true;
+}
+
+int IoUringReceiver::waitCompletions(Completion Completions[], int Count,
+                                     int TimeoutUS) {
+  unsigned int Head = *CqHead;
+  if (Head == loadAcquire(CqTail)) {
+    struct __kernel_timespec Timeout;
+    Timeout.tv_sec = TimeoutUS / 1000000;
+    Timeout.tv_nsec = (TimeoutUS % 1000000) * 1000;
+    struct io_uring_getevents_arg Arg;
+    std::memset(&Arg, 0, sizeof(Arg));
+    Arg.ts = reinterpret_cast<uint64_t>(&Timeout);
+    syscall(__NR_io_uring_enter, RingFd, 0, 1,
+            IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &Arg, sizeof(Arg));
+  }
+
+  unsigned int Tail = loadAcquire(CqTail);
+  int Received{0};
+  while ((Head != Tail) and (Received < Count)) {
+    auto *Cqe = static_cast<struct io_uring_cqe *>(Cqes) + (Head & *CqMask);
+    Completions[Received].Result = Cqe->res;
+    Completions[Received].BufferId = (Cqe->flags & IORING_CQE_F_BUFFER)
+                                         ? Cqe->flags >> IORING_CQE_BUFFER_SHIFT
+                                         : NoBuffer;
+    if (not(Cqe->flags & IORING_CQE_F_MORE)) {
+      // Request terminated (error or out of buffers), needs re-arming
+      XTRACE(IPC, WAR, "io_uring multishot receive ended (res %d)", Cqe->res);
+      Armed = false;
+    }
+    Received++;
+    Head++;
+  }
+  storeRelease(CqHead, Head);
+  return Received;
+}
+
+#endif
@@ -0,0 +1,97 @@
+// Copyright (C) 2024 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief UDP receiver using io_uring multishot receive with provided buffers
+///
+/// The application hands fixed size buffers (the PacketQueue slots) to the
+/// kernel through a registered buffer ring. A single multishot receive
+/// request then keeps completing, one completion per datagram, each naming
+/// the id of the buffer the datagram was written into. No system call is
+/// needed per packet and data is received directly into the application
+/// buffers. Requires Linux >= 6.0, setup() fails gracefully otherwise.
+/// Only built with kernel headers from Linux >= 6.0 (HAVE_IO_URING, set by
+/// CMake), otherwise setup() always fails.
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <common/system/Socket.h>
+#include <cstddef>
+#include <cstdint>
+
+class IoUringReceiver : public UDPReceiver {
+public:
+  /// False when built without io_uring support, see HAVE_IO_URING
+#ifdef HAVE_IO_URING
+  static constexpr bool Supported{true};
+#else
+  static constexpr bool Supported{false};
+#endif
+
+  /// BufferId of completions that did not consume a buffer
+  static constexpr unsigned int NoBuffer{0xffffffff};
+
+  /// Outcome of a single receive
+  struct Completion {
+    int Result;            ///< datagram size (bytes) or -errno
+    unsigned int BufferId; ///< buffer holding the datagram, or NoBuffer
+  };
+
+  /// Bind to local endpoint, io_uring resources are created by setup()
+  IoUringReceiver(Endpoint Local, bool ReusePort = false)
+      : UDPReceiver(Local, ReusePort){};
+
+  /// Unmap rings and close the io_uring file descriptor
+  ~IoUringReceiver();
+
+  /// \brief Create io_uring instance and register a buffer ring
+  /// \param BufferRingEntries max number of buffers owned by the kernel,
+  /// rounded up to a power of two
+  /// \return false if io_uring (or a needed feature) is unavailable
+  bool setup(unsigned int BufferRingEntries);
+
+  /// \brief Queue a buffer for the kernel, visible after commitBuffers()
+  void provideBuffer(char *Buffer, unsigned int Length, unsigned int BufferId);
+
+  /// \brief Publish buffers queued by provideBuffer() to the kernel
+  void commitBuffers();
+
+  /// \brief Submit the multishot receive request. Must be called again
+  /// when the request terminates, see waitCompletions()
+  bool armReceive();
+
+  /// \brief Wait up to TimeoutUS for completions
+  /// \param Completions array to hold at most Count completions
+  /// \return number of completions returned
+  int waitCompletions(Completion Completions[], int Count, int TimeoutUS);
+
+  /// \brief True while the multishot request is still active
+  bool isArmed() { return Armed; }
+
+private:
+  int RingFd{-1};
+  bool Armed{false};
+
+  // Submission and completion rings (shared with kernel)
+  void *SqRing{nullptr};
+  size_t SqRingSize{0};
+  void *CqRing{nullptr};
+  size_t CqRingSize{0};
+  void *Sqes{nullptr};
+  size_t SqesSize{0};
+  unsigned int *SqTail{nullptr};
+  unsigned int *SqMask{nullptr};
+  unsigned int *SqArray{nullptr};
+  unsigned int *CqHead{nullptr};
+  unsigned int *CqTail{nullptr};
+  unsigned int *CqMask{nullptr};
+  void *Cqes{nullptr};
+
+  // Provided buffer ring (shared with kernel)
+  void *BufRing{nullptr};
+  size_t BufRingSize{0};
+  unsigned int BufRingMask{0};
+  uint16_t BufRingTail{0};
+  static constexpr uint16_t BufferGroup{0};
+};
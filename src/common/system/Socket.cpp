@@ -13,6 +13,10 @@
 #include <cstring>
 #include <iostream>
 #include <netdb.h>
+#include <netinet/udp.h>
+#ifdef SYSTEM_NAME_LINUX
+#include <linux/sock_diag.h>
+#endif
 
 // #undef TRC_LEVEL
 // #define TRC_LEVEL TRC_L_DEB
@@ -24,6 +28,11 @@
 #define SEND_FLAGS 0
 #endif
 
+/// Control message space for a SO_TIMESTAMPNS timestamp and a SO_RXQ_OVFL
+/// drop count
+#define RX_CMSG_SPACE                                                          \
+  (CMSG_SPACE(sizeof(struct timespec)) + CMSG_SPACE(sizeof(uint32_t)))
+
 bool Socket::isValidIp(std::string ipAddress) {
   struct sockaddr_in SockAddr;
   return inet_pton(AF_INET, ipAddress.c_str(), &(SockAddr.sin_addr)) != 0;
@@ -91,6 +100,15 @@ void Socket::setMulticastReceive() {
   }
 }
 
+void Socket::setReusePort() {
+  if ((setsockopt(SocketFileDescriptor, SOL_SOCKET, SO_REUSEPORT,
+                  &SockOptFlagOn, sizeof(SockOptFlagOn))) < 0) {
+    LOG(IPC, Sev::Error, "setsockopt(SOL_SOCKET, SO_REUSEPORT) failed");
+    throw std::runtime_error(
+        "system error - setsockopt(SOL_SOCKET, SO_REUSEPORT) failed");
+  }
+}
+
 int Socket::setBufferSizes(int sndbuf, int rcvbuf) {
   if (sndbuf) {
     setSockOpt(SO_SNDBUF, &sndbuf, sizeof(sndbuf));
@@ -129,6 +147,59 @@ int Socket::setRecvTimeout(int seconds, int usecs) {
   return setSockOpt(SO_RCVTIMEO, &timeout, sizeof(timeout));
 }
 
+bool Socket::enableGRO() {
+#ifdef UDP_GRO
+  if (setsockopt(SocketFileDescriptor, SOL_UDP, UDP_GRO, &SockOptFlagOn,
+                 sizeof(SockOptFlagOn)) < 0) {
+    LOG(IPC, Sev::Warning, "setsockopt(SOL_UDP, UDP_GRO) failed");
+    return false;
+  }
+  return true;
+#else
+  LOG(IPC, Sev::Warning, "UDP_GRO is not supported on this platform");
+  return false;
+#endif
+}
+
+bool Socket::enableDropCount() {
+#ifdef SO_RXQ_OVFL
+  if (setSockOpt(SO_RXQ_OVFL, &SockOptFlagOn, sizeof(SockOptFlagOn)) < 0) {
+    LOG(IPC, Sev::Warning, "setsockopt(SO_RXQ_OVFL) failed");
+    return false;
+  }
+  return true;
+#else
+  LOG(IPC, Sev::Warning, "SO_RXQ_OVFL is not supported on this platform");
+  return false;
+#endif
+}
+
+uint32_t Socket::readKernelDrops() {
+#if defined(SO_MEMINFO) && defined(SYSTEM_NAME_LINUX)
+  uint32_t MemInfo[SK_MEMINFO_VARS];
+  socklen_t Size = sizeof(MemInfo);
+  if (getsockopt(SocketFileDescriptor, SOL_SOCKET, SO_MEMINFO, MemInfo,
+                 &Size) == 0 and
+      Size > SK_MEMINFO_DROPS * sizeof(uint32_t)) {
+    KernelDrops = MemInfo[SK_MEMINFO_DROPS];
+  }
+#endif
+  return KernelDrops;
+}
+
+bool Socket::enableTimestamps() {
+#ifdef SO_TIMESTAMPNS
+  if (setSockOpt(SO_TIMESTAMPNS, &SockOptFlagOn, sizeof(SockOptFlagOn)) < 0) {
+    LOG(IPC, Sev::Warning, "setsockopt(SO_TIMESTAMPNS) failed");
+    return false;
+  }
+  return true;
+#else
+  LOG(IPC, Sev::Warning, "SO_TIMESTAMPNS is not supported on this platform");
+  return false;
+#endif
+}
+
 int Socket::setNOSIGPIPE() {
 #ifdef SYSTEM_NAME_DARWIN
   LOG(IPC, Sev::Info, "setsockopt() - MacOS specific");
@@ -240,10 +311,155 @@ ssize_t Socket::receive(void *buffer, int buflen) {
                   (struct sockaddr *)&remoteSockAddr, &slen);
 }
 
+ssize_t Socket::receive(void *buffer, int buflen, int64_t &TimestampNs) {
+  struct iovec IoVector;
+  union {
+    char Buffer[RX_CMSG_SPACE];
+    struct cmsghdr Align;
+  } Control;
+  struct msghdr Message;
+
+  std::memset(&Message, 0, sizeof(Message));
+  IoVector.iov_base = buffer;
+  IoVector.iov_len = buflen;
+  Message.msg_iov = &IoVector;
+  Message.msg_iovlen = 1;
+  Message.msg_control = Control.Buffer;
+  Message.msg_controllen = sizeof(Control.Buffer);
+
+  ssize_t ReadSize = recvmsg(SocketFileDescriptor, &Message, 0);
+  TimestampNs = (ReadSize >= 0) ? parseControl(&Message) : 0;
+  return ReadSize;
+}
+
+int Socket::receiveBatch(char *Buffers[], int BufferSize, int Lengths[],
+                         int Count, int64_t Timestamps[]) {
+  if (Count > MaxBatchSize) {
+    Count = MaxBatchSize;
+  }
+#ifdef SYSTEM_NAME_DARWIN
+  if (Count < 1) {
+    return 0;
+  }
+  ssize_t ReadSize = receive(Buffers[0], BufferSize);
+  if (ReadSize <= 0) {
+    return ReadSize;
+  }
+  Lengths[0] = ReadSize;
+  if (Timestamps != nullptr) {
+    Timestamps[0] = 0;
+  }
+  return 1;
+#else
+  struct mmsghdr Messages[MaxBatchSize];
+  struct iovec IoVectors[MaxBatchSize];
+  union {
+    char Buffer[RX_CMSG_SPACE];
+    struct cmsghdr Align;
+  } Controls[MaxBatchSize];
+
+  std::memset(Messages, 0, sizeof(Messages[0]) * Count);
+  for (int i = 0; i < Count; i++) {
+    IoVectors[i].iov_base = Buffers[i];
+    IoVectors[i].iov_len = BufferSize;
+    Messages[i].msg_hdr.msg_iov = &IoVectors[i];
+    Messages[i].msg_hdr.msg_iovlen = 1;
+    Messages[i].msg_hdr.msg_control = Controls[i].Buffer;
+    Messages[i].msg_hdr.msg_controllen = sizeof(Controls[i].Buffer);
+  }
+
+  // Block (subject to SO_RCVTIMEO) for the first datagram, then return
+  // whatever else is already queued on the socket
+  int Received = recvmmsg(SocketFileDescriptor, Messages, Count,
+                          MSG_WAITFORONE, nullptr);
+  for (int i = 0; i < Received; i++) {
+    Lengths[i] = Messages[i].msg_len;
+    int64_t TimestampNs = parseControl(&Messages[i].msg_hdr);
+    if (Timestamps != nullptr) {
+      Timestamps[i] = TimestampNs;
+    }
+  }
+  XTRACE(IPC, DEB, "recvmmsg() returned %d datagrams", Received);
+  return Received;
+#endif
+}
+
+ssize_t Socket::receiveScatter(char *Buffers[], int BufferSize, int Count,
+                               int &SegmentSize, int64_t *TimestampNs) {
+  if (Count > MaxBatchSize) {
+    Count = MaxBatchSize;
+  }
+  struct iovec IoVectors[MaxBatchSize];
+  union {
+    char Buffer[CMSG_SPACE(sizeof(int)) + RX_CMSG_SPACE];
+    struct cmsghdr Align;
+  } Control;
+  struct msghdr Message;
+
+  std::memset(&Message, 0, sizeof(Message));
+  for (int i = 0; i < Count; i++) {
+    IoVectors[i].iov_base = Buffers[i];
+    IoVectors[i].iov_len = BufferSize;
+  }
+  Message.msg_iov = IoVectors;
+  Message.msg_iovlen = Count;
+  Message.msg_control = Control.Buffer;
+  Message.msg_controllen = sizeof(Control.Buffer);
+
+  SegmentSize = 0;
+  ssize_t ReadSize = recvmsg(SocketFileDescriptor, &Message, 0);
+  if (ReadSize <= 0) {
+    return ReadSize;
+  }
+
+  if (Message.msg_flags & MSG_TRUNC) {
+    XTRACE(IPC, WAR, "recvmsg() truncated datagram, %d buffers too small",
+           Count);
+  }
+
+  int64_t Timestamp = parseControl(&Message);
+  if (TimestampNs != nullptr) {
+    *TimestampNs = Timestamp;
+  }
+
+#ifdef UDP_GRO
+  for (struct cmsghdr *Cmsg = CMSG_FIRSTHDR(&Message); Cmsg != nullptr;
+       Cmsg = CMSG_NXTHDR(&Message, Cmsg)) {
+    if ((Cmsg->cmsg_level == SOL_UDP) and (Cmsg->cmsg_type == UDP_GRO)) {
+      std::memcpy(&SegmentSize, CMSG_DATA(Cmsg), sizeof(SegmentSize));
+    }
+  }
+#endif
+  return ReadSize;
+}
+
 //
 // Private methods
 //
 
+int64_t Socket::parseControl(struct msghdr *Message) {
+  int64_t TimestampNs{0};
+  for (struct cmsghdr *Cmsg = CMSG_FIRSTHDR(Message); Cmsg != nullptr;
+       Cmsg = CMSG_NXTHDR(Message, Cmsg)) {
+    if (Cmsg->cmsg_level != SOL_SOCKET) {
+      continue;
+    }
+#ifdef SO_TIMESTAMPNS
+    if (Cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+      struct timespec Time;
+      std::memcpy(&Time, CMSG_DATA(Cmsg), sizeof(Time));
+      TimestampNs = Time.tv_sec * 1000000000LL + Time.tv_nsec;
+    }
+#endif
+#ifdef SO_RXQ_OVFL
+    if (Cmsg->cmsg_type == SO_RXQ_OVFL) {
+      std::memcpy(&KernelDrops, CMSG_DATA(Cmsg), sizeof(KernelDrops));
+    }
+#endif
+  }
+  return TimestampNs;
+}
+
 int Socket::getSockOpt(int option) {
   XTRACE(IPC, DEB, "getSockOpt(%d), fd %d", option, SocketFileDescriptor);
   int optval, ret;
@@ -24,6 +24,9 @@ class Socket {
 public:
   enum class SocketType { UDP, TCP };
 
+  /// Upper limit on the number of datagrams fetched by receiveBatch()
+  static constexpr int MaxBatchSize{64};
+
   class Endpoint {
   public:
     const std::string IpAddress;
@@ -59,6 +62,11 @@ public:
   // void setMulticastReceive(std::string MultiCastAddress);
   void setMulticastReceive();
 
+  /// Allow several sockets to bind the same ip and port, the kernel then
+  /// distributes datagrams between them by hashing the source address.
+  /// Must be called before binding.
+  void setReusePort();
+
   /// Attempt to specify the socket receive and transmit buffer sizes (for
   /// performance)
   int setBufferSizes(int sndbuf, int rcvbuf);
@@ -75,6 +83,30 @@ public:
   /// Set a timeout for recv() function rather than wait for ever
   int setRecvTimeout(int seconds, int usecs);
 
+  /// \brief Enable UDP generic receive offload (UDP_GRO, Linux >= 5.0)
+  /// \return true if the option was accepted by the kernel
+  bool enableGRO();
+
+  /// \brief Enable kernel receive timestamps (SO_TIMESTAMPNS), reported by
+  /// the receive functions taking timestamp arguments
+  /// \return true if the option was accepted by the kernel
+  bool enableTimestamps();
+
+  /// \brief Have the kernel report its count of datagrams dropped on this
+  /// socket (SO_RXQ_OVFL) with each received datagram, see getKernelDrops()
+  /// \return true if the option was accepted by the kernel
+  bool enableDropCount();
+
+  /// \brief Datagrams dropped by the kernel on this socket, typically
+  /// because the receive buffer was full. Updated by the receive functions
+  /// taking timestamp arguments, receiveBatch() and receiveScatter() after
+  /// enableDropCount(), or by readKernelDrops()
+  uint32_t getKernelDrops() const { return KernelDrops; }
+
+  /// \brief Update and return the kernel drop count with getsockopt
+  /// (SO_MEMINFO), for receive paths without control messages
+  uint32_t readKernelDrops();
+
   /// Set socket option (Mac only) for not sending SIGPIPE on transmitting on
   /// invalid socket
   int setNOSIGPIPE();
@@ -92,6 +124,33 @@ public:
   /// Receive data on socket into buffer with specified length
   ssize_t receive(void *receiveBuffer, int bufferSize);
 
+  /// \brief Receive data on socket into buffer with specified length
+  /// \param TimestampNs set to the kernel receive time in ns since the epoch
+  /// (CLOCK_REALTIME), 0 when timestamps are not enabled
+  ssize_t receive(void *receiveBuffer, int bufferSize, int64_t &TimestampNs);
+
+  /// \brief Receive up to Count datagrams using a single system call
+  /// (recvmmsg() on Linux, falls back to a single receive() elsewhere)
+  /// \param Buffers array of Count receive buffers
+  /// \param BufferSize size of each receive buffer (bytes)
+  /// \param Lengths array of Count entries, set to the size of each datagram
+  /// \param Count number of buffers, clamped to MaxBatchSize
+  /// \param Timestamps optional array of Count entries, set to the kernel
+  /// receive time of each datagram as for receive()
+  /// \return number of datagrams received, or < 0 on timeout or error
+  int receiveBatch(char *Buffers[], int BufferSize, int Lengths[], int Count,
+                   int64_t Timestamps[] = nullptr);
+
+  /// \brief Receive one (possibly GRO coalesced) datagram scattered over
+  /// Count buffers of BufferSize bytes each
+  /// \param SegmentSize set to the size of the coalesced datagrams, or 0 if
+  /// the kernel did not coalesce anything
+  /// \param TimestampNs optional, set to the kernel receive time as for
+  /// receive()
+  /// \return total number of bytes received, or < 0 on timeout or error
+  ssize_t receiveScatter(char *Buffers[], int BufferSize, int Count,
+                         int &SegmentSize, int64_t *TimestampNs = nullptr);
+
   /// Send data in buffer with specified length
   int send(void const *dataBuffer, int dataLength);
 
@@ -103,16 +162,26 @@ public:
     return IN_MULTICAST(ntohl(inet_addr(IpAddress.c_str())));
   };
 
+protected:
+  /// For derived receivers issuing their own system calls on the socket
+  int getFileDescriptor() const { return SocketFileDescriptor; }
+
 private:
   int SocketFileDescriptor{-1};
   bool SocketIsGood{true};
   int SockOptFlagOn{1};
   struct ip_mreq MulticastRequest;
+  uint32_t KernelDrops{0};
   std::string RemoteIp;
   int RemotePort;
   struct sockaddr_in remoteSockAddr;
   struct sockaddr_in localSockAddr;
 
+  /// \brief read SO_TIMESTAMPNS and SO_RXQ_OVFL control messages of a
+  /// received message, updates KernelDrops
+  /// \return receive time in ns since the epoch, 0 if not reported
+  int64_t parseControl(struct msghdr *Message);
+
   /// wrapper for getsockopt() system call
   int getSockOpt(int option);
 
@@ -123,7 +192,11 @@ private:
 /// UDP receiver only needs to specify local socket
 class UDPReceiver : public Socket {
 public:
-  UDPReceiver(Endpoint Local) : Socket(Socket::SocketType::UDP) {
+  UDPReceiver(Endpoint Local, bool ReusePort = false)
+      : Socket(Socket::SocketType::UDP) {
+    if (ReusePort) {
+      this->setReusePort();
+    }
     this->setLocalSocket(Local.IpAddress, Local.Port);
   };
 };
@@ -52,6 +52,158 @@ TEST_F(DetectorTest, ThreadInfoNoThreads) {
   ASSERT_EQ(0, threadlist.size());
 }
 
+TEST_F(DetectorTest, SplitSegmentsInPlace) {
+  unsigned int Indexes[Socket::MaxBatchSize];
+  for (int i = 0; i < 3; i++) {
+    Indexes[i] = det->InputQueue.getWriteIndex(i);
+    memset(det->InputQueue.getDataBuffer(Indexes[i]), i + 1, 100);
+  }
+
+  auto Segments = det->splitSegments(det->InputQueue, det->ITCounters,
+                                     Indexes, 100, 250, 100, nullptr);
+  ASSERT_EQ(Segments, 3);
+  ASSERT_EQ(det->ITCounters.RxGroCopies, 0);
+  ASSERT_EQ(det->InputQueue.getDataLength(Indexes[0]), 100);
+  ASSERT_EQ(det->InputQueue.getDataLength(Indexes[1]), 100);
+  ASSERT_EQ(det->InputQueue.getDataLength(Indexes[2]), 50);
+}
+
+TEST_F(DetectorTest, SplitSegmentsCopy) {
+  std::vector<char> Staging(65535);
+  unsigned int Indexes[Socket::MaxBatchSize];
+  for (int i = 0; i < Socket::MaxBatchSize; i++) {
+    Indexes[i] = det->InputQueue.getWriteIndex(i);
+  }
+  // three datagrams of 100, 100 and 50 bytes received into the first entry
+  char *Data = det->InputQueue.getDataBuffer(Indexes[0]);
+  for (int i = 0; i < 250; i++) {
+    Data[i] = i / 100 + 1;
+  }
+
+  auto Segments = det->splitSegments(det->InputQueue, det->ITCounters,
+                                     Indexes, 9000, 250, 100, Staging.data());
+  ASSERT_EQ(Segments, 3);
+  ASSERT_EQ(det->ITCounters.RxGroCopies, 1);
+  for (int i = 0; i < Segments; i++) {
+    auto Length = det->InputQueue.getDataLength(Indexes[i]);
+    ASSERT_EQ(Length, i < 2 ? 100 : 50);
+    char *Segment = det->InputQueue.getDataBuffer(Indexes[i]);
+    for (int j = 0; j < Length; j++) {
+      ASSERT_EQ(Segment[j], i + 1);
+    }
+  }
+}
+
+TEST_F(DetectorTest, SplitSegmentsNotCoalesced) {
+  unsigned int Indexes[Socket::MaxBatchSize];
+  Indexes[0] = det->InputQueue.getWriteIndex(0);
+
+  auto Segments = det->splitSegments(det->InputQueue, det->ITCounters,
+                                     Indexes, 9000, 80, 0, nullptr);
+  ASSERT_EQ(Segments, 1);
+  ASSERT_EQ(det->ITCounters.RxGroCopies, 0);
+  ASSERT_EQ(det->InputQueue.getDataLength(Indexes[0]), 80);
+}
+
+TEST_F(DetectorTest, SplitSegmentsOversize) {
+  std::vector<char> Staging(65535);
+  unsigned int Indexes[Socket::MaxBatchSize];
+  for (int i = 0; i < Socket::MaxBatchSize; i++) {
+    Indexes[i] = det->InputQueue.getWriteIndex(i);
+    det->InputQueue.setDataLength(Indexes[i], 0);
+  }
+
+  // not coalesced, scattered over the first slots
+  auto Segments = det->splitSegments(det->InputQueue, det->ITCounters,
+                                     Indexes, 9000, 9001, 0, Staging.data());
+  ASSERT_EQ(Segments, 0);
+  Segments = det->splitSegments(det->InputQueue, det->ITCounters, Indexes,
+                                9000, 20000, 0, Staging.data());
+  ASSERT_EQ(Segments, 0);
+  ASSERT_EQ(det->ITCounters.RxGroOversize, 2);
+
+  // two coalesced datagrams of 20000 bytes
+  Segments = det->splitSegments(det->InputQueue, det->ITCounters, Indexes,
+                                20000, 40000, 20000, Staging.data());
+  ASSERT_EQ(Segments, 0);
+  ASSERT_EQ(det->ITCounters.RxGroOversize, 4);
+  ASSERT_EQ(det->ITCounters.RxPackets, 4);
+  ASSERT_EQ(det->ITCounters.RxGroCopies, 0);
+  for (int i = 0; i < Socket::MaxBatchSize; i++) {
+    ASSERT_EQ(det->InputQueue.getDataLength(Indexes[i]), 0);
+  }
+}
+
+TEST_F(DetectorTest, QueueFillSampled) {
+  det->InputQueue.push(2);
+  det->updateQueueFill(det->InputQueue, det->ITCounters);
+  ASSERT_EQ(det->ITCounters.RxQueueHighWater, 2);
+  ASSERT_EQ(det->ITCounters.RxQueueFill[0], 1);
+
+  // within the sample interval
+  det->InputQueue.push(2);
+  det->updateQueueFill(det->InputQueue, det->ITCounters);
+  ASSERT_EQ(det->ITCounters.RxQueueHighWater, 2);
+  ASSERT_EQ(det->ITCounters.RxQueueFill[0], 1);
+
+  det->ITCounters.RxQueueFillNextTsc = 0;
+  det->updateQueueFill(det->InputQueue, det->ITCounters);
+  ASSERT_EQ(det->ITCounters.RxQueueHighWater, 4);
+  ASSERT_EQ(det->ITCounters.RxQueueFill[0], 2);
+}
+
+TEST_F(DetectorTest, AddPipelines) {
+  settings.RxPipelines = 3;
+  settings.RxQueueEntries = 16;
+  det = std::shared_ptr<Detector>(new Detector(settings));
+  std::vector<unsigned int> Started;
+  det->addPipelines([&Started](unsigned int Pipeline) {
+    Started.push_back(Pipeline);
+  });
+
+  auto &threadlist = det->GetThreadInfo();
+  ASSERT_EQ(threadlist.size(), 4);
+  ASSERT_EQ(threadlist[0].name, "input_01");
+  ASSERT_EQ(threadlist[1].name, "processing_01");
+  threadlist[1].func();
+  threadlist[3].func();
+  ASSERT_EQ(Started, std::vector<unsigned int>({1, 2}));
+
+  ASSERT_EQ(&det->inputQueue(0), &det->InputQueue);
+  ASSERT_NE(&det->inputQueue(1), &det->inputQueue(2));
+  ASSERT_EQ(&det->inputCounters(0), &det->ITCounters);
+  ASSERT_EQ(det->statsize(), 10);
+  ASSERT_EQ(det->statname(1), "pipeline.01.receive.packets");
+}
+
+TEST_F(DetectorTest, PopInOrder) {
+  ESSReadout::Parser Parser;
+  Parser.Reorder.configure(4, 1000000);
+  auto &Queue = det->InputQueue;
+  for (uint32_t SeqNum : {0, 2, 3, 1}) {
+    unsigned int Index = Queue.getWriteIndex();
+    auto Header =
+        (ESSReadout::Parser::PacketHeaderV0 *)Queue.getDataBuffer(Index);
+    memset(Header, 0, sizeof(*Header));
+    memcpy(Queue.getDataBuffer(Index) + 2, "ESS", 3);
+    Header->SeqNum = SeqNum;
+    Queue.setDataLength(Index, sizeof(*Header));
+    Queue.push();
+  }
+
+  std::vector<uint32_t> SeqNums;
+  unsigned int Index;
+  while (det->popInOrder(Parser, Index)) {
+    auto Header =
+        (ESSReadout::Parser::PacketHeaderV0 *)Queue.getDataBuffer(Index);
+    SeqNums.push_back(Header->SeqNum);
+  }
+  ASSERT_EQ(SeqNums, std::vector<uint32_t>({0, 1, 2, 3}));
+  ASSERT_EQ(Parser.Reorder.Stats.Reordered, 1);
+  ASSERT_FALSE(Queue.pop(Index));
+  ASSERT_TRUE(Queue.wasEmpty());
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,106 @@
+// Copyright (C) 2024 European Spallation Source ERIC
+
+/// \file
+/// \brief Packets per second for the ESS readout header check, with the
+/// header version detected per packet and with the fast path selected by
+/// setHeaderVersion(). Packets are valid and in sequence, as on a healthy
+/// link, so every check of the header is evaluated.
+
+#include <benchmark/benchmark.h>
+#include <common/readout/ess/Parser.h>
+#include <cstring>
+#include <vector>
+
+using namespace ESSReadout;
+
+namespace {
+constexpr unsigned int PacketSize{8972};
+
+template <typename Header> std::vector<char> makePacket(uint8_t Version) {
+  std::vector<char> Packet(PacketSize, 0);
+  Header Hdr{};
+  Hdr.Version = Version;
+  Hdr.CookieAndType = 0x535345 | Parser::LOKI << 24;
+  Hdr.TotalLength = PacketSize;
+  Hdr.OutputQueue = 3;
+  Hdr.PulseHigh = 100;
+  Hdr.PulseLow = 1000;
+  Hdr.PrevPulseHigh = 100;
+  Hdr.PrevPulseLow = 500;
+  std::memcpy(Packet.data(), &Hdr, sizeof(Hdr));
+  return Packet;
+}
+
+template <typename Header, typename ValidateFn>
+void run(benchmark::State &state, uint8_t Version, Parser &RdOut,
+         ValidateFn &&Validate) {
+  auto Packet = makePacket<Header>(Version);
+  auto Hdr = (Header *)Packet.data();
+  RdOut.setMaxPulseTimeDiff(1000000);
+  uint32_t SeqNum{0};
+  for (auto _ : state) {
+    Hdr->SeqNum = SeqNum++;
+    benchmark::DoNotOptimize(Validate(Packet.data(), PacketSize));
+  }
+  if (RdOut.Stats.ErrorSeqNum != 0) {
+    state.SkipWithError("unexpected header errors");
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+} // namespace
+
+static void ValidateRuntimeV0(benchmark::State &state) {
+  Parser RdOut;
+  run<Parser::PacketHeaderV0>(state, Parser::V0, RdOut,
+                              [&](const char *Buffer, uint32_t Size) {
+                                return RdOut.validate(Buffer, Size,
+                                                      Parser::LOKI);
+                              });
+}
+BENCHMARK(ValidateRuntimeV0);
+
+static void ValidateRuntimeV1(benchmark::State &state) {
+  Parser RdOut;
+  run<Parser::PacketHeaderV1>(state, Parser::V1, RdOut,
+                              [&](const char *Buffer, uint32_t Size) {
+                                return RdOut.validate(Buffer, Size,
+                                                      Parser::LOKI);
+                              });
+}
+BENCHMARK(ValidateRuntimeV1);
+
+static void ValidateFastV0(benchmark::State &state) {
+  Parser RdOut;
+  run<Parser::PacketHeaderV0>(state, Parser::V0, RdOut,
+                              [&](const char *Buffer, uint32_t Size) {
+                                return RdOut.validate<Parser::V0,
+                                                      Parser::LOKI>(Buffer,
+                                                                    Size);
+                              });
+}
+BENCHMARK(ValidateFastV0);
+
+static void ValidateFastV1(benchmark::State &state) {
+  Parser RdOut;
+  run<Parser::PacketHeaderV1>(state, Parser::V1, RdOut,
+                              [&](const char *Buffer, uint32_t Size) {
+                                return RdOut.validate<Parser::V1,
+                                                      Parser::LOKI>(Buffer,
+                                                                    Size);
+                              });
+}
+BENCHMARK(ValidateFastV1);
+
+/// \brief fast path selected at configuration time, as in the instruments
+static void ValidateConfiguredV1(benchmark::State &state) {
+  Parser RdOut;
+  RdOut.setHeaderVersion(Parser::V1, Parser::LOKI);
+  run<Parser::PacketHeaderV1>(state, Parser::V1, RdOut,
+                              [&](const char *Buffer, uint32_t Size) {
+                                return RdOut.validate(Buffer, Size,
+                                                      Parser::LOKI);
+                              });
+}
+BENCHMARK(ValidateConfiguredV1);
+
+BENCHMARK_MAIN();
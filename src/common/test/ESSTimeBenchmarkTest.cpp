@@ -0,0 +1,118 @@
+// Copyright (C) 2024 European Spallation Source ERIC
+
+/// \file
+/// \brief Per packet and per readout cost of the ESS time conversions. The
+/// double based tick to ns conversion is kept here as the reference for
+/// ESSTime::ticksToNS(). Packets are 64 per pulse, as seen from the
+/// detector readout masters at moderate rates.
+
+#include <benchmark/benchmark.h>
+#include <common/time/ESSTime.h>
+#include <vector>
+
+using namespace esstime;
+
+namespace {
+constexpr int PacketsPerPulse{64};
+constexpr int ReadoutsPerPacket{200};
+constexpr uint32_t PulseTicks{6289464}; // 14 Hz
+
+uint64_t doubleToNS(uint32_t High, uint32_t Low) {
+  return High * ESSTime::SecInNs.count() +
+         (uint64_t)(Low * ESSTime::ESSClockTick);
+}
+
+/// Low part of the readout times within a pulse
+std::vector<uint32_t> readoutTicks() {
+  std::vector<uint32_t> Ticks(ReadoutsPerPacket);
+  for (int i = 0; i < ReadoutsPerPacket; i++) {
+    Ticks[i] = PulseTicks + i * 30011;
+  }
+  return Ticks;
+}
+} // namespace
+
+static void TicksToNSDouble(benchmark::State &state) {
+  auto Ticks = readoutTicks();
+  for (auto _ : state) {
+    for (auto Low : Ticks) {
+      benchmark::DoNotOptimize(doubleToNS(100, Low));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * Ticks.size());
+}
+BENCHMARK(TicksToNSDouble);
+
+static void TicksToNSInteger(benchmark::State &state) {
+  auto Ticks = readoutTicks();
+  for (auto _ : state) {
+    for (auto Low : Ticks) {
+      benchmark::DoNotOptimize(ESSTime::toNS(100, Low));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * Ticks.size());
+}
+BENCHMARK(TicksToNSInteger);
+
+static void SetReferenceEveryPacket(benchmark::State &state) {
+  ESSReferenceTime Time;
+  uint32_t Pulse{0};
+  for (auto _ : state) {
+    for (int i = 0; i < PacketsPerPulse; i++) {
+      Time.setReference(ESSTime(Pulse, PulseTicks));
+      Time.setPrevReference(ESSTime(Pulse - 1, PulseTicks));
+      benchmark::DoNotOptimize(Time.getRefTimeUInt64());
+    }
+    Pulse++;
+  }
+  state.SetItemsProcessed(state.iterations() * PacketsPerPulse);
+}
+BENCHMARK(SetReferenceEveryPacket);
+
+static void SetReferencesCached(benchmark::State &state) {
+  ESSReferenceTime Time;
+  uint32_t Pulse{0};
+  for (auto _ : state) {
+    for (int i = 0; i < PacketsPerPulse; i++) {
+      Time.setReferences(ESSTime(Pulse, PulseTicks),
+                         ESSTime(Pulse - 1, PulseTicks));
+      benchmark::DoNotOptimize(Time.getRefTimeUInt64());
+    }
+    Pulse++;
+  }
+  state.SetItemsProcessed(state.iterations() * PacketsPerPulse);
+}
+BENCHMARK(SetReferencesCached);
+
+static void PacketTOF(benchmark::State &state) {
+  ESSReferenceTime Time;
+  auto Ticks = readoutTicks();
+  uint32_t Pulse{1};
+  for (auto _ : state) {
+    Time.setReferences(ESSTime(Pulse, 0), ESSTime(Pulse - 1, PulseTicks));
+    for (auto Low : Ticks) {
+      benchmark::DoNotOptimize(Time.getTOF(ESSTime(Pulse, Low)));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * Ticks.size());
+}
+BENCHMARK(PacketTOF);
+
+static void PacketTOFBatch(benchmark::State &state) {
+  ESSReferenceTime Time;
+  auto Ticks = readoutTicks();
+  TOFBatch Batch;
+  uint32_t Pulse{1};
+  for (auto _ : state) {
+    Time.setReferences(ESSTime(Pulse, 0), ESSTime(Pulse - 1, PulseTicks));
+    Batch.clear();
+    for (auto Low : Ticks) {
+      Batch.add(Pulse, Low);
+    }
+    benchmark::DoNotOptimize(Batch.calculate(Time));
+  }
+  state.SetItemsProcessed(state.iterations() * Ticks.size());
+}
+BENCHMARK(PacketTOFBatch);
+
+BENCHMARK_MAIN();
@@ -228,6 +228,104 @@ TEST_F(ESSTimeTest, ESSTimeIncreasedNanosecDuration) {
   EXPECT_EQ(testTime.getTimeLow(), 1);
 }
 
+TEST_F(ESSTimeTest, TicksToNSMatchesClockTick) {
+  for (uint32_t Low = 0; Low <= 88052499; Low += 997) {
+    ASSERT_EQ(ESSTime::ticksToNS(Low), (uint64_t)(Low * ESSTime::ESSClockTick));
+  }
+  ASSERT_EQ(ESSTime::ticksToNS(35221), 400000);
+  ASSERT_EQ(ESSTime::ticksToNS(88052499), 999999988);
+}
+
+TEST_F(ESSTimeTest, SetReferencesCached) {
+  ASSERT_TRUE(Time.setReferences(ESSTime(100, 1000), ESSTime(100, 0)));
+  ASSERT_FALSE(Time.setReferences(ESSTime(100, 1000), ESSTime(100, 0)));
+  ASSERT_EQ(Time.getRefTimeNS(), ESSTime(100, 1000).toNS());
+  ASSERT_EQ(Time.getPrevRefTimeNS(), ESSTime(100, 0).toNS());
+  ASSERT_EQ(Time.getTOF(ESSTime(100, 1000)), 0);
+
+  // individual setters keep the cache consistent
+  Time.setReference(ESSTime(200, 0));
+  ASSERT_TRUE(Time.setReferences(ESSTime(100, 1000), ESSTime(100, 0)));
+  ASSERT_EQ(Time.getRefTimeNS(), ESSTime(100, 1000).toNS());
+  ASSERT_TRUE(Time.setReferences(ESSTime(100, 1000), ESSTime(100, 1)));
+  ASSERT_EQ(Time.getPrevRefTimeNS(), ESSTime(100, 1).toNS());
+}
+
+TEST_F(ESSTimeTest, MaxTOFLimitAfterReferenceChange) {
+  Time.setMaxTOF(1000);
+  Time.setReferences(ESSTime(100, 0), ESSTime(99, 0));
+  ASSERT_EQ(Time.getTOF(ESSTime(100, 88)), 999);
+  ASSERT_EQ(Time.getTOF(ESSTime(100, 89)), Time.InvalidTOF);
+  Time.setReferences(ESSTime(101, 0), ESSTime(100, 0));
+  ASSERT_EQ(Time.getTOF(ESSTime(101, 88)), 999);
+  ASSERT_EQ(Time.getTOF(ESSTime(100, 88)), 999);
+
+  Time.setMaxTOF(0xffffffffffffffff);
+  ASSERT_EQ(Time.getTOF(ESSTime(200, 0)), 99000000000);
+}
+
+TEST_F(ESSTimeTest, BatchTOFMatchesGetTOF) {
+  std::vector<uint32_t> High;
+  std::vector<uint32_t> Low;
+  uint32_t Seed{12345};
+  for (int i = 0; i < 1003; i++) {
+    Seed = Seed * 1103515245 + 12345;
+    High.push_back(99 + (Seed >> 8) % 4);
+    Low.push_back((Seed >> 4) % 88052500);
+  }
+  Low[17] = 88052500; // beyond the ESS clock, handled by the scalar code
+  Low[18] = 0xffffffff;
+
+  for (uint32_t Delay : {0U, 1000000U}) {
+    for (uint64_t MaxTOF : {(uint64_t)2147483647, (uint64_t)500000000,
+                            (uint64_t)0xffffffffffffffff}) {
+      ESSReferenceTime Single;
+      ESSReferenceTime Batch;
+      for (auto Ref : {&Single, &Batch}) {
+        Ref->setMaxTOF(MaxTOF);
+        Ref->setReferences(ESSTime(100, 1000000), ESSTime(99, 80000000));
+      }
+
+      std::vector<uint64_t> TOF(High.size());
+      size_t ValidCount = Batch.getTOFs(High, Low, TOF, Delay);
+
+      size_t Expected{0};
+      for (size_t i = 0; i < High.size(); i++) {
+        uint64_t SingleTOF = Single.getTOF(ESSTime(High[i], Low[i]), Delay);
+        ASSERT_EQ(TOF[i], SingleTOF) << "index " << i;
+        Expected += (SingleTOF != Single.InvalidTOF);
+      }
+      ASSERT_EQ(ValidCount, Expected);
+      ASSERT_EQ(Batch.Stats.TofCount, Single.Stats.TofCount);
+      ASSERT_EQ(Batch.Stats.TofNegative, Single.Stats.TofNegative);
+      ASSERT_EQ(Batch.Stats.TofHigh, Single.Stats.TofHigh);
+      ASSERT_EQ(Batch.Stats.PrevTofCount, Single.Stats.PrevTofCount);
+      ASSERT_EQ(Batch.Stats.PrevTofNegative, Single.Stats.PrevTofNegative);
+      ASSERT_EQ(Batch.Stats.PrevTofHigh, Single.Stats.PrevTofHigh);
+    }
+  }
+}
+
+TEST_F(ESSTimeTest, TOFBatch) {
+  Time.setReferences(ESSTime(100, 0), ESSTime(99, 0));
+  TOFBatch Batch;
+  Batch.add(100, 1);
+  Batch.add(99, 2);
+  Batch.add(98, 0);
+  ASSERT_EQ(Batch.calculate(Time), 2);
+  ASSERT_EQ(Batch.Count, 3);
+  ASSERT_EQ(Batch.TOF[0], 11);
+  ASSERT_EQ(Batch.TOF[1], 22);
+  ASSERT_EQ(Batch.TOF[2], Time.InvalidTOF);
+  Batch.clear();
+  ASSERT_EQ(Batch.calculate(Time), 0);
+  for (int i = 0; i < 1000; i++) {
+    Batch.add(100, 1);
+  }
+  ASSERT_EQ(Batch.calculate(Time), 1000);
+  ASSERT_EQ(Batch.TOF[999], 11);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
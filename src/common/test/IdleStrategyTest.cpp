@@ -0,0 +1,81 @@
+// Copyright (C) 2024 European Spallation Source ERIC
+
+#include <common/memory/PacketQueue.h>
+#include <common/system/IdleStrategy.h>
+#include <common/testutils/TestBase.h>
+#include <thread>
+
+class IdleStrategyTest : public TestBase {
+protected:
+  void SetUp() override {}
+  void TearDown() override {}
+
+  PacketQueue<100> Queue{4};
+};
+
+// Test cases below
+TEST_F(IdleStrategyTest, Constructor) {
+  IdleStrategy Idle(10, 10, 100);
+  ASSERT_EQ(Idle.Stats.SpinNs, 0);
+  ASSERT_EQ(Idle.Stats.YieldNs, 0);
+  ASSERT_EQ(Idle.Stats.WaitNs, 0);
+  ASSERT_EQ(Idle.Stats.Waits, 0);
+}
+
+TEST_F(IdleStrategyTest, SpinOnly) {
+  IdleStrategy Idle(10, 10, 100);
+  for (int i = 0; i < 5; i++) {
+    Idle.idle(Queue);
+  }
+  Idle.reset();
+  ASSERT_GE(Idle.Stats.SpinNs, 0);
+  ASSERT_EQ(Idle.Stats.YieldNs, 0);
+  ASSERT_EQ(Idle.Stats.Waits, 0);
+}
+
+TEST_F(IdleStrategyTest, EscalateToWait) {
+  IdleStrategy Idle(10, 10, 1000);
+  for (int i = 0; i < 25; i++) {
+    Idle.idle(Queue);
+  }
+  ASSERT_EQ(Idle.Stats.Waits, 5);
+  ASSERT_EQ(Idle.Stats.WaitWakeups, 0);
+  ASSERT_GT(Idle.Stats.WaitNs, 0);
+  ASSERT_GE(Idle.Stats.YieldNs, 0);
+
+  // Escalation starts over after reset()
+  Idle.reset();
+  for (int i = 0; i < 20; i++) {
+    Idle.idle(Queue);
+  }
+  ASSERT_EQ(Idle.Stats.Waits, 5);
+}
+
+TEST_F(IdleStrategyTest, NoSpinNoYield) {
+  IdleStrategy Idle(0, 0, 100);
+  Idle.idle(Queue);
+  ASSERT_EQ(Idle.Stats.Waits, 1);
+  Idle.reset();
+  Idle.idle(Queue);
+  ASSERT_EQ(Idle.Stats.Waits, 2);
+}
+
+TEST_F(IdleStrategyTest, WaitWokenByPush) {
+  IdleStrategy Idle(0, 0, 10000000);
+  std::thread Producer([this]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    Queue.push();
+  });
+  while (Idle.Stats.WaitWakeups == 0) {
+    Idle.idle(Queue);
+  }
+  Producer.join();
+  ASSERT_LT(Idle.Stats.WaitNs, 5000000000);
+  unsigned int Index;
+  ASSERT_TRUE(Queue.pop(Index));
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
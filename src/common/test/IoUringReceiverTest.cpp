@@ -0,0 +1,87 @@
+// Copyright (C) 2024 European Spallation Source, ERIC. See LICENSE file
+
+#include <common/system/IoUringReceiver.h>
+#include <common/testutils/TestBase.h>
+#include <cstring>
+
+class IoUringReceiverTest : public TestBase {
+protected:
+  Socket::Endpoint Local{"127.0.0.1", 13244};
+  static constexpr int BufferSize{9000};
+  char Buffers[4][BufferSize];
+};
+
+TEST_F(IoUringReceiverTest, ReceiveIntoProvidedBuffers) {
+  IoUringReceiver Receiver(Local);
+  if (not Receiver.setup(4)) {
+    GTEST_SKIP() << "io_uring not available";
+  }
+  for (unsigned int i = 0; i < 4; i++) {
+    Receiver.provideBuffer(Buffers[i], BufferSize, i);
+  }
+  Receiver.commitBuffers();
+  ASSERT_TRUE(Receiver.armReceive());
+
+  UDPTransmitter Transmitter(Socket::Endpoint("127.0.0.1", 0), Local);
+  char TxData[3]{0x01, 0x02, 0x03};
+  for (int i = 1; i <= 3; i++) {
+    ASSERT_EQ(Transmitter.send(TxData, i), i);
+  }
+
+  IoUringReceiver::Completion Completions[4];
+  int Received{0};
+  while (Received < 3) {
+    int Count = Receiver.waitCompletions(Completions + Received,
+                                         4 - Received, 100000);
+    ASSERT_GT(Count, 0);
+    Received += Count;
+  }
+
+  // Buffers are consumed in the order they were provided
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(Completions[i].Result, i + 1);
+    ASSERT_EQ(Completions[i].BufferId, (unsigned int)i);
+    ASSERT_EQ(memcmp(Buffers[i], TxData, i + 1), 0);
+  }
+  ASSERT_TRUE(Receiver.isArmed());
+
+  // Nothing more to receive
+  ASSERT_EQ(Receiver.waitCompletions(Completions, 4, 10000), 0);
+}
+
+TEST_F(IoUringReceiverTest, OutOfBuffersAndRearm) {
+  IoUringReceiver Receiver(Local);
+  if (not Receiver.setup(1)) {
+    GTEST_SKIP() << "io_uring not available";
+  }
+  Receiver.provideBuffer(Buffers[0], BufferSize, 0);
+  Receiver.commitBuffers();
+  ASSERT_TRUE(Receiver.armReceive());
+
+  UDPTransmitter Transmitter(Socket::Endpoint("127.0.0.1", 0), Local);
+  char TxData[2]{0x01, 0x02};
+  ASSERT_EQ(Transmitter.send(TxData, 1), 1);
+  ASSERT_EQ(Transmitter.send(TxData, 2), 2);
+
+  IoUringReceiver::Completion Completions[4];
+  int Count{0};
+  while ((Count == 0) or Receiver.isArmed()) {
+    Count += Receiver.waitCompletions(Completions + Count, 4 - Count, 100000);
+  }
+  ASSERT_EQ(Completions[0].Result, 1);
+  ASSERT_EQ(Completions[0].BufferId, 0U);
+  ASSERT_EQ(Completions[Count - 1].BufferId, IoUringReceiver::NoBuffer);
+
+  // Second datagram is still queued on the socket
+  Receiver.provideBuffer(Buffers[1], BufferSize, 1);
+  Receiver.commitBuffers();
+  ASSERT_TRUE(Receiver.armReceive());
+  ASSERT_GE(Receiver.waitCompletions(Completions, 4, 100000), 1);
+  ASSERT_EQ(Completions[0].Result, 2);
+  ASSERT_EQ(Completions[0].BufferId, 1U);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
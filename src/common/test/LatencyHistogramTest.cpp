@@ -0,0 +1,88 @@
+// Copyright (C) 2024 European Spallation Source ERIC
+
+#include <common/testutils/TestBase.h>
+#include <common/time/LatencyHistogram.h>
+#include <common/time/ProcessingLatency.h>
+
+class LatencyHistogramTest : public TestBase {
+protected:
+  void SetUp() override {}
+  void TearDown() override {}
+
+  LatencyHistogram Histogram;
+};
+
+// Test cases below
+TEST_F(LatencyHistogramTest, Bins) {
+  for (uint64_t Ns = 0; Ns < 4; Ns++) {
+    ASSERT_EQ(LatencyHistogram::bin(Ns), Ns);
+  }
+  int Previous = LatencyHistogram::bin(3);
+  for (uint64_t Ns = 4; Ns < 100000; Ns++) {
+    int Bin = LatencyHistogram::bin(Ns);
+    ASSERT_GE(Bin, Previous);
+    ASSERT_LE(Bin, Previous + 1);
+    ASSERT_GE(Ns, LatencyHistogram::binStart(Bin));
+    ASSERT_LT(Ns, LatencyHistogram::binStart(Bin + 1));
+    Previous = Bin;
+  }
+  ASSERT_EQ(LatencyHistogram::bin(1ULL << 50), LatencyHistogram::Bins - 1);
+}
+
+TEST_F(LatencyHistogramTest, Empty) {
+  ASSERT_EQ(Histogram.percentile(0.5), 0);
+  Histogram.update();
+  ASSERT_EQ(Histogram.Stats.Count, 0);
+  ASSERT_EQ(Histogram.Stats.P99, 0);
+  ASSERT_EQ(Histogram.Stats.Max, 0);
+}
+
+TEST_F(LatencyHistogramTest, Percentiles) {
+  for (int i = 1; i <= 1000; i++) {
+    Histogram.add(i * 1000);
+  }
+  Histogram.update();
+  ASSERT_EQ(Histogram.Stats.Count, 1000);
+  ASSERT_EQ(Histogram.Stats.Max, 1000000);
+  // Within the 25% bin width
+  ASSERT_GE(Histogram.Stats.P50, 500000);
+  ASSERT_LE(Histogram.Stats.P50, 625000);
+  ASSERT_GE(Histogram.Stats.P90, 900000);
+  ASSERT_LE(Histogram.Stats.P99, 1000000);
+  ASSERT_GE(Histogram.Stats.P99, Histogram.Stats.P90);
+  ASSERT_GE(Histogram.Stats.P999, Histogram.Stats.P99);
+}
+
+TEST_F(LatencyHistogramTest, UpdateStartsNewInterval) {
+  Histogram.add(1000000);
+  Histogram.add(-5);
+  Histogram.update();
+  ASSERT_EQ(Histogram.Stats.Count, 2);
+  ASSERT_EQ(Histogram.Stats.Max, 1000000);
+  ASSERT_EQ(Histogram.Stats.P50, 0);
+
+  Histogram.add(100);
+  Histogram.update();
+  ASSERT_EQ(Histogram.Stats.Count, 3);
+  ASSERT_EQ(Histogram.Stats.Max, 100);
+  ASSERT_EQ(Histogram.Stats.P999, 100);
+}
+
+TEST_F(LatencyHistogramTest, ProcessingStages) {
+  ProcessingLatency Latency;
+  Latency.dequeued(0); // unknown arrival time is not counted
+  Latency.parsed();
+  Latency.serialized();
+  Latency.dequeued(ProcessingLatency::realtimeNs() - 1000000);
+  Latency.update();
+  ASSERT_EQ(Latency.ArrivalDequeue.Stats.Count, 1);
+  ASSERT_GE(Latency.ArrivalDequeue.Stats.Max, 1000000);
+  ASSERT_EQ(Latency.DequeueParsed.Stats.Count, 1);
+  ASSERT_EQ(Latency.ParsedSerialized.Stats.Count, 1);
+  ASSERT_EQ(Latency.SerializedDelivered.Stats.Count, 0);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
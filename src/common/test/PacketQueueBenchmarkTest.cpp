@@ -0,0 +1,130 @@
+// Copyright (C) 2024 European Spallation Source ERIC
+
+/// \file
+/// \brief Compare the PacketQueue against the RingBuffer + CircularFifo pair
+/// it replaces. Packets are written, queued, dequeued and read back in
+/// bursts from a single thread, and streamed between two threads.
+
+#include <benchmark/benchmark.h>
+#include <common/memory/PacketQueue.h>
+#include <common/memory/RingBuffer.h>
+#include <common/memory/SPSCFifo.h>
+#include <memory>
+#include <thread>
+
+namespace {
+constexpr int Entries{2000};
+constexpr int BufferSize{9000};
+constexpr int PacketSize{64};
+constexpr int64_t ThreadedPackets{100000};
+
+using Fifo = memory_sequential_consistent::CircularFifo<unsigned int, Entries>;
+} // namespace
+
+static void RingBufferFifoBurst(benchmark::State &state) {
+  auto Ring = std::make_unique<RingBuffer<BufferSize>>(Entries + 11);
+  auto InputFifo = std::make_unique<Fifo>();
+  int Burst = state.range(0);
+  int64_t Items{0};
+
+  for (auto _ : state) {
+    for (int i = 0; i < Burst; i++) {
+      unsigned int Index = Ring->getDataIndex();
+      Ring->getDataBuffer(Index)[0] = i;
+      Ring->setDataLength(Index, PacketSize);
+      InputFifo->push(Index);
+      Ring->getNextBuffer();
+    }
+    unsigned int Index;
+    while (InputFifo->pop(Index)) {
+      benchmark::DoNotOptimize(Ring->getDataBuffer(Index)[0]);
+      benchmark::DoNotOptimize(Ring->getDataLength(Index));
+      Items++;
+    }
+  }
+  state.SetItemsProcessed(Items);
+}
+BENCHMARK(RingBufferFifoBurst)->Arg(1)->Arg(64);
+
+static void PacketQueueBurst(benchmark::State &state) {
+  auto Queue = std::make_unique<PacketQueue<BufferSize>>(Entries);
+  int Burst = state.range(0);
+  int64_t Items{0};
+
+  for (auto _ : state) {
+    for (int i = 0; i < Burst; i++) {
+      Queue->writable();
+      unsigned int Index = Queue->getWriteIndex();
+      Queue->getDataBuffer(Index)[0] = i;
+      Queue->setDataLength(Index, PacketSize);
+      Queue->push();
+    }
+    unsigned int Index;
+    while (Queue->pop(Index)) {
+      benchmark::DoNotOptimize(Queue->getDataBuffer(Index)[0]);
+      benchmark::DoNotOptimize(Queue->getDataLength(Index));
+      Items++;
+    }
+  }
+  state.SetItemsProcessed(Items);
+}
+BENCHMARK(PacketQueueBurst)->Arg(1)->Arg(64);
+
+static void RingBufferFifoThreaded(benchmark::State &state) {
+  auto Ring = std::make_unique<RingBuffer<BufferSize>>(Entries + 11);
+  auto InputFifo = std::make_unique<Fifo>();
+
+  for (auto _ : state) {
+    std::thread Consumer([&]() {
+      unsigned int Index;
+      for (int64_t i = 0; i < ThreadedPackets; i++) {
+        while (not InputFifo->pop(Index)) {
+          std::this_thread::yield();
+        }
+        benchmark::DoNotOptimize(Ring->getDataBuffer(Index)[0]);
+      }
+    });
+    for (int64_t i = 0; i < ThreadedPackets; i++) {
+      unsigned int Index = Ring->getDataIndex();
+      Ring->getDataBuffer(Index)[0] = i;
+      Ring->setDataLength(Index, PacketSize);
+      while (not InputFifo->push(Index)) {
+        std::this_thread::yield();
+      }
+      Ring->getNextBuffer();
+    }
+    Consumer.join();
+  }
+  state.SetItemsProcessed(state.iterations() * ThreadedPackets);
+}
+BENCHMARK(RingBufferFifoThreaded)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void PacketQueueThreaded(benchmark::State &state) {
+  auto Queue = std::make_unique<PacketQueue<BufferSize>>(Entries);
+
+  for (auto _ : state) {
+    std::thread Consumer([&]() {
+      unsigned int Index;
+      for (int64_t i = 0; i < ThreadedPackets; i++) {
+        while (not Queue->pop(Index)) {
+          std::this_thread::yield();
+        }
+        benchmark::DoNotOptimize(Queue->getDataBuffer(Index)[0]);
+      }
+    });
+    for (int64_t i = 0; i < ThreadedPackets; i++) {
+      while (Queue->writable() == 0) {
+        std::this_thread::yield();
+      }
+      unsigned int Index = Queue->getWriteIndex();
+      Queue->getDataBuffer(Index)[0] = i;
+      Queue->setDataLength(Index, PacketSize);
+      Queue->push();
+    }
+    Consumer.join();
+  }
+  state.SetItemsProcessed(state.iterations() * ThreadedPackets);
+}
+BENCHMARK(PacketQueueThreaded)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,189 @@
+// Copyright (C) 2024 European Spallation Source ERIC
+
+#include <common/memory/PacketQueue.h>
+#include <common/testutils/TestBase.h>
+#include <chrono>
+#include <thread>
+
+class PacketQueueTest : public TestBase {
+protected:
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+// Test cases below
+TEST_F(PacketQueueTest, Constructor) {
+  PacketQueue<9000> Queue(100);
+  ASSERT_EQ(Queue.getMaxElements(), 128);
+  ASSERT_EQ(Queue.getMaxBufSize(), 9000);
+  ASSERT_EQ(Queue.writable(1000), 128);
+  ASSERT_TRUE(Queue.wasEmpty());
+}
+
+TEST_F(PacketQueueTest, Allocation) {
+  PacketQueue<9000> Queue(300);
+  auto Bytes = Queue.getAllocatedBytes();
+  ASSERT_GE(Bytes, 512 * sizeof(PacketQueue<9000>::Slot));
+  ASSERT_EQ(Bytes % PacketQueue<9000>::HugePageSize, 0);
+  ASSERT_EQ((uintptr_t)Queue.getDataBuffer(0) % 64, 0);
+  ASSERT_EQ(Queue.getDataLength(511), 0);
+  GTEST_COUT << "Backing " << Queue.getBacking() << ", locked "
+             << Queue.isLocked() << "\n";
+}
+
+TEST_F(PacketQueueTest, BindToNode) {
+  PacketQueue<9000> Queue(300);
+  ASSERT_FALSE(Queue.bindToNode(-1));
+  ASSERT_FALSE(Queue.bindToNode(64));
+  GTEST_COUT << "Bind to node 0: " << Queue.bindToNode(0) << "\n";
+  Queue.setDataLength(0, 42);
+  ASSERT_EQ(Queue.getDataLength(0), 42);
+}
+
+TEST_F(PacketQueueTest, PushPop) {
+  PacketQueue<100> Queue(4);
+  unsigned int Index;
+  ASSERT_FALSE(Queue.pop(Index));
+
+  unsigned int WriteIndex = Queue.getWriteIndex();
+  ASSERT_EQ(WriteIndex, 0);
+  Queue.setDataLength(WriteIndex, 42);
+  Queue.getDataBuffer(WriteIndex)[0] = 'x';
+  Queue.push();
+  ASSERT_FALSE(Queue.wasEmpty());
+
+  ASSERT_TRUE(Queue.pop(Index));
+  ASSERT_EQ(Index, 0);
+  ASSERT_EQ(Queue.getDataLength(Index), 42);
+  ASSERT_EQ(Queue.getDataBuffer(Index)[0], 'x');
+  ASSERT_FALSE(Queue.pop(Index));
+  ASSERT_TRUE(Queue.wasEmpty());
+}
+
+TEST_F(PacketQueueTest, FullAndWrap) {
+  PacketQueue<100> Queue(4);
+  unsigned int Index;
+  for (int Round = 0; Round < 3; Round++) {
+    ASSERT_EQ(Queue.writable(8), 4);
+    for (unsigned int i = 0; i < 4; i++) {
+      Queue.setDataLength(Queue.getWriteIndex(i), Round * 4 + i);
+    }
+    Queue.push(4);
+    ASSERT_EQ(Queue.writable(), 0);
+
+    for (int i = 0; i < 4; i++) {
+      ASSERT_TRUE(Queue.pop(Index));
+      ASSERT_EQ(Index, i);
+      ASSERT_EQ(Queue.getDataLength(Index), Round * 4 + i);
+    }
+    ASSERT_FALSE(Queue.pop(Index));
+  }
+}
+
+TEST_F(PacketQueueTest, Occupancy) {
+  PacketQueue<100> Queue(4);
+  unsigned int Index;
+  ASSERT_EQ(Queue.occupancy(), 0);
+  Queue.push(3);
+  ASSERT_EQ(Queue.occupancy(), 3);
+  ASSERT_TRUE(Queue.pop(Index));
+  ASSERT_EQ(Queue.occupancy(), 3); // popped slot not yet released
+  ASSERT_TRUE(Queue.pop(Index));
+  ASSERT_EQ(Queue.occupancy(), 2);
+}
+
+TEST_F(PacketQueueTest, PoppedSlotHeldUntilNextPop) {
+  PacketQueue<100> Queue(2);
+  unsigned int Index;
+  Queue.push(2);
+
+  ASSERT_TRUE(Queue.pop(Index));
+  ASSERT_EQ(Queue.writable(), 0);
+  ASSERT_TRUE(Queue.pop(Index));
+  ASSERT_EQ(Queue.writable(2), 1);
+  ASSERT_EQ(Queue.getWriteIndex(), 0);
+  ASSERT_FALSE(Queue.pop(Index));
+  ASSERT_EQ(Queue.writable(2), 2);
+}
+
+TEST_F(PacketQueueTest, HeldSlotBlocksRelease) {
+  PacketQueue<100> Queue(4);
+  unsigned int Index;
+  Queue.push(4);
+
+  ASSERT_TRUE(Queue.pop(Index));
+  ASSERT_EQ(Index, 0);
+  Queue.hold(Index);
+  ASSERT_TRUE(Queue.pop(Index));
+  ASSERT_TRUE(Queue.pop(Index));
+  ASSERT_EQ(Queue.writable(4), 0);
+
+  Queue.release(0);
+  ASSERT_TRUE(Queue.pop(Index));
+  ASSERT_EQ(Index, 3);
+  ASSERT_EQ(Queue.writable(4), 3);
+  ASSERT_FALSE(Queue.pop(Index));
+  ASSERT_EQ(Queue.writable(4), 4);
+}
+
+TEST_F(PacketQueueTest, ProducerConsumerThreads) {
+  PacketQueue<100> Queue(16);
+  const int Packets{100000};
+
+  std::thread Producer([&Queue]() {
+    for (int i = 0; i < Packets; i++) {
+      while (Queue.writable() == 0) {
+        std::this_thread::yield();
+      }
+      unsigned int Index = Queue.getWriteIndex();
+      *(int *)Queue.getDataBuffer(Index) = i;
+      Queue.setDataLength(Index, sizeof(int));
+      Queue.push();
+    }
+  });
+
+  unsigned int Index;
+  for (int i = 0; i < Packets; i++) {
+    while (not Queue.pop(Index)) {
+      std::this_thread::yield();
+    }
+    ASSERT_EQ(Queue.getDataLength(Index), sizeof(int));
+    ASSERT_EQ(*(int *)Queue.getDataBuffer(Index), i);
+  }
+  Producer.join();
+  ASSERT_FALSE(Queue.pop(Index));
+}
+
+TEST_F(PacketQueueTest, WaitForDataTimeout) {
+  PacketQueue<100> Queue(4);
+  auto Start = std::chrono::steady_clock::now();
+  ASSERT_FALSE(Queue.waitForData(20000));
+  auto Elapsed = std::chrono::steady_clock::now() - Start;
+  ASSERT_GE(Elapsed, std::chrono::milliseconds(15));
+
+  Queue.push();
+  ASSERT_TRUE(Queue.readable());
+  ASSERT_TRUE(Queue.waitForData(1000000));
+}
+
+TEST_F(PacketQueueTest, WaitForDataWokenByPush) {
+  PacketQueue<100> Queue(4);
+  std::thread Producer([&Queue]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    Queue.push();
+  });
+
+  auto Start = std::chrono::steady_clock::now();
+  while (not Queue.waitForData(5000000)) {
+  }
+  auto Elapsed = std::chrono::steady_clock::now() - Start;
+  Producer.join();
+  ASSERT_LT(Elapsed, std::chrono::seconds(2));
+  unsigned int Index;
+  ASSERT_TRUE(Queue.pop(Index));
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
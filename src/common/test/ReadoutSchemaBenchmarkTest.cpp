@@ -0,0 +1,105 @@
+// Copyright (C) 2024 European Spallation Source ERIC
+
+/// \file
+/// \brief Parsing cost per readout for a readout schema with the checks of
+/// a typical detector readout: fiber and FEN ranges in the header, range
+/// checks and a function check in the body. Packets hold valid readouts
+/// only, so every check of the schema is evaluated.
+
+#include <benchmark/benchmark.h>
+#include <common/readout/ess/ReadoutSchema.h>
+#include <vector>
+
+using namespace ESSReadout::Schema;
+
+namespace {
+constexpr unsigned int ReadoutsPerPacket{400};
+
+struct BenchReadout {
+  uint8_t FiberId;
+  uint8_t FENId;
+  uint16_t DataLength;
+  uint32_t TimeHigh;
+  uint32_t TimeLow;
+  uint8_t Flags;
+  uint8_t Group;
+  uint16_t Unused;
+  int16_t AmpA;
+  int16_t AmpB;
+  int16_t AmpC;
+  int16_t AmpD;
+} __attribute__((__packed__));
+
+struct BenchStats {
+  int64_t HeaderSizeErrors{0};
+  int64_t BufferErrors{0};
+  int64_t DataHeaders{0};
+  int64_t DataLenErrors{0};
+  int64_t Readouts{0};
+  int64_t FiberErrors{0};
+  int64_t FENErrors{0};
+  int64_t GroupErrors{0};
+  int64_t AmplitudeErrors{0};
+};
+
+bool amplitudeSet(const BenchReadout &Readout) {
+  return (Readout.AmpA | Readout.AmpB | Readout.AmpC | Readout.AmpD) != 0;
+}
+
+struct BenchSchema {
+  using Readout = BenchReadout;
+  using Stats = BenchStats;
+
+  using Header = Fields<Range<&Readout::FiberId, 0, 23, &Stats::FiberErrors>,
+                        Range<&Readout::FENId, 0, 23, &Stats::FENErrors>>;
+  using Body = Fields<Range<&Readout::Group, 0, 14, &Stats::GroupErrors>,
+                      Check<&amplitudeSet, &Stats::AmplitudeErrors>>;
+
+  static constexpr auto HeaderSizeErrors{&Stats::HeaderSizeErrors};
+  static constexpr auto BufferErrors{&Stats::BufferErrors};
+  static constexpr auto DataHeaders{&Stats::DataHeaders};
+  static constexpr auto DataLenErrors{&Stats::DataLenErrors};
+  static constexpr auto Readouts{&Stats::Readouts};
+};
+
+std::vector<BenchReadout> makePacket() {
+  auto Readout = validReadout<BenchSchema>();
+  Readout.AmpA = 100;
+  std::vector<BenchReadout> Packet(ReadoutsPerPacket, Readout);
+  for (unsigned int i = 0; i < ReadoutsPerPacket; i++) {
+    Packet[i].TimeLow = i * 1000;
+  }
+  return Packet;
+}
+} // namespace
+
+/// \brief readouts back to back, stopping at the first error
+static void ParseStream(benchmark::State &state) {
+  auto Packet = makePacket();
+  BenchStats Stats{};
+  unsigned int Size = Packet.size() * sizeof(BenchReadout);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        parseStream<BenchSchema>((const char *)Packet.data(), Size, Stats));
+  }
+  state.SetItemsProcessed(state.iterations() * Packet.size());
+}
+BENCHMARK(ParseStream);
+
+/// \brief readouts of fixed size, skipping invalid ones
+static void ParseFixed(benchmark::State &state) {
+  auto Packet = makePacket();
+  BenchStats Stats{};
+  for (auto _ : state) {
+    uint32_t Accepted{0};
+    parseFixed<BenchSchema>((const char *)Packet.data(), Packet.size(), Stats,
+                            [&](const BenchReadout &Readout) {
+                              Accepted += Readout.TimeLow;
+                            });
+    benchmark::DoNotOptimize(Accepted);
+  }
+  state.SetItemsProcessed(state.iterations() * Packet.size());
+}
+BENCHMARK(ParseFixed);
+
+BENCHMARK_MAIN();
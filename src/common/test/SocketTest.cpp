@@ -174,6 +174,157 @@ TEST_F(SocketTest, MultiCastSetReceive)
   ASSERT_NO_THROW(udpsocket.setLocalSocket("224.1.2.1", 9729));
 }
 
+TEST_F(SocketTest, ReceiveBatch)
+{
+  Socket::Endpoint local("127.0.0.1", 13242);
+  Socket::Endpoint remote("127.0.0.1", 13242);
+  UDPReceiver Receiver(local);
+  Receiver.setRecvTimeout(0, 100000);
+  UDPTransmitter Transmitter(Socket::Endpoint("127.0.0.1", 0), remote);
+
+  char TxData[3]{0x01, 0x02, 0x03};
+  for (int i = 1; i <= 3; i++) {
+    ASSERT_EQ(Transmitter.send(TxData, i), i);
+  }
+
+  char RxData[4][16];
+  char *Buffers[4] = {RxData[0], RxData[1], RxData[2], RxData[3]};
+  int Lengths[4]{0, 0, 0, 0};
+  int Received{0};
+  while (Received < 3) {
+    int Res = Receiver.receiveBatch(Buffers + Received, sizeof(RxData[0]),
+                                    Lengths + Received, 4 - Received);
+    ASSERT_GT(Res, 0);
+    Received += Res;
+  }
+  ASSERT_EQ(Received, 3);
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(Lengths[i], i + 1);
+    ASSERT_EQ(memcmp(RxData[i], TxData, i + 1), 0);
+  }
+
+  // Nothing left, times out
+  ASSERT_LT(Receiver.receiveBatch(Buffers, sizeof(RxData[0]), Lengths, 4), 0);
+}
+
+TEST_F(SocketTest, ReceiveScatterGRO)
+{
+  Socket::Endpoint local("127.0.0.1", 13243);
+  Socket::Endpoint remote("127.0.0.1", 13243);
+  UDPReceiver Receiver(local);
+  Receiver.setRecvTimeout(0, 100000);
+  Receiver.enableGRO();
+  UDPTransmitter Transmitter(Socket::Endpoint("127.0.0.1", 0), remote);
+
+  char TxData[30];
+  memset(TxData, 0x5a, sizeof(TxData));
+  ASSERT_EQ(Transmitter.send(TxData, sizeof(TxData)), sizeof(TxData));
+
+  // Single datagram scattered over three 16 byte buffers
+  char RxData[3][16];
+  char *Buffers[3] = {RxData[0], RxData[1], RxData[2]};
+  int SegmentSize{-1};
+  auto Res = Receiver.receiveScatter(Buffers, 16, 3, SegmentSize);
+  ASSERT_EQ(Res, sizeof(TxData));
+  ASSERT_EQ(SegmentSize, 0);
+  ASSERT_EQ(memcmp(RxData[0], TxData, 16), 0);
+  ASSERT_EQ(memcmp(RxData[1], TxData, 14), 0);
+
+  ASSERT_LT(Receiver.receiveScatter(Buffers, 16, 3, SegmentSize), 0);
+}
+
+TEST_F(SocketTest, ReusePort)
+{
+  Socket::Endpoint local("127.0.0.1", 13244);
+  UDPReceiver First(local, true);
+  UDPReceiver Second(local, true);
+  ASSERT_THROW(UDPReceiver Third(local), std::runtime_error);
+
+  // Packets from one source always go to the same socket
+  UDPTransmitter Transmitter(Socket::Endpoint("127.0.0.1", 0), local);
+  First.setRecvTimeout(0, 100000);
+  Second.setRecvTimeout(0, 100000);
+  char Data[4]{0x01, 0x02, 0x03, 0x04};
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ(Transmitter.send(Data, sizeof(Data)), sizeof(Data));
+  }
+  int FirstCount{0};
+  int SecondCount{0};
+  while (First.receive(Data, sizeof(Data)) > 0) {
+    FirstCount++;
+  }
+  while (Second.receive(Data, sizeof(Data)) > 0) {
+    SecondCount++;
+  }
+  ASSERT_EQ(FirstCount + SecondCount, 4);
+  ASSERT_TRUE((FirstCount == 0) or (SecondCount == 0));
+}
+
+TEST_F(SocketTest, ReceiveTimestamps)
+{
+  Socket::Endpoint local("127.0.0.1", 13245);
+  UDPReceiver Receiver(local);
+  Receiver.setRecvTimeout(0, 100000);
+  UDPTransmitter Transmitter(Socket::Endpoint("127.0.0.1", 0), local);
+  char Data[4]{0x01, 0x02, 0x03, 0x04};
+
+  // No timestamps until enabled
+  int64_t Timestamp{-1};
+  ASSERT_EQ(Transmitter.send(Data, sizeof(Data)), sizeof(Data));
+  ASSERT_EQ(Receiver.receive(Data, sizeof(Data), Timestamp), sizeof(Data));
+  ASSERT_EQ(Timestamp, 0);
+
+  ASSERT_TRUE(Receiver.enableTimestamps());
+  struct timespec Now;
+  clock_gettime(CLOCK_REALTIME, &Now);
+  int64_t Before = Now.tv_sec * 1000000000LL + Now.tv_nsec;
+  ASSERT_EQ(Transmitter.send(Data, sizeof(Data)), sizeof(Data));
+  ASSERT_EQ(Transmitter.send(Data, sizeof(Data)), sizeof(Data));
+  ASSERT_EQ(Receiver.receive(Data, sizeof(Data), Timestamp), sizeof(Data));
+  ASSERT_GE(Timestamp, Before);
+  ASSERT_LT(Timestamp - Before, 1000000000LL);
+
+  char *Buffers[1] = {Data};
+  int Lengths[1];
+  int64_t Timestamps[1]{0};
+  ASSERT_EQ(Receiver.receiveBatch(Buffers, sizeof(Data), Lengths, 1,
+                                  Timestamps), 1);
+  ASSERT_GE(Timestamps[0], Timestamp);
+
+  ASSERT_EQ(Transmitter.send(Data, sizeof(Data)), sizeof(Data));
+  int SegmentSize;
+  ASSERT_EQ(Receiver.receiveScatter(Buffers, sizeof(Data), 1, SegmentSize,
+                                    &Timestamp), sizeof(Data));
+  ASSERT_GE(Timestamp, Timestamps[0]);
+}
+
+TEST_F(SocketTest, KernelDrops)
+{
+  Socket::Endpoint local("127.0.0.1", 13246);
+  UDPReceiver Receiver(local);
+  Receiver.setBufferSizes(0, 4096);
+  Receiver.setRecvTimeout(0, 100000);
+  ASSERT_TRUE(Receiver.enableDropCount());
+  ASSERT_EQ(Receiver.getKernelDrops(), 0);
+  ASSERT_EQ(Receiver.readKernelDrops(), 0);
+
+  UDPTransmitter Transmitter(Socket::Endpoint("127.0.0.1", 0), local);
+  char Data[1000]{0};
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(Transmitter.send(Data, sizeof(Data)), sizeof(Data));
+  }
+
+  // The count is reported with the datagrams queued after the drops
+  ASSERT_EQ(Receiver.receive(Data, sizeof(Data)), sizeof(Data));
+  ASSERT_EQ(Transmitter.send(Data, sizeof(Data)), sizeof(Data));
+  int64_t Timestamp;
+  while (Receiver.receive(Data, sizeof(Data), Timestamp) > 0) {
+  }
+  uint32_t Drops = Receiver.getKernelDrops();
+  ASSERT_GT(Drops, 0);
+  ASSERT_EQ(Receiver.readKernelDrops(), Drops);
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,101 @@
+// Copyright (C) 2024 European Spallation Source ERIC
+
+/// \file
+/// \brief Compare packet rate of the blocking recv() loop against the
+/// io_uring multishot receiver on loopback. Each iteration sends a burst of
+/// datagrams and receives them again, the send cost is common to both.
+
+#include <benchmark/benchmark.h>
+#include <common/system/IoUringReceiver.h>
+#include <common/system/Socket.h>
+#include <vector>
+
+namespace {
+constexpr int BurstSize{64};
+constexpr int PacketSize{8972};
+constexpr int BufferSize{9000};
+constexpr int SocketBufferSize{4000000};
+
+void sendBurst(UDPTransmitter &Transmitter, char *Data) {
+  for (int i = 0; i < BurstSize; i++) {
+    Transmitter.send(Data, PacketSize);
+  }
+}
+} // namespace
+
+static void RecvLoop(benchmark::State &state) {
+  Socket::Endpoint Local("127.0.0.1", 9100);
+  UDPReceiver Receiver(Local);
+  Receiver.setBufferSizes(SocketBufferSize, SocketBufferSize);
+  Receiver.setRecvTimeout(0, 100000);
+  UDPTransmitter Transmitter(Socket::Endpoint("0.0.0.0", 0), Local);
+  Transmitter.setBufferSizes(SocketBufferSize, SocketBufferSize);
+
+  std::vector<char> Data(PacketSize);
+  std::vector<char> Buffer(BufferSize);
+  int64_t Items{0};
+  for (auto _ : state) {
+    sendBurst(Transmitter, Data.data());
+    for (int i = 0; i < BurstSize; i++) {
+      if (Receiver.receive(Buffer.data(), BufferSize) > 0) {
+        Items++;
+      }
+    }
+  }
+  state.SetItemsProcessed(Items);
+  state.SetBytesProcessed(Items * PacketSize);
+}
+BENCHMARK(RecvLoop);
+
+static void IoUringMultishot(benchmark::State &state) {
+  Socket::Endpoint Local("127.0.0.1", 9101);
+  IoUringReceiver Receiver(Local);
+  Receiver.setBufferSizes(SocketBufferSize, SocketBufferSize);
+  UDPTransmitter Transmitter(Socket::Endpoint("0.0.0.0", 0), Local);
+  Transmitter.setBufferSizes(SocketBufferSize, SocketBufferSize);
+
+  if (not Receiver.setup(BurstSize)) {
+    state.SkipWithError("io_uring not available");
+    return;
+  }
+  std::vector<char> Buffers(BurstSize * BufferSize);
+  for (unsigned int i = 0; i < BurstSize; i++) {
+    Receiver.provideBuffer(&Buffers[i * BufferSize], BufferSize, i);
+  }
+  Receiver.commitBuffers();
+  Receiver.armReceive();
+
+  std::vector<char> Data(PacketSize);
+  IoUringReceiver::Completion Completions[BurstSize];
+  int64_t Items{0};
+  for (auto _ : state) {
+    sendBurst(Transmitter, Data.data());
+    int Received{0};
+    while (Received < BurstSize) {
+      int Count = Receiver.waitCompletions(Completions, BurstSize, 100000);
+      if (Count == 0) {
+        break;
+      }
+      for (int i = 0; i < Count; i++) {
+        if (Completions[i].BufferId == IoUringReceiver::NoBuffer) {
+          continue;
+        }
+        if (Completions[i].Result > 0) {
+          Items++;
+        }
+        Received++;
+        unsigned int Id = Completions[i].BufferId;
+        Receiver.provideBuffer(&Buffers[Id * BufferSize], BufferSize, Id);
+      }
+      Receiver.commitBuffers();
+      if (not Receiver.isArmed()) {
+        Receiver.armReceive();
+      }
+    }
+  }
+  state.SetItemsProcessed(Items);
+  state.SetBytesProcessed(Items * PacketSize);
+}
+BENCHMARK(IoUringMultishot);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,43 @@
+// Copyright (C) 2024 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Tests generated from an ESS readout schema, shared by the tests
+/// of the parsers using ReadoutSchema.h
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <common/readout/ess/ReadoutSchema.h>
+#include <gtest/gtest.h>
+
+namespace ESSReadout {
+namespace Schema {
+
+/// \brief Parse must accept Good, and reject and count each copy of Good
+/// made invalid in one field of the schema
+/// \param Stats counters updated by Parse
+/// \param Parse called as Parse(Readout) for a single readout, returning
+/// the number of readouts accepted
+/// \param ExpectedFields number of fields of the schema that can be invalid
+template <typename Schema, typename ParseFn>
+void checkFieldErrors(const typename Schema::Readout &Good,
+                      const typename Schema::Stats &Stats, ParseFn &&Parse,
+                      int ExpectedFields) {
+  ASSERT_EQ(Parse(Good), 1);
+
+  int Fields{0};
+  auto Expect = [&](const typename Schema::Readout &Readout, auto Counter) {
+    auto Before = Stats.*Counter;
+    ASSERT_EQ(Parse(Readout), 0);
+    ASSERT_EQ(Stats.*Counter, Before + 1);
+    Fields++;
+  };
+  forEachInvalid<typename Schema::Header>(Good, Expect);
+  forEachInvalid<typename Schema::Body>(Good, Expect);
+  ASSERT_EQ(Fields, ExpectedFields);
+}
+
+} // namespace Schema
+} // namespace ESSReadout
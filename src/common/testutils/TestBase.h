@@ -22,16 +22,16 @@ template <typename T>
 void writePacketToRxFIFO(T & Base, std::vector<uint8_t> Packet) {
   Base.startThreads();
 
-  unsigned int rxBufferIndex = Base.RxRingbuffer.getDataIndex();
+  ASSERT_EQ(Base.InputQueue.writable(), 1);
+  unsigned int rxBufferIndex = Base.InputQueue.getWriteIndex();
   ASSERT_EQ(rxBufferIndex, 0);
   auto PacketSize = Packet.size();
 
-  Base.RxRingbuffer.setDataLength(rxBufferIndex, PacketSize);
-  auto DataPtr = Base.RxRingbuffer.getDataBuffer(rxBufferIndex);
+  Base.InputQueue.setDataLength(rxBufferIndex, PacketSize);
+  auto DataPtr = Base.InputQueue.getDataBuffer(rxBufferIndex);
   memcpy(DataPtr, (unsigned char *)&Packet[0], PacketSize);
 
-  ASSERT_TRUE(Base.InputFifo.push(rxBufferIndex));
-  Base.RxRingbuffer.getNextBuffer();
+  Base.InputQueue.push();
 
   while (Base.ITCounters.RxIdle == 0){
     usleep(100);
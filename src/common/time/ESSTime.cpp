@@ -12,21 +12,152 @@
 
 #include <common/time/ESSTime.h>
 #include <inttypes.h>
+#include <limits>
+
+#if defined(__x86_64__) and (defined(__GNUC__) or defined(__clang__))
+#define ESSTIME_AVX2
+#include <immintrin.h>
+#endif
 
 namespace esstime {
 
+#ifdef ESSTIME_AVX2
+namespace {
+/// Reference times and limits of getTOFs(), as signed values for the AVX2
+/// 64 bit compares. Event times are below 2^63 for any 32 bit TimeHigh.
+struct TOFLimits {
+  int64_t Ref;
+  int64_t RefLimit;
+  int64_t Prev;
+  int64_t PrevLimit;
+  int64_t Delay;
+};
+
+/// Number of readouts in each outcome of getTOF()
+struct TOFCounts {
+  int64_t Tof{0};
+  int64_t TofNegative{0};
+  int64_t TofHigh{0};
+  int64_t PrevTof{0};
+  int64_t PrevTofNegative{0};
+  int64_t PrevTofHigh{0};
+};
+
+/// \brief TOF of four event times per iteration. Blocks with a TimeLow
+/// beyond the ESS clock range are left for the scalar code, which handles
+/// them exactly as getTOF() does.
+/// \return number of leading event times processed
+__attribute__((target("avx2,popcnt"))) size_t
+tofBlocksAVX2(const uint32_t *TimeHigh, const uint32_t *TimeLow, size_t Count,
+              uint64_t *TOF, const TOFLimits &Limits,
+              TOFCounts &Counts) {
+  const __m128i MaxLow = _mm_set1_epi32(88052499);
+  const __m256d Tick = _mm256_set1_pd(ESSTime::ESSClockTick);
+  const __m256i SecNs = _mm256_set1_epi64x(ESSTime::SecInNs.count());
+  const __m256i Delay = _mm256_set1_epi64x(Limits.Delay);
+  const __m256i Ref = _mm256_set1_epi64x(Limits.Ref);
+  const __m256i RefLimit = _mm256_set1_epi64x(Limits.RefLimit);
+  const __m256i Prev = _mm256_set1_epi64x(Limits.Prev);
+  const __m256i PrevLimit = _mm256_set1_epi64x(Limits.PrevLimit);
+  const __m256i Ones = _mm256_set1_epi64x(-1);
+  // Local counts, TOF stores could otherwise alias them
+  int64_t Tof{0}, TofNegative{0}, TofHigh{0};
+  int64_t PrevTof{0}, PrevTofNegative{0}, PrevTofHigh{0};
+
+  size_t i = 0;
+  for (; i + 4 <= Count; i += 4) {
+    __m128i Low = _mm_loadu_si128((const __m128i *)(TimeLow + i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_max_epu32(Low, MaxLow),
+                                          MaxLow)) != 0xffff) {
+      break;
+    }
+    __m128i High = _mm_loadu_si128((const __m128i *)(TimeHigh + i));
+
+    // Truncated double product Low * ESSClockTick. For all Low up to
+    // 88052499 (checked above) its rounding error is smaller than the
+    // distance to the next integer, so the result is that of the integer
+    // Low * 400000 / 35221 in ESSTime::ticksToNS() used by the scalar code
+    __m128i LowNs32 =
+        _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_cvtepi32_pd(Low), Tick));
+    __m256i Time = _mm256_mul_epu32(_mm256_cvtepu32_epi64(High), SecNs);
+    Time = _mm256_add_epi64(Time, _mm256_cvtepu32_epi64(LowNs32));
+    Time = _mm256_add_epi64(Time, Delay);
+
+    __m256i Negative = _mm256_cmpgt_epi64(Ref, Time);
+    __m256i TooHigh = _mm256_cmpgt_epi64(Time, RefLimit);
+    __m256i PrevNegative = _mm256_cmpgt_epi64(Prev, Time);
+    __m256i PrevTooHigh = _mm256_cmpgt_epi64(Time, PrevLimit);
+
+    __m256i Ok = _mm256_xor_si256(_mm256_or_si256(Negative, TooHigh), Ones);
+    __m256i PrevOk = _mm256_andnot_si256(
+        _mm256_or_si256(PrevNegative, PrevTooHigh), Negative);
+    __m256i IsValid = _mm256_or_si256(Ok, PrevOk);
+
+    __m256i Result = _mm256_blendv_epi8(_mm256_sub_epi64(Time, Prev),
+                                        _mm256_sub_epi64(Time, Ref), Ok);
+    Result = _mm256_or_si256(Result, _mm256_xor_si256(IsValid, Ones));
+    _mm256_storeu_si256((__m256i *)(TOF + i), Result);
+
+    // One bit per event time
+    int OkBits = _mm256_movemask_pd(_mm256_castsi256_pd(Ok));
+    int NegativeBits = _mm256_movemask_pd(_mm256_castsi256_pd(Negative));
+    int TooHighBits = _mm256_movemask_pd(_mm256_castsi256_pd(TooHigh));
+    int PrevOkBits = _mm256_movemask_pd(_mm256_castsi256_pd(PrevOk));
+    int PrevNegativeBits =
+        _mm256_movemask_pd(_mm256_castsi256_pd(PrevNegative));
+    int PrevTooHighBits = _mm256_movemask_pd(_mm256_castsi256_pd(PrevTooHigh));
+
+    Tof += __builtin_popcount(OkBits);
+    TofNegative += __builtin_popcount(NegativeBits);
+    TofHigh += __builtin_popcount(TooHighBits & ~NegativeBits);
+    PrevTof += __builtin_popcount(PrevOkBits);
+    PrevTofNegative += __builtin_popcount(PrevNegativeBits & NegativeBits);
+    PrevTofHigh += __builtin_popcount(PrevTooHighBits & NegativeBits &
+                                      ~PrevNegativeBits);
+  }
+  Counts = {Tof, TofNegative, TofHigh, PrevTof, PrevTofNegative, PrevTofHigh};
+  return i;
+}
+
+bool haveAVX2() {
+  static const bool Supported = __builtin_cpu_supports("avx2");
+  return Supported;
+}
+} // namespace
+#endif
+
 uint64_t ESSReferenceTime::setReference(const ESSTime &refESSTime) {
+  RefHigh = refESSTime.getTimeHigh();
+  RefLow = refESSTime.getTimeLow();
   TimeInNS = refESSTime.toNS();
+  setLimits();
   return TimeInNS.count();
 }
 
 uint64_t ESSReferenceTime::setPrevReference(const ESSTime &refPrevESSTime) {
+  PrevRefHigh = refPrevESSTime.getTimeHigh();
+  PrevRefLow = refPrevESSTime.getTimeLow();
   PrevTimeInNS = refPrevESSTime.toNS();
+  setLimits();
   return PrevTimeInNS.count();
 }
 
+bool ESSReferenceTime::setReferences(const ESSTime &refESSTime,
+                                     const ESSTime &refPrevESSTime) {
+  if (refESSTime.getTimeLow() == RefLow and
+      refESSTime.getTimeHigh() == RefHigh and
+      refPrevESSTime.getTimeLow() == PrevRefLow and
+      refPrevESSTime.getTimeHigh() == PrevRefHigh) {
+    return false;
+  }
+  setReference(refESSTime);
+  setPrevReference(refPrevESSTime);
+  return true;
+}
+
 void ESSReferenceTime::setMaxTOF(uint64_t NewMaxTOF) {
   MaxTOF = TimeDurationNano(NewMaxTOF);
+  setLimits();
 }
 
 uint64_t ESSReferenceTime::getTOF(const ESSTime eventTime, const uint32_t DelayNS) {
@@ -39,7 +170,7 @@ uint64_t ESSReferenceTime::getTOF(const ESSTime eventTime, const uint32_t DelayN
     Stats.TofNegative++;
     return getPrevTOF(eventTime, DelayNS);
   }
-  if ((timeval - TimeInNS) > MaxTOF) {
+  if (timeval > TOFLimit) {
     XTRACE(EVENT, WAR, "High TOF: High: 0x%08x, Low: 0x%08x, timens %" PRIu64,
            ", PrevPTns: %" PRIu64, eventTime.getTimeHigh(),
            eventTime.getTimeLow(), timeval, TimeInNS);
@@ -61,7 +192,7 @@ uint64_t ESSReferenceTime::getPrevTOF(const ESSTime eventTime,const uint32_t Del
     Stats.PrevTofNegative++;
     return InvalidTOF;
   }
-  if ((timeval - PrevTimeInNS) > MaxTOF) {
+  if (timeval > PrevTOFLimit) {
     XTRACE(EVENT, WAR,
            "High Prev TOF: High: 0x%04x, Low: 0x%04x, timens %" PRIu64,
            ", PrevPTns: %" PRIu64, eventTime.getTimeHigh(),
@@ -73,4 +204,47 @@ uint64_t ESSReferenceTime::getPrevTOF(const ESSTime eventTime,const uint32_t Del
   return (timeval - PrevTimeInNS).count();
 }
 
+size_t ESSReferenceTime::getTOFs(nonstd::span<const uint32_t> TimeHigh,
+                                 nonstd::span<const uint32_t> TimeLow,
+                                 nonstd::span<uint64_t> TOF,
+                                 const uint32_t DelayNS) {
+  size_t Count = TimeHigh.size();
+  size_t ValidCount{0};
+  size_t i{0};
+
+  while (i < Count) {
+#ifdef ESSTIME_AVX2
+    if (haveAVX2()) {
+      const int64_t Max = std::numeric_limits<int64_t>::max();
+      TOFLimits Limits{(int64_t)TimeInNS.count(),
+                       (int64_t)std::min<uint64_t>(TOFLimit.count(), Max),
+                       (int64_t)PrevTimeInNS.count(),
+                       (int64_t)std::min<uint64_t>(PrevTOFLimit.count(), Max),
+                       DelayNS};
+      TOFCounts Counts;
+      size_t Done = tofBlocksAVX2(&TimeHigh[i], &TimeLow[i], Count - i,
+                                  &TOF[i], Limits, Counts);
+      Stats.TofCount += Counts.Tof;
+      Stats.TofNegative += Counts.TofNegative;
+      Stats.TofHigh += Counts.TofHigh;
+      Stats.PrevTofCount += Counts.PrevTof;
+      Stats.PrevTofNegative += Counts.PrevTofNegative;
+      Stats.PrevTofHigh += Counts.PrevTofHigh;
+      ValidCount += Counts.Tof + Counts.PrevTof;
+      i += Done;
+      if (i == Count) {
+        break;
+      }
+    }
+#endif
+    // Tail, or a block the vector code left for exact scalar handling
+    size_t End = std::min(Count, i + 4);
+    for (; i < End; i++) {
+      TOF[i] = getTOF(ESSTime(TimeHigh[i], TimeLow[i]), DelayNS);
+      ValidCount += (TOF[i] != InvalidTOF);
+    }
+  }
+  return ValidCount;
+}
+
 } // namespace esstime
@@ -12,7 +12,9 @@
 #include <chrono>
 #include <cmath>
 #include <common/debug/Trace.h>
+#include <common/memory/span.hpp>
 #include <cstdint>
+#include <vector>
 
 namespace esstime {
 
@@ -36,6 +38,15 @@ public:
   static constexpr double ESSClockFreqHz{88052500};
   static constexpr double ESSClockTick{SecInNs.count() / ESSClockFreqHz};
 
+  /// ESSClockTick as the exact ratio 1e9 / 88052500, ns = ticks * Num / Den
+  /// in integer arithmetic. Division by a constant is compiled to a
+  /// multiply and shift.
+  static constexpr uint64_t TickNsNum{400000};
+  static constexpr uint64_t TickNsDen{35221};
+  static_assert(TickNsNum * (uint64_t)ESSClockFreqHz ==
+                    TickNsDen * SecInNs.count(),
+                "TickNsNum / TickNsDen must equal the ESS clock tick");
+
   /// \brief Default constructor.
   ESSTime() : TimeHigh(0), TimeLow(0) {}
 
@@ -128,8 +139,14 @@ public:
   /// \param Low The low part of the timestamp.
   /// \return The duration in nanoseconds.
   static TimeDurationNano toNS(const uint32_t &High, const uint32_t &Low) {
-    return TimeDurationNano(High * SecInNs.count() +
-                            (uint64_t)(Low * ESSClockTick));
+    return TimeDurationNano(High * SecInNs.count() + ticksToNS(Low));
+  }
+
+  /// \brief Convert a number of ESS clock ticks to nanoseconds, rounded
+  /// down. Same result as truncating Ticks * ESSClockTick for all valid
+  /// Low values, without floating point.
+  static constexpr uint64_t ticksToNS(const uint32_t Ticks) {
+    return Ticks * TickNsNum / TickNsDen;
   }
 
   /// \brief Returns the high part of the timestamp.
@@ -170,7 +187,7 @@ public:
   /// given pulse time.
   ///
   /// \param pulseTime The pulse time used as the reference time.
-  ESSReferenceTime(ESSTime pulseTime) : TimeInNS(pulseTime.toNS()){};
+  ESSReferenceTime(ESSTime pulseTime) { setReference(pulseTime); };
 
   const uint64_t InvalidTOF{0xFFFFFFFFFFFFFFFFULL};
 
@@ -186,6 +203,15 @@ public:
   /// \return The previous reference time as a 64-bit unsigned integer.
   uint64_t setPrevReference(const ESSTime &refPrevESSTime);
 
+  /// \brief Sets the reference and previous reference times. Consecutive
+  /// packets of a pulse carry the same pair, then the ns values and TOF
+  /// limits of the previous call are kept and nothing is converted.
+  ///
+  /// \param refESSTime The reference time to set.
+  /// \param refPrevESSTime The previous reference time to set.
+  /// \return true if either time differs from the previous call
+  bool setReferences(const ESSTime &refESSTime, const ESSTime &refPrevESSTime);
+
   /// \brief Sets the maximum TOF value.
   ///
   /// \param NewMaxTOF The maximum TOF value to set.
@@ -237,13 +263,86 @@ public:
   /// \return The calculated previous TOF value.
   uint64_t getPrevTOF(const ESSTime eventTime, const uint32_t DelayNS = 0);
 
+  /// \brief Calculates the TOF values of a batch of event times, the result
+  /// and the Stats are the same as calling getTOF() for each of them. Uses
+  /// AVX2 when the CPU supports it.
+  ///
+  /// \param TimeHigh The high parts of the event times.
+  /// \param TimeLow The low parts of the event times, same size as TimeHigh.
+  /// \param TOF The calculated TOF values, InvalidTOF where getTOF() would
+  /// return it. Same size as TimeHigh.
+  /// \param DelayNS The delay in nanoseconds.
+  /// \return The number of valid TOF values.
+  size_t getTOFs(nonstd::span<const uint32_t> TimeHigh,
+                 nonstd::span<const uint32_t> TimeLow,
+                 nonstd::span<uint64_t> TOF, const uint32_t DelayNS = 0);
+
   struct Stats_t Stats = {};
 
 private:
+  /// \brief update the TOF upper limits after a change of reference or
+  /// max TOF, saturating for very large max TOF values
+  void setLimits() {
+    const TimeDurationNano Max{TimeDurationNano::max()};
+    TOFLimit = (TimeInNS > Max - MaxTOF) ? Max : TimeInNS + MaxTOF;
+    PrevTOFLimit = (PrevTimeInNS > Max - MaxTOF) ? Max : PrevTimeInNS + MaxTOF;
+  }
+
   TimeDurationNano TimeInNS{0};
   TimeDurationNano PrevTimeInNS{0};
   TimeDurationNano MaxTOF{
       2147483647}; // max 32 bit integer, larger TOFs cause errors downstream
+  TimeDurationNano TOFLimit{TimeInNS + MaxTOF};         // largest valid time
+  TimeDurationNano PrevTOFLimit{PrevTimeInNS + MaxTOF}; // for prev pulse
+
+  // ESS times of the current references, for setReferences()
+  uint32_t RefHigh{0};
+  uint32_t RefLow{0};
+  uint32_t PrevRefHigh{0};
+  uint32_t PrevRefLow{0};
+};
+
+/// \class TOFBatch
+///
+/// \brief Event times of the readouts of a packet, gathered for a single
+/// ESSReferenceTime::getTOFs() call.
+/// The vectors only grow, Count is the number of event times added since
+/// clear().
+struct TOFBatch {
+  std::vector<uint32_t> TimeHigh;
+  std::vector<uint32_t> TimeLow;
+  std::vector<uint64_t> TOF;
+  size_t Count{0};
+
+  /// \brief reserve space for Readouts event times
+  void reserve(size_t Readouts) {
+    if (TimeHigh.size() < Readouts) {
+      TimeHigh.resize(Readouts);
+      TimeLow.resize(Readouts);
+      TOF.resize(Readouts);
+    }
+  }
+
+  /// \brief remove all event times
+  void clear() { Count = 0; }
+
+  /// \brief add an event time, TOF[i] is the result for the i'th added
+  void add(uint32_t High, uint32_t Low) {
+    if (Count == TimeHigh.size()) {
+      reserve(2 * Count + 64);
+    }
+    TimeHigh[Count] = High;
+    TimeLow[Count] = Low;
+    Count++;
+  }
+
+  /// \brief calculate TOF[0 .. Count - 1] for the added event times
+  /// \return The number of valid TOF values.
+  size_t calculate(ESSReferenceTime &Reference, const uint32_t DelayNS = 0) {
+    return Reference.getTOFs({TimeHigh.data(), Count},
+                             {TimeLow.data(), Count}, {TOF.data(), Count},
+                             DelayNS);
+  }
 };
 
 } // namespace esstime
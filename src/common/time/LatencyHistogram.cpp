@@ -0,0 +1,39 @@
+// Copyright (C) 2024 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Implementation of latency histogram percentiles
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <common/time/LatencyHistogram.h>
+
+int64_t LatencyHistogram::percentile(double Fraction) const {
+  if (Samples == 0) {
+    return 0;
+  }
+  int64_t Wanted = std::max<int64_t>(1, Fraction * Samples + 0.5);
+  int64_t Sum{0};
+  for (int Bin = 0; Bin < Bins; Bin++) {
+    Sum += Hist[Bin];
+    if (Sum >= Wanted) {
+      int64_t Upper = (Bin == Bins - 1) ? IntervalMax : binStart(Bin + 1) - 1;
+      return std::min(Upper, IntervalMax);
+    }
+  }
+  return IntervalMax;
+}
+
+void LatencyHistogram::update() {
+  Stats.Count += Samples;
+  Stats.P50 = percentile(0.50);
+  Stats.P90 = percentile(0.90);
+  Stats.P99 = percentile(0.99);
+  Stats.P999 = percentile(0.999);
+  Stats.Max = IntervalMax;
+
+  std::fill(Hist, Hist + Bins, 0);
+  Samples = 0;
+  IntervalMax = 0;
+}
@@ -0,0 +1,80 @@
+// Copyright (C) 2024 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Log-linear latency histogram with percentile counters
+///
+/// Latencies in ns are counted in bins of four per power of two, giving
+/// percentiles within 25% for anything from 1 ns to 18 minutes. update()
+/// computes the percentiles of the samples added since the previous call
+/// into Stats, which can be registered with Statistics, and starts a new
+/// interval. Single threaded: add() and update() must be called from the
+/// same thread.
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+class LatencyHistogram {
+public:
+  static constexpr int SubBins{4};   ///< bins per power of two
+  static constexpr int MaxLog2{40};  ///< 2^40 ns ~ 18 min
+  static constexpr int Bins{MaxLog2 * SubBins};
+
+  struct LatencyStats {
+    int64_t Count{0}; ///< total samples, not reset by update()
+    int64_t P50{0};   ///< percentiles (ns) of the last interval
+    int64_t P90{0};
+    int64_t P99{0};
+    int64_t P999{0};
+    int64_t Max{0};   ///< largest sample (ns) of the last interval
+  };
+
+  /// \brief add a sample, negative values are counted as 0
+  void add(int64_t Ns) {
+    uint64_t Value = (Ns < 0) ? 0 : Ns;
+    Hist[bin(Value)]++;
+    Samples++;
+    if ((int64_t)Value > IntervalMax) {
+      IntervalMax = Value;
+    }
+  }
+
+  /// \brief set Stats from the samples since the last update and clear them
+  void update();
+
+  /// \brief upper bound (ns) of the bin holding the Fraction percentile of
+  /// the current interval, 0 if there are no samples
+  int64_t percentile(double Fraction) const;
+
+  /// \brief bin holding Ns
+  static int bin(uint64_t Ns) {
+    if (Ns < SubBins) {
+      return Ns;
+    }
+    int Msb = 63 - __builtin_clzll(Ns);
+    if (Msb >= MaxLog2) {
+      return Bins - 1;
+    }
+    int Sub = (Ns >> (Msb - 2)) & (SubBins - 1);
+    return (Msb - 1) * SubBins + Sub;
+  }
+
+  /// \brief smallest value (ns) counted in Bin
+  static uint64_t binStart(int Bin) {
+    if (Bin < SubBins) {
+      return Bin;
+    }
+    int Msb = Bin / SubBins + 1;
+    return (uint64_t)(SubBins + Bin % SubBins) << (Msb - 2);
+  }
+
+  LatencyStats Stats;
+
+private:
+  int64_t Hist[Bins]{0};
+  int64_t Samples{0};
+  int64_t IntervalMax{0};
+};
@@ -0,0 +1,65 @@
+// Copyright (C) 2024 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Latency of the stages a packet passes through in the EFU
+///
+/// arrival -> dequeue: kernel receive timestamp (SO_TIMESTAMPNS) to the
+/// processing thread popping the packet, both CLOCK_REALTIME.
+/// dequeue -> parsed -> serialized: measured with the TSC in the processing
+/// thread. serialized -> delivered: from Producer::produce() to the Kafka
+/// delivery report, added by the Producer.
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <common/time/LatencyHistogram.h>
+#include <common/time/TSCTimer.h>
+#include <ctime>
+
+class ProcessingLatency {
+public:
+  /// \brief a packet was popped from the queue
+  /// \param ArrivalNs its receive time in ns since the epoch, 0 if unknown
+  void dequeued(int64_t ArrivalNs) {
+    if (ArrivalNs != 0) {
+      ArrivalDequeue.add(realtimeNs() - ArrivalNs);
+    }
+    Timer.reset();
+  }
+
+  /// \brief readout headers and data of the packet have been parsed
+  void parsed() {
+    DequeueParsed.add(Timer.timetsc() * TSCTimer::nsPerTick());
+    Timer.reset();
+  }
+
+  /// \brief events of the packet have been handed to the serializer
+  void serialized() {
+    ParsedSerialized.add(Timer.timetsc() * TSCTimer::nsPerTick());
+  }
+
+  /// \brief update percentile stats of all stages
+  void update() {
+    ArrivalDequeue.update();
+    DequeueParsed.update();
+    ParsedSerialized.update();
+    SerializedDelivered.update();
+  }
+
+  /// \brief CLOCK_REALTIME in ns, the clock of SO_TIMESTAMPNS
+  static int64_t realtimeNs() {
+    struct timespec Now;
+    clock_gettime(CLOCK_REALTIME, &Now);
+    return Now.tv_sec * 1000000000LL + Now.tv_nsec;
+  }
+
+  LatencyHistogram ArrivalDequeue;
+  LatencyHistogram DequeueParsed;
+  LatencyHistogram ParsedSerialized;
+  LatencyHistogram SerializedDelivered;
+
+private:
+  TSCTimer Timer;
+};
@@ -6,7 +6,9 @@
 /// \brief Implementation (\todo put in header?
 //===----------------------------------------------------------------------===//
 
+#include <chrono>
 #include <common/time/TSCTimer.h>
+#include <thread>
 
 ///
 TSCTimer::TSCTimer(void) { T0 = rdtsc(); }
@@ -28,3 +30,17 @@ void TSCTimer::reset(void) { T0 = rdtsc(); }
 
 ///
 uint64_t TSCTimer::timetsc(void) { return (rdtsc() - T0); }
+
+///
+double TSCTimer::nsPerTick(void) {
+  static const double NsPerTick = []() {
+    using namespace std::chrono;
+    auto Start = steady_clock::now();
+    uint64_t StartTicks = rdtsc();
+    std::this_thread::sleep_for(milliseconds(10));
+    uint64_t Ticks = rdtsc() - StartTicks;
+    auto Ns = duration_cast<nanoseconds>(steady_clock::now() - Start).count();
+    return (Ticks == 0) ? 1.0 : (double)Ns / Ticks;
+  }();
+  return NsPerTick;
+}
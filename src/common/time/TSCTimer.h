@@ -30,6 +30,10 @@ public:
 
   uint64_t timetsc(void); ///< time since T0
 
+  /// \brief nanoseconds per TSC tick, measured against steady_clock on the
+  /// first call (takes 10 ms)
+  static double nsPerTick(void);
+
 private:
   uint64_t T0; ///< reference tsc timestamp
 
@@ -11,11 +11,153 @@
 #include <common/debug/Log.h>
 #include <common/detector/Detector.h>
 #include <common/detector/EFUArgs.h>
+#include <cstring>
+#include <dirent.h>
 #include <efu/Launcher.h>
 #include <iostream>
 #include <map>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
 #include <thread>
 
+namespace {
+/// \brief Pin the calling thread to Cpu (if >= 0) and set SCHED_FIFO
+/// Priority (if > 0). Failures are logged, the thread runs regardless.
+void placeCurrentThread(const std::string &Name, int Cpu, int Priority) {
+#ifdef SYSTEM_NAME_LINUX
+  if (Cpu >= 0) {
+    cpu_set_t CpuSet;
+    CPU_ZERO(&CpuSet);
+    CPU_SET(Cpu, &CpuSet);
+    int Res = pthread_setaffinity_np(pthread_self(), sizeof(CpuSet), &CpuSet);
+    if (Res != 0) {
+      LOG(INIT, Sev::Warning, "Thread {}: unable to pin to cpu {}: {}", Name,
+          Cpu, strerror(Res));
+    }
+  }
+#endif
+  if (Priority > 0) {
+    struct sched_param Param;
+    Param.sched_priority = Priority;
+    int Res = pthread_setschedparam(pthread_self(), SCHED_FIFO, &Param);
+    if (Res != 0) {
+      LOG(INIT, Sev::Warning, "Thread {}: unable to set SCHED_FIFO {}: {}",
+          Name, Priority, strerror(Res));
+    }
+  }
+}
+
+bool isInputThread(const std::string &Name) {
+  return Name.rfind("input", 0) == 0;
+}
+} // namespace
+
+bool Launcher::setThreadAffinity(const std::string &Spec) {
+  ThreadCpus.clear();
+  std::stringstream Stream(Spec);
+  std::string Entry;
+  while (std::getline(Stream, Entry, ',')) {
+    auto Colon = Entry.find(':');
+    if (Colon == 0 or Colon == std::string::npos) {
+      LOG(INIT, Sev::Error, "Invalid thread affinity '{}', use thread:cpu",
+          Entry);
+      return false;
+    }
+
+    int Cpu{-1};
+    try {
+      size_t End;
+      Cpu = std::stoi(Entry.substr(Colon + 1), &End);
+      if (End != Entry.size() - Colon - 1) {
+        Cpu = -1;
+      }
+    } catch (std::exception &) {
+    }
+
+    if (not cpuAvailable(Cpu)) {
+      LOG(INIT, Sev::Error, "Thread affinity '{}': cpu not available", Entry);
+      return false;
+    }
+    ThreadCpus[Entry.substr(0, Colon)] = Cpu;
+  }
+  return true;
+}
+
+bool Launcher::cpuAvailable(int Cpu) {
+  if (Cpu < 0) {
+    return false;
+  }
+#ifdef SYSTEM_NAME_LINUX
+  if (Cpu >= CPU_SETSIZE) {
+    return false;
+  }
+  cpu_set_t CpuSet;
+  CPU_ZERO(&CpuSet);
+  if (sched_getaffinity(0, sizeof(CpuSet), &CpuSet) != 0) {
+    return false;
+  }
+  return CPU_ISSET(Cpu, &CpuSet);
+#else
+  return Cpu < (int)std::thread::hardware_concurrency();
+#endif
+}
+
+int Launcher::numaNode(int Cpu) {
+  int Node{-1};
+#ifdef SYSTEM_NAME_LINUX
+  auto Path = fmt::format("/sys/devices/system/cpu/cpu{}", Cpu);
+  DIR *Dir = opendir(Path.c_str());
+  if (Dir == nullptr) {
+    return -1;
+  }
+  struct dirent *Entry;
+  while ((Entry = readdir(Dir)) != nullptr) {
+    if (sscanf(Entry->d_name, "node%d", &Node) == 1) {
+      break;
+    }
+    Node = -1;
+  }
+  closedir(Dir);
+#else
+  (void)Cpu;
+#endif
+  return Node;
+}
+
+int Launcher::threadCpu(const std::string &Name) {
+  auto It = ThreadCpus.find(Name);
+  return (It == ThreadCpus.end()) ? -1 : It->second;
+}
+
+void Launcher::bindInputQueues(std::shared_ptr<Detector> &detector) {
+  for (unsigned int i = 0; i <= detector->Pipelines.size(); i++) {
+    auto Suffix = (i == 0) ? std::string("") : fmt::format("_{:02}", i);
+    int InputNode = numaNode(threadCpu("input" + Suffix));
+    int ProcessingNode = numaNode(threadCpu("processing" + Suffix));
+
+    if ((InputNode >= 0) and (ProcessingNode >= 0) and
+        (InputNode != ProcessingNode)) {
+      LOG(INIT, Sev::Warning,
+          "input{} on NUMA node {}, processing{} on node {}: packets cross "
+          "sockets",
+          Suffix, InputNode, Suffix, ProcessingNode);
+    }
+
+    int Node = (InputNode >= 0) ? InputNode : ProcessingNode;
+    if (Node < 0) {
+      continue;
+    }
+    if (detector->inputQueue(i).bindToNode(Node)) {
+      LOG(INIT, Sev::Info, "Packet queue{} placed on NUMA node {}", Suffix,
+          Node);
+    } else {
+      LOG(INIT, Sev::Warning, "Unable to place packet queue{} on NUMA node {}",
+          Suffix, Node);
+    }
+  }
+}
+
 void Launcher::launchThreads(std::shared_ptr<Detector> &detector) {
   auto startThreadsWithoutAffinity = [&detector]() {
     LOG(INIT, Sev::Info, "Launching threads without core affinity.");
@@ -25,5 +167,35 @@ void Launcher::launchThreads(std::shared_ptr<Detector> &detector) {
     }
   };
 
-  startThreadsWithoutAffinity();
+  if (ThreadCpus.empty() and (InputPriority == 0)) {
+    startThreadsWithoutAffinity();
+    return;
+  }
+
+  for (auto &Pinned : ThreadCpus) {
+    bool Found{false};
+    for (auto &ThreadInfo : detector->GetThreadInfo()) {
+      Found |= (ThreadInfo.name == Pinned.first);
+    }
+    if (not Found) {
+      LOG(INIT, Sev::Warning, "Thread affinity: no thread named {}",
+          Pinned.first);
+    }
+  }
+
+  bindInputQueues(detector);
+
+  for (auto &ThreadInfo : detector->GetThreadInfo()) {
+    int Cpu = threadCpu(ThreadInfo.name);
+    int Priority = isInputThread(ThreadInfo.name) ? InputPriority : 0;
+    LOG(INIT, Sev::Info, "Creating new thread (id: {}, cpu: {}, node: {})",
+        ThreadInfo.name, Cpu, numaNode(Cpu));
+
+    auto Func = ThreadInfo.func;
+    auto Name = ThreadInfo.name;
+    ThreadInfo.thread = std::thread([Func, Name, Cpu, Priority]() {
+      placeCurrentThread(Name, Cpu, Priority);
+      Func();
+    });
+  }
 }
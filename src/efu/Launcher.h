@@ -5,23 +5,48 @@
 ///
 /// \brief Class for launching processing threads
 ///
+/// Threads can be pinned to cpus by name (input, processing, generator,
+/// input_01, ...). A pinned thread sets its own affinity before running, so
+/// buffers it allocates are first touched on its NUMA node, and the packet
+/// queue of each receive pipeline is moved to the node of its input thread.
 //===----------------------------------------------------------------------===//
 
 #pragma once
 #include <common/detector/Detector.h>
 #include <common/detector/EFUArgs.h>
+#include <map>
+#include <string>
 #include <vector>
 
 class Launcher {
 public:
   /// \brief Launches previously Loaded detector functions
-  /// \param ld Dynamic detector object (from Loader)
-  /// \param args Arguments to be passed to threads
-  /// \param cpus vector of three cpuids for launching input, processing and
-  /// output threads.
   Launcher() {}
 
+  /// \brief Set thread to cpu mapping from a comma separated list of
+  /// thread:cpu pairs, e.g. "input:2,processing:3"
+  /// \return false on syntax errors or cpus not available to the process
+  bool setThreadAffinity(const std::string &Spec);
+
+  /// \brief SCHED_FIFO priority for input threads, 0 for normal scheduling
+  void setInputPriority(int Priority) { InputPriority = Priority; }
+
   void launchThreads(std::shared_ptr<Detector> &detector);
 
+  /// \brief true if Cpu is in the affinity mask of this process
+  static bool cpuAvailable(int Cpu);
+
+  /// \brief NUMA node of Cpu, -1 if unknown
+  static int numaNode(int Cpu);
+
+  /// \brief cpu of thread Name, -1 if not pinned
+  int threadCpu(const std::string &Name);
+
+  std::map<std::string, int> ThreadCpus;
+
 private:
+  /// \brief move receive pipeline queues to the node of their input thread
+  void bindInputQueues(std::shared_ptr<Detector> &detector);
+
+  int InputPriority{0};
 };
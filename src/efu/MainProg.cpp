@@ -81,6 +81,11 @@ int MainProg::run(Detector *inst) {
       DetectorSettings.DetectorName);
 
   Launcher launcher;
+  if (not launcher.setThreadAffinity(DetectorSettings.ThreadAffinity)) {
+    LOG(MAIN, Sev::Error, "Invalid thread affinity, exiting...");
+    return -1;
+  }
+  launcher.setInputPriority(DetectorSettings.InputPriority);
 
   launcher.launchThreads(detector);
 
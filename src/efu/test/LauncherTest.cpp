@@ -0,0 +1,85 @@
+// Copyright (C) 2024 European Spallation Source ERIC
+
+#include <atomic>
+#include <common/testutils/TestBase.h>
+#include <efu/Launcher.h>
+#include <sched.h>
+
+class LauncherTest : public TestBase {
+protected:
+  BaseSettings Settings;
+  void SetUp() override { Det = std::make_shared<Detector>(Settings); }
+  void TearDown() override {}
+
+  std::shared_ptr<Detector> Det;
+  Launcher Launch;
+};
+
+// Test cases below
+TEST_F(LauncherTest, ParseAffinity) {
+  ASSERT_TRUE(Launch.setThreadAffinity(""));
+  ASSERT_TRUE(Launch.ThreadCpus.empty());
+
+  ASSERT_TRUE(Launch.setThreadAffinity("input:0,processing:0"));
+  ASSERT_EQ(Launch.ThreadCpus.size(), 2);
+  ASSERT_EQ(Launch.threadCpu("input"), 0);
+  ASSERT_EQ(Launch.threadCpu("processing"), 0);
+  ASSERT_EQ(Launch.threadCpu("generator"), -1);
+}
+
+TEST_F(LauncherTest, ParseAffinityErrors) {
+  ASSERT_FALSE(Launch.setThreadAffinity("input"));
+  ASSERT_FALSE(Launch.setThreadAffinity(":0"));
+  ASSERT_FALSE(Launch.setThreadAffinity("input:"));
+  ASSERT_FALSE(Launch.setThreadAffinity("input:zero"));
+  ASSERT_FALSE(Launch.setThreadAffinity("input:0x"));
+  ASSERT_FALSE(Launch.setThreadAffinity("input:-1"));
+  ASSERT_FALSE(Launch.setThreadAffinity("input:100000"));
+}
+
+TEST_F(LauncherTest, Topology) {
+  ASSERT_TRUE(Launcher::cpuAvailable(sched_getcpu()));
+  ASSERT_FALSE(Launcher::cpuAvailable(-1));
+  ASSERT_GE(Launcher::numaNode(0), -1);
+  ASSERT_EQ(Launcher::numaNode(-1), -1);
+}
+
+TEST_F(LauncherTest, LaunchPinned) {
+  // Pin to the last CPU this process may run on
+  cpu_set_t Allowed;
+  CPU_ZERO(&Allowed);
+  ASSERT_EQ(sched_getaffinity(0, sizeof(Allowed), &Allowed), 0);
+  int Target{-1};
+  for (int i = 0; i < CPU_SETSIZE; i++) {
+    if (CPU_ISSET(i, &Allowed)) {
+      Target = i;
+    }
+  }
+  ASSERT_GE(Target, 0);
+
+  std::atomic<int> Cpu{-1};
+  std::function<void()> Func = [&Cpu]() { Cpu = sched_getcpu(); };
+  Det->AddThreadFunction(Func, "processing");
+
+  ASSERT_TRUE(
+      Launch.setThreadAffinity("processing:" + std::to_string(Target)));
+  Launch.launchThreads(Det);
+  Det->GetThreadInfo()[0].thread.join();
+  ASSERT_EQ(Cpu, Target);
+}
+
+TEST_F(LauncherTest, LaunchUnpinned) {
+  std::atomic<bool> Ran{false};
+  std::function<void()> Func = [&Ran]() { Ran = true; };
+  Det->AddThreadFunction(Func, "input");
+
+  Launch.setInputPriority(1); // fails without CAP_SYS_NICE, thread still runs
+  Launch.launchThreads(Det);
+  Det->GetThreadInfo()[0].thread.join();
+  ASSERT_TRUE(Ran);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -24,31 +24,6 @@ BifrostGeometry::BifrostGeometry(Config &CaenConfiguration) {
   MaxGroup = CaenConfiguration.MaxGroup;
 }
 
-bool BifrostGeometry::validateData(DataParser::CaenReadout &Data) {
-  int Ring = Data.FiberId / 2;
-  XTRACE(DATA, DEB, "Fiber %u, Ring %d, FEN %u, Group %u", Data.FiberId, Ring,
-         Data.FENId, Data.Group);
-
-  if (Ring > MaxRing) {
-    XTRACE(DATA, WAR, "RING %d is incompatible with config", Ring);
-    Stats.RingErrors++;
-    return false;
-  }
-
-  if (Data.FENId > MaxFEN) {
-    XTRACE(DATA, WAR, "FEN %d is incompatible with config", Data.FENId);
-    Stats.FENErrors++;
-    return false;
-  }
-
-  if (Data.Group > MaxGroup) {
-    XTRACE(DATA, WAR, "Group %d is incompatible with config", Data.Group);
-    Stats.GroupErrors++;
-    return false;
-  }
-  return true;
-}
-
 int BifrostGeometry::xOffset(int Ring, int Group) {
   int RingOffset = Ring * NPos;
   int GroupOffset = (Group % 3) * UnitPixellation;
@@ -64,6 +39,14 @@ int BifrostGeometry::yOffset(int Group) {
 std::pair<int, double> BifrostGeometry::calcUnitAndPos(int Group, int AmpA,
                                                        int AmpB) {
 
+  if (CaenCDCalibration.QuantisedSteps) {
+    auto Entry = quantisedUnitAndPos(Group, AmpA, AmpA + AmpB);
+    if (Entry == nullptr) {
+      return InvalidPos;
+    }
+    return std::make_pair(Entry->Unit, Entry->UnitPos);
+  }
+
   if (AmpA + AmpB == 0) {
     XTRACE(DATA, DEB, "Sum of amplitudes is 0");
     Stats.AmplitudeZero++;
@@ -71,6 +54,12 @@ std::pair<int, double> BifrostGeometry::calcUnitAndPos(int Group, int AmpA,
   }
 
   double GlobalPos = 1.0 * AmpA / (AmpA + AmpB); // [0.0 ; 1.0]
+  XTRACE(DATA, DEB, "A %d, B %d, GlobalPos %f", AmpA, AmpB, GlobalPos);
+  return calcUnitAndPos(Group, GlobalPos);
+}
+
+std::pair<int, double> BifrostGeometry::calcUnitAndPos(int Group,
+                                                       double GlobalPos) {
   if ((GlobalPos < 0) or (GlobalPos > 1.0)) {
     XTRACE(DATA, WAR, "Pos %f not in unit interval", GlobalPos);
     return InvalidPos;
@@ -78,8 +67,7 @@ std::pair<int, double> BifrostGeometry::calcUnitAndPos(int Group, int AmpA,
 
   int Unit = CaenCDCalibration.getUnitId(Group, GlobalPos);
   if (Unit == -1) {
-    XTRACE(DATA, DEB, "A %d, B %d, GlobalPos %f outside valid region", AmpA,
-           AmpB, GlobalPos);
+    XTRACE(DATA, DEB, "GlobalPos %f outside valid region", GlobalPos);
     return InvalidPos;
   }
 
@@ -95,7 +83,7 @@ std::pair<int, double> BifrostGeometry::calcUnitAndPos(int Group, int AmpA,
   return std::make_pair(Unit, RawUnitPos);
 }
 
-uint32_t BifrostGeometry::calcPixel(DataParser::CaenReadout &Data) {
+uint32_t BifrostGeometry::calcPixel(const DataParser::CaenReadout &Data) {
   int Ring = Data.FiberId / 2;
   int xoff = xOffset(Ring, Data.Group);
   int yoff = yOffset(Data.Group);
@@ -124,4 +112,48 @@ uint32_t BifrostGeometry::calcPixel(DataParser::CaenReadout &Data) {
   return pixel;
 }
 
+void BifrostGeometry::calcPixels(const ReadoutColumns &Readouts,
+                                 uint32_t *Pixels) {
+  const size_t Count = Readouts.size();
+  Batch.resize(Count);
+
+  for (size_t i = 0; i < Count; i++) {
+    Batch.Numerator[i] = Readouts.AmpA[i];
+    Batch.Denominator[i] = Readouts.AmpA[i] + Readouts.AmpB[i];
+  }
+  calcRatios(Count);
+
+  // As calcPixel(), without tracing
+  for (size_t i = 0; i < Count; i++) {
+    Batch.X[i] = -1;
+    int Ring = Readouts.FiberId[i] / 2;
+    int Group = Ring * TripletsPerRing + Readouts.Group[i];
+
+    std::pair<int, double> UnitPos;
+    if (CaenCDCalibration.QuantisedSteps) {
+      auto Entry = quantisedUnitAndPos(Group, Batch.Numerator[i],
+                                       Batch.Denominator[i]);
+      if (Entry == nullptr) {
+        continue;
+      }
+      UnitPos = std::make_pair(Entry->Unit, Entry->UnitPos);
+    } else {
+      if (Batch.Denominator[i] == 0) {
+        Stats.AmplitudeZero++;
+        continue;
+      }
+      UnitPos = calcUnitAndPos(Group, Batch.Pos[i]);
+      if (UnitPos.first == -1) {
+        continue;
+      }
+    }
+
+    int xlocal = UnitPos.second * (UnitPixellation - 1);
+    Batch.X[i] = xOffset(Ring, Readouts.Group[i]) + xlocal;
+    Batch.Y[i] = yOffset(Readouts.Group[i]) + UnitPos.first;
+  }
+
+  pixels2D(Count, Pixels);
+}
+
 } // namespace Caen
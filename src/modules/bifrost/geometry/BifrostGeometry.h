@@ -24,15 +24,42 @@
 // #define TRC_LEVEL TRC_L_DEB
 
 namespace Caen {
-class BifrostGeometry : public Geometry {
+class BifrostGeometry final : public Geometry {
 public:
   BifrostGeometry(Config &CaenConfiguration);
 
   ///\brief virtual method inherited from base class
-  uint32_t calcPixel(DataParser::CaenReadout &Data);
+  uint32_t calcPixel(const DataParser::CaenReadout &Data);
 
   ///\brief virtual method inherited from base class
-  bool validateData(DataParser::CaenReadout &Data);
+  bool validateData(const DataParser::CaenReadout &Data) {
+    int Ring = Data.FiberId / 2;
+    XTRACE(DATA, DEB, "Fiber %u, Ring %d, FEN %u, Group %u", Data.FiberId, Ring,
+           Data.FENId, Data.Group);
+
+    if (Ring > MaxRing) {
+      XTRACE(DATA, WAR, "RING %d is incompatible with config", Ring);
+      Stats.RingErrors++;
+      return false;
+    }
+
+    if (Data.FENId > MaxFEN) {
+      XTRACE(DATA, WAR, "FEN %d is incompatible with config", Data.FENId);
+      Stats.FENErrors++;
+      return false;
+    }
+
+    if (Data.Group > MaxGroup) {
+      XTRACE(DATA, WAR, "Group %d is incompatible with config", Data.Group);
+      Stats.GroupErrors++;
+      return false;
+    }
+    return true;
+  }
+
+  ///\brief virtual method inherited from base class, amplitude sums,
+  /// positions and pixels are calculated over the columns
+  void calcPixels(const ReadoutColumns &Readouts, uint32_t *Pixels) override;
 
   /// \brief return the global x-offset for the given identifiers
   /// \param Ring logical ring as defined in the ICD
@@ -50,6 +77,10 @@ public:
   /// or (-1, -1.0) if invalid
   std::pair<int, double> calcUnitAndPos(int Group, int AmpA, int AmpB);
 
+  /// \brief return the unit and position along it for a global position
+  /// \param GlobalPos AmpA / (AmpA + AmpB)
+  std::pair<int, double> calcUnitAndPos(int Group, double GlobalPos);
+
   const int UnitsPerGroup{3};
   const int TripletsPerRing{15};
   int UnitPixellation{100}; ///< Number of pixels along a single He tube.
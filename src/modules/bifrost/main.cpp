@@ -11,8 +11,8 @@
 int main(int argc, char *argv[]) {
   MainProg Main("bifrost", argc, argv);
 
-  auto Detector =
-      new Caen::CaenBase(Main.DetectorSettings, ESSReadout::Parser::BIFROST);
+  auto Detector = new Caen::CaenBase<Caen::BifrostGeometry>(
+      Main.DetectorSettings, ESSReadout::Parser::BIFROST);
 
   return Main.run(Detector);
 }
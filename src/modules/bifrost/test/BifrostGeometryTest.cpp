@@ -8,6 +8,7 @@
 //===----------------------------------------------------------------------===//
 #include <bifrost/geometry/BifrostGeometry.h>
 #include <caen/readout/DataParser.h>
+#include <caen/test/GeometryTestUtil.h>
 #include <common/testutils/TestBase.h>
 
 using namespace Caen;
@@ -134,6 +135,61 @@ TEST_F(BifrostGeometryTest, Validate) {
   ASSERT_EQ(geom->Stats.GroupErrors, 1);
 }
 
+TEST_F(BifrostGeometryTest, QuantisedCalibration) {
+  const unsigned int Steps{4096};
+  const int Sum{1000};
+  BifrostGeometry exact(CaenConfiguration);
+  exact.CaenCDCalibration = geom->CaenCDCalibration;
+  geom->CaenCDCalibration.buildQuantisedTable(Steps);
+
+  for (int Group : {NullCalibGroup, ManualCalibGroup}) {
+    auto &Intervals = geom->CaenCDCalibration.Intervals[Group];
+    for (int AmpA = 0; AmpA <= Sum; AmpA++) {
+      bool NearEdge{false};
+      for (auto &Interval : Intervals) {
+        NearEdge |= std::abs(1.0 * AmpA / Sum - Interval.first) <= 0.5 / Steps;
+        NearEdge |= std::abs(1.0 * AmpA / Sum - Interval.second) <= 0.5 / Steps;
+      }
+      if (NearEdge) {
+        continue;
+      }
+      auto Result = geom->calcUnitAndPos(Group, AmpA, Sum - AmpA);
+      auto Expected = exact.calcUnitAndPos(Group, AmpA, Sum - AmpA);
+      ASSERT_EQ(Result.first, Expected.first);
+      ASSERT_NEAR(Result.second, Expected.second, 0.001);
+    }
+  }
+  ASSERT_EQ(geom->CaenCDCalibration.Stats.OutsideInterval,
+            exact.CaenCDCalibration.Stats.OutsideInterval);
+  ASSERT_GT(geom->CaenCDCalibration.Stats.OutsideInterval, 0);
+
+  ASSERT_EQ(geom->calcUnitAndPos(ManualCalibGroup, -1, 20).first, -1);
+  ASSERT_EQ(geom->calcUnitAndPos(ManualCalibGroup, 0, 0).first, -1);
+  ASSERT_EQ(geom->Stats.AmplitudeZero, 1);
+}
+
+TEST_F(BifrostGeometryTest, CalcPixelsMatchesCalcPixel) {
+  ReadoutColumns Readouts = randomReadouts(5, 0, 14);
+
+  for (unsigned int Steps : {0, 4096}) {
+    BifrostGeometry exact(CaenConfiguration);
+    exact.NPos = geom->NPos;
+    exact.CaenCDCalibration = geom->CaenCDCalibration;
+    if (Steps) {
+      geom->CaenCDCalibration.buildQuantisedTable(Steps);
+      exact.CaenCDCalibration.buildQuantisedTable(Steps);
+    }
+    geom->Stats = exact.Stats;
+    geom->CaenCDCalibration.Stats = exact.CaenCDCalibration.Stats;
+
+    checkCalcPixels(*geom, exact, Readouts);
+    ASSERT_EQ(geom->Stats.AmplitudeZero, exact.Stats.AmplitudeZero);
+    ASSERT_EQ(geom->Stats.AmplitudeZero, 40);
+    ASSERT_EQ(geom->CaenCDCalibration.Stats.OutsideInterval,
+              exact.CaenCDCalibration.Stats.OutsideInterval);
+  }
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
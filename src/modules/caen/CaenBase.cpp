@@ -29,8 +29,9 @@ namespace Caen {
 
 const char *classname = "Caen detector with ESS readout";
 
-CaenBase::CaenBase(BaseSettings const &settings,
-                   ESSReadout::Parser::DetectorType t)
+template <typename GeometryType>
+CaenBase<GeometryType>::CaenBase(BaseSettings const &settings,
+                                 ESSReadout::Parser::DetectorType t)
     : Detector(settings), type(t) {
   Stats.setPrefix(EFUSettings.GraphitePrefix, EFUSettings.GraphiteRegion);
 
@@ -39,6 +40,26 @@ CaenBase::CaenBase(BaseSettings const &settings,
   Stats.create("receive.packets", ITCounters.RxPackets);
   Stats.create("receive.bytes", ITCounters.RxBytes);
   Stats.create("receive.dropped", ITCounters.FifoPushErrors);
+  for (int i = 0; i < RxBatchHistBins; i++) {
+    std::string statname = fmt::format("receive.batch_size.{:02}", i);
+    Stats.create(statname, ITCounters.RxBatchSize[i]);
+  }
+  Stats.create("receive.gro_calls", ITCounters.RxGroCalls);
+  Stats.create("receive.gro_segments", ITCounters.RxGroSegments);
+  Stats.create("receive.gro_segments_avg", ITCounters.RxGroSegmentsAvg);
+  Stats.create("receive.gro_copies", ITCounters.RxGroCopies);
+  Stats.create("receive.gro_oversize", ITCounters.RxGroOversize);
+  Stats.create("receive.queue_backing", ITCounters.RxQueueBacking);
+  Stats.create("receive.queue_bytes", ITCounters.RxQueueBytes);
+  Stats.create("receive.queue_locked", ITCounters.RxQueueLocked);
+  Stats.create("receive.queue_high_water", ITCounters.RxQueueHighWater);
+  for (int i = 0; i < RxQueueFillBins; i++) {
+    std::string statname = fmt::format("receive.queue_fill.{:02}", i);
+    Stats.create(statname, ITCounters.RxQueueFill[i]);
+  }
+  Stats.create("receive.kernel_drops", ITCounters.RxKernelDrops);
+  Stats.create("receive.kernel_drops_interval",
+               ITCounters.RxKernelDropsInterval);
   Stats.create("receive.fifo_seq_errors", Counters.FifoSeqErrors);
 
   // ESS Readout
@@ -95,6 +116,12 @@ CaenBase::CaenBase(BaseSettings const &settings,
   // System counters
   Stats.create("thread.input_idle", ITCounters.RxIdle);
   Stats.create("thread.processing_idle", Counters.ProcessingIdle);
+  Stats.create("thread.processing_idle_spin_ns", Idle.Stats.SpinNs);
+  Stats.create("thread.processing_idle_yield_ns", Idle.Stats.YieldNs);
+  Stats.create("thread.processing_idle_wait_ns", Idle.Stats.WaitNs);
+  Stats.create("thread.processing_idle_waits", Idle.Stats.Waits);
+  Stats.create("thread.processing_idle_wakeups", Idle.Stats.WaitWakeups);
+  createLatencyStats();
 
   // Produce cause call stats
   Stats.create("produce.cause.timeout", Counters.ProduceCauseTimeout);
@@ -126,13 +153,36 @@ CaenBase::CaenBase(BaseSettings const &settings,
   };
   Detector::AddThreadFunction(processingFunc, "processing");
 
+  if (EFUSettings.RxPipelines > 1) {
+    Merger = std::make_unique<EV44Merger>(EFUSettings.RxPipelines);
+    PipelineCounters.resize(EFUSettings.RxPipelines - 1);
+    for (unsigned int i = 1; i < EFUSettings.RxPipelines; i++) {
+      auto &PCounters = PipelineCounters[i - 1];
+      Stats.create(fmt::format("pipeline.{:02}.essheader.error_seqno", i),
+                   PCounters.ReadoutStats.ErrorSeqNum);
+      Stats.create(fmt::format("pipeline.{:02}.readouts.count", i),
+                   PCounters.Parser.Readouts);
+      Stats.create(fmt::format("pipeline.{:02}.events.count", i),
+                   PCounters.Events);
+    }
+    addPipelines([this](unsigned int Pipeline) {
+      CaenBase::processingThread(Pipeline);
+    });
+  }
+
   XTRACE(INIT, ALW, "Creating %d Caen Rx ringbuffers of size %d",
-         EthernetBufferMaxEntries, EthernetBufferSize);
+         InputQueue.getMaxElements(), EthernetBufferSize);
 }
 
 ///
 /// \brief Normal processing thread
-void CaenBase::processingThread() {
+template <typename GeometryType>
+void CaenBase<GeometryType>::processingThread(unsigned int Pipeline) {
+  if (Pipeline > 0) {
+    pipelineProcessingThread(Pipeline);
+    return;
+  }
+
   if (EFUSettings.KafkaTopic == "") {
     XTRACE(INIT, ERR, "No kafka topic set, using DetectorName + _detector");
     EFUSettings.KafkaTopic = EFUSettings.DetectorName + "_detector";
@@ -141,34 +191,51 @@ void CaenBase::processingThread() {
   KafkaConfig KafkaCfg(EFUSettings.KafkaConfigFile);
   Producer EventProducer(EFUSettings.KafkaBroker, EFUSettings.KafkaTopic,
                          KafkaCfg.CfgParms);
+  EventProducer.setDeliveryLatency(&Latency.SerializedDelivered);
 
   auto Produce = [&EventProducer](auto DataBuffer, auto Timestamp) {
     EventProducer.produce(DataBuffer, Timestamp);
   };
 
   Serializer = new EV44Serializer(KafkaBufferSize, "caen", Produce);
-  CaenInstrument Caen(Counters, EFUSettings);
-  Caen.setSerializer(Serializer); // would rather have this in CaenInstrument
+  CaenInstrument<GeometryType> Caen(Counters, EFUSettings);
+  // With several pipelines all events go through the merger
+  EV44Serializer *EventSerializer = Serializer;
+  std::unique_ptr<EV44MergeInput> MergeInput;
+  if (Merger) {
+    Merger->setOutput(Serializer);
+    MergeInput = std::make_unique<EV44MergeInput>(*Merger, 0, KafkaBufferSize);
+    EventSerializer = MergeInput.get();
+  }
+  Caen.setSerializer(
+      EventSerializer); // would rather have this in CaenInstrument
 
-  Producer EventProducerII(EFUSettings.KafkaBroker, "CAEN_debug",
-                           KafkaCfg.CfgParms);
+  std::unique_ptr<Producer> EventProducerII;
+  if constexpr (DebugStream) {
+    EventProducerII = std::make_unique<Producer>(
+        EFUSettings.KafkaBroker, "CAEN_debug", KafkaCfg.CfgParms);
 
-  auto ProduceII = [&EventProducerII](auto DataBuffer, auto Timestamp) {
-    EventProducerII.produce(DataBuffer, Timestamp);
-  };
+    auto ProduceII = [&EventProducerII](auto DataBuffer, auto Timestamp) {
+      EventProducerII->produce(DataBuffer, Timestamp);
+    };
 
-  SerializerII = new EV44Serializer(KafkaBufferSize, "caen", ProduceII);
-  Caen.setSerializerII(
-      SerializerII); // would rather have this in CaenInstrument
+    SerializerII = new EV44Serializer(KafkaBufferSize, "caen", ProduceII);
+    Caen.setSerializerII(
+        SerializerII); // would rather have this in CaenInstrument
+  }
 
   unsigned int DataIndex;
   TSCTimer ProduceTimer(EFUSettings.UpdateIntervalSec * 1000000 * TSC_MHZ);
 
   RuntimeStat RtStat({ITCounters.RxPackets, Counters.Events, Counters.KafkaStats.produce_bytes_ok});
 
+  Caen.ESSReadoutParser.setHeaderVersion(EFUSettings.HeaderVersion, type);
+
   while (runThreads) {
-    if (InputFifo.pop(DataIndex)) { // There is data in the FIFO - do processing
-      auto DataLen = RxRingbuffer.getDataLength(DataIndex);
+    if (InputQueue.pop(DataIndex)) { // There is data in the queue - do processing
+      Idle.reset();
+      Latency.dequeued(InputQueue.getArrivalTime(DataIndex));
+      auto DataLen = InputQueue.getDataLength(DataIndex);
       if (DataLen == 0) {
         XTRACE(DATA, ERR, "Data length in FIFO is zero");
         Counters.FifoSeqErrors++;
@@ -180,7 +247,7 @@ void CaenBase::processingThread() {
 
       /// \todo use the Buffer<T> class here and in parser?
       /// \todo avoid copying by passing reference to stats like for gdgem?
-      auto DataPtr = RxRingbuffer.getDataBuffer(DataIndex);
+      auto DataPtr = InputQueue.getDataBuffer(DataIndex);
       auto Res = Caen.ESSReadoutParser.validate(DataPtr, DataLen, type);
 
       /// \todo could be moved
@@ -195,9 +262,11 @@ void CaenBase::processingThread() {
       // We have good header information, now parse readout data
       Res = Caen.CaenParser.parse(Caen.ESSReadoutParser.Packet.DataPtr,
                                   Caen.ESSReadoutParser.Packet.DataLength);
+      Latency.parsed();
 
       // Process readouts, generate (and produce) events
       Caen.processReadouts();
+      Latency.serialized();
 
       /// \todo This could be moved and done less frequently
       Counters.Parser = Caen.CaenParser.Stats;
@@ -205,18 +274,34 @@ void CaenBase::processingThread() {
       Counters.Geom = Caen.Geom->Stats;
       Counters.Calibration = Caen.Geom->CaenCDCalibration.Stats;
 
-    } else { // There is NO data in the FIFO - do stop checks and sleep a little
+    } else { // There is NO data in the queue - do stop checks and idle
       Counters.ProcessingIdle++;
-      usleep(10);
+      Idle.idle(InputQueue);
+    }
+
+    // Pulses completed by all pipelines are produced from this thread only
+    if (Merger) {
+      Merger->produce();
     }
 
+    // Serve delivery reports also when nothing is being produced
+    EventProducer.poll();
+
     if (ProduceTimer.timeout()) {
+      Latency.update();
       // XTRACE(DATA, DEB, "Serializer timer timed out, producing message now");
       RuntimeStatusMask = RtStat.getRuntimeStatusMask(
           {ITCounters.RxPackets, Counters.Events, Counters.KafkaStats.produce_bytes_ok});
 
-      Serializer->produce();
-      SerializerII->produce();
+      if (Merger) {
+        EventSerializer->produce();
+        Merger->produceTimeout();
+      } else {
+        Serializer->produce();
+      }
+      if constexpr (DebugStream) {
+        SerializerII->produce();
+      }
       Counters.ProduceCauseTimeout++;
       Counters.ProduceCausePulseChange = Serializer->ProduceCausePulseChange;
       Counters.ProduceCauseMaxEventsReached = Serializer->ProduceCauseMaxEventsReached;
@@ -225,7 +310,90 @@ void CaenBase::processingThread() {
     /// don't increment as Producer & Serializer keep absolute count
     Counters.KafkaStats = EventProducer.stats;
   }
+  if (Merger) {
+    EventSerializer->produce();
+    while (PipelinesStopped < EFUSettings.RxPipelines - 1) {
+      usleep(100);
+    }
+    Merger->produceAll();
+    Merger->setOutput(nullptr); // Serializer's producer goes out of scope
+  }
   XTRACE(INPUT, ALW, "Stopping processing thread.");
   return;
 }
+
+///
+/// \brief Processing thread for receive pipelines 1 and up. Events go to
+/// the merger, messages are produced by pipeline 0. The debug stream and
+/// readout dump files are only available from pipeline 0.
+template <typename GeometryType>
+void CaenBase<GeometryType>::pipelineProcessingThread(unsigned int Pipeline) {
+  auto &Queue = inputQueue(Pipeline);
+  auto &PCounters = PipelineCounters[Pipeline - 1];
+
+  BaseSettings PipelineSettings = EFUSettings;
+  PipelineSettings.DumpFilePrefix = "";
+  CaenInstrument<GeometryType> Caen(PCounters, PipelineSettings);
+  EV44MergeInput EventSerializer(*Merger, Pipeline, KafkaBufferSize);
+  Caen.setSerializer(&EventSerializer);
+  std::unique_ptr<EV44Serializer> DebugSerializer;
+  if constexpr (DebugStream) {
+    DebugSerializer = std::make_unique<EV44Serializer>(KafkaBufferSize, "caen");
+    Caen.setSerializerII(DebugSerializer.get());
+  }
+
+  IdleStrategy PipelineIdle(EFUSettings.IdleSpinCount,
+                            EFUSettings.IdleYieldCount, EFUSettings.IdleWaitUS);
+
+  Caen.ESSReadoutParser.setHeaderVersion(EFUSettings.HeaderVersion, type);
+
+  unsigned int DataIndex;
+  TSCTimer ProduceTimer(EFUSettings.UpdateIntervalSec * 1000000 * TSC_MHZ);
+
+  while (runThreads) {
+    if (Queue.pop(DataIndex)) { // There is data in the queue - do processing
+      PipelineIdle.reset();
+      auto DataLen = Queue.getDataLength(DataIndex);
+      if (DataLen == 0) {
+        PCounters.FifoSeqErrors++;
+        continue;
+      }
+
+      auto DataPtr = Queue.getDataBuffer(DataIndex);
+      auto Res = Caen.ESSReadoutParser.validate(DataPtr, DataLen, type);
+      PCounters.ReadoutStats = Caen.ESSReadoutParser.Stats;
+
+      if (Res != ESSReadout::Parser::OK) {
+        PCounters.ErrorESSHeaders++;
+        continue;
+      }
+
+      Res = Caen.CaenParser.parse(Caen.ESSReadoutParser.Packet.DataPtr,
+                                  Caen.ESSReadoutParser.Packet.DataLength);
+      Caen.processReadouts();
+
+      PCounters.Parser = Caen.CaenParser.Stats;
+      PCounters.TimeStats = Caen.ESSReadoutParser.Packet.Time.Stats;
+      PCounters.Geom = Caen.Geom->Stats;
+      PCounters.Calibration = Caen.Geom->CaenCDCalibration.Stats;
+
+    } else { // There is NO data in the queue - do stop checks and idle
+      PCounters.ProcessingIdle++;
+      PipelineIdle.idle(Queue);
+    }
+
+    if (ProduceTimer.timeout()) {
+      EventSerializer.produce();
+    }
+  }
+  // Submit the buffered events before pipeline 0 merges the last pulses
+  EventSerializer.produce();
+  PipelinesStopped++;
+  XTRACE(INPUT, ALW, "Stopping processing thread %u.", Pipeline);
+}
+
+template class CaenBase<LokiGeometry>;
+template class CaenBase<BifrostGeometry>;
+template class CaenBase<MiraclesGeometry>;
+template class CaenBase<CspecGeometry>;
 } // namespace Caen
@@ -5,29 +5,56 @@
 ///
 /// \brief Caen detector base plugin interface definition
 ///
+/// The plugin is a template on the geometry of the instrument, which is
+/// chosen by main.cpp of each instrument
+///
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
+#include <bifrost/geometry/BifrostGeometry.h>
 #include <caen/CaenCounters.h>
 #include <common/detector/Detector.h>
+#include <common/kafka/EV44Merger.h>
 #include <common/kafka/EV44Serializer.h>
+#include <cspec/geometry/CspecGeometry.h>
+#include <loki/geometry/LokiGeometry.h>
+#include <memory>
+#include <miracles/geometry/MiraclesGeometry.h>
+#include <vector>
 
 namespace Caen {
 
-class CaenBase : public Detector {
+template <typename GeometryType> class CaenBase : public Detector {
   ESSReadout::Parser::DetectorType type;
 
 public:
   CaenBase(BaseSettings const &Settings, ESSReadout::Parser::DetectorType t);
   ~CaenBase() = default;
 
-  void processingThread();
+  /// \param Pipeline receive pipeline to process, see --rxpipelines
+  void processingThread(unsigned int Pipeline = 0);
+
+  /// \brief processing of receive pipelines 1 and up
+  void pipelineProcessingThread(unsigned int Pipeline);
 
   struct CaenCounters Counters;
+  /// Counters of receive pipelines 1 and up
+  std::vector<struct CaenCounters> PipelineCounters;
 
 protected:
   EV44Serializer *Serializer;
-  EV44Serializer *SerializerII;
+  EV44Serializer *SerializerII{nullptr};
+  /// Combines the events of all pipelines per pulse when there are several
+  std::unique_ptr<EV44Merger> Merger;
+  /// Receive pipelines 1 and up that have submitted their last events,
+  /// pipeline 0 waits for all of them before the final merge
+  std::atomic<unsigned int> PipelinesStopped{0};
 };
 
+extern template class CaenBase<LokiGeometry>;
+extern template class CaenBase<BifrostGeometry>;
+extern template class CaenBase<MiraclesGeometry>;
+extern template class CaenBase<CspecGeometry>;
+
 } // namespace Caen
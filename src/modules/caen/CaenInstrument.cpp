@@ -24,8 +24,9 @@ using namespace ESSReadout;
 ///
 /// throws if number of pixels do not match, and if the (invalid) pixel
 /// value 0 is mapped to a nonzero value
-CaenInstrument::CaenInstrument(struct CaenCounters &counters,
-                               BaseSettings &settings)
+template <typename GeometryType>
+CaenInstrument<GeometryType>::CaenInstrument(struct CaenCounters &counters,
+                                             BaseSettings &settings)
     : counters(counters), Settings(settings) {
 
   XTRACE(INIT, ALW, "Loading configuration file %s",
@@ -33,20 +34,7 @@ CaenInstrument::CaenInstrument(struct CaenCounters &counters,
   CaenConfiguration = Config(Settings.ConfigFile);
   CaenConfiguration.parseConfig();
 
-  if (settings.DetectorName == "loki") {
-    Geom = new LokiGeometry(CaenConfiguration);
-  } else if (settings.DetectorName == "bifrost") {
-    Geom = new BifrostGeometry(CaenConfiguration);
-  } else if (settings.DetectorName == "miracles") {
-    Geom = new MiraclesGeometry(CaenConfiguration);
-  } else if (settings.DetectorName == "cspec") {
-    Geom = new CspecGeometry(CaenConfiguration);
-  } else {
-    XTRACE(INIT, ERR, "Invalid Detector Name %s",
-           settings.DetectorName.c_str());
-    throw std::runtime_error(
-        fmt::format("Invalid Detector Name {}", settings.DetectorName));
-  }
+  Geom = new GeometryType(CaenConfiguration);
 
   if (Settings.CalibFile.empty()) {
     throw std::runtime_error("Calibration file is required, none supplied");
@@ -57,6 +45,13 @@ CaenInstrument::CaenInstrument(struct CaenCounters &counters,
       CDCalibration(settings.DetectorName, Settings.CalibFile);
   Geom->CaenCDCalibration.parseCalibration();
 
+  if (CaenConfiguration.CalibrationSteps) {
+    XTRACE(INIT, ALW, "Building quantised calibration, %u steps",
+           CaenConfiguration.CalibrationSteps);
+    Geom->CaenCDCalibration.buildQuantisedTable(
+        CaenConfiguration.CalibrationSteps);
+  }
+
   if (not Settings.DumpFilePrefix.empty()) {
     if (boost::filesystem::path(Settings.DumpFilePrefix).has_extension()) {
       DumpFile =
@@ -72,13 +67,16 @@ CaenInstrument::CaenInstrument(struct CaenCounters &counters,
   ESSReadoutParser.Packet.Time.setMaxTOF(CaenConfiguration.MaxTOFNS);
 }
 
-CaenInstrument::~CaenInstrument() {}
+template <typename GeometryType>
+CaenInstrument<GeometryType>::~CaenInstrument() {}
 
 /// \brief helper function to calculate pixels from knowledge about
 /// caen panel, FENId and a single readout dataset
 ///
 /// also applies the calibration
-uint32_t CaenInstrument::calcPixel(DataParser::CaenReadout &Data) {
+template <typename GeometryType>
+uint32_t
+CaenInstrument<GeometryType>::calcPixel(const DataParser::CaenReadout &Data) {
   XTRACE(DATA, DEB, "Calculating pixel");
 
   uint32_t pixel = Geom->calcPixel(Data);
@@ -88,7 +86,9 @@ uint32_t CaenInstrument::calcPixel(DataParser::CaenReadout &Data) {
   return pixel;
 }
 
-void CaenInstrument::dumpReadoutToFile(DataParser::CaenReadout &Data) {
+template <typename GeometryType>
+void CaenInstrument<GeometryType>::dumpReadoutToFile(
+    const DataParser::CaenReadout &Data) {
   Readout CurrentReadout;
   CurrentReadout.PulseTimeHigh =
       ESSReadoutParser.Packet.HeaderPtr.getPulseHigh();
@@ -112,17 +112,22 @@ void CaenInstrument::dumpReadoutToFile(DataParser::CaenReadout &Data) {
   DumpFile->push(CurrentReadout);
 }
 
-void CaenInstrument::processReadouts() {
+template <typename GeometryType>
+void CaenInstrument<GeometryType>::processReadouts() {
   XTRACE(DATA, DEB, "Reference time is %" PRIi64,
          ESSReadoutParser.Packet.Time.getRefTimeUInt64());
   /// \todo sometimes PrevPulseTime maybe?
   Serializer->checkAndSetReferenceTime(
       ESSReadoutParser.Packet.Time.getRefTimeUInt64());
-  SerializerII->checkAndSetReferenceTime(
-      ESSReadoutParser.Packet.Time.getRefTimeUInt64());
+  if constexpr (DebugStream) {
+    SerializerII->checkAndSetReferenceTime(
+        ESSReadoutParser.Packet.Time.getRefTimeUInt64());
+  }
 
-  /// Traverse readouts, calculate pixels
-  for (auto &Data : CaenParser.Result) {
+  /// Traverse readouts, validate
+  ValidReadouts.clear();
+  TOFs.clear();
+  for (const auto &Data : CaenParser.Result) {
     XTRACE(DATA, DEB, "Fiber %u, FEN %u", Data.FiberId, Data.FENId);
     bool validData = Geom->validateData(Data);
     if (not validData) {
@@ -134,9 +139,20 @@ void CaenInstrument::processReadouts() {
       dumpReadoutToFile(Data);
     }
 
-    // Calculate TOF in ns
-    uint64_t TimeOfFlight = ESSReadoutParser.Packet.Time.getTOF(
-        ESSTime(Data.TimeHigh, Data.TimeLow));
+    ValidReadouts.push_back(&Data);
+    TOFs.add(Data.TimeHigh, Data.TimeLow);
+  }
+
+  // Calculate TOF in ns
+  TOFs.calculate(ESSReadoutParser.Packet.Time);
+
+  /// Traverse valid readouts, keep those with a valid TOF
+  Columns.clear();
+  EventReadouts.clear();
+  EventTOFs.clear();
+  for (size_t i = 0; i < ValidReadouts.size(); i++) {
+    auto &Data = *ValidReadouts[i];
+    uint64_t TimeOfFlight = TOFs.TOF[i];
 
     XTRACE(DATA, DEB,
            "PulseTime     %" PRIu64 ", Previous PulseTime: %" PRIu64
@@ -155,20 +171,40 @@ void CaenInstrument::processReadouts() {
            Data.TimeHigh, Data.TimeLow, TimeOfFlight, Data.DataSeqNum,
            Data.Group, Data.AmpA, Data.AmpB, Data.AmpC, Data.AmpD);
 
-    // Calculate pixelid and apply calibration
-    uint32_t PixelId = calcPixel(Data);
+    Columns.push_back(Data);
+    if constexpr (DebugStream) {
+      EventReadouts.push_back(&Data);
+    }
+    EventTOFs.push_back(TimeOfFlight);
+  }
+
+  // Calculate pixelids and apply calibration for all readouts at once
+  Pixels.resize(Columns.size());
+  Geom->calcPixels(Columns, Pixels.data());
+
+  for (size_t i = 0; i < Pixels.size(); i++) {
+    uint32_t PixelId = Pixels[i];
 
     if (PixelId == 0) {
       XTRACE(EVENT, WAR, "Pixel error");
       counters.PixelErrors++;
     } else {
-      XTRACE(EVENT, DEB, "Pixel %u, TOF %u", PixelId, TimeOfFlight);
-      Serializer->addEvent(TimeOfFlight, PixelId);
+      XTRACE(EVENT, DEB, "Pixel %u, TOF %u", PixelId, EventTOFs[i]);
+      Serializer->addEvent(EventTOFs[i], PixelId);
       counters.Events++;
-      SerializerII->addEvent(Data.AmpA + Data.AmpB + Data.AmpC + Data.AmpD, 0);
+      if constexpr (DebugStream) {
+        auto &Data = *EventReadouts[i];
+        SerializerII->addEvent(Data.AmpA + Data.AmpB + Data.AmpC + Data.AmpD,
+                               0);
+      }
     }
 
   } // for()
 }
 
+template class CaenInstrument<LokiGeometry>;
+template class CaenInstrument<BifrostGeometry>;
+template class CaenInstrument<MiraclesGeometry>;
+template class CaenInstrument<CspecGeometry>;
+
 } // namespace Caen
@@ -6,7 +6,9 @@
 /// \brief Separating Caen processing from pipeline main loop
 ///
 /// Holds efu stats, instrument readout mappings, logical geometry, pixel
-/// calculations and Caen readout parser
+/// calculations and Caen readout parser. The instrument is a template on its
+/// geometry so that the geometry calls in the readout loop are resolved at
+/// compile time, see the explicit instantiations at the end of this file.
 //===----------------------------------------------------------------------===//
 
 #pragma once
@@ -24,7 +26,16 @@
 
 namespace Caen {
 
-class CaenInstrument {
+/// Amplitude sums of the events are sent to a second, debug, serializer.
+/// Configure with -DCAEN_DEBUG_STREAM=OFF to compile this out of the readout
+/// loop.
+#ifdef CAEN_DEBUG_STREAM
+constexpr bool DebugStream{true};
+#else
+constexpr bool DebugStream{false};
+#endif
+
+template <typename GeometryType> class CaenInstrument {
 public:
   /// \brief 'create' the Caen instruments
   ///
@@ -41,15 +52,16 @@ public:
   void setSerializer(EV44Serializer *serializer) { Serializer = serializer; }
 
   /// \brief Sets the second serializer to send events to, recording Amp values
+  /// (unused unless DebugStream)
   void setSerializerII(EV44Serializer *serializer) {
     SerializerII = serializer;
   }
 
   /// \brief Caen pixel calculations
-  uint32_t calcPixel(DataParser::CaenReadout &Data);
+  uint32_t calcPixel(const DataParser::CaenReadout &Data);
 
   /// \brief writes a single readout to file
-  void dumpReadoutToFile(DataParser::CaenReadout &Data);
+  void dumpReadoutToFile(const DataParser::CaenReadout &Data);
 
 public:
   /// \brief Stuff that 'ties' Caen together
@@ -60,10 +72,27 @@ public:
   BaseSettings &Settings;
   ESSReadout::Parser ESSReadoutParser;
   DataParser CaenParser;
-  Geometry *Geom;
+  GeometryType *Geom;
   EV44Serializer *Serializer;
-  EV44Serializer *SerializerII;
+  EV44Serializer *SerializerII{nullptr};
   std::shared_ptr<ReadoutFile> DumpFile;
+
+  /// Readouts of the current packet passing validation and their event
+  /// times, TOF is calculated for all of them at once
+  std::vector<const DataParser::CaenReadout *> ValidReadouts;
+  ESSReadout::TOFBatch TOFs;
+
+  /// Readouts with a valid TOF as columns, their TOF and pixels, pixels are
+  /// calculated for all of them at once
+  ReadoutColumns Columns;
+  std::vector<const DataParser::CaenReadout *> EventReadouts;
+  std::vector<uint64_t> EventTOFs;
+  std::vector<uint32_t> Pixels;
 };
 
+extern template class CaenInstrument<LokiGeometry>;
+extern template class CaenInstrument<BifrostGeometry>;
+extern template class CaenInstrument<MiraclesGeometry>;
+extern template class CaenInstrument<CspecGeometry>;
+
 } // namespace Caen
@@ -37,7 +37,7 @@ CDCalibration::CDCalibration(std::string Name, std::string CalibrationFile)
   }
 }
 
-double CDCalibration::posCorrection(int Group, int Unit, double Pos) {
+double CDCalibration::correctedPos(int Group, int Unit, double Pos) {
   std::vector<double> &Pols = Calibration[Group][Unit];
   double a = Pols[0];
   double b = Pols[1];
@@ -47,16 +47,22 @@ double CDCalibration::posCorrection(int Group, int Unit, double Pos) {
   double Delta = a + Pos * (b + Pos * (c + Pos * d));
   XTRACE(EVENT, DEB, "group %d, unit %d, pos: %g, delta %g", Group, Unit, Pos,
          Delta);
-  double CorrectedPos = Pos - Delta;
+  return Pos - Delta;
+}
+
+double CDCalibration::posCorrection(int Group, int Unit, double Pos) {
+  double CorrectedPos = correctedPos(Group, Unit, Pos);
   XTRACE(EVENT, DEB, "CorrectedPos %g", CorrectedPos);
 
   if (CorrectedPos < 0.0) {
-    XTRACE(EVENT, INF, "Clamping to low value, pos: %g, delta %g", Pos, Delta);
+    XTRACE(EVENT, INF, "Clamping to low value, pos: %g, delta %g", Pos,
+           Pos - CorrectedPos);
     Stats.ClampLow++;
     CorrectedPos = 0.0;
   }
   if (CorrectedPos > 1.0) {
-    XTRACE(EVENT, INF, "Clamping to high value, pos: %g, delta %g", Pos, Delta);
+    XTRACE(EVENT, INF, "Clamping to high value, pos: %g, delta %g", Pos,
+           Pos - CorrectedPos);
     Stats.ClampHigh++;
     CorrectedPos = 1.0;
   }
@@ -71,6 +77,14 @@ int CDCalibration::getUnitId(int GroupIndex, double GlobalPos) {
     Stats.GroupErrors++;
     return -1;
   }
+  int Unit = findUnit(GroupIndex, GlobalPos);
+  if (Unit == -1) {
+    Stats.OutsideInterval++;
+  }
+  return Unit;
+}
+
+int CDCalibration::findUnit(int GroupIndex, double GlobalPos) {
   auto &GroupIntervals = Intervals[GroupIndex];
 
   int Unit;
@@ -83,10 +97,53 @@ int CDCalibration::getUnitId(int GroupIndex, double GlobalPos) {
       return Unit;
     }
   }
-  Stats.OutsideInterval++;
   return -1;
 }
 
+///\brief The table holds for each step what getUnitId() and posCorrection()
+/// would return for the global position Step / Steps. The raw unit position
+/// is calculated as in the geometries.
+void CDCalibration::buildQuantisedTable(unsigned int Steps) {
+  if ((Steps == 0) or (Steps > MaxQuantisedSteps)) {
+    Message = fmt::format("CalibrationSteps {} outside [1; {}]", Steps,
+                          MaxQuantisedSteps);
+    throwException(Message);
+  }
+  QuantisedSteps = Steps;
+  QuantisedTable.assign(Intervals.size() * (Steps + 1), QuantisedPos());
+
+  for (int Group = 0; Group < (int)Intervals.size(); Group++) {
+    for (unsigned int Step = 0; Step <= Steps; Step++) {
+      QuantisedPos &Entry = QuantisedTable[Group * (Steps + 1) + Step];
+      double GlobalPos = 1.0 * Step / Steps;
+
+      int Unit = findUnit(Group, GlobalPos);
+      if (Unit == -1) {
+        continue;
+      }
+
+      double Lower = Intervals[Group][Unit].first;
+      double Upper = Intervals[Group][Unit].second;
+      double RawUnitPos = (GlobalPos - Lower) / (Upper - Lower);
+      double CorrectedPos = correctedPos(Group, Unit, RawUnitPos);
+
+      Entry.Unit = Unit;
+      Entry.UnitPos = RawUnitPos;
+      if (CorrectedPos < 0.0) {
+        Entry.Clamp = ClampedLow;
+        CorrectedPos = 0.0;
+      }
+      if (CorrectedPos > 1.0) {
+        Entry.Clamp = ClampedHigh;
+        CorrectedPos = 1.0;
+      }
+      Entry.CorrectedPos = CorrectedPos;
+    }
+  }
+  XTRACE(INIT, ALW, "Quantised calibration: %u steps for %zu groups", Steps,
+         Intervals.size());
+}
+
 ///\brief Use a two-pass approach. One pass to validate as much as possible,
 /// then a second pass to populate calibration table
 void CDCalibration::parseCalibration() {
@@ -12,7 +12,9 @@
 #pragma once
 
 #include <common/JsonFile.h>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 // #undef TRC_LEVEL
 // #define TRC_LEVEL TRC_L_DEB
@@ -45,12 +47,78 @@ public:
   /// \brief return the UnitId provided the Group and the Global position
   int getUnitId(int GroupIndex, double pos);
 
+  /// \brief unit and positions precomputed for a quantised global position
+  struct QuantisedPos {
+    int16_t Unit{-1};        ///< -1 if outside all intervals
+    uint8_t Clamp{NoClamp};  ///< clamping done by posCorrection()
+    float UnitPos{0.0};      ///< raw position along the unit [0.0 ; 1.0]
+    float CorrectedPos{0.0}; ///< UnitPos after posCorrection()
+  };
+  enum : uint8_t { NoClamp, ClampedLow, ClampedHigh };
+
+  /// \brief upper limit of the CalibrationSteps setting, the table takes
+  /// 12 bytes per step and group (about 200 kB per group)
+  static constexpr unsigned int MaxQuantisedSteps{16384};
+
+  /// \brief precompute getUnitId() and posCorrection() for the global
+  /// positions 0, 1/Steps, ... 1.0 in each group. Used by the geometries
+  /// instead of the exact calculation when Steps is nonzero.
+  /// \param Steps number of quantisation steps of the global position,
+  /// 1 to MaxQuantisedSteps, throws otherwise
+  void buildQuantisedTable(unsigned int Steps);
+
+  /// \brief quantise the amplitude ratio Numerator / Denominator
+  /// \param Denominator must be nonzero
+  /// \return table step, or -1 if the ratio is outside [0.0 ; 1.0]
+  int quantise(int Numerator, int Denominator) const {
+    if (Denominator < 0) {
+      Numerator = -Numerator;
+      Denominator = -Denominator;
+    }
+    if ((Numerator < 0) or (Numerator > Denominator)) {
+      return -1;
+    }
+    return (int64_t(Numerator) * QuantisedSteps + Denominator / 2) /
+           Denominator;
+  }
+
+  /// \brief return the table entry for the global position Step / Steps,
+  /// counting GroupErrors and OutsideInterval as getUnitId() does
+  /// \return table entry, or nullptr if outside all intervals
+  const QuantisedPos *getQuantisedPos(int GroupIndex, int Step) {
+    if (GroupIndex >= Parms.Groups) {
+      Stats.GroupErrors++;
+      return nullptr;
+    }
+    const QuantisedPos &Entry =
+        QuantisedTable[GroupIndex * (QuantisedSteps + 1) + Step];
+    if (Entry.Unit == -1) {
+      Stats.OutsideInterval++;
+      return nullptr;
+    }
+    return &Entry;
+  }
+
+  /// \brief return the corrected position of a table entry, counting
+  /// ClampLow and ClampHigh as posCorrection() does
+  double posCorrection(const QuantisedPos &Entry) {
+    Stats.ClampLow += (Entry.Clamp == ClampedLow);
+    Stats.ClampHigh += (Entry.Clamp == ClampedHigh);
+    return Entry.CorrectedPos;
+  }
+
   /// \brief intervals are vectors of vectors
   std::vector<std::vector<std::pair<double, double>>> Intervals;
 
   /// \brief coefficients are vectors of vectors of vectors
   std::vector<std::vector<std::vector<double>>> Calibration;
 
+  /// \brief quantisation steps of the global position, 0 if no table is built
+  unsigned int QuantisedSteps{0};
+
+  /// \brief Steps + 1 entries per group, flat for cache locality
+  std::vector<QuantisedPos> QuantisedTable;
+
   // Grafana Counters
   struct Stats {
     int64_t ClampLow{0};
@@ -74,6 +142,12 @@ public:
   nlohmann::json root;
 
 private:
+  ///\brief index of the interval containing GlobalPos, or -1
+  int findUnit(int GroupIndex, double GlobalPos);
+
+  ///\brief position after subtracting the polynomial, before clamping
+  double correctedPos(int GroupIndex, int UnitIndex, double Pos);
+
   ///\brief log and trace then throw runtime exception
   void throwException(std::string Message);
 
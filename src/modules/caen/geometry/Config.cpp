@@ -39,6 +39,13 @@ void Config::parseConfig() {
                              "loki, bifrost, miracles, or cspec");
   }
 
+  try {
+    CalibrationSteps = root["CalibrationSteps"].get<unsigned int>();
+  } catch (...) {
+    // Use default value
+  }
+  LOG(INIT, Sev::Info, "CalibrationSteps: {}", CalibrationSteps);
+
   if (InstrumentName == "loki") {
     LokiConf.root = root;
     LokiConf.parseConfig();
@@ -42,6 +42,8 @@ public:
   uint8_t MaxRing{0};
   uint8_t MaxFEN{0};
   uint8_t MaxGroup{14};
+  uint32_t CalibrationSteps{0}; /// quantised calibration table, 0 for exact,
+                                /// at most CDCalibration::MaxQuantisedSteps
 
   LokiConfig LokiConf;
 
@@ -21,6 +21,53 @@
 // #define TRC_LEVEL TRC_L_DEB
 
 namespace Caen {
+
+/// \brief the readouts of a packet as columns, input of calcPixels()
+struct ReadoutColumns {
+  std::vector<uint8_t> FiberId;
+  std::vector<uint8_t> FENId;
+  std::vector<uint8_t> Group;
+  std::vector<int16_t> AmpA;
+  std::vector<int16_t> AmpB;
+  std::vector<int16_t> AmpC;
+  std::vector<int16_t> AmpD;
+
+  size_t size() const { return Group.size(); }
+
+  void clear() {
+    FiberId.clear();
+    FENId.clear();
+    Group.clear();
+    AmpA.clear();
+    AmpB.clear();
+    AmpC.clear();
+    AmpD.clear();
+  }
+
+  void push_back(const DataParser::CaenReadout &Data) {
+    FiberId.push_back(Data.FiberId);
+    FENId.push_back(Data.FENId);
+    Group.push_back(Data.Group);
+    AmpA.push_back(Data.AmpA);
+    AmpB.push_back(Data.AmpB);
+    AmpC.push_back(Data.AmpC);
+    AmpD.push_back(Data.AmpD);
+  }
+
+  /// \brief the fields of readout i used for pixel calculations
+  DataParser::CaenReadout readout(size_t i) const {
+    DataParser::CaenReadout Data{};
+    Data.FiberId = FiberId[i];
+    Data.FENId = FENId[i];
+    Data.Group = Group[i];
+    Data.AmpA = AmpA[i];
+    Data.AmpB = AmpB[i];
+    Data.AmpC = AmpC[i];
+    Data.AmpD = AmpD[i];
+    return Data;
+  }
+};
+
 class Geometry {
 public:
   /// \brief sets the pixel resolution of a straw
@@ -35,11 +82,57 @@ public:
   /// \param Data CaenReadout object, containing ADC value information,
   /// Group id and other information needed to determine pixel of
   /// event. If a Calibration has been set, it will be applied here.
-  virtual uint32_t calcPixel(DataParser::CaenReadout &Data) = 0;
+  virtual uint32_t calcPixel(const DataParser::CaenReadout &Data) = 0;
 
   /// \brief returns true if Data is a valid readout with the given config
   /// \param Data CaenReadout to check validity of.
-  virtual bool validateData(DataParser::CaenReadout &Data) = 0;
+  virtual bool validateData(const DataParser::CaenReadout &Data) = 0;
+
+  /// \brief calculates the pixels of all readouts of a packet, giving the
+  /// same pixels and counters as calcPixel() for each readout. The default
+  /// implementation does exactly that, instruments override it with loops
+  /// over the columns the compiler can vectorise.
+  /// \param Readouts validated readouts of a packet
+  /// \param Pixels output, pixel of each readout or 0 if invalid
+  virtual void calcPixels(const ReadoutColumns &Readouts, uint32_t *Pixels) {
+    for (size_t i = 0; i < Readouts.size(); i++) {
+      Pixels[i] = calcPixel(Readouts.readout(i));
+    }
+  }
+
+  /// \brief ESSGeometry::pixel2D() of the coordinates in Batch.X and Batch.Y,
+  /// 0 if outside the logical geometry (including negative coordinates)
+  void pixels2D(size_t Count, uint32_t *Pixels) const {
+    const int32_t *X = Batch.X.data();
+    const int32_t *Y = Batch.Y.data();
+    const uint32_t NX = ESSGeom->nx();
+    const uint32_t NY = ESSGeom->ny();
+    for (size_t i = 0; i < Count; i++) {
+      uint32_t PixelX = X[i];
+      uint32_t PixelY = Y[i];
+      bool Valid = (PixelX < NX) & (PixelY < NY);
+      Pixels[i] = Valid ? PixelY * NX + PixelX + 1 : 0;
+    }
+  }
+
+  /// \brief unit and position for the amplitude ratio Numerator / Denominator
+  /// from the quantised calibration table, which must have been built
+  /// \return table entry, or nullptr if invalid
+  const CDCalibration::QuantisedPos *
+  quantisedUnitAndPos(int Group, int Numerator, int Denominator) {
+    if (Denominator == 0) {
+      XTRACE(DATA, DEB, "Sum of amplitudes is 0");
+      Stats.AmplitudeZero++;
+      return nullptr;
+    }
+    int Step = CaenCDCalibration.quantise(Numerator, Denominator);
+    if (Step == -1) {
+      XTRACE(DATA, WAR, "Pos %d/%d not in unit interval", Numerator,
+             Denominator);
+      return nullptr;
+    }
+    return CaenCDCalibration.getQuantisedPos(Group, Step);
+  }
 
   struct Stats {
     int64_t RingErrors{0};
@@ -50,6 +143,37 @@ public:
     int64_t AmplitudeZero{0};
   } Stats;
 
+  /// \brief intermediate columns of calcPixels(), kept to reuse allocations
+  struct {
+    std::vector<int32_t> Numerator; ///< amplitude sum for the position
+    std::vector<int32_t> Denominator; ///< sum of all amplitudes
+    std::vector<double> Pos; ///< Numerator / Denominator, if Denominator != 0
+    std::vector<int32_t> X;
+    std::vector<int32_t> Y;
+
+    void resize(size_t Count) {
+      Numerator.resize(Count);
+      Denominator.resize(Count);
+      Pos.resize(Count);
+      X.resize(Count);
+      Y.resize(Count);
+    }
+  } Batch;
+
+  /// \brief Batch.Pos from Batch.Numerator and Batch.Denominator, as
+  /// 1.0 * Numerator / Denominator in the per readout calculations. A zero
+  /// Denominator is replaced by one rather than branched on, so the loop
+  /// vectorises; callers check Batch.Denominator before using Batch.Pos.
+  void calcRatios(size_t Count) {
+    const int32_t *Numerator = Batch.Numerator.data();
+    const int32_t *Denominator = Batch.Denominator.data();
+    double *Pos = Batch.Pos.data();
+    for (size_t i = 0; i < Count; i++) {
+      int32_t Divisor = Denominator[i] + (Denominator[i] == 0);
+      Pos[i] = 1.0 * Numerator[i] / Divisor;
+    }
+  }
+
   CDCalibration CaenCDCalibration;
   ESSGeometry *ESSGeom;
   uint16_t NPos{512}; ///< resolution of position
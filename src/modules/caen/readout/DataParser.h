@@ -8,16 +8,17 @@
 
 #pragma once
 
+#include <common/memory/span.hpp>
 #include <common/readout/ess/Parser.h>
-#include <vector>
+#include <common/readout/ess/ReadoutSchema.h>
 
 namespace Caen {
 
 class DataParser {
 public:
-  const unsigned int MaxFiberId{23};
-  const unsigned int MaxFENId{23};
-  const unsigned int MaxReadoutsInPacket{500};
+  static constexpr unsigned int MaxFiberId{23};
+  static constexpr unsigned int MaxFENId{23};
+  static constexpr unsigned int MaxReadoutsInPacket{500};
 
   struct CaenReadout {
     uint8_t FiberId;
@@ -46,15 +47,35 @@ public:
 
   static_assert(sizeof(CaenReadout) == 24, "Caen readout header length error");
 
-  DataParser() { Result.reserve(MaxReadoutsInPacket); };
+  DataParser(){};
   ~DataParser(){};
 
   //
   int parse(const char *buffer, unsigned int size);
 
-  // To be iterated over in processing thread
-  std::vector<struct CaenReadout> Result;
+  // To be iterated over in processing thread. Points into the parsed
+  // buffer, which must outlive the processing of the readouts
+  nonstd::span<const CaenReadout> Result;
 
   struct Stats Stats;
 };
+
+/// \brief CAEN readout checks, see common/readout/ess/ReadoutSchema.h
+struct CaenSchema {
+  using Readout = DataParser::CaenReadout;
+  using Stats = struct DataParser::Stats;
+
+  using Header = ESSReadout::Schema::Fields<
+      ESSReadout::Schema::Range<&Readout::FiberId, 0, DataParser::MaxFiberId,
+                                &Stats::RingFenErrors>,
+      ESSReadout::Schema::Range<&Readout::FENId, 0, DataParser::MaxFENId,
+                                &Stats::RingFenErrors>>;
+  using Body = ESSReadout::Schema::Fields<>;
+
+  static constexpr auto HeaderSizeErrors{&Stats::DataHeaderSizeErrors};
+  static constexpr auto BufferErrors{&Stats::DataLenMismatch};
+  static constexpr auto DataHeaders{&Stats::DataHeaders};
+  static constexpr auto DataLenErrors{&Stats::DataLenInvalid};
+  static constexpr auto Readouts{&Stats::Readouts};
+};
 } // namespace Caen
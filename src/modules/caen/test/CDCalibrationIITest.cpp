@@ -84,6 +84,60 @@ TEST_F(CalibrationIITest, SelectedValues) {
   ASSERT_EQ(calib.Stats.ClampHigh, 1);
 }
 
+// The table holds the exact results at the quantised positions, including
+// the clamping counted when entries are used
+TEST_F(CalibrationIITest, QuantisedTableMatchesExact) {
+  calib.parseCalibration();
+  const unsigned int Steps{1000};
+  calib.buildQuantisedTable(Steps);
+  ASSERT_EQ(calib.QuantisedTable.size(), 4 * (Steps + 1));
+
+  CDCalibration exact{"dummy"};
+  exact.root = SimplePolynomials;
+  exact.parseCalibration();
+
+  for (int Group = 0; Group < 4; Group++) {
+    for (unsigned int Step = 0; Step <= Steps; Step++) {
+      double Pos = 1.0 * Step / Steps;
+      ASSERT_EQ(calib.quantise(Step, Steps), (int)Step);
+      auto Entry = calib.getQuantisedPos(Group, Step);
+      ASSERT_NE(Entry, nullptr);
+      ASSERT_EQ(Entry->Unit, exact.getUnitId(Group, Pos));
+      ASSERT_NEAR(Entry->UnitPos, Pos, 0.000001);
+      ASSERT_NEAR(calib.posCorrection(*Entry), exact.posCorrection(Group, 0, Pos),
+                  0.000001);
+    }
+  }
+  ASSERT_EQ(calib.Stats.ClampLow, exact.Stats.ClampLow);
+  ASSERT_EQ(calib.Stats.ClampHigh, exact.Stats.ClampHigh);
+
+  ASSERT_EQ(calib.getQuantisedPos(4, 0), nullptr);
+  ASSERT_EQ(calib.Stats.GroupErrors, 1);
+}
+
+TEST_F(CalibrationIITest, QuantisedStepsLimits) {
+  calib.parseCalibration();
+  ASSERT_THROW(calib.buildQuantisedTable(0), std::runtime_error);
+  ASSERT_THROW(calib.buildQuantisedTable(CDCalibration::MaxQuantisedSteps + 1),
+               std::runtime_error);
+  calib.buildQuantisedTable(CDCalibration::MaxQuantisedSteps);
+  ASSERT_EQ(calib.QuantisedTable.size(),
+            4 * (CDCalibration::MaxQuantisedSteps + 1));
+}
+
+TEST_F(CalibrationIITest, QuantiseRatio) {
+  calib.parseCalibration();
+  calib.buildQuantisedTable(1000);
+  ASSERT_EQ(calib.quantise(0, 7), 0);
+  ASSERT_EQ(calib.quantise(1, 3), 333);
+  ASSERT_EQ(calib.quantise(2, 3), 667);
+  ASSERT_EQ(calib.quantise(7, 7), 1000);
+  ASSERT_EQ(calib.quantise(-2, -3), 667);
+  ASSERT_EQ(calib.quantise(-1, 3), -1);
+  ASSERT_EQ(calib.quantise(4, 3), -1);
+  ASSERT_EQ(calib.quantise(1, -3), -1);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   auto retval = RUN_ALL_TESTS();
@@ -27,7 +27,8 @@ public:
 };
 
 TEST_F(CaenBaseTest, LokiConstructor) {
-  Caen::CaenBase Readout(Settings, ESSReadout::Parser::LOKI);
+  Caen::CaenBase<Caen::LokiGeometry> Readout(
+      Settings, ESSReadout::Parser::LOKI);
   EXPECT_EQ(Readout.ITCounters.RxPackets, 0);
 }
 
@@ -35,7 +36,8 @@ TEST_F(CaenBaseTest, BifrostConstructor) {
   Settings.ConfigFile = BIFROST_CONFIG;
   Settings.CalibFile = BIFROST_CALIB;
   Settings.DetectorName = "bifrost";
-  Caen::CaenBase Readout(Settings, ESSReadout::Parser::BIFROST);
+  Caen::CaenBase<Caen::BifrostGeometry> Readout(
+      Settings, ESSReadout::Parser::BIFROST);
   Readout.Counters = {};
   EXPECT_EQ(Readout.ITCounters.RxPackets, 0);
 }
@@ -45,7 +47,8 @@ TEST_F(CaenBaseTest, CspecConstructor) {
   Settings.ConfigFile = CSPEC_CONFIG;
   Settings.CalibFile = CSPEC_CALIB;
   Settings.DetectorName = "cspec";
-  Caen::CaenBase Readout(Settings, ESSReadout::Parser::CSPEC);
+  Caen::CaenBase<Caen::CspecGeometry> Readout(
+      Settings, ESSReadout::Parser::CSPEC);
   Readout.Counters = {};
   EXPECT_EQ(Readout.ITCounters.RxPackets, 0);
 }
@@ -54,7 +57,8 @@ TEST_F(CaenBaseTest, MiraclesConstructor) {
   Settings.ConfigFile = MIRACLES_CONFIG;
   Settings.CalibFile = MIRACLES_CALIB;
   Settings.DetectorName = "miracles";
-  Caen::CaenBase Readout(Settings, ESSReadout::Parser::MIRACLES);
+  Caen::CaenBase<Caen::MiraclesGeometry> Readout(
+      Settings, ESSReadout::Parser::MIRACLES);
   Readout.Counters = {};
   EXPECT_EQ(Readout.ITCounters.RxPackets, 0);
 }
@@ -124,7 +128,8 @@ std::vector<uint8_t> TestPacket2{
 // clang-format on
 
 TEST_F(CaenBaseTest, DataReceiveLoki) {
-  Caen::CaenBase Readout(Settings, ESSReadout::Parser::LOKI);
+  Caen::CaenBase<Caen::LokiGeometry> Readout(
+      Settings, ESSReadout::Parser::LOKI);
 
   writePacketToRxFIFO(Readout, TestPacket);
 
@@ -140,7 +145,8 @@ TEST_F(CaenBaseTest, DataReceiveBifrost) {
   Settings.DetectorName = "bifrost";
   Settings.ConfigFile = BIFROST_CONFIG;
   Settings.CalibFile = BIFROST_CALIB;
-  Caen::CaenBase Readout(Settings, ESSReadout::Parser::BIFROST);
+  Caen::CaenBase<Caen::BifrostGeometry> Readout(
+      Settings, ESSReadout::Parser::BIFROST);
 
   writePacketToRxFIFO(Readout, TestPacket2);
 
@@ -153,7 +159,8 @@ TEST_F(CaenBaseTest, DataReceiveMiracles) {
   Settings.DetectorName = "miracles";
   Settings.ConfigFile = MIRACLES_CONFIG;
   Settings.CalibFile = MIRACLES_CALIB;
-  Caen::CaenBase Readout(Settings, ESSReadout::Parser::MIRACLES);
+  Caen::CaenBase<Caen::MiraclesGeometry> Readout(
+      Settings, ESSReadout::Parser::MIRACLES);
 
   writePacketToRxFIFO(Readout, TestPacket2);
 
@@ -163,7 +170,8 @@ TEST_F(CaenBaseTest, DataReceiveMiracles) {
 
 TEST_F(CaenBaseTest, DataReceiveGoodLoki) {
   Settings.DumpFilePrefix = "deleteme_";
-  Caen::CaenBase Readout(Settings, ESSReadout::Parser::LOKI);
+  Caen::CaenBase<Caen::LokiGeometry> Readout(
+      Settings, ESSReadout::Parser::LOKI);
 
   writePacketToRxFIFO(Readout, TestPacket2);
 
@@ -186,7 +194,8 @@ TEST_F(CaenBaseTest, DataReceiveGoodBifrostForceUpdate) {
   Settings.CalibFile = BIFROST_CALIB;
   Settings.UpdateIntervalSec = 0;
   Settings.DumpFilePrefix = "deleteme_";
-  Caen::CaenBase Readout(Settings, ESSReadout::Parser::BIFROST);
+  Caen::CaenBase<Caen::BifrostGeometry> Readout(
+      Settings, ESSReadout::Parser::BIFROST);
 
   writePacketToRxFIFO(Readout, TestPacket2);
 
@@ -202,7 +211,8 @@ TEST_F(CaenBaseTest, DataReceiveGoodMiraclesForceUpdate) {
   Settings.CalibFile = MIRACLES_CALIB;
   Settings.UpdateIntervalSec = 0;
   Settings.DumpFilePrefix = "deleteme_";
-  Caen::CaenBase Readout(Settings, ESSReadout::Parser::MIRACLES);
+  Caen::CaenBase<Caen::MiraclesGeometry> Readout(
+      Settings, ESSReadout::Parser::MIRACLES);
 
   writePacketToRxFIFO(Readout, TestPacket2);
 
@@ -213,18 +223,19 @@ TEST_F(CaenBaseTest, DataReceiveGoodMiraclesForceUpdate) {
 
 
 TEST_F(CaenBaseTest, EmulateFIFOError) {
-  Caen::CaenBase Readout(Settings, ESSReadout::Parser::LOKI);
+  Caen::CaenBase<Caen::LokiGeometry> Readout(
+      Settings, ESSReadout::Parser::LOKI);
   EXPECT_EQ(Readout.Counters.FifoSeqErrors, 0);
 
   Readout.startThreads();
 
-  unsigned int rxBufferIndex = Readout.RxRingbuffer.getDataIndex();
+  ASSERT_EQ(Readout.InputQueue.writable(), 1);
+  unsigned int rxBufferIndex = Readout.InputQueue.getWriteIndex();
   ASSERT_EQ(rxBufferIndex, 0);
 
-  Readout.RxRingbuffer.setDataLength(rxBufferIndex, 0); ///< invalid size
+  Readout.InputQueue.setDataLength(rxBufferIndex, 0); ///< invalid size
 
-  ASSERT_TRUE(Readout.InputFifo.push(rxBufferIndex));
-  Readout.RxRingbuffer.getNextBuffer();
+  Readout.InputQueue.push();
 
   waitForProcessing(Readout);
 
@@ -0,0 +1,122 @@
+// Copyright (C) 2024 European Spallation Source ERIC
+
+/// \file
+/// \brief Readouts per second through the geometry of each CAEN instrument,
+/// called through the Geometry base class (virtual dispatch, as before
+/// CaenInstrument was a template) and through the instrument's own geometry
+/// type (static dispatch, as in CaenInstrument<GeometryType>). Both run the
+/// readout loop of CaenInstrument::processReadouts(): validate each readout,
+/// then calculate the pixels of the packet. Packets hold valid readouts only.
+
+#include <benchmark/benchmark.h>
+#include <caen/CaenInstrument.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace Caen;
+
+namespace {
+constexpr unsigned int ReadoutsPerPacket{400};
+
+template <typename GeometryType> struct Files;
+template <> struct Files<LokiGeometry> {
+  static constexpr const char *Name{"loki"};
+  static constexpr const char *Config{LOKI_CONFIG};
+  static constexpr const char *Calib{LOKI_CALIB};
+};
+template <> struct Files<BifrostGeometry> {
+  static constexpr const char *Name{"bifrost"};
+  static constexpr const char *Config{BIFROST_CONFIG};
+  static constexpr const char *Calib{BIFROST_CALIB};
+};
+template <> struct Files<MiraclesGeometry> {
+  static constexpr const char *Name{"miracles"};
+  static constexpr const char *Config{MIRACLES_CONFIG};
+  static constexpr const char *Calib{MIRACLES_CALIB};
+};
+template <> struct Files<CspecGeometry> {
+  static constexpr const char *Name{"cspec"};
+  static constexpr const char *Config{CSPEC_CONFIG};
+  static constexpr const char *Calib{CSPEC_CALIB};
+};
+
+/// \brief instrument from the configuration and calibration files of the
+/// module, and a packet of readouts accepted by its geometry
+template <typename GeometryType> struct Instrument {
+  CaenCounters Counters;
+  BaseSettings Settings;
+  std::unique_ptr<CaenInstrument<GeometryType>> Caen;
+  std::vector<DataParser::CaenReadout> Packet;
+
+  Instrument() {
+    Settings.DetectorName = Files<GeometryType>::Name;
+    Settings.ConfigFile = Files<GeometryType>::Config;
+    Settings.CalibFile = Files<GeometryType>::Calib;
+    Caen = std::make_unique<CaenInstrument<GeometryType>>(Counters, Settings);
+
+    std::mt19937 Generator(1);
+    std::uniform_int_distribution<int> Fiber(0, 23);
+    std::uniform_int_distribution<int> FEN(0, 3);
+    std::uniform_int_distribution<int> Group(0, 255);
+    std::uniform_int_distribution<int> Amplitude(0, 4000);
+    while (Packet.size() < ReadoutsPerPacket) {
+      DataParser::CaenReadout Readout{};
+      Readout.FiberId = Fiber(Generator);
+      Readout.FENId = FEN(Generator);
+      Readout.Group = Group(Generator);
+      Readout.AmpA = Amplitude(Generator);
+      Readout.AmpB = Amplitude(Generator);
+      Readout.AmpC = Amplitude(Generator);
+      Readout.AmpD = Amplitude(Generator);
+      if (Caen->Geom->validateData(Readout)) {
+        Packet.push_back(Readout);
+      }
+    }
+    Caen->Geom->Stats = {};
+  }
+};
+
+template <typename GeometryPtr>
+void run(benchmark::State &state,
+         const std::vector<DataParser::CaenReadout> &Packet,
+         GeometryPtr Geom) {
+  ReadoutColumns Columns;
+  std::vector<uint32_t> Pixels(Packet.size());
+  for (auto _ : state) {
+    Columns.clear();
+    for (const auto &Readout : Packet) {
+      if (Geom->validateData(Readout)) {
+        Columns.push_back(Readout);
+      }
+    }
+    Geom->calcPixels(Columns, Pixels.data());
+    benchmark::DoNotOptimize(Pixels.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * Packet.size());
+}
+} // namespace
+
+template <typename GeometryType> static void Virtual(benchmark::State &state) {
+  Instrument<GeometryType> Instr;
+  Geometry *Geom = Instr.Caen->Geom;
+  benchmark::DoNotOptimize(Geom); // hide the dynamic type from the compiler
+  run(state, Instr.Packet, Geom);
+}
+BENCHMARK_TEMPLATE(Virtual, LokiGeometry);
+BENCHMARK_TEMPLATE(Virtual, BifrostGeometry);
+BENCHMARK_TEMPLATE(Virtual, MiraclesGeometry);
+BENCHMARK_TEMPLATE(Virtual, CspecGeometry);
+
+template <typename GeometryType> static void Static(benchmark::State &state) {
+  Instrument<GeometryType> Instr;
+  GeometryType *Geom = Instr.Caen->Geom;
+  run(state, Instr.Packet, Geom);
+}
+BENCHMARK_TEMPLATE(Static, LokiGeometry);
+BENCHMARK_TEMPLATE(Static, BifrostGeometry);
+BENCHMARK_TEMPLATE(Static, MiraclesGeometry);
+BENCHMARK_TEMPLATE(Static, CspecGeometry);
+
+BENCHMARK_MAIN();
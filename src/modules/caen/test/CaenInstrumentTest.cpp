@@ -25,28 +25,28 @@ protected:
 // Test cases below
 TEST_F(CaenInstrumentTest, LokiConstructor) {
   Settings.CalibFile = LOKI_CALIB;
-  CaenInstrument Caen(counters, Settings);
+  CaenInstrument<LokiGeometry> Caen(counters, Settings);
 }
 
 TEST_F(CaenInstrumentTest, BifrostConstructor) {
   Settings.ConfigFile = BIFROST_CONFIG;
   Settings.CalibFile = BIFROST_CALIB;
   Settings.DetectorName = "bifrost";
-  CaenInstrument Caen(counters, Settings);
+  CaenInstrument<BifrostGeometry> Caen(counters, Settings);
 }
 
 TEST_F(CaenInstrumentTest, BifrostConstructorNoCalib) {
   Settings.ConfigFile = BIFROST_CONFIG;
   Settings.CalibFile = "";
   Settings.DetectorName = "bifrost";
-  ASSERT_ANY_THROW(CaenInstrument Caen(counters, Settings));
+  ASSERT_ANY_THROW(CaenInstrument<BifrostGeometry> Caen(counters, Settings));
 }
 
 TEST_F(CaenInstrumentTest, CspecConstructor) {
   Settings.ConfigFile = CSPEC_CONFIG;
   Settings.CalibFile = CSPEC_CALIB;
   Settings.DetectorName = "cspec";
-  CaenInstrument Caen(counters, Settings);
+  CaenInstrument<CspecGeometry> Caen(counters, Settings);
 }
 
 int main(int argc, char **argv) {
@@ -2,6 +2,7 @@
 
 #include <caen/readout/DataParser.h>
 #include <caen/test/DataParserTestData.h>
+#include <common/testutils/ReadoutSchemaUtil.h>
 #include <common/testutils/TestBase.h>
 
 using namespace Caen;
@@ -92,6 +93,8 @@ TEST_F(DataParserTest, MultipleDataSection) {
   ASSERT_EQ(Parser.Stats.DataLenMismatch, 0);
   ASSERT_EQ(Parser.Stats.DataLenInvalid, 0);
   ASSERT_EQ(Parser.Result.size(), 2);
+  // readouts are not copied
+  ASSERT_EQ((void *)Parser.Result.data(), (void *)&Ok2xCaenReadout[0]);
 }
 
 TEST_F(DataParserTest, MultipleDataPackets) {
@@ -128,6 +131,16 @@ TEST_F(DataParserTest, BadThreeReadouts) {
   ASSERT_EQ(Parser.Result.size(), 0);
 }
 
+// one test per checked field, generated from the readout schema
+TEST_F(DataParserTest, SchemaFieldErrors) {
+  ESSReadout::Schema::checkFieldErrors<CaenSchema>(
+      ESSReadout::Schema::validReadout<CaenSchema>(), Parser.Stats,
+      [&](const DataParser::CaenReadout &Readout) {
+        return Parser.parse((char *)&Readout, sizeof(Readout));
+      },
+      2);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,64 @@
+// Copyright (C) 2024 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Checks of Geometry::calcPixels() against calcPixel() shared by
+/// the tests of the CAEN geometries
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <caen/geometry/Geometry.h>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+namespace Caen {
+
+/// \brief Count random readouts with FiberId, FENId and Group drawn from
+/// [0; MaxFiber], [0; MaxFEN] and [0; MaxGroup]. The amplitudes of every
+/// 50th readout sum to zero, half of these have all amplitudes zero.
+inline ReadoutColumns randomReadouts(int MaxFiber, int MaxFEN, int MaxGroup,
+                                     int Count = 2000) {
+  std::mt19937 Generator(1);
+  std::uniform_int_distribution<int> Amplitude(-10, 2000);
+  std::uniform_int_distribution<int> Fiber(0, MaxFiber);
+  std::uniform_int_distribution<int> FEN(0, MaxFEN);
+  std::uniform_int_distribution<int> Group(0, MaxGroup);
+
+  ReadoutColumns Readouts;
+  DataParser::CaenReadout Readout{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+  for (int i = 0; i < Count; i++) {
+    Readout.FiberId = Fiber(Generator);
+    Readout.FENId = FEN(Generator);
+    Readout.Group = Group(Generator);
+    if (i % 50 == 0) {
+      Readout.AmpA = (i % 100) - 50;
+      Readout.AmpB = -Readout.AmpA;
+      Readout.AmpC = 0;
+      Readout.AmpD = 0;
+    } else {
+      Readout.AmpA = Amplitude(Generator);
+      Readout.AmpB = Amplitude(Generator);
+      Readout.AmpC = Amplitude(Generator);
+      Readout.AmpD = Amplitude(Generator);
+    }
+    Readouts.push_back(Readout);
+  }
+  return Readouts;
+}
+
+/// \brief the pixels from Batch.calcPixels() must be those from
+/// Single.calcPixel() for every readout
+template <typename GeometryType>
+void checkCalcPixels(GeometryType &Batch, GeometryType &Single,
+                     const ReadoutColumns &Readouts) {
+  std::vector<uint32_t> Pixels(Readouts.size());
+  Batch.calcPixels(Readouts, Pixels.data());
+  for (size_t i = 0; i < Readouts.size(); i++) {
+    ASSERT_EQ(Pixels[i], Single.calcPixel(Readouts.readout(i)));
+  }
+}
+
+} // namespace Caen
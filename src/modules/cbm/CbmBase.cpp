@@ -20,7 +20,6 @@
 #include <unistd.h>
 
 #include <common/RuntimeStat.h>
-#include <common/memory/SPSCFifo.h>
 #include <common/system/Socket.h>
 #include <common/time/TimeString.h>
 #include <common/time/Timer.h>
@@ -47,6 +46,26 @@ CbmBase::CbmBase(BaseSettings const &settings)
   Stats.create("receive.packets", ITCounters.RxPackets);
   Stats.create("receive.bytes", ITCounters.RxBytes);
   Stats.create("receive.dropped", ITCounters.FifoPushErrors);
+  for (int i = 0; i < RxBatchHistBins; i++) {
+    std::string statname = fmt::format("receive.batch_size.{:02}", i);
+    Stats.create(statname, ITCounters.RxBatchSize[i]);
+  }
+  Stats.create("receive.gro_calls", ITCounters.RxGroCalls);
+  Stats.create("receive.gro_segments", ITCounters.RxGroSegments);
+  Stats.create("receive.gro_segments_avg", ITCounters.RxGroSegmentsAvg);
+  Stats.create("receive.gro_copies", ITCounters.RxGroCopies);
+  Stats.create("receive.gro_oversize", ITCounters.RxGroOversize);
+  Stats.create("receive.queue_backing", ITCounters.RxQueueBacking);
+  Stats.create("receive.queue_bytes", ITCounters.RxQueueBytes);
+  Stats.create("receive.queue_locked", ITCounters.RxQueueLocked);
+  Stats.create("receive.queue_high_water", ITCounters.RxQueueHighWater);
+  for (int i = 0; i < RxQueueFillBins; i++) {
+    std::string statname = fmt::format("receive.queue_fill.{:02}", i);
+    Stats.create(statname, ITCounters.RxQueueFill[i]);
+  }
+  Stats.create("receive.kernel_drops", ITCounters.RxKernelDrops);
+  Stats.create("receive.kernel_drops_interval",
+               ITCounters.RxKernelDropsInterval);
   Stats.create("receive.fifo_seq_errors", Counters.FifoSeqErrors);
 
   // ESS Readout header stats
@@ -94,6 +113,12 @@ CbmBase::CbmBase(BaseSettings const &settings)
   //
   Stats.create("thread.receive_idle", ITCounters.RxIdle);
   Stats.create("thread.processing_idle", Counters.ProcessingIdle);
+  Stats.create("thread.processing_idle_spin_ns", Idle.Stats.SpinNs);
+  Stats.create("thread.processing_idle_yield_ns", Idle.Stats.YieldNs);
+  Stats.create("thread.processing_idle_wait_ns", Idle.Stats.WaitNs);
+  Stats.create("thread.processing_idle_waits", Idle.Stats.Waits);
+  Stats.create("thread.processing_idle_wakeups", Idle.Stats.WaitWakeups);
+  createLatencyStats();
 
   // Produce cause call stats
   Stats.create("produce.cause.timeout", Counters.ProduceCauseTimeout);
@@ -126,7 +151,7 @@ CbmBase::CbmBase(BaseSettings const &settings)
   Detector::AddThreadFunction(processingFunc, "processing");
 
   XTRACE(INIT, ALW, "Creating %d CBM Rx ringbuffers of size %d",
-         EthernetBufferMaxEntries, EthernetBufferSize);
+         InputQueue.getMaxElements(), EthernetBufferSize);
 }
 
 void CbmBase::processing_thread() {
@@ -141,6 +166,7 @@ void CbmBase::processing_thread() {
   KafkaConfig KafkaCfg(EFUSettings.KafkaConfigFile);
   Producer eventprod(EFUSettings.KafkaBroker, EFUSettings.KafkaTopic,
                      KafkaCfg.CfgParms);
+  eventprod.setDeliveryLatency(&Latency.SerializedDelivered);
   auto Produce = [&eventprod](auto DataBuffer, auto Timestamp) {
     eventprod.produce(DataBuffer, Timestamp);
   };
@@ -164,16 +190,21 @@ void CbmBase::processing_thread() {
   RuntimeStat RtStat(
       {ITCounters.RxPackets, Counters.MonitorCounts, Counters.KafkaStats.produce_bytes_ok});
 
+  cbmInstrument.ESSReadoutParser.setHeaderVersion(
+      EFUSettings.HeaderVersion, cbmInstrument.Conf.Parms.TypeSubType);
+
   while (runThreads) {
-    if (InputFifo.pop(DataIndex)) { // There is data in the FIFO - do processing
-      auto DataLen = RxRingbuffer.getDataLength(DataIndex);
+    if (InputQueue.pop(DataIndex)) { // There is data in the queue - do processing
+      Idle.reset();
+      Latency.dequeued(InputQueue.getArrivalTime(DataIndex));
+      auto DataLen = InputQueue.getDataLength(DataIndex);
       if (DataLen == 0) {
         Counters.FifoSeqErrors++;
         continue;
       }
 
       /// \todo use the Buffer<T> class here and in parser
-      auto DataPtr = RxRingbuffer.getDataBuffer(DataIndex);
+      auto DataPtr = InputQueue.getDataBuffer(DataIndex);
 
       int64_t SeqErrOld = Counters.ReadoutStats.ErrorSeqNum;
       auto Res = cbmInstrument.ESSReadoutParser.validate(
@@ -196,20 +227,26 @@ void CbmBase::processing_thread() {
 
       // We have good header information, now parse readout data
       cbmInstrument.CbmParser.parse(cbmInstrument.ESSReadoutParser.Packet);
+      Latency.parsed();
       Counters.CbmStats = cbmInstrument.CbmParser.Stats;
       Counters.TimeStats = cbmInstrument.ESSReadoutParser.Packet.Time.Stats;
 
       cbmInstrument.processMonitorReadouts();
+      Latency.serialized();
 
     } else {
-      // There is NO data in the FIFO - increment idle counter and sleep a
+      // There is NO data in the queue - increment idle counter and sleep a
       // little
       Counters.ProcessingIdle++;
-      usleep(10);
+      Idle.idle(InputQueue);
     }
 
+    // Serve delivery reports also when nothing is being produced
+    eventprod.poll();
+
     // Not only flush serializer data but also update runtime stats
     if (ProduceTimer.timeout()) {
+      Latency.update();
       RuntimeStatusMask = RtStat.getRuntimeStatusMask(
           {ITCounters.RxPackets, Counters.MonitorCounts, Counters.KafkaStats.produce_bytes_ok});
 
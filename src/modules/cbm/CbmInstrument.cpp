@@ -47,7 +47,8 @@ void CbmInstrument::processMonitorReadouts(void) {
 
   XTRACE(DATA, DEB, "processMonitorReadouts() - has %zu entries",
          CbmParser.Result.size());
-  for (const auto &readout : CbmParser.Result) {
+  for (const auto *ReadoutPtr : CbmParser.Result) {
+    const auto &readout = *ReadoutPtr;
 
     XTRACE(DATA, DEB,
            "readout: FiberId %d, FENId %d, POS %d, Type %d, Channel %d, ADC "
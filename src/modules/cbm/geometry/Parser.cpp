@@ -8,7 +8,6 @@
 /// Stat counters accumulate
 //===----------------------------------------------------------------------===//
 
-#include <CbmTypes.h>
 #include <cbm/geometry/Parser.h>
 #include <common/debug/Trace.h>
 
@@ -46,58 +45,19 @@ void Parser::parse(ESSReadout::Parser::PacketDataV0 &PacketData) {
     return;
   }
 
-  Parser::CbmReadout *DataPtr = (struct CbmReadout *)Buffer;
-  for (unsigned int i = 0; i < Size / DataLength; i++) {
-    Stats.Readouts++;
-    Parser::CbmReadout Readout = DataPtr[i];
-    if (Readout.FiberId > MaxFiberId) {
-      XTRACE(DATA, WAR, "Invalid FiberId %d (Max is %d)", Readout.FiberId,
-             MaxFiberId);
-      Stats.ErrorFiber++;
-      continue;
-    }
-
-    if (Readout.FENId > MaxFENId) {
-      XTRACE(DATA, WAR, "Invalid FENId %d (valid: 0 - %d)", Readout.FENId,
-             MaxFENId);
-      Stats.ErrorFEN++;
-      continue;
-    }
-
-    if (Readout.Type > CbmType::MAX || Readout.Type < CbmType::MIN) {
-      XTRACE(DATA, WAR, "Invalid data type %d (valid: %d - %d)", Readout.Type,
-             CbmType::MIN, CbmType::MAX);
-      Stats.ErrorType++;
-      continue;
-    }
+  TOFs.clear();
+  ESSReadout::Schema::parseFixed<CbmSchema>(
+      Buffer, Size / DataLength, Stats, [&](const CbmReadout &Readout) {
+        TOFs.add(Readout.TimeHigh, Readout.TimeLow);
+        Result.push_back(&Readout);
+      });
 
-    if (Readout.DataLength != DataLength) {
-      XTRACE(DATA, WAR, "Invalid header length %d - must be %d bytes",
-             Readout.DataLength, DataLength);
-      Stats.ErrorDataLength++;
-      continue;
-    }
-
-    // Check for invalid ADC values only for TTL readouts
-    if (Readout.Type == CbmType::TTL && Readout.ADC == 0) {
-      XTRACE(DATA, WAR, "Invalid ADC (0)");
-      Stats.ErrorADC++;
-    } else if (Readout.Type != CbmType::TTL && Readout.ADC != 0) {
-      XTRACE(DATA, WAR, "Invalid ADC unsued for this type should be 0");
-      Stats.ErrorADC++;
-      continue;
-    }
-
-    if (Readout.TimeLow > ESSReadout::MaxFracTimeCount) {
-      XTRACE(DATA, WAR, "Invalid TimeLO %u (max is %u)", Readout.TimeLow,
-             ESSReadout::MaxFracTimeCount);
-      Stats.ErrorTimeFrac++;
-      continue;
-    }
+  // Check for negative TOFs, for all readouts of the packet at once
+  TOFs.calculate(TimeRef);
 
-    // Check for negative TOFs
-    auto TimeOfFlight =
-        TimeRef.getTOF(ESSTime(Readout.TimeHigh, Readout.TimeLow));
+  size_t Kept{0};
+  for (size_t i = 0; i < Result.size(); i++) {
+    auto TimeOfFlight = TOFs.TOF[i];
     XTRACE(DATA, DEB, "PulseTime     %" PRIu64 ", TimeOfFlight %" PRIu64 " ",
            TimeRef.getRefTimeUInt64(), TimeOfFlight);
 
@@ -107,8 +67,9 @@ void Parser::parse(ESSReadout::Parser::PacketDataV0 &PacketData) {
       continue;
     }
 
-    Result.push_back(Readout);
+    Result[Kept++] = Result[i];
   }
+  Result.resize(Kept);
 
   return;
 }
@@ -11,6 +11,8 @@
 
 #include <cinttypes>
 #include <common/readout/ess/Parser.h>
+#include <common/readout/ess/ReadoutSchema.h>
+#include <modules/cbm/CbmTypes.h>
 #include <cstdint>
 #include <vector>
 
@@ -30,9 +32,9 @@ struct ParserStats {
 
 class Parser {
 public:
-  const unsigned int MaxFiberId{23};
-  const unsigned int MaxFENId{23};
-  const unsigned int MaxReadoutsInPacket{600};
+  static constexpr unsigned int MaxFiberId{23};
+  static constexpr unsigned int MaxFENId{23};
+  static constexpr unsigned int MaxReadoutsInPacket{600};
 
 // From TTLMon ICD (CBM ICD) version 1 draft 2 - 4
 // Preliminary agreed 2023 09 12 (Francesco, Farnaz, Fabio)
@@ -61,19 +63,58 @@ public:
   static_assert(sizeof(Parser::CbmReadout) == (DATASIZE),
                 "Wrong header size (update assert or check packing)");
 
-  Parser() { Result.reserve(MaxReadoutsInPacket); };
+  /// \brief the ADC is only used for TTL readouts
+  static bool adcUnusedIsZero(const CbmReadout &Readout) {
+    return Readout.Type == CbmType::TTL or Readout.ADC == 0;
+  }
+
+  /// \brief a TTL readout with ADC 0 is counted as an error but kept
+  static bool ttlAdcIsSet(const CbmReadout &Readout) {
+    return Readout.Type != CbmType::TTL or Readout.ADC != 0;
+  }
+
+  Parser() {
+    Result.reserve(MaxReadoutsInPacket);
+    TOFs.reserve(MaxReadoutsInPacket);
+  };
 
   ~Parser(){};
 
   //
   void parse(ESSReadout::Parser::PacketDataV0 &PacketData);
 
-  // To be iterated over in processing thread
-  std::vector<struct CbmReadout> Result;
+  // To be iterated over in processing thread. Points into the parsed
+  // buffer, which must outlive the processing of the readouts
+  std::vector<const CbmReadout *> Result;
 
   struct ParserStats Stats;
 
 private:
   const uint16_t DataLength{DATASIZE};
+  esstime::TOFBatch TOFs; // times of readouts passing the checks before TOF
+};
+
+/// \brief CBM readout checks, see common/readout/ess/ReadoutSchema.h
+struct CbmSchema {
+  using Readout = Parser::CbmReadout;
+  using Stats = ParserStats;
+
+  using Header = ESSReadout::Schema::Fields<
+      ESSReadout::Schema::Range<&Readout::FiberId, 0, Parser::MaxFiberId,
+                                &Stats::ErrorFiber>,
+      ESSReadout::Schema::Range<&Readout::FENId, 0, Parser::MaxFENId,
+                                &Stats::ErrorFEN>,
+      ESSReadout::Schema::Range<&Readout::Type, CbmType::MIN, CbmType::MAX,
+                                &Stats::ErrorType>,
+      ESSReadout::Schema::Equal<&Readout::DataLength, DATASIZE,
+                                &Stats::ErrorDataLength>>;
+  using Body = ESSReadout::Schema::Fields<
+      ESSReadout::Schema::Check<&Parser::adcUnusedIsZero, &Stats::ErrorADC>,
+      ESSReadout::Schema::Warn<&Parser::ttlAdcIsSet, &Stats::ErrorADC>,
+      ESSReadout::Schema::Range<&Readout::TimeLow, 0,
+                                ESSReadout::MaxFracTimeCount,
+                                &Stats::ErrorTimeFrac>>;
+
+  static constexpr auto Readouts{&Stats::Readouts};
 };
 } // namespace cbm
@@ -8,6 +8,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <common/readout/ess/Parser.h>
+#include <common/testutils/ReadoutSchemaUtil.h>
 #include <common/testutils/TestBase.h>
 #include <modules/cbm/geometry/Parser.h>
 
@@ -213,6 +214,21 @@ TEST_F(CbmParserTest, CheckADCValues) {
   ASSERT_EQ(parser.Stats.Readouts, 4);
 }
 
+// one test per checked field, generated from the readout schema
+TEST_F(CbmParserTest, SchemaFieldErrors) {
+  auto Good = ESSReadout::Schema::validReadout<CbmSchema>();
+  Good.ADC = 1; // TTL
+  ESSReadout::Schema::checkFieldErrors<CbmSchema>(
+      Good, parser.Stats,
+      [&](const Parser::CbmReadout &Readout) {
+        PacketData.DataPtr = (char *)&Readout;
+        PacketData.DataLength = sizeof(Readout);
+        parser.parse(PacketData);
+        return parser.Result.size();
+      },
+      5);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -25,31 +25,6 @@ CspecGeometry::CspecGeometry(Config &CaenConfiguration) {
   MaxGroup = CaenConfiguration.MaxGroup;
 }
 
-bool CspecGeometry::validateData(DataParser::CaenReadout &Data) {
-  int Ring = Data.FiberId / 2;
-  XTRACE(DATA, DEB, "FiberId: %u, Ring %d, FEN %u, Group %u", Data.FiberId,
-         Ring, Data.FENId, Data.Group);
-
-  if (Ring > MaxRing) {
-    XTRACE(DATA, WAR, "RING %d is incompatible with config", Ring);
-    Stats.RingErrors++;
-    return false;
-  }
-
-  if (Data.FENId > MaxFEN) {
-    XTRACE(DATA, WAR, "FEN %d is incompatible with config", Data.FENId);
-    Stats.FENErrors++;
-    return false;
-  }
-
-  if (Data.Group > MaxGroup) {
-    XTRACE(DATA, WAR, "Group %d is incompatible with config", Data.Group);
-    Stats.GroupErrors++;
-    return false;
-  }
-  return true;
-}
-
 int CspecGeometry::xOffset(int Ring, int Group) {
   ///\todo Determine the 'real' x-offset once a new ICD is decided for 3He CSPEC
   return Ring * NPos + (Group % 24) * (NPos / 24);
@@ -63,7 +38,7 @@ int CspecGeometry::posAlongUnit(int AmpA, int AmpB) {
   return ((NPos - 1) * AmpA) / (AmpA + AmpB);
 }
 
-uint32_t CspecGeometry::calcPixel(DataParser::CaenReadout &Data) {
+uint32_t CspecGeometry::calcPixel(const DataParser::CaenReadout &Data) {
   int Ring = Data.FiberId / 2;
   int xoff = xOffset(Ring, Data.Group);
   int ylocal = yCoord(Data.AmpA, Data.AmpB);
@@ -74,4 +49,29 @@ uint32_t CspecGeometry::calcPixel(DataParser::CaenReadout &Data) {
   return pixel;
 }
 
+/// The integer division of posAlongUnit() is done in double precision, which
+/// vectorises. For amplitudes of 16 bits the rounding error of the quotient is
+/// far below its distance to the next integer, so the truncation is the same.
+/// A zero sum gives -1 (invalid) through a mask instead of a branch.
+void CspecGeometry::calcPixels(const ReadoutColumns &Readouts,
+                               uint32_t *Pixels) {
+  const size_t Count = Readouts.size();
+  Batch.resize(Count);
+  const int Resolution = NPos;
+
+  for (size_t i = 0; i < Count; i++) {
+    int Ring = Readouts.FiberId[i] / 2;
+    int AmpA = Readouts.AmpA[i];
+    int Sum = AmpA + Readouts.AmpB[i];
+    int Divisor = Sum + (Sum == 0);
+    int Pos = 1.0 * (Resolution - 1) * AmpA / Divisor;
+
+    Batch.X[i] = Ring * Resolution +
+                 (Readouts.Group[i] % 24) * (Resolution / 24);
+    Batch.Y[i] = Pos | -(Sum == 0);
+  }
+
+  pixels2D(Count, Pixels);
+}
+
 } // namespace Caen
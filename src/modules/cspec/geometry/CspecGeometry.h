@@ -20,11 +20,37 @@
 // #define TRC_LEVEL TRC_L_DEB
 
 namespace Caen {
-class CspecGeometry : public Geometry {
+class CspecGeometry final : public Geometry {
 public:
   CspecGeometry(Config &CaenConfiguration);
-  uint32_t calcPixel(DataParser::CaenReadout &Data);
-  bool validateData(DataParser::CaenReadout &Data);
+  uint32_t calcPixel(const DataParser::CaenReadout &Data);
+  bool validateData(const DataParser::CaenReadout &Data) {
+    int Ring = Data.FiberId / 2;
+    XTRACE(DATA, DEB, "FiberId: %u, Ring %d, FEN %u, Group %u", Data.FiberId,
+           Ring, Data.FENId, Data.Group);
+
+    if (Ring > MaxRing) {
+      XTRACE(DATA, WAR, "RING %d is incompatible with config", Ring);
+      Stats.RingErrors++;
+      return false;
+    }
+
+    if (Data.FENId > MaxFEN) {
+      XTRACE(DATA, WAR, "FEN %d is incompatible with config", Data.FENId);
+      Stats.FENErrors++;
+      return false;
+    }
+
+    if (Data.Group > MaxGroup) {
+      XTRACE(DATA, WAR, "Group %d is incompatible with config", Data.Group);
+      Stats.GroupErrors++;
+      return false;
+    }
+    return true;
+  }
+
+  /// \brief coordinates and pixels are calculated over the columns
+  void calcPixels(const ReadoutColumns &Readouts, uint32_t *Pixels) override;
 
   /// \brief return the global x-offset for the given identifiers
   int xOffset(int Ring, int Group);
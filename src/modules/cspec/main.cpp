@@ -11,8 +11,8 @@
 int main(int argc, char *argv[]) {
   MainProg Main("cspec", argc, argv);
 
-  auto Detector =
-      new Caen::CaenBase(Main.DetectorSettings, ESSReadout::Parser::CSPEC);
+  auto Detector = new Caen::CaenBase<Caen::CspecGeometry>(
+      Main.DetectorSettings, ESSReadout::Parser::CSPEC);
 
   return Main.run(Detector);
 }
@@ -7,6 +7,7 @@
 ///
 //===----------------------------------------------------------------------===//
 #include <caen/readout/DataParser.h>
+#include <caen/test/GeometryTestUtil.h>
 #include <common/testutils/TestBase.h>
 #include <cspec/geometry/CspecGeometry.h>
 
@@ -105,6 +106,11 @@ TEST_F(CspecGeometryTest, Validate) {
   ASSERT_EQ(geom->Stats.GroupErrors, 1);
 }
 
+TEST_F(CspecGeometryTest, CalcPixelsMatchesCalcPixel) {
+  ReadoutColumns Readouts = randomReadouts(7, 0, 23);
+  checkCalcPixels(*geom, *geom, Readouts);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
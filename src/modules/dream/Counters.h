@@ -37,6 +37,7 @@ struct Counters {
   int64_t ProcessingIdle;
   int64_t Events;
   int64_t GeometryErrors;
+  int64_t PixelTableBytes{0};
 
   // Identification of the cause of produce calls
   int64_t ProduceCauseTimeout;
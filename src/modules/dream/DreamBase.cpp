@@ -39,6 +39,26 @@ DreamBase::DreamBase(BaseSettings const &Settings) : Detector(Settings) {
   Stats.create("receive.packets", ITCounters.RxPackets);
   Stats.create("receive.bytes", ITCounters.RxBytes);
   Stats.create("receive.dropped", ITCounters.FifoPushErrors);
+  for (int i = 0; i < RxBatchHistBins; i++) {
+    std::string statname = fmt::format("receive.batch_size.{:02}", i);
+    Stats.create(statname, ITCounters.RxBatchSize[i]);
+  }
+  Stats.create("receive.gro_calls", ITCounters.RxGroCalls);
+  Stats.create("receive.gro_segments", ITCounters.RxGroSegments);
+  Stats.create("receive.gro_segments_avg", ITCounters.RxGroSegmentsAvg);
+  Stats.create("receive.gro_copies", ITCounters.RxGroCopies);
+  Stats.create("receive.gro_oversize", ITCounters.RxGroOversize);
+  Stats.create("receive.queue_backing", ITCounters.RxQueueBacking);
+  Stats.create("receive.queue_bytes", ITCounters.RxQueueBytes);
+  Stats.create("receive.queue_locked", ITCounters.RxQueueLocked);
+  Stats.create("receive.queue_high_water", ITCounters.RxQueueHighWater);
+  for (int i = 0; i < RxQueueFillBins; i++) {
+    std::string statname = fmt::format("receive.queue_fill.{:02}", i);
+    Stats.create(statname, ITCounters.RxQueueFill[i]);
+  }
+  Stats.create("receive.kernel_drops", ITCounters.RxKernelDrops);
+  Stats.create("receive.kernel_drops_interval",
+               ITCounters.RxKernelDropsInterval);
   Stats.create("receive.fifo_seq_errors", Counters.FifoSeqErrors);
 
   // ESS Readout
@@ -73,10 +93,19 @@ DreamBase::DreamBase(BaseSettings const &Settings) : Detector(Settings) {
   //
   Stats.create("thread.input_idle", ITCounters.RxIdle);
   Stats.create("thread.processing_idle", Counters.ProcessingIdle);
+  Stats.create("thread.processing_idle_spin_ns", Idle.Stats.SpinNs);
+  Stats.create("thread.processing_idle_yield_ns", Idle.Stats.YieldNs);
+  Stats.create("thread.processing_idle_wait_ns", Idle.Stats.WaitNs);
+  Stats.create("thread.processing_idle_waits", Idle.Stats.Waits);
+  Stats.create("thread.processing_idle_wakeups", Idle.Stats.WaitWakeups);
+  createLatencyStats();
 
   Stats.create("events.count", Counters.Events);
   Stats.create("events.geometry_errors", Counters.GeometryErrors);
 
+  // Memory of the precomputed pixel tables
+  Stats.create("geometry.pixel_table_bytes", Counters.PixelTableBytes);
+
   Stats.create("transmit.monitor_packets", Counters.TxRawReadoutPackets);
 
   // Produce cause call stats
@@ -110,7 +139,7 @@ DreamBase::DreamBase(BaseSettings const &Settings) : Detector(Settings) {
   Detector::AddThreadFunction(processingFunc, "processing");
 
   XTRACE(INIT, ALW, "Creating %d Dream Rx ringbuffers of size %d",
-         EthernetBufferMaxEntries, EthernetBufferSize);
+         InputQueue.getMaxElements(), EthernetBufferSize);
 }
 
 ///
@@ -123,6 +152,7 @@ void DreamBase::processingThread() {
 
   Producer EventProducer(EFUSettings.KafkaBroker, EFUSettings.KafkaTopic,
                          KafkaCfg.CfgParms);
+  EventProducer.setDeliveryLatency(&Latency.SerializedDelivered);
 
   auto Produce = [&EventProducer](auto DataBuffer, auto Timestamp) {
     EventProducer.produce(DataBuffer, Timestamp);
@@ -145,9 +175,14 @@ void DreamBase::processingThread() {
 
   RuntimeStat RtStat({ITCounters.RxPackets, Counters.Events, Counters.KafkaStats.produce_bytes_ok});
 
+  Dream.ESSReadoutParser.setHeaderVersion(EFUSettings.HeaderVersion,
+                                          Dream.Type);
+
   while (runThreads) {
-    if (InputFifo.pop(DataIndex)) { // There is data in the FIFO - do processing
-      auto DataLen = RxRingbuffer.getDataLength(DataIndex);
+    if (InputQueue.pop(DataIndex)) { // There is data in the queue - do processing
+      Idle.reset();
+      Latency.dequeued(InputQueue.getArrivalTime(DataIndex));
+      auto DataLen = InputQueue.getDataLength(DataIndex);
       if (DataLen == 0) {
         Counters.FifoSeqErrors++;
         continue;
@@ -155,7 +190,7 @@ void DreamBase::processingThread() {
 
       /// \todo use the Buffer<T> class here and in parser?
       /// \todo avoid copying by passing reference to stats like for gdgem?
-      auto DataPtr = RxRingbuffer.getDataBuffer(DataIndex);
+      auto DataPtr = InputQueue.getDataBuffer(DataIndex);
 
       auto Res = Dream.ESSReadoutParser.validate(DataPtr, DataLen, Dream.Type);
       Counters.ReadoutStats = Dream.ESSReadoutParser.Stats;
@@ -169,9 +204,11 @@ void DreamBase::processingThread() {
       // We have good header information, now parse readout data
       Res = Dream.DreamParser.parse(Dream.ESSReadoutParser.Packet.DataPtr,
                                     Dream.ESSReadoutParser.Packet.DataLength);
+      Latency.parsed();
 
       // Process readouts, generate (end produce) events
       Dream.processReadouts();
+      Latency.serialized();
 
       // send monitoring data
       if (ITCounters.RxPackets % EFUSettings.MonitorPeriod < EFUSettings.MonitorSamples) {
@@ -181,13 +218,17 @@ void DreamBase::processingThread() {
         Counters.TxRawReadoutPackets++;
       }
 
-    } else { // There is NO data in the FIFO - do stop checks and sleep a little
+    } else { // There is NO data in the queue - do stop checks and idle
       Counters.ProcessingIdle++;
-      usleep(10);
+      Idle.idle(InputQueue);
     }
 
+    // Serve delivery reports also when nothing is being produced
+    EventProducer.poll();
+
     if (ProduceTimer.timetsc() >=
         EFUSettings.UpdateIntervalSec * 1000000 * TSC_MHZ) {
+      Latency.update();
 
       RuntimeStatusMask = RtStat.getRuntimeStatusMask(
           {ITCounters.RxPackets, Counters.Events, Counters.KafkaStats.produce_bytes_ok});
@@ -40,10 +40,36 @@ DreamInstrument::DreamInstrument(struct Counters &counters,
     throw std::runtime_error(
         "Unsupported instrument instance (not DREAM/MAGIC)");
   }
+
+  buildPixelTables();
+}
+
+void DreamInstrument::buildPixelTables() {
+  counters.PixelTableBytes = 0;
+  for (int Ring = 0; Ring <= DreamConfiguration.MaxRing; Ring++) {
+    for (int FEN = 0; FEN <= DreamConfiguration.MaxFEN; FEN++) {
+      Config::ModuleParms &Parms = DreamConfiguration.RMConfig[Ring][FEN];
+      if (not Parms.Initialised) {
+        continue;
+      }
+
+      PixelTable::Box Box = (DreamConfiguration.Instance == Config::DREAM)
+                                ? DreamGeom.getTableBox(Parms)
+                                : MagicGeom.getTableBox(Parms);
+      PixelTable &Table = PixelTables[Ring][FEN];
+      Table.build(Box, [&](const DataParser::DreamReadout &Data) {
+        return calcPixel(Parms, Data);
+      });
+      counters.PixelTableBytes += Table.getMemoryBytes();
+    }
+  }
+  LOG(INIT, Sev::Info, "Pixel tables use {} bytes", counters.PixelTableBytes);
+  XTRACE(INIT, ALW, "Pixel tables use %" PRIi64 " bytes",
+         counters.PixelTableBytes);
 }
 
 uint32_t DreamInstrument::calcPixel(Config::ModuleParms &Parms,
-                                    DataParser::DreamReadout &Data) {
+                                    const DataParser::DreamReadout &Data) {
   if (DreamConfiguration.Instance == Config::DREAM) {
     return DreamGeom.getPixel(Parms, Data);
   } else if (DreamConfiguration.Instance == Config::MAGIC) {
@@ -57,10 +83,12 @@ void DreamInstrument::processReadouts() {
   /// \todo We have a design issue here. Check is it a good approach to share
   /// the ownership of the buffer between the parser and the instrument.
   auto PacketHeader = ESSReadoutParser.Packet.HeaderPtr;
-  uint64_t PulseTime = Time.setReference(ESSReadout::ESSTime(
-      PacketHeader.getPulseHigh(), PacketHeader.getPulseLow()));
-  uint64_t PrevPulseTime = Time.setPrevReference(ESSTime(
-      PacketHeader.getPrevPulseHigh(), PacketHeader.getPrevPulseLow()));
+  Time.setReferences(
+      ESSReadout::ESSTime(PacketHeader.getPulseHigh(),
+                          PacketHeader.getPulseLow()),
+      ESSTime(PacketHeader.getPrevPulseHigh(), PacketHeader.getPrevPulseLow()));
+  uint64_t PulseTime = Time.getRefTimeUInt64();
+  uint64_t PrevPulseTime = Time.getPrevRefTimeUInt64();
 
   if (PulseTime - PrevPulseTime > DreamConfiguration.MaxPulseTimeDiffNS) {
     XTRACE(DATA, WAR, "PulseTime and PrevPulseTime too far apart: %" PRIu64 "",
@@ -78,8 +106,10 @@ void DreamInstrument::processReadouts() {
          PacketHeader.getPrevPulseLow());
   //
 
-  /// Traverse readouts, calculate pixels
-  for (auto &Data : DreamParser.Result) {
+  /// Traverse readouts, check configuration
+  ValidReadouts.clear();
+  TOFs.clear();
+  for (const auto &Data : DreamParser.Result) {
     int Ring = Data.FiberId / 2;
     XTRACE(DATA, DEB, "Ring %u, FEN %u", Ring, Data.FENId);
 
@@ -104,11 +134,20 @@ void DreamInstrument::processReadouts() {
       continue;
     }
 
-    auto TimeOfFlight = ESSReadoutParser.Packet.Time.getTOF(
-        ESSTime(Data.TimeHigh, Data.TimeLow));
+    ValidReadouts.push_back({&Data, &Parms});
+    TOFs.add(Data.TimeHigh, Data.TimeLow);
+  }
+
+  TOFs.calculate(ESSReadoutParser.Packet.Time);
+
+  /// Traverse configured readouts, calculate pixels
+  for (size_t i = 0; i < ValidReadouts.size(); i++) {
+    auto &Data = *ValidReadouts[i].first;
+    auto &Parms = *ValidReadouts[i].second;
+    auto TimeOfFlight = TOFs.TOF[i];
 
     // Calculate pixelid and apply calibration
-    uint32_t PixelId = calcPixel(Parms, Data);
+    uint32_t PixelId = lookupPixel(Data.FiberId / 2, Parms, Data);
     XTRACE(DATA, DEB, "PixelId: %u", PixelId);
 
     if (PixelId == 0) {
@@ -18,6 +18,8 @@
 #include <dream/geometry/DreamGeometry.h>
 #include <dream/geometry/MagicGeometry.h>
 #include <dream/readout/DataParser.h>
+#include <utility>
+#include <vector>
 
 namespace Dream {
 
@@ -39,7 +41,22 @@ public:
 
   //
   uint32_t calcPixel(Config::ModuleParms &Parms,
-                     DataParser::DreamReadout &Data);
+                     const DataParser::DreamReadout &Data);
+
+  /// \brief precompute the pixels of every configured module with
+  /// calcPixel(), the memory used is reported in counters.PixelTableBytes
+  void buildPixelTables();
+
+  /// \brief pixel from the table of the module, calculated by calcPixel()
+  /// for readouts outside the table
+  uint32_t lookupPixel(int Ring, Config::ModuleParms &Parms,
+                       const DataParser::DreamReadout &Data) {
+    uint32_t Pixel;
+    if (PixelTables[Ring][Data.FENId].lookup(Data, Pixel)) {
+      return Pixel;
+    }
+    return calcPixel(Parms, Data);
+  }
 
 public:
   /// \brief Stuff that 'ties' DREAM together
@@ -53,6 +70,15 @@ public:
   EV44Serializer *Serializer;
   DreamGeometry DreamGeom;
   MagicGeometry MagicGeom;
+  PixelTable PixelTables[Config::MaxRing + 1][Config::MaxFEN + 1];
+
+  /// Readouts of the current packet with a valid configuration, their
+  /// module parameters and event times, TOF is calculated for all of them
+  /// at once
+  std::vector<
+      std::pair<const DataParser::DreamReadout *, Config::ModuleParms *>>
+      ValidReadouts;
+  ESSReadout::TOFBatch TOFs;
 };
 
 } // namespace Dream
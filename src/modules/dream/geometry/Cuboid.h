@@ -100,7 +100,7 @@ public:
 
   //
   uint32_t getPixelId(Config::ModuleParms &Parms,
-                      DataParser::DreamReadout &Data) {
+                      const DataParser::DreamReadout &Data) {
     uint8_t Index = Parms.P1.Index;
     Index += Data.UnitId;
 
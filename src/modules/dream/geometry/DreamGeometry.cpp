@@ -16,7 +16,7 @@
 namespace Dream {
 
 int DreamGeometry::getPixel(Config::ModuleParms &Parms,
-                            DataParser::DreamReadout &Data) {
+                            const DataParser::DreamReadout &Data) {
 
   int Pixel{0};
   XTRACE(DATA, DEB, "Type: %u", Parms.Type);
@@ -52,6 +52,33 @@ int DreamGeometry::getPixel(Config::ModuleParms &Parms,
   return GlobalPixel;
 }
 
+PixelTable::Box DreamGeometry::getTableBox(const Config::ModuleParms &Parms) {
+  PixelTable::Box Box;
+  switch (Parms.Type) {
+  case Config::BwEndCap: // fallthrough
+  case Config::FwEndCap:
+    // SumoId is UnitId, the cassettes of SUMO 6 span the most cathodes
+    Box = {true, fwec.MinSumo, 4, 64, 160};
+    break;
+
+  case Config::Mantle:
+    // two counters of 32 wires
+    Box = {false, 0, 1, 64, mantle.StripsPerCass};
+    break;
+
+  case Config::HR: // fallthrough
+  case Config::SANS:
+    // two cuboids per FEN (Index, Index + 1) of eight cassettes,
+    // Anode / 32 + 2 * (Cathode / 32)
+    Box = {true, 0, 2, 64, 128};
+    break;
+  default:
+    XTRACE(INIT, WAR, "Unknown detector");
+    break;
+  }
+  return Box;
+}
+
 int DreamGeometry::getPixelOffset(Config::ModuleType Type) {
   int RetVal{-1};
   switch (Type) {
@@ -16,6 +16,7 @@
 #include <dream/geometry/Config.h>
 #include <dream/geometry/Cuboid.h>
 #include <dream/geometry/Mantle.h>
+#include <dream/geometry/PixelTable.h>
 #include <dream/geometry/SUMO.h>
 #include <dream/readout/DataParser.h>
 
@@ -29,7 +30,12 @@ public:
   int getPixelOffset(Config::ModuleType Type);
 
   /// \brief return pixel id from the digital identifiers
-  int getPixel(Config::ModuleParms &Parms, DataParser::DreamReadout &Data);
+  int getPixel(Config::ModuleParms &Parms,
+               const DataParser::DreamReadout &Data);
+
+  /// \brief return the readouts for which the pixels of a module are
+  /// precomputed, an empty box for unknown module types
+  PixelTable::Box getTableBox(const Config::ModuleParms &Parms);
 
   SUMO fwec{280, 256};
   SUMO bwec{616, 256};
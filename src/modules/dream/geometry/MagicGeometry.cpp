@@ -19,7 +19,7 @@
 namespace Dream {
 
 int MagicGeometry::getPixel(Config::ModuleParms &Parms,
-                            DataParser::DreamReadout &Data) {
+                            const DataParser::DreamReadout &Data) {
 
   int Pixel{0};
   XTRACE(DATA, DEB, "Type: %u", Parms.Type);
@@ -48,6 +48,26 @@ int MagicGeometry::getPixel(Config::ModuleParms &Parms,
   return GlobalPixel;
 }
 
+PixelTable::Box MagicGeometry::getTableBox(const Config::ModuleParms &Parms) {
+  PixelTable::Box Box;
+  switch (Parms.Type) {
+  case Config::PA:
+    // 16 cassettes, Anode / 32 + 4 * (Cathode / 64)
+    Box = {false, 0, 1, 128, 256};
+    break;
+
+  case Config::FR:
+    // two counters of 32 wires
+    Box = {false, 0, 1, 64, frdetector.StripsPerCass};
+    break;
+
+  default:
+    XTRACE(INIT, WAR, "Unknown detector");
+    break;
+  }
+  return Box;
+}
+
 ///\brief the pixel offset values are defined in the MAGIC ICD
 int MagicGeometry::getPixelOffset(Config::ModuleType Type) {
   int RetVal{-1};
@@ -43,7 +43,7 @@ public:
 
   /// \todo CHECK AND VALIDATE, THIS IS UNCONFIRMED
   uint32_t getPixelId(Config::ModuleParms &Parms,
-                      DataParser::DreamReadout &Data) {
+                      const DataParser::DreamReadout &Data) {
     uint8_t Sector = Parms.P1.Sector;
     ///\todo two sumos per CDRE or just one?
 
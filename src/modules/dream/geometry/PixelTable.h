@@ -0,0 +1,75 @@
+// Copyright (C) 2024 European Spallation Source, see LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Precomputed global pixels of a configured DREAM/MAGIC module
+///
+/// The pixel of a readout only depends on the module parameters, which are
+/// fixed after configuration, and on UnitId, Anode and Cathode. The table
+/// holds the global pixel for every combination of these within a box
+/// chosen per module type, so the pixel calculation becomes a bounds check
+/// and a load. Readouts outside the box use the formulae instead.
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cinttypes>
+#include <dream/readout/DataParser.h>
+#include <vector>
+
+namespace Dream {
+
+class PixelTable {
+public:
+  /// \brief the readouts covered by the table. If PerUnit is false the
+  /// pixel does not depend on UnitId and the table has a single unit.
+  struct Box {
+    bool PerUnit{false};
+    uint8_t FirstUnit{0};
+    uint16_t Units{1};
+    uint16_t Anodes{0};
+    uint16_t Cathodes{0};
+  };
+
+  /// \brief fill the table with the global pixels calculated by PixelFn for
+  /// every UnitId, Anode and Cathode of the box
+  template <typename PixelFn> void build(const Box &TableBox, PixelFn &&Pixel) {
+    Dims = TableBox;
+    Pixels.resize(Dims.Units * Dims.Anodes * Dims.Cathodes);
+
+    DataParser::DreamReadout Data{};
+    uint32_t Entry{0};
+    for (uint16_t Unit = 0; Unit < Dims.Units; Unit++) {
+      Data.UnitId = Dims.FirstUnit + Unit;
+      for (uint16_t Anode = 0; Anode < Dims.Anodes; Anode++) {
+        Data.Anode = Anode;
+        for (uint16_t Cathode = 0; Cathode < Dims.Cathodes; Cathode++) {
+          Data.Cathode = Cathode;
+          Pixels[Entry++] = Pixel(Data);
+        }
+      }
+    }
+  }
+
+  /// \brief look up the global pixel of a readout
+  /// \return false if the readout is outside the table
+  bool lookup(const DataParser::DreamReadout &Data, uint32_t &Pixel) const {
+    // readouts below FirstUnit wrap around to large values
+    unsigned int Unit = Dims.PerUnit ? Data.UnitId - Dims.FirstUnit : 0;
+    if ((Unit >= Dims.Units) or (Data.Anode >= Dims.Anodes) or
+        (Data.Cathode >= Dims.Cathodes)) {
+      return false;
+    }
+    Pixel = Pixels[(Unit * Dims.Anodes + Data.Anode) * Dims.Cathodes +
+                   Data.Cathode];
+    return true;
+  }
+
+  /// \brief memory used by the table in bytes
+  size_t getMemoryBytes() const { return Pixels.size() * sizeof(uint32_t); }
+
+  Box Dims;
+  std::vector<uint32_t> Pixels;
+};
+} // namespace Dream
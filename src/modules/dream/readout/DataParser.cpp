@@ -7,7 +7,6 @@
 //===----------------------------------------------------------------------===//
 
 #include <common/debug/Trace.h>
-#include <common/readout/ess/Parser.h>
 #include <dream/readout/DataParser.h>
 
 // #undef TRC_LEVEL
@@ -15,70 +14,14 @@
 
 namespace Dream {
 
-constexpr unsigned int DreamReadoutSize{sizeof(DataParser::DreamReadout)};
-
 // Assume we start after the PacketHeader
 int DataParser::parse(const char *Buffer, unsigned int Size) {
-  Result.clear();
-  unsigned int ParsedReadouts = 0;
-
-  unsigned int BytesLeft = Size;
-  char *DataPtr = (char *)Buffer;
-
-  while (BytesLeft) {
-    // Parse Data Header
-    if (BytesLeft < sizeof(ESSReadout::Parser::DataHeader)) {
-      XTRACE(DATA, WAR, "Not enough data left for header: %u", BytesLeft);
-      Stats.BufferErrors++;
-      return ParsedReadouts;
-    }
-
-    auto Data = (DreamReadout *)((char *)DataPtr);
-
-    if (BytesLeft < Data->DataLength) {
-      XTRACE(DATA, WAR, "Data size mismatch, header says %u got %d",
-             Data->DataLength, BytesLeft);
-      Stats.BufferErrors++;
-      return ParsedReadouts;
-    }
-
-    if (Data->FiberId > MaxFiberId) {
-      XTRACE(DATA, WAR, "Invalid FiberId (%u)", Data->FiberId);
-      Stats.FiberErrors++;
-      return ParsedReadouts;
-    }
-
-    if (Data->FENId > MaxFENId) {
-      XTRACE(DATA, WAR, "FENId (%u)", Data->FENId);
-      Stats.FENErrors++;
-      return ParsedReadouts;
-    }
-
-    XTRACE(DATA, DEB, "Fiber %u, FEN %u, Length %u", Data->FiberId, Data->FENId,
-           Data->DataLength);
-    Stats.DataHeaders++;
-
-    if (Data->DataLength != DreamReadoutSize) {
-      XTRACE(DATA, WAR, "Invalid data length %u, expected %u", Data->DataLength,
-             DreamReadoutSize);
-      Stats.DataLenErrors++;
-      return ParsedReadouts;
-    }
-
-    XTRACE(DATA, DEB,
-           "fiber %u, fen %u, time: 0x%08x %08x, OM %3u ,"
-           "Cathode 0x%3u Anode 0x%3u",
-           Data->FiberId, Data->FENId, Data->TimeHigh, Data->TimeLow, Data->OM,
-           Data->Cathode, Data->Anode);
-
-    ParsedReadouts++;
-    Stats.Readouts++;
-
-    Result.push_back(*Data);
-    BytesLeft -= Data->DataLength;
-    DataPtr += Data->DataLength;
-  }
+  unsigned int ParsedReadouts =
+      ESSReadout::Schema::parseStream<DreamSchema>(Buffer, Size, Stats);
+  XTRACE(DATA, DEB, "Parsed %u readouts from %u bytes", ParsedReadouts, Size);
 
+  // Readouts have a fixed size, so the valid ones are contiguous
+  Result = {(const DreamReadout *)Buffer, ParsedReadouts};
   return ParsedReadouts;
 }
 } // namespace Dream
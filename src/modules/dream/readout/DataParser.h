@@ -8,17 +8,18 @@
 
 #pragma once
 
+#include <common/memory/span.hpp>
 #include <common/readout/ess/Parser.h>
+#include <common/readout/ess/ReadoutSchema.h>
 #include <modules/dream/Counters.h>
-#include <vector>
 
 namespace Dream {
 
 class DataParser {
 public:
-  const unsigned int MaxFiberId{23};
-  const unsigned int MaxFENId{12};
-  const unsigned int MaxReadoutsInPacket{500};
+  static constexpr unsigned int MaxFiberId{23};
+  static constexpr unsigned int MaxFENId{12};
+  static constexpr unsigned int MaxReadoutsInPacket{500};
 
   struct DreamReadout {
     uint8_t FiberId;
@@ -35,17 +36,35 @@ public:
   static_assert(sizeof(DreamReadout) == 16,
                 "DREAM readout header length error");
 
-  DataParser(struct Counters &counters) : Stats(counters) {
-    Result.reserve(MaxReadoutsInPacket);
-  };
+  DataParser(struct Counters &counters) : Stats(counters){};
   ~DataParser(){};
 
   //
   int parse(const char *buffer, unsigned int size);
 
-  // To be iterated over in processing thread
-  std::vector<struct DreamReadout> Result;
+  // To be iterated over in processing thread. Points into the parsed
+  // buffer, which must outlive the processing of the readouts
+  nonstd::span<const DreamReadout> Result;
 
   struct Counters &Stats;
 };
+
+/// \brief DREAM readout checks, see common/readout/ess/ReadoutSchema.h
+struct DreamSchema {
+  using Readout = DataParser::DreamReadout;
+  using Stats = struct Counters;
+
+  using Header = ESSReadout::Schema::Fields<
+      ESSReadout::Schema::Range<&Readout::FiberId, 0, DataParser::MaxFiberId,
+                                &Stats::FiberErrors>,
+      ESSReadout::Schema::Range<&Readout::FENId, 0, DataParser::MaxFENId,
+                                &Stats::FENErrors>>;
+  using Body = ESSReadout::Schema::Fields<>;
+
+  static constexpr auto HeaderSizeErrors{&Stats::BufferErrors};
+  static constexpr auto BufferErrors{&Stats::BufferErrors};
+  static constexpr auto DataHeaders{&Stats::DataHeaders};
+  static constexpr auto DataLenErrors{&Stats::DataLenErrors};
+  static constexpr auto Readouts{&Stats::Readouts};
+};
 } // namespace Dream
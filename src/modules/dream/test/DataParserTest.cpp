@@ -7,6 +7,7 @@
 ///
 //===----------------------------------------------------------------------===//
 
+#include <common/testutils/ReadoutSchemaUtil.h>
 #include <common/testutils/TestBase.h>
 #include <dream/readout/DataParser.h>
 #include <dream/test/DataParserTestData.h>
@@ -81,6 +82,18 @@ TEST_F(DataParserTest, ParseThree) {
   ASSERT_EQ(Parser.Stats.BufferErrors, 0);
   ASSERT_EQ(Parser.Stats.DataLenErrors, 0);
   ASSERT_EQ(Parser.Result.size(), 3);
+  // readouts are not copied
+  ASSERT_EQ((void *)Parser.Result.data(), (void *)&OkThreeDreamReadouts[0]);
+}
+
+// one test per checked field, generated from the readout schema
+TEST_F(DataParserTest, SchemaFieldErrors) {
+  ESSReadout::Schema::checkFieldErrors<DreamSchema>(
+      ESSReadout::Schema::validReadout<DreamSchema>(), Parser.Stats,
+      [&](const DataParser::DreamReadout &Readout) {
+        return Parser.parse((char *)&Readout, sizeof(Readout));
+      },
+      2);
 }
 
 int main(int argc, char **argv) {
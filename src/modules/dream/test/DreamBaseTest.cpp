@@ -130,13 +130,13 @@ TEST_F(DreamBaseTest, EmulateFIFOError) {
 
   Readout.startThreads();
 
-  unsigned int rxBufferIndex = Readout.RxRingbuffer.getDataIndex();
+  ASSERT_EQ(Readout.InputQueue.writable(), 1);
+  unsigned int rxBufferIndex = Readout.InputQueue.getWriteIndex();
   ASSERT_EQ(rxBufferIndex, 0);
 
-  Readout.RxRingbuffer.setDataLength(rxBufferIndex, 0); ///< invalid size
+  Readout.InputQueue.setDataLength(rxBufferIndex, 0); ///< invalid size
 
-  ASSERT_TRUE(Readout.InputFifo.push(rxBufferIndex));
-  Readout.RxRingbuffer.getNextBuffer();
+  Readout.InputQueue.push();
 
   waitForProcessing(Readout);
 
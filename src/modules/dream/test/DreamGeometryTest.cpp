@@ -51,6 +51,29 @@ TEST_F(DreamGeometryTest, GetPixelError) {
   ASSERT_EQ(geometry.getPixel(Parms, Readout), 0);
 }
 
+TEST_F(DreamGeometryTest, TableBox) {
+  Parms.Type = Config::ModuleType::FwEndCap;
+  auto Box = geometry.getTableBox(Parms);
+  ASSERT_TRUE(Box.PerUnit);
+  ASSERT_EQ(Box.FirstUnit, 3);
+  ASSERT_EQ(Box.Units, 4);
+
+  Parms.Type = Config::ModuleType::Mantle;
+  Box = geometry.getTableBox(Parms);
+  ASSERT_FALSE(Box.PerUnit);
+  ASSERT_EQ(Box.Anodes, 64);
+  ASSERT_EQ(Box.Cathodes, 256);
+
+  Parms.Type = Config::ModuleType::SANS;
+  Box = geometry.getTableBox(Parms);
+  ASSERT_EQ(Box.Units, 2);
+}
+
+TEST_F(DreamGeometryTest, TableBoxError) {
+  Parms.Type = Config::ModuleType::PA;
+  ASSERT_EQ(geometry.getTableBox(Parms).Anodes, 0);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -81,6 +81,62 @@ TEST_F(DreamInstrumentTest, CalcPixelMagic) {
             245760 + 1);
 }
 
+/// \brief pixels from the tables, and from the formulae outside of them,
+/// must be the pixels calculated by the formulae for all readouts
+void checkPixelTables(DreamInstrument &Dream, int Modules) {
+  for (int FEN = 0; FEN < Modules; FEN++) {
+    auto &Parms = Dream.DreamConfiguration.RMConfig[0][FEN];
+    DataParser::DreamReadout Data{0, (uint8_t)FEN, 0, 0, 0, 0, 0, 0, 0};
+    for (int Unit = 0; Unit < 8; Unit++) {
+      Data.UnitId = Unit;
+      for (int Anode = 0; Anode < 256; Anode++) {
+        Data.Anode = Anode;
+        for (int Cathode = 0; Cathode < 256; Cathode++) {
+          Data.Cathode = Cathode;
+          ASSERT_EQ(Dream.lookupPixel(0, Parms, Data),
+                    Dream.calcPixel(Parms, Data));
+        }
+      }
+    }
+  }
+}
+
+TEST_F(DreamInstrumentTest, PixelTables) {
+  DreamInstrument Dream(counters, Settings);
+  ASSERT_EQ(counters.PixelTableBytes, 4 * 64 * 160 * 4);
+
+  Config::ModuleType Types[] = {Config::FwEndCap, Config::BwEndCap,
+                                Config::Mantle, Config::HR, Config::SANS};
+  for (int FEN = 0; FEN < 5; FEN++) {
+    auto &Parms = Dream.DreamConfiguration.RMConfig[0][FEN];
+    Parms.Initialised = true;
+    Parms.Type = Types[FEN];
+    Parms.P1.Index = 2 * FEN;
+    Parms.P2.Index = 6;
+  }
+  Dream.buildPixelTables();
+  ASSERT_EQ(counters.PixelTableBytes,
+            2 * 4 * 64 * 160 * 4 + 64 * 256 * 4 + 2 * 2 * 64 * 128 * 4);
+  checkPixelTables(Dream, 5);
+}
+
+TEST_F(DreamInstrumentTest, PixelTablesMagic) {
+  Settings.ConfigFile = ConfigFileMagic;
+  DreamInstrument Dream(counters, Settings);
+
+  Config::ModuleType Types[] = {Config::PA, Config::FR};
+  for (int FEN = 0; FEN < 2; FEN++) {
+    auto &Parms = Dream.DreamConfiguration.RMConfig[0][FEN];
+    Parms.Initialised = true;
+    Parms.Type = Types[FEN];
+    Parms.P1.Index = 3;
+    Parms.P2.Index = 4;
+  }
+  Dream.buildPixelTables();
+  ASSERT_EQ(counters.PixelTableBytes, 128 * 256 * 4 + 64 * 128 * 4);
+  checkPixelTables(Dream, 2);
+}
+
 TEST_F(DreamInstrumentTest, PulseTimeDiffTooLarge) {
   DreamInstrument Dream(counters, Settings);
 
@@ -106,7 +162,8 @@ TEST_F(DreamInstrumentTest, ProcessReadoutsMaxRing) {
   Dream.Serializer = new EV44Serializer(115000, "dream");
 
   // invalid FiberId
-  Dream.DreamParser.Result.push_back({12, 0, 0, 0, 0, 0, 6, 0, 0});
+  DataParser::DreamReadout Readout{12, 0, 0, 0, 0, 0, 6, 0, 0};
+  Dream.DreamParser.Result = {&Readout, 1};
   ASSERT_EQ(Dream.counters.RingMappingErrors, 0);
   Dream.processReadouts();
   ASSERT_EQ(Dream.counters.ConfigErrors, 1);
@@ -118,7 +175,8 @@ TEST_F(DreamInstrumentTest, ProcessReadoutsMaxFEN) {
   Dream.Serializer = new EV44Serializer(115000, "dream");
 
   // invalid FENId
-  Dream.DreamParser.Result.push_back({0, 12, 0, 0, 0, 0, 6, 0, 0});
+  DataParser::DreamReadout Readout{0, 12, 0, 0, 0, 0, 6, 0, 0};
+  Dream.DreamParser.Result = {&Readout, 1};
   ASSERT_EQ(Dream.counters.FENErrors, 0);
   Dream.processReadouts();
   ASSERT_EQ(Dream.counters.ConfigErrors, 0);
@@ -131,7 +189,8 @@ TEST_F(DreamInstrumentTest, ProcessReadoutsConfigError) {
   Dream.Serializer = new EV44Serializer(115000, "dream");
 
   // unconfigured ring,fen combination
-  Dream.DreamParser.Result.push_back({2, 2, 0, 0, 0, 0, 6, 0, 0});
+  DataParser::DreamReadout Readout{2, 2, 0, 0, 0, 0, 6, 0, 0};
+  Dream.DreamParser.Result = {&Readout, 1};
   ASSERT_EQ(Dream.counters.ConfigErrors, 0);
   Dream.processReadouts();
   ASSERT_EQ(Dream.counters.ConfigErrors, 1);
@@ -145,7 +204,8 @@ TEST_F(DreamInstrumentTest, ProcessReadoutsGeometryError) {
   Dream.Serializer = new EV44Serializer(115000, "dream");
 
   // geometry error (no sumo defined)
-  Dream.DreamParser.Result.push_back({0, 0, 0, 0, 0, 0, 0, 0, 0});
+  DataParser::DreamReadout Readout{0, 0, 0, 0, 0, 0, 0, 0, 0};
+  Dream.DreamParser.Result = {&Readout, 1};
   Dream.processReadouts();
   ASSERT_EQ(Dream.counters.ConfigErrors, 0);
   ASSERT_EQ(Dream.counters.RingMappingErrors, 0);
@@ -161,7 +221,8 @@ TEST_F(DreamInstrumentTest, ProcessReadoutsGood) {
   Dream.Serializer = new EV44Serializer(115000, "dream");
 
   // finally an event
-  Dream.DreamParser.Result.push_back({0, 0, 0, 0, 0, 0, 6, 0, 0});
+  DataParser::DreamReadout Readout{0, 0, 0, 0, 0, 0, 6, 0, 0};
+  Dream.DreamParser.Result = {&Readout, 1};
   ASSERT_EQ(Dream.counters.Events, 0);
   Dream.processReadouts();
   ASSERT_EQ(Dream.counters.ConfigErrors, 0);
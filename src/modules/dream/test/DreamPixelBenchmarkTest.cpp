@@ -0,0 +1,100 @@
+// Copyright (C) 2024 European Spallation Source ERIC
+
+/// \file
+/// \brief Readouts per second through the pixel tables of the full DREAM
+/// configuration (lookupPixel()) and through the geometry formulae
+/// (calcPixel()). The readouts are spread over all configured modules. Each
+/// iteration takes the next of state.range(0) packets: with one packet the
+/// tables stay in the cache, with many the table benchmark includes the
+/// cache misses caused by the table memory (the TableBytes counter).
+
+#include <benchmark/benchmark.h>
+#include <dream/DreamInstrument.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace Dream;
+
+namespace {
+constexpr unsigned int ReadoutsPerPacket{400};
+
+/// \brief DREAM instrument from the full configuration and packets of
+/// readouts from its configured modules
+struct Instrument {
+  struct Counters Counters;
+  BaseSettings Settings;
+  std::unique_ptr<DreamInstrument> Dream;
+  std::vector<DataParser::DreamReadout> Readouts;
+
+  explicit Instrument(unsigned int Packets) {
+    Settings.ConfigFile = DREAM_CONFIG;
+    Dream = std::make_unique<DreamInstrument>(Counters, Settings);
+
+    std::mt19937 Generator(1);
+    std::uniform_int_distribution<int> Ring(0, Config::MaxRing);
+    std::uniform_int_distribution<int> FEN(0, Config::MaxFEN);
+    std::uniform_int_distribution<int> Unit(0, 7);
+    std::uniform_int_distribution<int> Anode(0, 63);
+    std::uniform_int_distribution<int> Cathode(0, 159);
+    while (Readouts.size() < Packets * ReadoutsPerPacket) {
+      DataParser::DreamReadout Readout{};
+      Readout.FiberId = 2 * Ring(Generator);
+      Readout.FENId = FEN(Generator);
+      Readout.UnitId = Unit(Generator);
+      Readout.Anode = Anode(Generator);
+      Readout.Cathode = Cathode(Generator);
+      if (parms(Readout).Initialised) {
+        Readouts.push_back(Readout);
+      }
+    }
+  }
+
+  Config::ModuleParms &parms(const DataParser::DreamReadout &Readout) {
+    return Dream->DreamConfiguration.RMConfig[Readout.FiberId / 2]
+                                             [Readout.FENId];
+  }
+};
+} // namespace
+
+static void LookupPixel(benchmark::State &state) {
+  unsigned int Packets = state.range(0);
+  Instrument Instr(Packets);
+  std::vector<uint32_t> Pixels(ReadoutsPerPacket);
+  unsigned int Packet{0};
+  for (auto _ : state) {
+    const auto *Readouts = &Instr.Readouts[Packet * ReadoutsPerPacket];
+    Packet = (Packet + 1) % Packets;
+    for (unsigned int i = 0; i < ReadoutsPerPacket; i++) {
+      const auto &Readout = Readouts[i];
+      Pixels[i] = Instr.Dream->lookupPixel(Readout.FiberId / 2,
+                                           Instr.parms(Readout), Readout);
+    }
+    benchmark::DoNotOptimize(Pixels.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * ReadoutsPerPacket);
+  state.counters["TableBytes"] = Instr.Counters.PixelTableBytes;
+}
+BENCHMARK(LookupPixel)->Arg(1)->Arg(1024);
+
+static void CalcPixel(benchmark::State &state) {
+  unsigned int Packets = state.range(0);
+  Instrument Instr(Packets);
+  std::vector<uint32_t> Pixels(ReadoutsPerPacket);
+  unsigned int Packet{0};
+  for (auto _ : state) {
+    const auto *Readouts = &Instr.Readouts[Packet * ReadoutsPerPacket];
+    Packet = (Packet + 1) % Packets;
+    for (unsigned int i = 0; i < ReadoutsPerPacket; i++) {
+      const auto &Readout = Readouts[i];
+      Pixels[i] = Instr.Dream->calcPixel(Instr.parms(Readout), Readout);
+    }
+    benchmark::DoNotOptimize(Pixels.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * ReadoutsPerPacket);
+}
+BENCHMARK(CalcPixel)->Arg(1)->Arg(1024);
+
+BENCHMARK_MAIN();
@@ -37,6 +37,17 @@ TEST_F(MagicGeometryTest, GetPixel) {
   ASSERT_TRUE(geometry.getPixel(Parms, Readout) >= 245761);
 }
 
+TEST_F(MagicGeometryTest, TableBox) {
+  Parms.Type = Config::ModuleType::BwEndCap;
+  ASSERT_EQ(geometry.getTableBox(Parms).Anodes, 0);
+
+  Parms.Type = Config::ModuleType::FR;
+  ASSERT_EQ(geometry.getTableBox(Parms).Cathodes, 128);
+
+  Parms.Type = Config::ModuleType::PA;
+  ASSERT_EQ(geometry.getTableBox(Parms).Anodes, 128);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -16,7 +16,6 @@
 #include <unistd.h>
 
 #include <common/RuntimeStat.h>
-#include <common/memory/SPSCFifo.h>
 #include <common/system/Socket.h>
 #include <common/time/TSCTimer.h>
 #include <common/time/TimeString.h>
@@ -43,6 +42,26 @@ FreiaBase::FreiaBase(BaseSettings const &settings) : Detector(settings) {
   Stats.create("receive.packets", ITCounters.RxPackets);
   Stats.create("receive.bytes", ITCounters.RxBytes);
   Stats.create("receive.dropped", ITCounters.FifoPushErrors);
+  for (int i = 0; i < RxBatchHistBins; i++) {
+    std::string statname = fmt::format("receive.batch_size.{:02}", i);
+    Stats.create(statname, ITCounters.RxBatchSize[i]);
+  }
+  Stats.create("receive.gro_calls", ITCounters.RxGroCalls);
+  Stats.create("receive.gro_segments", ITCounters.RxGroSegments);
+  Stats.create("receive.gro_segments_avg", ITCounters.RxGroSegmentsAvg);
+  Stats.create("receive.gro_copies", ITCounters.RxGroCopies);
+  Stats.create("receive.gro_oversize", ITCounters.RxGroOversize);
+  Stats.create("receive.queue_backing", ITCounters.RxQueueBacking);
+  Stats.create("receive.queue_bytes", ITCounters.RxQueueBytes);
+  Stats.create("receive.queue_locked", ITCounters.RxQueueLocked);
+  Stats.create("receive.queue_high_water", ITCounters.RxQueueHighWater);
+  for (int i = 0; i < RxQueueFillBins; i++) {
+    std::string statname = fmt::format("receive.queue_fill.{:02}", i);
+    Stats.create(statname, ITCounters.RxQueueFill[i]);
+  }
+  Stats.create("receive.kernel_drops", ITCounters.RxKernelDrops);
+  Stats.create("receive.kernel_drops_interval",
+               ITCounters.RxKernelDropsInterval);
   Stats.create("receive.fifo_seq_errors", Counters.FifoSeqErrors);
   Stats.create("transmit.monitor_packets", Counters.TxRawReadoutPackets);
 
@@ -61,6 +80,9 @@ FreiaBase::FreiaBase(BaseSettings const &settings) : Detector(settings) {
   Stats.create("essheader.heartbeats", Counters.ReadoutStats.HeartBeats);
   Stats.create("essheader.version.v0", Counters.ReadoutStats.Version0Header);
   Stats.create("essheader.version.v1", Counters.ReadoutStats.Version1Header);
+  Stats.create("essheader.reorder.reordered", Counters.ReorderStats.Reordered);
+  Stats.create("essheader.reorder.timeouts", Counters.ReorderStats.Timeouts);
+  Stats.create("essheader.reorder.max_depth", Counters.ReorderStats.MaxDepth);
 
   //
   Stats.create("readouts.adc_max", Counters.MaxADC);
@@ -105,6 +127,12 @@ FreiaBase::FreiaBase(BaseSettings const &settings) : Detector(settings) {
   //
   Stats.create("thread.receive_idle", ITCounters.RxIdle);
   Stats.create("thread.processing_idle", Counters.ProcessingIdle);
+  Stats.create("thread.processing_idle_spin_ns", Idle.Stats.SpinNs);
+  Stats.create("thread.processing_idle_yield_ns", Idle.Stats.YieldNs);
+  Stats.create("thread.processing_idle_wait_ns", Idle.Stats.WaitNs);
+  Stats.create("thread.processing_idle_waits", Idle.Stats.Waits);
+  Stats.create("thread.processing_idle_wakeups", Idle.Stats.WaitWakeups);
+  createLatencyStats();
 
   // Produce cause call stats
   Stats.create("produce.cause.timeout", Counters.ProduceCauseTimeout);
@@ -150,7 +178,7 @@ FreiaBase::FreiaBase(BaseSettings const &settings) : Detector(settings) {
   Detector::AddThreadFunction(processingFunc, "processing");
 
   XTRACE(INIT, ALW, "Creating %d Freia Rx ringbuffers of size %d",
-         EthernetBufferMaxEntries, EthernetBufferSize);
+         InputQueue.getMaxElements(), EthernetBufferSize);
 }
 
 void FreiaBase::processing_thread() {
@@ -162,6 +190,7 @@ void FreiaBase::processing_thread() {
   KafkaConfig KafkaCfg(EFUSettings.KafkaConfigFile);
   Producer eventprod(EFUSettings.KafkaBroker, EFUSettings.KafkaTopic,
                      KafkaCfg.CfgParms);
+  eventprod.setDeliveryLatency(&Latency.SerializedDelivered);
   auto Produce = [&eventprod](auto DataBuffer, auto Timestamp) {
     eventprod.produce(DataBuffer, Timestamp);
   };
@@ -183,21 +212,29 @@ void FreiaBase::processing_thread() {
   // Monitor these counters
   RuntimeStat RtStat({ITCounters.RxPackets, Counters.Events, Counters.KafkaStats.produce_bytes_ok});
 
+  Freia.ESSReadoutParser.Reorder.configure(
+      EFUSettings.ReorderDepth, EFUSettings.ReorderTimeoutUS * TSC_MHZ);
+  Freia.ESSReadoutParser.setHeaderVersion(EFUSettings.HeaderVersion,
+                                          ESSReadout::Parser::FREIA);
+
   while (runThreads) {
-    if (InputFifo.pop(DataIndex)) { // There is data in the FIFO - do processing
-      auto DataLen = RxRingbuffer.getDataLength(DataIndex);
+    if (popInOrder(Freia.ESSReadoutParser, DataIndex)) { // There is data in the queue - do processing
+      Idle.reset();
+      Latency.dequeued(InputQueue.getArrivalTime(DataIndex));
+      auto DataLen = InputQueue.getDataLength(DataIndex);
       if (DataLen == 0) {
         Counters.FifoSeqErrors++;
         continue;
       }
 
       /// \todo use the Buffer<T> class here and in parser
-      auto DataPtr = RxRingbuffer.getDataBuffer(DataIndex);
+      auto DataPtr = InputQueue.getDataBuffer(DataIndex);
 
       int64_t SeqErrOld = Counters.ReadoutStats.ErrorSeqNum;
       auto Res = Freia.ESSReadoutParser.validate(DataPtr, DataLen,
                                                  ESSReadout::Parser::FREIA);
       Counters.ReadoutStats = Freia.ESSReadoutParser.Stats;
+      Counters.ReorderStats = Freia.ESSReadoutParser.Reorder.Stats;
 
       if (SeqErrOld != Counters.ReadoutStats.ErrorSeqNum) {
         XTRACE(DATA, WAR, "SeqNum error at RxPackets %" PRIu64,
@@ -214,6 +251,7 @@ void FreiaBase::processing_thread() {
 
       // We have good header information, now parse readout data
       Res = Freia.VMMParser.parse(Freia.ESSReadoutParser.Packet);
+      Latency.parsed();
       Counters.TimeStats = Freia.ESSReadoutParser.Packet.Time.Stats;
       Counters.VMMStats = Freia.VMMParser.Stats;
 
@@ -223,6 +261,7 @@ void FreiaBase::processing_thread() {
         Freia.generateEvents(builder.Events);
         Counters.MatcherStats.addAndClear(builder.matcher.Stats);
       }
+      Latency.serialized();
       // done processing data
 
       // send monitoring data
@@ -233,13 +272,17 @@ void FreiaBase::processing_thread() {
         Counters.TxRawReadoutPackets++;
       }
     } else {
-      // There is NO data in the FIFO - increment idle counter and sleep a
+      // There is NO data in the queue - increment idle counter and sleep a
       // little
       Counters.ProcessingIdle++;
-      usleep(10);
+      Idle.idle(InputQueue);
     }
 
+    // Serve delivery reports also when nothing is being produced
+    eventprod.poll();
+
     if (ProduceTimer.timeout()) {
+      Latency.update();
 
       RuntimeStatusMask = RtStat.getRuntimeStatusMask(
           {ITCounters.RxPackets, Counters.Events, Counters.KafkaStats.produce_bytes_ok});
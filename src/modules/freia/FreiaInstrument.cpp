@@ -8,6 +8,7 @@
 ///
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <common/debug/Log.h>
 #include <common/debug/Trace.h>
 #include <common/readout/vmm3/Readout.h>
@@ -37,6 +38,7 @@ FreiaInstrument::FreiaInstrument(struct Counters &counters,
   // We can now use the settings in Conf
 
   Geom.setGeometry(Conf.FileParameters.InstrumentGeometry);
+  buildChannelMap();
 
   ESSReadoutParser.setMaxPulseTimeDiff(Conf.FileParameters.MaxPulseTimeNS);
 }
@@ -72,6 +74,30 @@ void FreiaInstrument::loadConfigAndCalib() {
   }
 }
 
+void FreiaInstrument::buildChannelMap() {
+  ChannelMap.build(Conf, [&](uint8_t, uint8_t, uint8_t HybridId, uint8_t Asic,
+                             uint8_t Channel, ESSReadout::Hybrid &Hybrid) {
+    uint8_t VMM = 2 * HybridId + Asic;
+    ESSReadout::VMM3ChannelMap::Entry Entry;
+    if (Geom.isXCoord(VMM)) {
+      Entry.Coord = Geom.xCoord(VMM, Channel);
+      Entry.Plane = PlaneX;
+    } else { // implicit isYCoord
+      Entry.Coord = Geom.yCoord(Hybrid.YOffset, VMM, Channel);
+      Entry.Plane = PlaneY;
+    }
+    // thresholds are only given in version 1 of the configuration
+    if (not Hybrid.ADCThresholds[Asic].empty()) {
+      Entry.MinADC = std::clamp(Hybrid.ADCThresholds[Asic][0], 0, 0xFFFF);
+    }
+    Entry.Builder = Hybrid.HybridNumber;
+    Entry.State = ESSReadout::VMM3ChannelMap::Valid;
+    return Entry;
+  });
+  XTRACE(INIT, ALW, "Channel map uses %zu bytes",
+         ChannelMap.getMemoryBytes());
+}
+
 void FreiaInstrument::processReadouts(void) {
   XTRACE(DATA, DEB,"\n================== NEW PACKET =====================\n\n");
   // All readouts are potentially now valid, but rings and fens
@@ -107,30 +133,27 @@ void FreiaInstrument::processReadouts(void) {
       continue;
     }
 
-    uint8_t HybridId = readout.VMM >> 1;
-    if (!Conf.getHybrid(Ring, readout.FENId, HybridId).Initialised) {
+    const ESSReadout::VMM3ChannelMap::Entry &Channel =
+        ChannelMap.lookup(Ring, readout.FENId, readout.VMM, readout.Channel);
+    if (Channel.State == ESSReadout::VMM3ChannelMap::Unconfigured) {
       XTRACE(DATA, WAR,
              "Hybrid for Ring %d, FEN %d, VMM %d not defined in config file",
-             Ring, readout.FENId, HybridId);
+             Ring, readout.FENId, readout.VMM >> 1);
       counters.HybridMappingErrors++;
       continue;
     }
 
-    ESSReadout::Hybrid &Hybrid =
-        Conf.getHybrid(Ring, readout.FENId, readout.VMM >> 1);
-
-    uint8_t Asic = readout.VMM & 0x1;
-    XTRACE(DATA, DEB, "Asic calculated to be %u", Asic);
-    VMM3Calibration &Calib = Hybrid.VMMs[Asic];
-    XTRACE(DATA, DEB, "Hybrid at: %p", &Hybrid);
-    XTRACE(DATA, DEB, "Calibration at: %p", &Hybrid.VMMs[Asic]);
-
     // apply adc thresholds
-    if (readout.OTADC < Hybrid.ADCThresholds[Asic][0]) {
+    if (readout.OTADC < Channel.MinADC) {
       counters.ADCBelowThreshold++;
       continue;
     }
 
+    uint8_t Asic = readout.VMM & 0x1;
+    XTRACE(DATA, DEB, "Asic calculated to be %u", Asic);
+    VMM3Calibration &Calib =
+        Conf.getHybrid(Ring, readout.FENId, readout.VMM >> 1).VMMs[Asic];
+
     uint64_t TimeNS = ESSReadout::ESSTime::toNS(readout.TimeHigh, readout.TimeLow).count();
     int64_t TDCCorr = Calib.TDCCorr(readout.Channel, readout.TDC);
     XTRACE(DATA, DEB, "TimeNS raw %" PRIu64 ", correction %" PRIi64, TimeNS,
@@ -152,24 +175,11 @@ void FreiaInstrument::processReadouts(void) {
     }
 
     // Now we add readouts with the calibrated time and adc to the x,y builders
-    if (Geom.isXCoord(readout.VMM)) {
-      XTRACE(DATA, INF,
-             "X: TimeNS %" PRIu64 ", Plane %u, Coord %u, Channel %u, ADC %u",
-             TimeNS, PlaneX, Geom.xCoord(readout.VMM, readout.Channel),
-             readout.Channel, ADC);
-      builders[Hybrid.HybridNumber].insert(
-          {TimeNS, Geom.xCoord(readout.VMM, readout.Channel), ADC, PlaneX});
-
-    } else { // implicit isYCoord
-      XTRACE(DATA, INF,
-             "Y: TimeNS %" PRIu64 ", Plane %u, Coord %u, Channel %u, ADC %u",
-             TimeNS, PlaneY,
-             Geom.yCoord(Hybrid.YOffset, readout.VMM, readout.Channel),
-             readout.Channel, ADC);
-      builders[Hybrid.HybridNumber].insert(
-          {TimeNS, Geom.yCoord(Hybrid.YOffset, readout.VMM, readout.Channel),
-           ADC, PlaneY});
-    }
+    XTRACE(DATA, INF,
+           "TimeNS %" PRIu64 ", Plane %u, Coord %u, Channel %u, ADC %u",
+           TimeNS, Channel.Plane, Channel.Coord, readout.Channel, ADC);
+    builders[Channel.Builder].insert(
+        {TimeNS, Channel.Coord, ADC, Channel.Plane});
   }
 
   for (auto &builder : builders) {
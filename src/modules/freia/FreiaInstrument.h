@@ -14,6 +14,7 @@
 #include <common/readout/ess/Parser.h>
 #include <common/readout/vmm3/Hybrid.h>
 #include <common/readout/vmm3/Readout.h>
+#include <common/readout/vmm3/VMM3ChannelMap.h>
 #include <common/readout/vmm3/VMM3Parser.h>
 #include <common/reduction/EventBuilder2D.h>
 #include <freia/Counters.h>
@@ -42,6 +43,10 @@ public:
   /// we can later do consistency checks when applying the calibration data
   void setHybridIds(std::vector<std::string> Ids);
 
+  /// \brief precompute coordinate, plane, builder and ADC threshold of all
+  /// channels of the configured hybrids
+  void buildChannelMap();
+
   /// \brief process parsed vmm data into clusters
   void processReadouts(void);
 
@@ -74,6 +79,9 @@ public:
   /// get x- and y- coordinates from cassettes and channels
   Geometry Geom;
 
+  /// \brief channel mapping used by processReadouts()
+  ESSReadout::VMM3ChannelMap ChannelMap;
+
   /// \brief logical geometry
   /// get pixel IDs from x- and y- coordinates
   ESSGeometry essgeom{64, 1024, 1, 1};
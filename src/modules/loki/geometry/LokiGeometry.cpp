@@ -39,6 +39,13 @@ std::pair<int, double> LokiGeometry::calcUnitAndPos(int GlobalGroup, int AmpA,
   }
 
   double GlobalPos = 1.0 * (AmpA + AmpB )/ Denominator; // [0.0 ; 1.0]
+  XTRACE(DATA, DEB, "A %d, B %d, GlobalPos %f", AmpA, AmpB, GlobalPos);
+  return calcUnitAndPos(GlobalGroup, GlobalPos);
+}
+
+
+std::pair<int, double> LokiGeometry::calcUnitAndPos(int GlobalGroup,
+    double GlobalPos) {
   if ((GlobalPos < 0) or (GlobalPos > 1.0)) {
     XTRACE(DATA, WAR, "Pos %f not in unit interval", GlobalPos);
     return InvalidPos;
@@ -46,8 +53,7 @@ std::pair<int, double> LokiGeometry::calcUnitAndPos(int GlobalGroup, int AmpA,
 
   int Unit = CaenCDCalibration.getUnitId(GlobalGroup, GlobalPos);
   if (Unit == -1) {
-    XTRACE(DATA, DEB, "A %d, B %d, GlobalPos %f outside valid region", AmpA,
-           AmpB, GlobalPos);
+    XTRACE(DATA, DEB, "GlobalPos %f outside valid region", GlobalPos);
     return InvalidPos;
   }
 
@@ -64,7 +70,7 @@ std::pair<int, double> LokiGeometry::calcUnitAndPos(int GlobalGroup, int AmpA,
 }
 
 
-uint32_t LokiGeometry::calcPixel(DataParser::CaenReadout &Data) {
+uint32_t LokiGeometry::calcPixel(const DataParser::CaenReadout &Data) {
   int Ring = Data.FiberId/2;
   int FEN = Data.FENId;
   int Group = Data.Group; // local group for a FEN
@@ -75,18 +81,31 @@ uint32_t LokiGeometry::calcPixel(DataParser::CaenReadout &Data) {
   XTRACE(DATA, DEB, "FEN %d, LocalGroup %d, GlobalGroup %d", FEN, Group,
     GlobalGroup);
 
-  std::pair<int, double> UnitPos = calcUnitAndPos(GlobalGroup, Data.AmpA,
-    Data.AmpB, Data.AmpC, Data.AmpD);
+  std::pair<int, double> UnitPos;
+  double CalibratedUnitPos;
+  if (CaenCDCalibration.QuantisedSteps) {
+    auto Entry = quantisedUnitAndPos(GlobalGroup, Data.AmpA + Data.AmpB,
+      Data.AmpA + Data.AmpB + Data.AmpC + Data.AmpD);
+    if (Entry == nullptr) {
+      return 0;
+    }
+    UnitPos = std::make_pair(Entry->Unit, Entry->UnitPos);
+    CalibratedUnitPos = CaenCDCalibration.posCorrection(*Entry);
+  } else {
+    UnitPos = calcUnitAndPos(GlobalGroup, Data.AmpA, Data.AmpB, Data.AmpC,
+      Data.AmpD);
     XTRACE(DATA, DEB, "Unit %d, GlobalPos %f", UnitPos.first, UnitPos.second);
 
-  if (UnitPos.first == -1) {
-    return 0;
+    if (UnitPos.first == -1) {
+      return 0;
+    }
+
+    CalibratedUnitPos = CaenCDCalibration.posCorrection(GlobalGroup,
+      UnitPos.first, UnitPos.second);
   }
 
   uint32_t GlobalUnit = Conf.LokiConf.getY(Ring, FEN, Data.Group, UnitPos.first);
 
-  double CalibratedUnitPos =
-      CaenCDCalibration.posCorrection(GlobalGroup, UnitPos.first, UnitPos.second);
   uint16_t CalibratedPos = CalibratedUnitPos * (NPos - 1);
   XTRACE(EVENT, DEB, "Group %d, Unit %d - calibrated unit pos: %g, pos %d",
          GlobalGroup, UnitPos.first, CalibratedUnitPos, CalibratedPos);
@@ -101,33 +120,56 @@ uint32_t LokiGeometry::calcPixel(DataParser::CaenReadout &Data) {
   return PixelId;
 }
 
-bool LokiGeometry::validateData(DataParser::CaenReadout &Data) {
-  unsigned int Ring = Data.FiberId / 2;
+void LokiGeometry::calcPixels(const ReadoutColumns &Readouts,
+                              uint32_t *Pixels) {
+  const size_t Count = Readouts.size();
+  Batch.resize(Count);
 
-  auto & Cfg = Conf.LokiConf.Parms;
-
-  if (Ring >= Cfg.NumRings) {
-    XTRACE(DATA, WAR, "RINGId %u is >= %u", Ring, Cfg.NumRings);
-    Stats.RingErrors++;
-    return false;
+  for (size_t i = 0; i < Count; i++) {
+    Batch.Numerator[i] = Readouts.AmpA[i] + Readouts.AmpB[i];
+    Batch.Denominator[i] =
+        Batch.Numerator[i] + Readouts.AmpC[i] + Readouts.AmpD[i];
   }
-
-  int Bank = Cfg.Rings[Ring].Bank;
-  if (Bank == -1) {
-    XTRACE(DATA, WAR, "RINGId %u is uninitialised", Ring);
-    Stats.RingMappingErrors++;
-    return false;
+  calcRatios(Count);
+
+  // As calcPixel(), without tracing
+  for (size_t i = 0; i < Count; i++) {
+    Batch.X[i] = -1;
+    int Ring = Readouts.FiberId[i] / 2;
+    int FEN = Readouts.FENId[i];
+    int Group = Readouts.Group[i];
+    uint32_t GlobalGroup = Conf.LokiConf.getGlobalGroup(Ring, FEN, Group);
+
+    int Unit;
+    double CalibratedUnitPos;
+    if (CaenCDCalibration.QuantisedSteps) {
+      auto Entry = quantisedUnitAndPos(GlobalGroup, Batch.Numerator[i],
+                                       Batch.Denominator[i]);
+      if (Entry == nullptr) {
+        continue;
+      }
+      Unit = Entry->Unit;
+      CalibratedUnitPos = CaenCDCalibration.posCorrection(*Entry);
+    } else {
+      if (Batch.Denominator[i] == 0) {
+        Stats.AmplitudeZero++;
+        continue;
+      }
+      std::pair<int, double> UnitPos =
+          calcUnitAndPos(GlobalGroup, Batch.Pos[i]);
+      if (UnitPos.first == -1) {
+        continue;
+      }
+      Unit = UnitPos.first;
+      CalibratedUnitPos = CaenCDCalibration.posCorrection(GlobalGroup, Unit,
+                                                          UnitPos.second);
+    }
+
+    Batch.X[i] = uint16_t(CalibratedUnitPos * (NPos - 1));
+    Batch.Y[i] = Conf.LokiConf.getY(Ring, FEN, Group, Unit);
   }
 
-  int FENs = Cfg.Rings[Ring].FENs;
-  if (Data.FENId >= FENs) {
-    XTRACE(DATA, WAR, "FENId %u outside valid range 0 - %u", Data.FENId, FENs);
-    Stats.FENMappingErrors++;
-    return false;
-  }
-  XTRACE(DATA, DEB, "FENId %d, Max FENId %d", Data.FENId, FENs - 1);
-  return true;
+  pixels2D(Count, Pixels);
 }
 
-
 } // namespace Caen
@@ -27,7 +27,7 @@
 
 namespace Caen {
 
-class LokiGeometry : public Geometry {
+class LokiGeometry final : public Geometry {
 public:
   LokiGeometry(Config &CaenConfiguration);
 
@@ -41,6 +41,10 @@ public:
   std::pair<int, double> calcUnitAndPos(int Group,
     int AmpA, int AmpB, int AmpC, int AmpD);
 
+  /// \brief return the unit and position along it for a global position
+  /// \param GlobalPos (AmpA + AmpB) / (AmpA + AmpB + AmpC + AmpD)
+  std::pair<int, double> calcUnitAndPos(int Group, double GlobalPos);
+
 
   /// \brief The four amplitudes measured at certain points in the
   /// Helium tube circuit diagram are used to identify the straw that
@@ -54,8 +58,39 @@ public:
 
   void setCalibration(CDCalibration Calib) { CaenCDCalibration = Calib; }
 
-  uint32_t calcPixel(DataParser::CaenReadout &Data);
-  bool validateData(DataParser::CaenReadout &Data);
+  uint32_t calcPixel(const DataParser::CaenReadout &Data);
+  bool validateData(const DataParser::CaenReadout &Data) {
+    unsigned int Ring = Data.FiberId / 2;
+
+    auto & Cfg = Conf.LokiConf.Parms;
+
+    if (Ring >= Cfg.NumRings) {
+      XTRACE(DATA, WAR, "RINGId %u is >= %u", Ring, Cfg.NumRings);
+      Stats.RingErrors++;
+      return false;
+    }
+
+    int Bank = Cfg.Rings[Ring].Bank;
+    if (Bank == -1) {
+      XTRACE(DATA, WAR, "RINGId %u is uninitialised", Ring);
+      Stats.RingMappingErrors++;
+      return false;
+    }
+
+    int FENs = Cfg.Rings[Ring].FENs;
+    if (Data.FENId >= FENs) {
+      XTRACE(DATA, WAR, "FENId %u outside valid range 0 - %u", Data.FENId,
+             FENs);
+      Stats.FENMappingErrors++;
+      return false;
+    }
+    XTRACE(DATA, DEB, "FENId %d, Max FENId %d", Data.FENId, FENs - 1);
+    return true;
+  }
+
+  /// \brief amplitude sums, positions and pixels are calculated over the
+  /// columns, units and calibration per readout
+  void calcPixels(const ReadoutColumns &Readouts, uint32_t *Pixels) override;
 
   // Holds the parsed configuration
   Config Conf;
@@ -8,6 +8,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <caen/test/GeometryTestUtil.h>
 #include <common/testutils/TestBase.h>
 #include <loki/geometry/LokiGeometry.h>
 #include <memory>
@@ -139,6 +140,75 @@ TEST_F(LokiGeometryTest, calcPixel) {
 }
 
 
+TEST_F(LokiGeometryTest, QuantisedCalibration) {
+  const unsigned int Steps{4096};
+  const int Sum{1000};
+  LokiGeometry exact(CaenConfiguration);
+  exact.CaenCDCalibration = geom->CaenCDCalibration;
+  geom->CaenCDCalibration.buildQuantisedTable(Steps);
+
+  auto &Intervals = geom->CaenCDCalibration.Intervals[0];
+  auto nearEdge = [&](double Pos) {
+    for (auto &Interval : Intervals) {
+      if ((std::abs(Pos - Interval.first) <= 0.5 / Steps) or
+          (std::abs(Pos - Interval.second) <= 0.5 / Steps)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  DataParser::CaenReadout readout{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+  int Compared{0};
+  for (int AB = 0; AB <= Sum; AB++) {
+    readout.AmpA = AB / 2;
+    readout.AmpB = AB - AB / 2;
+    readout.AmpC = (Sum - AB) / 2;
+    readout.AmpD = Sum - AB - (Sum - AB) / 2;
+    if (nearEdge(1.0 * AB / Sum)) {
+      continue;
+    }
+    uint32_t Pixel = geom->calcPixel(readout);
+    uint32_t ExactPixel = exact.calcPixel(readout);
+    ASSERT_EQ(Pixel == 0, ExactPixel == 0);
+    if (Pixel != 0) {
+      // same unit (row), position within one pixel
+      ASSERT_EQ((Pixel - 1) / 512, (ExactPixel - 1) / 512);
+      ASSERT_LE(std::abs((int)Pixel - (int)ExactPixel), 1);
+      Compared++;
+    }
+  }
+  ASSERT_GT(Compared, Sum * 0.98);
+  ASSERT_EQ(geom->CaenCDCalibration.Stats.OutsideInterval,
+            exact.CaenCDCalibration.Stats.OutsideInterval);
+
+  readout.AmpA = readout.AmpB = readout.AmpC = readout.AmpD = 0;
+  ASSERT_EQ(geom->calcPixel(readout), 0);
+  ASSERT_EQ(geom->Stats.AmplitudeZero, 1);
+}
+
+TEST_F(LokiGeometryTest, CalcPixelsMatchesCalcPixel) {
+  ReadoutColumns Readouts = randomReadouts(0, 15, 7);
+
+  for (unsigned int Steps : {0, 4096}) {
+    LokiGeometry exact(CaenConfiguration);
+    exact.setResolution(512);
+    exact.CaenCDCalibration = geom->CaenCDCalibration;
+    if (Steps) {
+      geom->CaenCDCalibration.buildQuantisedTable(Steps);
+      exact.CaenCDCalibration.buildQuantisedTable(Steps);
+    }
+    geom->Stats = exact.Stats;
+    geom->CaenCDCalibration.Stats = exact.CaenCDCalibration.Stats;
+
+    checkCalcPixels(*geom, exact, Readouts);
+    ASSERT_EQ(geom->Stats.AmplitudeZero, exact.Stats.AmplitudeZero);
+    ASSERT_EQ(geom->Stats.AmplitudeZero, 40);
+    ASSERT_EQ(geom->CaenCDCalibration.Stats.OutsideInterval,
+              exact.CaenCDCalibration.Stats.OutsideInterval);
+  }
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -24,7 +24,7 @@ MiraclesGeometry::MiraclesGeometry(Config &CaenConfiguration) {
   MaxRing = CaenConfiguration.MaxRing;
 }
 
-uint32_t MiraclesGeometry::calcPixel(DataParser::CaenReadout &Data) {
+uint32_t MiraclesGeometry::calcPixel(const DataParser::CaenReadout &Data) {
   int Ring = Data.FiberId / 2;
   int x = xCoord(Ring, Data.Group, Data.AmpA, Data.AmpB);
   int y = yCoord(Ring, Data.AmpA, Data.AmpB);
@@ -35,18 +35,6 @@ uint32_t MiraclesGeometry::calcPixel(DataParser::CaenReadout &Data) {
   return pixel;
 }
 
-bool MiraclesGeometry::validateData(DataParser::CaenReadout &Data) {
-  int Ring = Data.FiberId / 2;
-  XTRACE(DATA, DEB, "Ring %u, FEN %u, Group %u", Ring, Data.FENId, Data.Group);
-
-  if (Ring > MaxRing) {
-    XTRACE(DATA, WAR, "RING %d is incompatible with config", Ring);
-    Stats.RingErrors++;
-    return false;
-  }
-  return true;
-}
-
 int MiraclesGeometry::xCoord(int Ring, int Tube, int AmpA, int AmpB) {
   int xOffset = 2 * Tube;
   if ((Ring == 1) or (Ring == 3)) {
@@ -68,6 +56,10 @@ int MiraclesGeometry::yCoord(int Ring, int AmpA, int AmpB) {
 // 0 is A, 1 is B
 int MiraclesGeometry::tubeAorB(int AmpA, int AmpB) {
   float UnitPos = 1.0 * AmpA / (AmpA + AmpB);
+  return tubeAorB(UnitPos);
+}
+
+int MiraclesGeometry::tubeAorB(float UnitPos) {
   if (UnitPos <= 0.5) {
     XTRACE(DATA, DEB, "A-tube (pos %f)", UnitPos);
     return 0;
@@ -78,7 +70,6 @@ int MiraclesGeometry::tubeAorB(int AmpA, int AmpB) {
 }
 
 int MiraclesGeometry::posAlongUnit(int AmpA, int AmpB) {
-  int tubepos;
   if (AmpA + AmpB == 0) {
     XTRACE(DATA, WAR, "AmpA + AmpB == 0, invalid amplitudes");
     ///\todo add counter
@@ -87,8 +78,12 @@ int MiraclesGeometry::posAlongUnit(int AmpA, int AmpB) {
 
   float pos = (1.0 * AmpA / (AmpA + AmpB));
   XTRACE(DATA, DEB, "Position along tube pair %f", pos);
+  return posAlongUnit(pos);
+}
 
-  if (tubeAorB(AmpA, AmpB) == 0) {
+int MiraclesGeometry::posAlongUnit(float pos) {
+  int tubepos;
+  if (tubeAorB(pos) == 0) {
     tubepos = pos * 2 * (NPos / 2 - 1);
     XTRACE(DATA, DEB, "A: TubePos %u, pos: %f", tubepos, pos);
     return tubepos;
@@ -99,4 +94,45 @@ int MiraclesGeometry::posAlongUnit(int AmpA, int AmpB) {
   }
 }
 
+void MiraclesGeometry::calcPixels(const ReadoutColumns &Readouts,
+                                  uint32_t *Pixels) {
+  const size_t Count = Readouts.size();
+  Batch.resize(Count);
+
+  for (size_t i = 0; i < Count; i++) {
+    Batch.Numerator[i] = Readouts.AmpA[i];
+    Batch.Denominator[i] = Readouts.AmpA[i] + Readouts.AmpB[i];
+  }
+  calcRatios(Count);
+
+  // As xCoord() and yCoord()
+  for (size_t i = 0; i < Count; i++) {
+    int Ring = Readouts.FiberId[i] / 2;
+    int Tube;
+    int TubePos;
+    if (Batch.Denominator[i] == 0) {
+      // AmpA / 0 is NaN or +inf for tube B, -inf for tube A
+      Tube = Readouts.AmpA[i] < 0 ? 0 : 1;
+      TubePos = -1;
+    } else {
+      float UnitPos = Batch.Pos[i];
+      Tube = tubeAorB(UnitPos);
+      TubePos = posAlongUnit(UnitPos);
+    }
+
+    int xOffset = 2 * Readouts.Group[i];
+    if ((Ring == 1) or (Ring == 3)) {
+      xOffset += 24;
+    }
+    int yOffset{0};
+    if ((Ring == 2) or (Ring == 3)) {
+      yOffset += NPos / 2;
+    }
+    Batch.X[i] = xOffset + Tube;
+    Batch.Y[i] = yOffset + TubePos;
+  }
+
+  pixels2D(Count, Pixels);
+}
+
 } // namespace Caen
@@ -21,11 +21,26 @@
 // #define TRC_LEVEL TRC_L_DEB
 
 namespace Caen {
-class MiraclesGeometry : public Geometry {
+class MiraclesGeometry final : public Geometry {
 public:
   MiraclesGeometry(Config &CaenConfiguration);
-  uint32_t calcPixel(DataParser::CaenReadout &Data);
-  bool validateData(DataParser::CaenReadout &Data);
+  uint32_t calcPixel(const DataParser::CaenReadout &Data);
+  bool validateData(const DataParser::CaenReadout &Data) {
+    int Ring = Data.FiberId / 2;
+    XTRACE(DATA, DEB, "Ring %u, FEN %u, Group %u", Ring, Data.FENId,
+           Data.Group);
+
+    if (Ring > MaxRing) {
+      XTRACE(DATA, WAR, "RING %d is incompatible with config", Ring);
+      Stats.RingErrors++;
+      return false;
+    }
+    return true;
+  }
+
+  /// \brief amplitude ratios and pixels are calculated over the columns,
+  /// tube and position per readout
+  void calcPixels(const ReadoutColumns &Readouts, uint32_t *Pixels) override;
 
   /// \brief return local x-coordinate from amplitudes
   int xCoord(int Ring, int Tube, int AmpA, int AmpB);
@@ -35,7 +50,13 @@ public:
 
   int tubeAorB(int AmpA, int AmpB);
 
+  /// \brief tube from the position AmpA / (AmpA + AmpB)
+  int tubeAorB(float UnitPos);
+
   /// \brief return the position along the tube
   int posAlongUnit(int AmpA, int AmpB);
+
+  /// \brief position along the tube from the position AmpA / (AmpA + AmpB)
+  int posAlongUnit(float UnitPos);
 };
 } // namespace Caen
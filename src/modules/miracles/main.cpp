@@ -11,8 +11,8 @@
 int main(int argc, char *argv[]) {
   MainProg Main("miracles", argc, argv);
 
-  auto Detector =
-      new Caen::CaenBase(Main.DetectorSettings, ESSReadout::Parser::MIRACLES);
+  auto Detector = new Caen::CaenBase<Caen::MiraclesGeometry>(
+      Main.DetectorSettings, ESSReadout::Parser::MIRACLES);
 
   return Main.run(Detector);
 }
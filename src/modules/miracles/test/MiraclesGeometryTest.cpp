@@ -8,6 +8,7 @@
 /// \brief Unit test for Miracles position calculations
 ///
 //===----------------------------------------------------------------------===//
+#include <caen/test/GeometryTestUtil.h>
 #include <common/testutils/TestBase.h>
 #include <miracles/geometry/MiraclesGeometry.h>
 
@@ -66,6 +67,11 @@ TEST_F(MiraclesGeometryTest, CalcPixel) {
   ASSERT_EQ(geom->calcPixel(readout2), 1);
 }
 
+TEST_F(MiraclesGeometryTest, CalcPixelsMatchesCalcPixel) {
+  ReadoutColumns Readouts = randomReadouts(7, 0, 23);
+  checkCalcPixels(*geom, *geom, Readouts);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -21,6 +21,7 @@ struct Counters {
 
   // ESSReadout parser
   struct ESSReadout::ESSHeaderStats ReadoutStats;
+  struct ESSReadout::ReorderStats ReorderStats;
   int64_t ErrorESSHeaders;
   // int64_t RingRx[24];
 
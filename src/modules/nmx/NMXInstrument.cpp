@@ -44,6 +44,8 @@ NMXInstrument::NMXInstrument(struct Counters &counters, BaseSettings &settings,
     throw std::runtime_error("Invalid InstrumentGeometry in config file");
   }
 
+  buildChannelMap();
+
   ESSReadoutParser.setMaxPulseTimeDiff(Conf.FileParameters.MaxPulseTimeNS);
 }
 
@@ -96,25 +98,17 @@ void NMXInstrument::processReadouts(void) {
 
     // Convert from fiberid to ringid
     int Ring = readout.FiberId / 2;
-    uint8_t HybridId = readout.VMM >> 1;
-    ESSReadout::Hybrid &Hybrid = Conf.getHybrid(Ring, readout.FENId, HybridId);
+    const ESSReadout::VMM3ChannelMap::Entry &Channel =
+        ChannelMap.lookup(Ring, readout.FENId, readout.VMM, readout.Channel);
 
-    if (!Hybrid.Initialised) {
+    if (Channel.State == ESSReadout::VMM3ChannelMap::Unconfigured) {
       XTRACE(DATA, ALW,
              "Hybrid for Ring %d, FEN %d, VMM %d not defined in config file",
-             Ring, readout.FENId, HybridId);
+             Ring, readout.FENId, readout.VMM >> 1);
       counters.HybridMappingErrors++;
       continue;
     }
 
-    uint8_t AsicId = readout.VMM & 0x1;
-    uint16_t Offset = Conf.Offset[Ring][readout.FENId][HybridId];
-    uint8_t Plane = Conf.Plane[Ring][readout.FENId][HybridId];
-    uint8_t Panel = Conf.Panel[Ring][readout.FENId][HybridId];
-    bool ReversedChannels =
-        Conf.ReversedChannels[Ring][readout.FENId][HybridId];
-    uint16_t MinADC = Hybrid.MinADC;
-
     //VMM3Calibration & Calib = Hybrids[Hybrid].VMMs[Asic];
 
     uint64_t TimeNS = ESSReadout::ESSTime::toNS(readout.TimeHigh, readout.TimeLow).count();
@@ -130,8 +124,9 @@ void NMXInstrument::processReadouts(void) {
     // no calibration yet, so using raw ADC value
     uint16_t ADC = readout.OTADC & 0x3FF;
 
-    if (ADC < MinADC) {
-      XTRACE(DATA, INF, "Under MinADC value, got %u, minimum is %u", ADC, MinADC);
+    if (ADC < Channel.MinADC) {
+      XTRACE(DATA, INF, "Under MinADC value, got %u, minimum is %u", ADC,
+             Channel.MinADC);
       counters.MinADC++;
       continue;
     } else {
@@ -151,19 +146,16 @@ void NMXInstrument::processReadouts(void) {
     // Now we add readouts with the calibrated time and adc to the panel
     // builders
 
-    uint16_t Coord = GeometryInstance->coord(readout.Channel, AsicId, Offset,
-                                             ReversedChannels);
-
-    // 65535 is used for invalid coordinate value
-    if (Coord == Geometry::InvalidCoord) {
+    if (Channel.State == ESSReadout::VMM3ChannelMap::InvalidCoord) {
       XTRACE(DATA, ERR, "Invalid Coord");
       counters.MappingErrors++;
       continue;
     }
 
-    XTRACE(DATA, DEB, "Plane %u, Coord %u, Channel %u, Panel %u", Plane, Coord,
-           readout.Channel, Panel);
-    builders[Panel].insert({TimeNS, Coord, ADC, Plane});
+    XTRACE(DATA, DEB, "Plane %u, Coord %u, Channel %u, Panel %u",
+           Channel.Plane, Channel.Coord, readout.Channel, Channel.Builder);
+    builders[Channel.Builder].insert(
+        {TimeNS, Channel.Coord, ADC, Channel.Plane});
   }
 
   for (auto &builder : builders) {
@@ -171,6 +163,27 @@ void NMXInstrument::processReadouts(void) {
   }
 }
 
+void NMXInstrument::buildChannelMap() {
+  ChannelMap.build(Conf, [&](uint8_t Ring, uint8_t FEN, uint8_t HybridId,
+                             uint8_t Asic, uint8_t Channel,
+                             ESSReadout::Hybrid &Hybrid) {
+    ESSReadout::VMM3ChannelMap::Entry Entry;
+    Entry.Coord = GeometryInstance->coord(
+        Channel, Asic, Conf.Offset[Ring][FEN][HybridId],
+        Conf.ReversedChannels[Ring][FEN][HybridId]);
+    Entry.MinADC = Hybrid.MinADC;
+    Entry.Builder = Conf.Panel[Ring][FEN][HybridId];
+    Entry.Plane = Conf.Plane[Ring][FEN][HybridId];
+    // 65535 is used for invalid coordinate value
+    Entry.State = (Entry.Coord == Geometry::InvalidCoord)
+                      ? ESSReadout::VMM3ChannelMap::InvalidCoord
+                      : ESSReadout::VMM3ChannelMap::Valid;
+    return Entry;
+  });
+  XTRACE(INIT, ALW, "Channel map uses %zu bytes",
+         ChannelMap.getMemoryBytes());
+}
+
 void NMXInstrument::checkConfigAndGeometry() {
   std::set<int> Coords[4][2];
   std::set<int> *CurrentCoordSet;
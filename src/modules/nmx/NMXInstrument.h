@@ -15,6 +15,7 @@
 #include <common/readout/ess/Parser.h>
 #include <common/readout/vmm3/Hybrid.h>
 #include <common/readout/vmm3/Readout.h>
+#include <common/readout/vmm3/VMM3ChannelMap.h>
 #include <common/readout/vmm3/VMM3Parser.h>
 #include <common/reduction/Event.h>
 #include <common/reduction/EventBuilder2D.h>
@@ -56,6 +57,10 @@ public:
   /// in overlapping pixels. If it does, throws a runtime error.
   void checkConfigAndGeometry();
 
+  /// \brief precompute coordinate, plane, panel and MinADC of all channels
+  /// of the configured hybrids
+  void buildChannelMap();
+
 public:
   /// \brief Stuff that 'ties' NMX together
   struct Counters &counters;
@@ -86,6 +91,9 @@ public:
 
   Geometry *GeometryInstance;
 
+  /// \brief channel mapping used by processReadouts()
+  ESSReadout::VMM3ChannelMap ChannelMap;
+
   //
   std::vector<ESSReadout::Hybrid> Hybrids;
 
@@ -19,7 +19,6 @@
 
 #include <unistd.h>
 
-#include <common/memory/SPSCFifo.h>
 #include <common/system/Socket.h>
 #include <common/time/TSCTimer.h>
 #include <common/time/Timer.h>
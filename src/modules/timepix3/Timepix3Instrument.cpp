@@ -20,6 +20,8 @@
 
 namespace Timepix3 {
 
+template class BasicDataParser<PixelEventHandler, TimingEventHandler>;
+
 using namespace Observer;
 using namespace timepixDTO;
 using namespace timepixReadout;
@@ -49,14 +51,9 @@ Timepix3Instrument::Timepix3Instrument(Counters &counters,
                         timepix3Configuration),
       timepix3Parser(counters) {
 
-  // Setup observable subscriptions
-  timepix3Parser.DataEventObservable<TDCReadout>::subscribe(
-      &timingEventHandler);
-  timepix3Parser.DataEventObservable<EVRReadout>::subscribe(
-      &timingEventHandler);
-
-  timepix3Parser.DataEventObservable<PixelReadout>::subscribe(
-      &pixelEventHandler);
+  // Setup observable subscriptions, the parser calls the handlers with
+  // static dispatch
+  timepix3Parser.bind(&pixelEventHandler, &timingEventHandler);
   timingEventHandler.DataEventObservable<ESSGlobalTimeStamp>::subscribe(
       &pixelEventHandler);
 }
@@ -24,6 +24,8 @@
 
 namespace Timepix3 {
 
+extern template class BasicDataParser<PixelEventHandler, TimingEventHandler>;
+
 class Timepix3Instrument {
 public:
   /// \brief 'create' the Timepix3 instruments
@@ -48,7 +50,7 @@ public:
   shared_ptr<Timepix3Geometry> geomPtr;
   TimingEventHandler timingEventHandler;
   PixelEventHandler pixelEventHandler;
-  DataParser timepix3Parser;
+  BasicDataParser<PixelEventHandler, TimingEventHandler> timepix3Parser;
 
   Timepix3Instrument(Counters &counters, const Config &timepix3Configuration,
                      EV44Serializer &serializer);
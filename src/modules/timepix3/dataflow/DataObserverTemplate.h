@@ -13,6 +13,8 @@
 #include <cstdint>
 #include <locale>
 #include <memory>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
 namespace Observer {
@@ -91,4 +93,55 @@ public:
   }
 };
 
+/**
+ * @brief Template class for an observable data event with listeners wired at
+ * compile time.
+ *
+ * Handlers bound with bind() receive the data event through a qualified, non
+ * virtual call of their `applyData`, which the compiler can inline where its
+ * definition is visible. Only the handler types observing `DataEvent` are
+ * called. Listeners added with subscribe() are called after the bound
+ * handlers, so tests can still observe the data events.
+ *
+ * @tparam DataEvent The type of data event.
+ * @tparam Handler The types of the handlers which can be bound.
+ */
+template <typename DataEvent, typename... Handler>
+class StaticDataEventObservable : public DataEventObservable<DataEvent> {
+private:
+  std::tuple<Handler *...> boundHandlers{};
+
+  template <typename H>
+  static inline void applyBound(H *handler, const DataEvent &event) {
+    if constexpr (std::is_base_of_v<DataEventObserver<DataEvent>, H>) {
+      if (handler != nullptr) {
+        handler->H::applyData(event);
+      }
+    }
+  }
+
+public:
+  /**
+   * @brief Binds the handlers, replacing the previously bound ones.
+   *
+   * @param handlers Pointers to the handlers, nullptr for none.
+   */
+  inline void bind(Handler *...handlers) {
+    boundHandlers = std::make_tuple(handlers...);
+  }
+
+  /**
+   * @brief Publishes a data event to the bound handlers and then to all
+   * subscribed listeners.
+   *
+   * @param event The data event to be published.
+   */
+  inline void publishData(const DataEvent &event) const {
+    std::apply(
+        [&event](Handler *...handlers) { (applyBound(handlers, event), ...); },
+        boundHandlers);
+    DataEventObservable<DataEvent>::publishData(event);
+  }
+};
+
 } // namespace Observer
\ No newline at end of file
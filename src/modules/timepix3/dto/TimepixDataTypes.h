@@ -9,7 +9,9 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 #define PIXEL_MAX_TIMESTAMP_NS 26843545600
 
@@ -271,4 +273,78 @@ struct PixelReadout {
   }
 };
 
+/**
+ * @brief Pixel readouts of a packet decoded into one column per field.
+ *
+ * Row i holds the pixel fields of the i-th 64 bit word of the packet. Rows
+ * of words that are not pixel readouts hold undefined values, they are never
+ * part of a PixelBatch.
+ */
+struct PixelColumns {
+  std::vector<uint16_t> dCol;      ///< The digital column of the pixel.
+  std::vector<uint16_t> sPix;      ///< The sub pixel index of the pixel.
+  std::vector<uint16_t> pix;       ///< The pixel index within the sub pixel.
+  std::vector<uint16_t> ToT;       ///< The Time-over-Threshold value.
+  std::vector<uint16_t> fToA;      ///< The fine Time-of-Arrival value.
+  std::vector<uint16_t> toa;       ///< The Time-of-Arrival value.
+  std::vector<uint16_t> spidrTime; ///< The SPIDR timestamp.
+
+  /**
+   * @brief Number of rows in the columns.
+   */
+  size_t size() const { return dCol.size(); }
+
+  /**
+   * @brief Resizes all columns to the specified number of rows.
+   */
+  void resize(size_t Rows) {
+    for (auto Column : {&dCol, &sPix, &pix, &ToT, &fToA, &toa, &spidrTime}) {
+      Column->resize(Rows);
+    }
+  }
+
+  /**
+   * @brief Returns the specified row as a PixelReadout object.
+   */
+  PixelReadout readout(size_t Row) const {
+    return PixelReadout(dCol[Row], sPix[Row], pix[Row], ToT[Row], fToA[Row],
+                        toa[Row], spidrTime[Row]);
+  }
+};
+
+/**
+ * @brief Consecutive pixel readouts of a packet, rows Begin to End - 1 of
+ * the decoded columns.
+ *
+ * The parser publishes one batch for each run of pixel readouts between
+ * other readouts, so that handlers see TDC readouts and pixel readouts in
+ * packet order.
+ */
+struct PixelBatch {
+  const PixelColumns &Columns; ///< The decoded columns of the packet.
+  const size_t Begin;          ///< The first row of the batch.
+  const size_t End;            ///< One past the last row of the batch.
+
+  /**
+   * @brief Number of pixel readouts in the batch.
+   */
+  size_t size() const { return End - Begin; }
+
+  /**
+   * @brief Compares the readouts of two batches for equality.
+   */
+  bool operator==(const PixelBatch &other) const {
+    if (size() != other.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < size(); i++) {
+      if (not(Columns.readout(Begin + i) ==
+              other.Columns.readout(other.Begin + i))) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
 } // namespace timepixReadout
\ No newline at end of file
@@ -53,15 +53,13 @@ int Timepix3Geometry::getChunkWindowIndex(const uint16_t X,
 // Calculation and naming (Col and Row) is taken over from CFEL-CMI pymepix
 // https://github.com/CFEL-CMI/pymepix/blob/develop/pymepix/processing/logic/packet_processor.py
 uint32_t Timepix3Geometry::calcX(const PixelReadout &Data) const {
-  uint32_t Col = static_cast<uint32_t>(Data.dCol) + Data.pix / 4;
-  return Col;
+  return calcX(Data.dCol, Data.pix);
 }
 
 // Calculation and naming (Col and Row) is taken over from CFEL-CMI pymepix
 // https://github.com/CFEL-CMI/pymepix/blob/develop/pymepix/processing/logic/packet_processor.py
 uint32_t Timepix3Geometry::calcY(const PixelReadout &Data) const {
-  uint32_t Row = static_cast<uint32_t>(Data.sPix) + (Data.pix & 0x3);
-  return Row;
+  return calcY(Data.sPix, Data.pix);
 }
 
 /// \brief Calculates that the received data is fir to the geometry
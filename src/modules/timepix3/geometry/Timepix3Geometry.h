@@ -54,6 +54,16 @@ public:
   /// \brief calculated the Y coordinate from a const PixelDataEvent
   uint32_t calcY(const timepixReadout::PixelReadout &Data) const;
 
+  /// \brief calculates the X coordinate from the dCol and pix fields
+  uint32_t calcX(uint16_t DCol, uint16_t Pix) const {
+    return static_cast<uint32_t>(DCol) + Pix / 4;
+  }
+
+  /// \brief calculates the Y coordinate from the sPix and pix fields
+  uint32_t calcY(uint16_t SPix, uint16_t Pix) const {
+    return static_cast<uint32_t>(SPix) + (Pix & 0x3);
+  }
+
   /// \brief returns the total number of chunks
   int getChunkNumber() const { return totalNumChunkWindows; }
 
@@ -46,38 +46,6 @@ void PixelEventHandler::applyData(const ESSGlobalTimeStamp &epochEssPulseTime) {
   serializer.setReferenceTime(lastEpochESSPulseTime->pulseTimeInEpochNs);
 }
 
-void PixelEventHandler::applyData(const PixelReadout &pixelReadout) {
-
-  bool ValidData = geometry->validateData(pixelReadout);
-  if (not ValidData) {
-    XTRACE(DATA, WAR, "Invalid Data, skipping readout");
-    statCounters.InvalidPixelReadout++;
-    return;
-  }
-
-  if (lastEpochESSPulseTime == nullptr) {
-    XTRACE(DATA, WAR, "No epoch pulse time, skipping readout");
-    statCounters.NoGlobalTime++;
-    return;
-  }
-
-  // Calculate TOF in ns
-  uint16_t X = geometry->calcX(pixelReadout);
-  uint16_t Y = geometry->calcY(pixelReadout);
-
-  XTRACE(DATA, DEB, "Parsed new hit, ToF: %u, X: %u, Y: %u, ToT: %u",
-         pixelReadout.fToA, X, Y, pixelReadout.ToT);
-
-  uint64_t pixelGlobalTimeStamp = calculateGlobalTime(
-      pixelReadout.toa, pixelReadout.fToA, pixelReadout.spidrTime);
-
-  int windowIndex = geometry->getChunkWindowIndex(X, Y);
-  // Add the hit to the corresponding window vector
-
-  sub2DFrames[windowIndex].push_back(
-      {pixelGlobalTimeStamp, X, Y, pixelReadout.ToT});
-}
-
 void PixelEventHandler::clusterHits(Hierarchical2DClusterer &clusterer,
                                     Hit2DVector &hitsVector) {
 
@@ -170,30 +138,4 @@ void PixelEventHandler::publishEvents(Cluster2DContainer &clusters) {
   clusters.clear();
 }
 
-uint64_t PixelEventHandler::calculateGlobalTime(const uint16_t &toa,
-                                                const uint8_t &fToA,
-                                                const uint32_t &spidrTime) {
-
-  // Calculate pixel clock time according to timepix documentation. Use static
-  // cast to ensure all result is 64 bit
-  uint64_t pixelClockTime = 409600 * static_cast<uint64_t>(spidrTime) +
-                            25 * static_cast<uint64_t>(toa) -
-                            1.5625 * static_cast<uint64_t>(fToA);
-
-  // Handle the case if pixel clock is smaller then the tdc clock
-  // happens in case of pixel clock reset between two tdc
-  if (lastEpochESSPulseTime->tdcClockInPixelTime > pixelClockTime) {
-
-    // Calculate time until reset from the last tdc time
-    uint64_t timeUntilReset =
-        PIXEL_MAX_TIMESTAMP_NS - lastEpochESSPulseTime->tdcClockInPixelTime;
-
-    return lastEpochESSPulseTime->pulseTimeInEpochNs + timeUntilReset +
-           pixelClockTime;
-  } else {
-    uint64_t tofInPixelTime =
-        pixelClockTime - lastEpochESSPulseTime->tdcClockInPixelTime;
-    return lastEpochESSPulseTime->pulseTimeInEpochNs + tofInPixelTime;
-  }
-}
 } // namespace Timepix3
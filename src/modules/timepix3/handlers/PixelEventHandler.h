@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <common/debug/Trace.h>
 #include <common/kafka/EV44Serializer.h>
 #include <common/reduction/clustering/Hierarchical2DClusterer.h>
 #include <modules/timepix3/Counters.h>
@@ -39,7 +40,7 @@ namespace Timepix3 {
 /// \see Observer::DataEventObserver
 ///
 class PixelEventHandler
-    : public Observer::DataEventObserver<timepixReadout::PixelReadout>,
+    : public Observer::DataEventObserver<timepixReadout::PixelBatch>,
       public Observer::DataEventObserver<timepixDTO::ESSGlobalTimeStamp> {
 
 private:
@@ -68,6 +69,9 @@ private:
                    /// storing clustered hits for sub frames
                    /// in case of parrallel processing
 
+  std::vector<uint64_t>
+      batchGlobalTimes; /// < Global times of the pixels of the last batch
+
   ///
   /// \brief Publishes the clustered events to the appropriate kafka topic.
   ///
@@ -93,22 +97,51 @@ private:
   ///
   void clusterHits(Hierarchical2DClusterer &clusterer, Hit2DVector &hitsVector);
 
+public:
   ///
-  /// \brief Calculates the global time based on the pixel time over threshold
-  /// (ToT), fine time over amplitude (fToA), and SPIDR time.
+  /// \brief Calculates the pixel clock time in nanoseconds.
   ///
-  /// This method takes the ToT, fToA, and SPIDR time as input and calculates
-  /// the global time.
+  /// The time is calculated with integers only, exact in units of 1/64 ns in
+  /// which the 1.5625 ns fToA bins are whole, and truncated to nanoseconds.
   ///
-  /// \param toa The pixel time over threshold (ToT).
-  /// \param fToA The fine time over amplitude (fToA).
-  /// \param spidrTime The SPIDR time.
-  /// \return The calculated global time.
+  /// \param toa The pixel time of arrival, in 25 ns bins.
+  /// \param fToA The fine time of arrival, in 1.5625 ns bins.
+  /// \param spidrTime The SPIDR time, in 409.6 us bins.
+  /// \return The pixel clock time in nanoseconds.
   ///
-  uint64_t calculateGlobalTime(const uint16_t &toa, const uint8_t &fToA,
-                               const uint32_t &spidrTime);
+  static uint64_t pixelClockTime(uint16_t toa, uint16_t fToA,
+                                 uint32_t spidrTime);
+
+  ///
+  /// \brief Calculates the global time of a pixel from its pixel clock time.
+  ///
+  /// A pixel clock time smaller than the tdc clock means that the pixel clock
+  /// was reset after the tdc, then the time until the reset is added. This is
+  /// done with a mask instead of a branch, so that loops over pixels can be
+  /// vectorised.
+  ///
+  /// \param pixelClockTime The pixel clock time in nanoseconds.
+  /// \param pulseTimeInEpochNs The last pulse time in epoch nanoseconds.
+  /// \param tdcClockInPixelTime The tdc clock of the last pulse in pixel time.
+  /// \return The global time in nanoseconds.
+  ///
+  static uint64_t globalTime(uint64_t pixelClockTime,
+                             uint64_t pulseTimeInEpochNs,
+                             uint64_t tdcClockInPixelTime);
+
+  ///
+  /// \brief Calculates the global times of all pixels of a batch.
+  ///
+  /// \param pixelBatch The pixels to calculate the global times for.
+  /// \param epochEssPulseTime The epoch ESS pulse time of the pixels.
+  /// \param globalTimes Output, the global time of pixel Begin + i is written
+  /// to globalTimes[i].
+  ///
+  static void
+  calculateGlobalTimes(const timepixReadout::PixelBatch &pixelBatch,
+                       const timepixDTO::ESSGlobalTimeStamp &epochEssPulseTime,
+                       uint64_t *globalTimes);
 
-public:
   ///
   /// \brief Constructs a new PixelEventHandler object with the specified
   /// counters, geometry, and serializer.
@@ -134,17 +167,15 @@ public:
   virtual ~PixelEventHandler(){};
 
   ///
-  /// \brief Applies the pixel data to the PixelEventHandler.
+  /// \brief Applies a batch of pixel data to the PixelEventHandler.
   ///
-  /// This method is an implementation of the applyData method from the
-  /// Observer::DataEventObserver interface. It takes a
-  /// timepixReadout::PixelReadout object as input and applies the pixel data to
-  /// the PixelEventHandler.
+  /// This method reads the fields directly from the decoded columns, with
+  /// one call per run of pixel readouts in a packet.
   ///
-  /// \param pixelDataEvent The timepixReadout::PixelReadout object containing
-  /// the pixel data.
+  /// \param pixelBatch The timepixReadout::PixelBatch object containing
+  /// consecutive pixel readouts of a packet.
   ///
-  void applyData(const timepixReadout::PixelReadout &pixelDataEvent) override;
+  void applyData(const timepixReadout::PixelBatch &pixelBatch) override;
 
   ///
   /// \brief Applies the epoch ESS pulse time data to the PixelEventHandler.
@@ -168,4 +199,89 @@ public:
   void pushDataToKafka();
 };
 
-} // namespace Timepix3
\ No newline at end of file
+// Defined here, so that parsers with this handler bound can inline them
+
+inline uint64_t PixelEventHandler::pixelClockTime(uint16_t toa, uint16_t fToA,
+                                                  uint32_t spidrTime) {
+  // Calculate pixel clock time according to timepix documentation: 409600 ns
+  // per SPIDR tick, 25 ns per ToA tick minus 1.5625 ns = 100/64 ns per fToA
+  // tick. Subtracting the fToA time rounded up to whole ns gives the exact
+  // time truncated to ns, as the conversion from double did.
+  return 409600 * static_cast<uint64_t>(spidrTime) +
+         25 * static_cast<uint64_t>(toa) -
+         ((100 * static_cast<uint64_t>(fToA) + 63) >> 6);
+}
+
+inline uint64_t PixelEventHandler::globalTime(uint64_t pixelClockTime,
+                                              uint64_t pulseTimeInEpochNs,
+                                              uint64_t tdcClockInPixelTime) {
+  // In case of pixel clock reset between two tdc, the time until the reset
+  // from the last tdc time is added. Both clocks are far below 2^63, so the
+  // difference is negative exactly when the pixel clock is behind the tdc.
+  uint64_t tofInPixelTime = pixelClockTime - tdcClockInPixelTime;
+  uint64_t resetMask = -(tofInPixelTime >> 63);
+  return pulseTimeInEpochNs + tofInPixelTime +
+         (PIXEL_MAX_TIMESTAMP_NS & resetMask);
+}
+
+inline void PixelEventHandler::calculateGlobalTimes(
+    const timepixReadout::PixelBatch &pixelBatch,
+    const timepixDTO::ESSGlobalTimeStamp &epochEssPulseTime,
+    uint64_t *globalTimes) {
+  const timepixReadout::PixelColumns &Columns = pixelBatch.Columns;
+  const uint16_t *toa = Columns.toa.data() + pixelBatch.Begin;
+  const uint16_t *fToA = Columns.fToA.data() + pixelBatch.Begin;
+  const uint16_t *spidrTime = Columns.spidrTime.data() + pixelBatch.Begin;
+  const uint64_t pulseTimeInEpochNs = epochEssPulseTime.pulseTimeInEpochNs;
+  const uint64_t tdcClockInPixelTime = epochEssPulseTime.tdcClockInPixelTime;
+  const size_t pixels = pixelBatch.size();
+
+  for (size_t i = 0; i < pixels; i++) {
+    globalTimes[i] =
+        globalTime(pixelClockTime(toa[i], fToA[i], spidrTime[i]),
+                   pulseTimeInEpochNs, tdcClockInPixelTime);
+  }
+}
+
+inline void
+PixelEventHandler::applyData(const timepixReadout::PixelBatch &pixelBatch) {
+  const timepixReadout::PixelColumns &Columns = pixelBatch.Columns;
+
+  // Global times for the whole batch first, in a loop without branches
+  if (lastEpochESSPulseTime != nullptr) {
+    if (batchGlobalTimes.size() < pixelBatch.size()) {
+      batchGlobalTimes.resize(pixelBatch.size());
+    }
+    calculateGlobalTimes(pixelBatch, *lastEpochESSPulseTime,
+                         batchGlobalTimes.data());
+  }
+
+  for (size_t Row = pixelBatch.Begin; Row < pixelBatch.End; Row++) {
+    uint32_t Col = geometry->calcX(Columns.dCol[Row], Columns.pix[Row]);
+    uint32_t Line = geometry->calcY(Columns.sPix[Row], Columns.pix[Row]);
+
+    if (Col >= geometry->nx() or Line >= geometry->ny()) {
+      XTRACE(DATA, WAR, "Invalid Data, skipping readout");
+      statCounters.InvalidPixelReadout++;
+      continue;
+    }
+
+    if (lastEpochESSPulseTime == nullptr) {
+      XTRACE(DATA, WAR, "No epoch pulse time, skipping readout");
+      statCounters.NoGlobalTime++;
+      continue;
+    }
+
+    uint16_t X = Col;
+    uint16_t Y = Line;
+
+    uint64_t pixelGlobalTimeStamp = batchGlobalTimes[Row - pixelBatch.Begin];
+
+    int windowIndex = geometry->getChunkWindowIndex(X, Y);
+
+    sub2DFrames[windowIndex].push_back(
+        {pixelGlobalTimeStamp, X, Y, Columns.ToT[Row]});
+  }
+}
+
+} // namespace Timepix3
@@ -7,8 +7,14 @@
 //===----------------------------------------------------------------------===//
 
 #include <common/debug/Trace.h>
+#include <cstring>
 #include <timepix3/readout/DataParser.h>
 
+#if defined(__x86_64__) and (defined(__GNUC__) or defined(__clang__))
+#define TIMEPIX3PARSER_AVX2
+#include <immintrin.h>
+#endif
+
 // #undef TRC_LEVEL
 // #define TRC_LEVEL TRC_L_DEB
 
@@ -16,127 +22,130 @@ namespace Timepix3 {
 
 using namespace timepixReadout;
 
-DataParser::DataParser(struct Counters &counters) : Stats(counters) {}
-
-int DataParser::parse(const char *Buffer, unsigned int Size) {
-  XTRACE(DATA, DEB, "parsing data, size is %u", Size);
-
-  unsigned int ParsedReadouts = 0;
-
-  unsigned int BytesLeft = Size;
-  char *DataPtr = (char *)Buffer;
-
-  // packets in timepix3 datastream are either from the camera or the EVR system
-  // if from the EVR system, they will be 24 bits, and will contain pulse time
-  // information. If they are 24 bits but not type = 1, then it is a camera
-  // packet
+namespace {
+/// \brief decode words First to Last - 1 into rows of Columns, adding the
+/// rows of words which are not pixel readouts to Others
+void decodeScalar(const char *Buffer, unsigned int First, unsigned int Last,
+                  PixelColumns &Columns,
+                  std::vector<uint32_t> &Others) {
+  for (unsigned int Row = First; Row < Last; Row++) {
+    // the data is not guaranteed to be aligned to 64 bits
+    uint64_t Word;
+    std::memcpy(&Word, Buffer + Row * sizeof(Word), sizeof(Word));
+
+    if ((Word & TYPE_MASK) >> TYPE_OFFS != PIXEL_READOUT_TYPE) {
+      Others.push_back(Row);
+    }
+    Columns.dCol[Row] = (Word & PIXEL_DCOL_MASK) >> PIXEL_DCOL_OFFSET;
+    Columns.sPix[Row] = (Word & PIXEL_SPIX_MASK) >> PIXEL_SPIX_OFFSET;
+    Columns.pix[Row] = (Word & PIXEL_PIX_MASK) >> PIXEL_PIX_OFFSET;
+    Columns.ToT[Row] = (Word & PIXEL_TOT_MASK) >> PIXEL_TOT_OFFSET;
+    Columns.fToA[Row] = (Word & PIXEL_FTOA_MASK) >> PIXEL_FTOA_OFFSET;
+    Columns.toa[Row] = (Word & PIXEL_TOA_MASK) >> PIXEL_TOA_OFFSET;
+    Columns.spidrTime[Row] = Word & PIXEL_SPTIME_MASK;
+  }
+}
 
-  if (Size == sizeof(struct EVRReadout)) {
-    XTRACE(DATA, DEB, "size is 24, could be EVR timestamp");
-    EVRReadout *Data = (EVRReadout *)((char *)DataPtr);
+#ifdef TIMEPIX3PARSER_AVX2
+/// \brief 32 bit field (Words >> Shift) & Mask of eight words, given the
+/// upper (Shift >= 32) or lower 32 bits of each word in High and Low
+#define FIELD32(High, Low, Shift, Mask)                                        \
+  _mm256_and_si256(                                                            \
+      _mm256_srli_epi32((Shift) >= 32 ? (High) : (Low), (Shift) % 32),         \
+      _mm256_set1_epi32(Mask))
+
+/// \brief the low 32 bits of the 64 bit lanes of A and then B
+__attribute__((target("avx2"))) inline __m256i
+compact(__m256i A, __m256i B, __m256i Index) {
+  return _mm256_permute2x128_si256(_mm256_permutevar8x32_epi32(A, Index),
+                                   _mm256_permutevar8x32_epi32(B, Index), 0x20);
+}
 
-    if (Data->type == EVR_READOUT_TYPE) {
-      XTRACE(DATA, DEB,
-             "Processed readout, packet type = %u, counter = %u, pulsetime "
-             "seconds = %u, "
-             "pulsetime nanoseconds = %u, previous pulsetime seconds = %u, "
-             "previous pulsetime nanoseconds = %u",
-             1, Data->counter, Data->pulseTimeSeconds,
-             Data->pulseTimeNanoSeconds, Data->prevPulseTimeSeconds,
-             Data->prevPulseTimeNanoSeconds);
+/// \brief store sixteen 32 bit values < 2^16 as 16 bit values
+__attribute__((target("avx2"))) inline void store16(uint16_t *Column,
+                                                    __m256i A, __m256i B) {
+  _mm256_storeu_si256(
+      (__m256i *)Column,
+      _mm256_permute4x64_epi64(_mm256_packus_epi32(A, B), 0xD8));
+}
 
-      DataEventObservable<EVRReadout>::publishData(*Data);
-      Stats.EVRReadoutCounter++;
-      return 1;
+/// \brief decode whole blocks of sixteen words, as decodeScalar()
+/// \return number of words decoded
+__attribute__((target("avx2"))) unsigned int
+decodeAVX2(const char *Buffer, unsigned int Words, PixelColumns &Columns,
+           std::vector<uint32_t> &Others) {
+  const __m256i LowIndex = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+  const __m256i HighIndex = _mm256_setr_epi32(1, 3, 5, 7, 1, 3, 5, 7);
+  const __m256i Pixel = _mm256_set1_epi32(PIXEL_READOUT_TYPE);
+
+  unsigned int Row{0};
+  for (; Row + 16 <= Words; Row += 16) {
+    const __m256i *Data = (const __m256i *)(Buffer + Row * sizeof(uint64_t));
+    __m256i W0 = _mm256_loadu_si256(Data);
+    __m256i W1 = _mm256_loadu_si256(Data + 1);
+    __m256i W2 = _mm256_loadu_si256(Data + 2);
+    __m256i W3 = _mm256_loadu_si256(Data + 3);
+
+    // upper and lower halves of eight words each, ToA straddles the halves
+    __m256i High0 = compact(W0, W1, HighIndex);
+    __m256i High1 = compact(W2, W3, HighIndex);
+    __m256i Low0 = compact(W0, W1, LowIndex);
+    __m256i Low1 = compact(W2, W3, LowIndex);
+    __m256i ToA0 = compact(_mm256_srli_epi64(W0, PIXEL_TOA_OFFSET),
+                           _mm256_srli_epi64(W1, PIXEL_TOA_OFFSET), LowIndex);
+    __m256i ToA1 = compact(_mm256_srli_epi64(W2, PIXEL_TOA_OFFSET),
+                           _mm256_srli_epi64(W3, PIXEL_TOA_OFFSET), LowIndex);
+
+    uint32_t NotPixel =
+        ~(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(
+              _mm256_srli_epi32(High0, TYPE_OFFS - 32), Pixel))) |
+          _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(
+              _mm256_srli_epi32(High1, TYPE_OFFS - 32), Pixel)))
+              << 8) &
+        0xFFFF;
+    while (NotPixel) {
+      Others.push_back(Row + __builtin_ctz(NotPixel));
+      NotPixel &= NotPixel - 1;
     }
-    XTRACE(DATA, DEB,
-           "Not type = 1, not an EVR timestamp, processing as normal");
-  }
 
-  while (BytesLeft) {
-    uint64_t *DataBytesPtr;
+#define STORE_FIELD(Column, Shift, Mask)                                       \
+  store16(Columns.Column.data() + Row, FIELD32(High0, Low0, Shift, Mask),      \
+          FIELD32(High1, Low1, Shift, Mask))
+
+    STORE_FIELD(dCol, PIXEL_DCOL_OFFSET, PIXEL_DCOL_MASK >> PIXEL_DCOL_OFFSET);
+    STORE_FIELD(sPix, PIXEL_SPIX_OFFSET, PIXEL_SPIX_MASK >> PIXEL_SPIX_OFFSET);
+    STORE_FIELD(pix, PIXEL_PIX_OFFSET, PIXEL_PIX_MASK >> PIXEL_PIX_OFFSET);
+    STORE_FIELD(ToT, PIXEL_TOT_OFFSET, PIXEL_TOT_MASK >> PIXEL_TOT_OFFSET);
+    STORE_FIELD(fToA, PIXEL_FTOA_OFFSET, PIXEL_FTOA_MASK >> PIXEL_FTOA_OFFSET);
+    STORE_FIELD(spidrTime, 0, PIXEL_SPTIME_MASK);
+#undef STORE_FIELD
+    store16(Columns.toa.data() + Row,
+            FIELD32(ToA0, ToA0, 0, PIXEL_TOA_MASK >> PIXEL_TOA_OFFSET),
+            FIELD32(ToA1, ToA1, 0, PIXEL_TOA_MASK >> PIXEL_TOA_OFFSET));
+  }
+  return Row;
+}
+#undef FIELD32
 
-    if (BytesLeft < sizeof(*DataBytesPtr)) {
-      // TODO add some error handling here
-      // Maybe add a counter about demaged chunks
-      XTRACE(DATA, DEB, "not enough bytes left, %u", BytesLeft);
-      break;
-    }
-    
-    // we read the data as 64 bit integers, and then use bitmasks to extract the
-    // relevant information. This is done to avoid alignment issues, as the data
-    // is not guaranteed to be aligned to 64 bits
-    DataBytesPtr = reinterpret_cast<uint64_t*>(DataPtr);
-
-    // regardless of readout type, the type variable is always in the same place
-    // we read it here
-    uint8_t ReadoutType = (*DataBytesPtr & TYPE_MASK) >> TYPE_OFFS;
-
-    // pixel readout, identifies where a pixel on the camera was activated
-    if (ReadoutType == PIXEL_READOUT_TYPE_CONST) {
-
-      PixelReadout pixelDataEvent(
-          (*DataBytesPtr & PIXEL_DCOL_MASK) >> PIXEL_DCOL_OFFSET,
-          (*DataBytesPtr & PIXEL_SPIX_MASK) >> PIXEL_SPIX_OFFSET,
-          (*DataBytesPtr & PIXEL_PIX_MASK) >> PIXEL_PIX_OFFSET,
-          (*DataBytesPtr & PIXEL_TOT_MASK) >> PIXEL_TOT_OFFSET,
-          (*DataBytesPtr & PIXEL_FTOA_MASK) >> PIXEL_FTOA_OFFSET,
-          (*DataBytesPtr & PIXEL_TOA_MASK) >> PIXEL_TOA_OFFSET,
-          *DataBytesPtr & PIXEL_SPTIME_MASK);
-
-      DataEventObservable<PixelReadout>::publishData(pixelDataEvent);
-
-      ParsedReadouts++;
-      Stats.PixelReadouts++;
-
-      // TDC readout type, indicating when the camera received a TDC pulse. In
-      // the ESS setup, this should correspond to an EVR pulse, indicating the
-      // start of a new pulse.
-    } else if (ReadoutType == TDC_READOUT_TYPE_CONST) {
-
-      // mask and offset values are defined in DataParser.h
-      TDCReadout tdcReadout(
-          (*DataBytesPtr & TDC_TYPE_MASK) >> TDC_TYPE_OFFSET,
-          (*DataBytesPtr & TDC_TRIGGERCOUNTER_MASK) >> TDC_TRIGGERCOUNTER_OFFSET,
-          (*DataBytesPtr & TDC_TIMESTAMP_MASK) >> TDC_TIMESTAMP_OFFSET,
-          (*DataBytesPtr & TDC_STAMP_MASK) >> TDC_STAMP_OFFSET);
-
-      ParsedReadouts++;
-      Stats.TDCReadoutCounter++;
-
-      // TDC readouts can belong to one of two channels, and can either
-      // indicate the rising or the falling edge of the signal. The camera
-      // setup will determine which of these are sent.
-      /// \todo: Review that it's necessary monitor which type of TDC we
-      /// received. Probably this is not important.
-      if (tdcReadout.type == TDC1_RISING_CONST) {
-        Stats.TDC1RisingReadouts++;
-        DataEventObservable<TDCReadout>::publishData(tdcReadout);
-      } else if (tdcReadout.type == TDC1_FALLING_CONST) {
-        Stats.TDC1FallingReadouts++;
-        DataEventObservable<TDCReadout>::publishData(tdcReadout);
-      } else if (tdcReadout.type == TDC2_RISING_CONST) {
-        Stats.TDC2RisingReadouts++;
-        DataEventObservable<TDCReadout>::publishData(tdcReadout);
-      } else if (tdcReadout.type == TDC2_FALLING_CONST) {
-        Stats.TDC2FallingReadouts++;
-        DataEventObservable<TDCReadout>::publishData(tdcReadout);
-      } else {
-        // this should never happen - if it does something has gone wrong with
-        // the data format or parsing
-        Stats.UnknownTDCReadouts++;
-      }
-
-    } else {
-      // we sometimes see packet type 7 here, which accompanies a lot of
-      // control signals
-      XTRACE(DATA, WAR, "Unknown packet type: %u", ReadoutType);
-      Stats.UndefinedReadoutCounter++;
-    }
-    BytesLeft -= sizeof(*DataBytesPtr);
-    DataPtr += sizeof(*DataBytesPtr);
+bool haveAVX2() {
+  static const bool Supported = __builtin_cpu_supports("avx2");
+  return Supported;
+}
+#endif
+} // namespace
+
+void decodePixelColumns(const char *Buffer, unsigned int Words,
+                        [[maybe_unused]] bool Vectorised, PixelColumns &Columns,
+                        std::vector<uint32_t> &Others) {
+  unsigned int Row{0};
+#ifdef TIMEPIX3PARSER_AVX2
+  if (Vectorised and haveAVX2()) {
+    Row = decodeAVX2(Buffer, Words, Columns, Others);
   }
-  return ParsedReadouts;
+#endif
+  decodeScalar(Buffer, Row, Words, Columns, Others);
 }
 
+template class BasicDataParser<>;
+
 } // namespace Timepix3
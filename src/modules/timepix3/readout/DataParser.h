@@ -8,10 +8,13 @@
 
 #pragma once
 
+#include <common/debug/Trace.h>
 #include <cstdint>
+#include <cstring>
 #include <dataflow/DataObserverTemplate.h>
 #include <dto/TimepixDataTypes.h>
 #include <modules/timepix3/Counters.h>
+#include <vector>
 
 namespace Timepix3 {
 
@@ -21,6 +24,7 @@ namespace Timepix3 {
 // clang-format off
 #define TYPE_MASK 0xF000000000000000
 #define TYPE_OFFS 60
+#define PIXEL_READOUT_TYPE 11
 
 // pixel type data
 #define PIXEL_DCOL_MASK     0x0FE0000000000000
@@ -58,24 +62,71 @@ namespace Timepix3 {
 #define EVR_READOUT_TYPE          1
 // clang-format on
 
-class DataParser
-    : public Observer::DataEventObservable<timepixReadout::TDCReadout>,
-      public Observer::DataEventObservable<timepixReadout::EVRReadout>,
-      public Observer::DataEventObservable<timepixReadout::PixelReadout> {
+/// \brief decode Words 64 bit words at Buffer into rows of Columns as pixel
+/// readouts, adding the rows of words of other types to Others. Words are
+/// decoded sixteen at a time with AVX2 if Vectorised and the cpu supports it.
+void decodePixelColumns(const char *Buffer, unsigned int Words,
+                        bool Vectorised, timepixReadout::PixelColumns &Columns,
+                        std::vector<uint32_t> &Others);
+
+/// \brief Timepix3 readout parser publishing to the Handler types with static
+/// dispatch once bound with bind(), and to subscribed observers.
+/// DataParser has no static handlers, the instrument binds its handlers.
+template <typename... Handler>
+class BasicDataParser
+    : public Observer::StaticDataEventObservable<timepixReadout::TDCReadout,
+                                                 Handler...>,
+      public Observer::StaticDataEventObservable<timepixReadout::EVRReadout,
+                                                 Handler...>,
+      public Observer::StaticDataEventObservable<timepixReadout::PixelBatch,
+                                                 Handler...> {
 public:
   const unsigned int MaxReadoutsInPacket{500};
 
-  DataParser(Counters &counters);
+  BasicDataParser(Counters &counters) : Stats(counters) {}
+
+  ~BasicDataParser(){};
 
-  ~DataParser(){};
+  /// \brief bind the handlers receiving the readouts they observe without
+  /// virtual dispatch, before any subscribed observers
+  void bind(Handler *...handlers) {
+    TDCObservable::bind(handlers...);
+    EVRObservable::bind(handlers...);
+    PixelObservable::bind(handlers...);
+  }
 
+  /// \brief decode the packet into Pixels and publish the pixel readouts as
+  /// one PixelBatch per run between TDC and other readouts, in packet order
   int parse(const char *buffer, unsigned int size);
 
+  /// \brief decode words sixteen at a time with AVX2 when the cpu supports
+  /// it (default) or one at a time. Both give the same Pixels and Stats.
+  void setVectorised(bool Enable) { Vectorised = Enable; };
+
   struct Counters &Stats;
 
+  /// \brief pixel fields of every word of the last parsed packet
+  timepixReadout::PixelColumns Pixels;
+
 private:
+  using TDCObservable =
+      Observer::StaticDataEventObservable<timepixReadout::TDCReadout,
+                                          Handler...>;
+  using EVRObservable =
+      Observer::StaticDataEventObservable<timepixReadout::EVRReadout,
+                                          Handler...>;
+  using PixelObservable =
+      Observer::StaticDataEventObservable<timepixReadout::PixelBatch,
+                                          Handler...>;
+
+  /// \brief count and publish a word which is not a pixel readout
+  /// \return 1 for TDC readouts, 0 otherwise
+  int parseOther(uint64_t Word);
+
+  bool Vectorised{true};
+  std::vector<uint32_t> OtherWords; // rows which are not pixel readouts
+
   // Const expression
-  static constexpr uint8_t PIXEL_READOUT_TYPE_CONST = 11;
   static constexpr uint8_t TDC_READOUT_TYPE_CONST = 6;
 
   static constexpr uint8_t TDC1_RISING_CONST = 15;
@@ -84,4 +135,134 @@ private:
   static constexpr uint8_t TDC2_FALLING_CONST = 11;
 };
 
+/// \brief parser with subscribed observers only
+using DataParser = BasicDataParser<>;
+
+template <typename... Handler>
+int BasicDataParser<Handler...>::parse(const char *Buffer,
+                                       unsigned int Size) {
+  using namespace timepixReadout;
+  XTRACE(DATA, DEB, "parsing data, size is %u", Size);
+
+  unsigned int ParsedReadouts = 0;
+
+  // packets in timepix3 datastream are either from the camera or the EVR system
+  // if from the EVR system, they will be 24 bits, and will contain pulse time
+  // information. If they are 24 bits but not type = 1, then it is a camera
+  // packet
+
+  if (Size == sizeof(struct EVRReadout)) {
+    XTRACE(DATA, DEB, "size is 24, could be EVR timestamp");
+    const EVRReadout *Data = (const EVRReadout *)Buffer;
+
+    if (Data->type == EVR_READOUT_TYPE) {
+      XTRACE(DATA, DEB,
+             "Processed readout, packet type = %u, counter = %u, pulsetime "
+             "seconds = %u, "
+             "pulsetime nanoseconds = %u, previous pulsetime seconds = %u, "
+             "previous pulsetime nanoseconds = %u",
+             1, Data->counter, Data->pulseTimeSeconds,
+             Data->pulseTimeNanoSeconds, Data->prevPulseTimeSeconds,
+             Data->prevPulseTimeNanoSeconds);
+
+      EVRObservable::publishData(*Data);
+      Stats.EVRReadoutCounter++;
+      return 1;
+    }
+    XTRACE(DATA, DEB,
+           "Not type = 1, not an EVR timestamp, processing as normal");
+  }
+
+  if (Size % sizeof(uint64_t)) {
+    // TODO add some error handling here
+    // Maybe add a counter about demaged chunks
+    XTRACE(DATA, DEB, "not enough bytes left, %u", Size % sizeof(uint64_t));
+  }
+  unsigned int Words = Size / sizeof(uint64_t);
+
+  // decode every word as a pixel readout, one column per field, and collect
+  // the words of other types for the scalar handling below
+  if (Pixels.size() < Words) {
+    Pixels.resize(Words);
+  }
+  OtherWords.clear();
+  decodePixelColumns(Buffer, Words, Vectorised, Pixels, OtherWords);
+
+  unsigned int PixelReadouts = Words - OtherWords.size();
+  ParsedReadouts += PixelReadouts;
+  Stats.PixelReadouts += PixelReadouts;
+
+  // TDC readouts update the pulse time used for the pixels following them,
+  // so pixel runs and other words are published in packet order
+  unsigned int Begin{0};
+  for (auto Other : OtherWords) {
+    if (Other > Begin) {
+      PixelObservable::publishData({Pixels, Begin, Other});
+    }
+    uint64_t Word;
+    std::memcpy(&Word, Buffer + Other * sizeof(Word), sizeof(Word));
+    ParsedReadouts += parseOther(Word);
+    Begin = Other + 1;
+  }
+  if (Words > Begin) {
+    PixelObservable::publishData({Pixels, Begin, Words});
+  }
+  return ParsedReadouts;
+}
+
+template <typename... Handler>
+int BasicDataParser<Handler...>::parseOther(uint64_t Word) {
+  using namespace timepixReadout;
+
+  // regardless of readout type, the type variable is always in the same place
+  uint8_t ReadoutType = (Word & TYPE_MASK) >> TYPE_OFFS;
+
+  // TDC readout type, indicating when the camera received a TDC pulse. In
+  // the ESS setup, this should correspond to an EVR pulse, indicating the
+  // start of a new pulse.
+  if (ReadoutType == TDC_READOUT_TYPE_CONST) {
+
+    // mask and offset values are defined in DataParser.h
+    TDCReadout tdcReadout(
+        (Word & TDC_TYPE_MASK) >> TDC_TYPE_OFFSET,
+        (Word & TDC_TRIGGERCOUNTER_MASK) >> TDC_TRIGGERCOUNTER_OFFSET,
+        (Word & TDC_TIMESTAMP_MASK) >> TDC_TIMESTAMP_OFFSET,
+        (Word & TDC_STAMP_MASK) >> TDC_STAMP_OFFSET);
+
+    Stats.TDCReadoutCounter++;
+
+    // TDC readouts can belong to one of two channels, and can either
+    // indicate the rising or the falling edge of the signal. The camera
+    // setup will determine which of these are sent.
+    /// \todo: Review that it's necessary monitor which type of TDC we
+    /// received. Probably this is not important.
+    if (tdcReadout.type == TDC1_RISING_CONST) {
+      Stats.TDC1RisingReadouts++;
+      TDCObservable::publishData(tdcReadout);
+    } else if (tdcReadout.type == TDC1_FALLING_CONST) {
+      Stats.TDC1FallingReadouts++;
+      TDCObservable::publishData(tdcReadout);
+    } else if (tdcReadout.type == TDC2_RISING_CONST) {
+      Stats.TDC2RisingReadouts++;
+      TDCObservable::publishData(tdcReadout);
+    } else if (tdcReadout.type == TDC2_FALLING_CONST) {
+      Stats.TDC2FallingReadouts++;
+      TDCObservable::publishData(tdcReadout);
+    } else {
+      // this should never happen - if it does something has gone wrong with
+      // the data format or parsing
+      Stats.UnknownTDCReadouts++;
+    }
+    return 1;
+  }
+
+  // we sometimes see packet type 7 here, which accompanies a lot of
+  // control signals
+  XTRACE(DATA, WAR, "Unknown packet type: %u", ReadoutType);
+  Stats.UndefinedReadoutCounter++;
+  return 0;
+}
+
+extern template class BasicDataParser<>;
+
 } // namespace Timepix3
@@ -0,0 +1,181 @@
+// Copyright (C) 2024 European Spallation Source ERIC
+
+/// \file
+/// \brief Packets per second for the Timepix3 parser publishing to its
+/// handlers through subscribed observers (virtual dispatch) and through bound
+/// handlers (static dispatch). The stream has the shape of a camera recording:
+/// per pulse an EVR packet and camera packets of clustered pixel hits, the
+/// first one starting with the TDC readout of the pulse.
+
+#include <benchmark/benchmark.h>
+#include <common/kafka/EV44Serializer.h>
+#include <cstring>
+#include <modules/timepix3/handlers/PixelEventHandler.h>
+#include <modules/timepix3/handlers/TimingEventHandler.h>
+#include <modules/timepix3/readout/DataParser.h>
+#include <random>
+#include <vector>
+
+using namespace Observer;
+using namespace Timepix3;
+using namespace timepixReadout;
+
+namespace {
+constexpr int Pulses{4};
+constexpr int PacketsPerPulse{8};
+constexpr int WordsPerPacket{1121};
+constexpr int HitsPerCluster{5};
+constexpr uint64_t TDCTimestamp{320000000}; // 1 s in 3.125 ns TDC bins
+
+uint64_t pixelWord(uint16_t X, uint16_t Y, uint64_t PixelClockNs) {
+  uint64_t Pix = (X & 1) << 2 | (Y & 3);
+  uint64_t SpidrTime = PixelClockNs / 409600;
+  uint64_t ToA = (PixelClockNs % 409600) / 25;
+  return 0xBULL << TYPE_OFFS | uint64_t(X & 0xFE) << PIXEL_DCOL_OFFSET |
+         uint64_t(Y & 0xFC) << PIXEL_SPIX_OFFSET | Pix << PIXEL_PIX_OFFSET |
+         (ToA << PIXEL_TOA_OFFSET & PIXEL_TOA_MASK) |
+         100ULL << PIXEL_TOT_OFFSET | (SpidrTime & PIXEL_SPTIME_MASK);
+}
+
+uint64_t tdcWord(uint16_t Counter) {
+  return 0x6FULL << TDC_TYPE_OFFSET |
+         uint64_t(Counter) << TDC_TRIGGERCOUNTER_OFFSET |
+         TDCTimestamp << TDC_TIMESTAMP_OFFSET;
+}
+
+std::vector<std::vector<char>> makeStream() {
+  std::mt19937 Generator(1);
+  std::uniform_int_distribution<int> Coordinate(2, 250);
+  std::uniform_int_distribution<uint64_t> Tof(0, 70000000);
+  const uint64_t TDCClockNs = TDCTimestamp * 3.125;
+
+  std::vector<std::vector<char>> Stream;
+  for (int Pulse = 0; Pulse < Pulses; Pulse++) {
+    std::vector<char> Evr(sizeof(EVRReadout));
+    EVRReadout EvrReadout{1, 0, 0, static_cast<uint32_t>(Pulse), 1700000000,
+                          static_cast<uint32_t>(Pulse * 71428571), 1700000000,
+                          0};
+    std::memcpy(Evr.data(), &EvrReadout, sizeof(EvrReadout));
+    Stream.push_back(Evr);
+
+    for (int Packet = 0; Packet < PacketsPerPulse; Packet++) {
+      std::vector<uint64_t> Words;
+      if (Packet == 0) {
+        Words.push_back(tdcWord(Pulse));
+      }
+      while (Words.size() < WordsPerPacket) {
+        uint16_t X = Coordinate(Generator);
+        uint16_t Y = Coordinate(Generator);
+        uint64_t Time = TDCClockNs + Tof(Generator);
+        for (int Hit = 0; Hit < HitsPerCluster; Hit++) {
+          Words.push_back(pixelWord(X + Hit % 2, Y + Hit / 2, Time + Hit));
+        }
+      }
+      Words.resize(WordsPerPacket);
+      std::vector<char> Data(Words.size() * sizeof(uint64_t));
+      std::memcpy(Data.data(), Words.data(), Data.size());
+      Stream.push_back(Data);
+    }
+  }
+  return Stream;
+}
+
+/// \brief handler doing minimal work per pixel, to show the dispatch cost
+class CountingHandler : public DataEventObserver<PixelBatch>,
+                        public DataEventObserver<TDCReadout>,
+                        public DataEventObserver<EVRReadout> {
+public:
+  uint64_t Sum{0};
+
+  void applyData(const PixelBatch &Batch) override {
+    for (size_t Row = Batch.Begin; Row < Batch.End; Row++) {
+      Sum += Batch.Columns.ToT[Row];
+    }
+  }
+  void applyData(const TDCReadout &Readout) override { Sum += Readout.counter; }
+  void applyData(const EVRReadout &Readout) override { Sum += Readout.counter; }
+};
+
+/// \brief the handlers of Timepix3Instrument, clustering after each packet
+struct InstrumentHandlers {
+  Counters Stats;
+  Config Configuration;
+  EV44Serializer Serializer{115000, "timepix3"};
+  std::shared_ptr<Timepix3Geometry> Geometry{
+      std::make_shared<Timepix3Geometry>(256, 256, 1)};
+  TimingEventHandler Timing{Stats,
+                            static_cast<int>(Configuration.FrequencyHz)};
+  std::unique_ptr<PixelEventHandler> Pixels;
+
+  InstrumentHandlers() {
+    Configuration.XResolution = 256;
+    Configuration.YResolution = 256;
+    Configuration.MaxTimeGapNS = 500;
+    Configuration.MinEventSizeHits = 2;
+    Pixels = std::make_unique<PixelEventHandler>(Stats, Geometry, Serializer,
+                                                 Configuration);
+    Timing.DataEventObservable<timepixDTO::ESSGlobalTimeStamp>::subscribe(
+        Pixels.get());
+  }
+};
+
+template <typename ParserType, typename ProcessFn>
+void run(benchmark::State &state, ParserType &Parser, ProcessFn &&Process) {
+  auto Stream = makeStream();
+  size_t Packet{0};
+  for (auto _ : state) {
+    auto &Data = Stream[Packet];
+    benchmark::DoNotOptimize(Parser.parse(Data.data(), Data.size()));
+    Process();
+    Packet = (Packet + 1) % Stream.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["Pixels"] = benchmark::Counter(Parser.Stats.PixelReadouts,
+                                                benchmark::Counter::kIsRate);
+}
+} // namespace
+
+static void CountingVirtual(benchmark::State &state) {
+  Counters Stats;
+  CountingHandler Handler;
+  DataParser Parser{Stats};
+  Parser.DataEventObservable<PixelBatch>::subscribe(&Handler);
+  Parser.DataEventObservable<TDCReadout>::subscribe(&Handler);
+  Parser.DataEventObservable<EVRReadout>::subscribe(&Handler);
+  run(state, Parser, [] {});
+  benchmark::DoNotOptimize(Handler.Sum);
+}
+BENCHMARK(CountingVirtual);
+
+static void CountingStatic(benchmark::State &state) {
+  Counters Stats;
+  CountingHandler Handler;
+  BasicDataParser<CountingHandler> Parser{Stats};
+  Parser.bind(&Handler);
+  run(state, Parser, [] {});
+  benchmark::DoNotOptimize(Handler.Sum);
+}
+BENCHMARK(CountingStatic);
+
+static void InstrumentVirtual(benchmark::State &state) {
+  InstrumentHandlers Handlers;
+  DataParser Parser{Handlers.Stats};
+  Parser.DataEventObservable<PixelBatch>::subscribe(Handlers.Pixels.get());
+  Parser.DataEventObservable<TDCReadout>::subscribe(&Handlers.Timing);
+  Parser.DataEventObservable<EVRReadout>::subscribe(&Handlers.Timing);
+  run(state, Parser, [&] { Handlers.Pixels->pushDataToKafka(); });
+  state.counters["Events"] = Handlers.Stats.Events;
+}
+BENCHMARK(InstrumentVirtual);
+
+static void InstrumentStatic(benchmark::State &state) {
+  InstrumentHandlers Handlers;
+  BasicDataParser<PixelEventHandler, TimingEventHandler> Parser{
+      Handlers.Stats};
+  Parser.bind(Handlers.Pixels.get(), &Handlers.Timing);
+  run(state, Parser, [&] { Handlers.Pixels->pushDataToKafka(); });
+  state.counters["Events"] = Handlers.Stats.Events;
+}
+BENCHMARK(InstrumentStatic);
+
+BENCHMARK_MAIN();
@@ -9,6 +9,7 @@
 #include <dto/TimepixDataTypes.h>
 #include <memory>
 #include <modules/timepix3/Counters.h>
+#include <random>
 #include <modules/timepix3/test/TimepixTestHelper.h>
 #include <timepix3/readout/DataParser.h>
 
@@ -23,8 +24,7 @@ std::vector<uint8_t> singlePixelReadoutData{
     0x8b, 0xa8, 0x3a, 0xbf
 };
 
-PixelReadout singlePixelReadout{15, 2231, 30,
-                                                  6, 45, 454, 33};
+PixelReadout singlePixelReadout{242, 212, 2, 3, 0, 35000, 50833};
 
 std::vector<uint8_t> TooShort{
     0x00, 0x01
@@ -96,7 +96,25 @@ std::vector<uint8_t> TDCAndPixelReadout{
 
 class TDCReadoutHandler : public MockupDataEventReceiver<TDCReadout> {};
 class EVRReadoutHandler : public MockupDataEventReceiver<EVRReadout> {};
-class PixelReadoutHandler : public MockupDataEventReceiver<PixelReadout> {};
+
+/// \brief records pixel batches as readouts and the order of batches and
+/// TDC readouts, batch size for a batch and -1 for a TDC readout
+class PixelBatchRecorder : public DataEventObserver<PixelBatch>,
+                           public DataEventObserver<TDCReadout> {
+public:
+  std::vector<std::vector<PixelReadout>> Batches;
+  std::vector<int> Sequence;
+
+  void applyData(const PixelBatch &Batch) override {
+    Batches.emplace_back();
+    for (size_t Row = Batch.Begin; Row < Batch.End; Row++) {
+      Batches.back().push_back(Batch.Columns.readout(Row));
+    }
+    Sequence.push_back(Batch.size());
+  }
+
+  void applyData(const TDCReadout &) override { Sequence.push_back(-1); }
+};
 
 class Timepix3ParserTest : public TestBase {
 protected:
@@ -104,7 +122,7 @@ protected:
   DataParser timepix3Parser{counters};
   TDCReadoutHandler tdcTestHandler;
   EVRReadoutHandler evrTestHandler;
-  PixelReadoutHandler pixelTestHandler;
+  PixelBatchRecorder pixelRecorder;
 
   EV44Serializer serializer{115000, "timepix3"};
 
@@ -114,6 +132,8 @@ protected:
 
     timepix3Parser.DataEventObservable<TDCReadout>::subscribe(&tdcTestHandler);
     timepix3Parser.DataEventObservable<EVRReadout>::subscribe(&evrTestHandler);
+    timepix3Parser.DataEventObservable<PixelBatch>::subscribe(&pixelRecorder);
+    timepix3Parser.DataEventObservable<TDCReadout>::subscribe(&pixelRecorder);
   }
 
   void TearDown() override {}
@@ -122,11 +142,13 @@ protected:
 // Test cases below
 
 TEST_F(Timepix3ParserTest, SinglePixelReadout) {
-  pixelTestHandler.setData(singlePixelReadout);
   auto Res = timepix3Parser.parse((char *)singlePixelReadoutData.data(),
                                   singlePixelReadoutData.size());
   EXPECT_EQ(Res, 1);
   EXPECT_EQ(counters.PixelReadouts, 1);
+  ASSERT_EQ(pixelRecorder.Batches.size(), 1);
+  ASSERT_EQ(pixelRecorder.Batches[0].size(), 1);
+  EXPECT_EQ(pixelRecorder.Batches[0][0], singlePixelReadout);
 }
 
 TEST_F(Timepix3ParserTest, TDC1RisingReadouts) {
@@ -200,7 +222,6 @@ TEST_F(Timepix3ParserTest, SingleEVRReadout) {
 
 TEST_F(Timepix3ParserTest, TDCAndPixelReadout) {
   tdcTestHandler.setData(tdc1RisingReadout);
-  pixelTestHandler.setData(singlePixelReadout);
 
   auto Res = timepix3Parser.parse((char *)TDCAndPixelReadout.data(),
                                   TDCAndPixelReadout.size());
@@ -208,6 +229,89 @@ TEST_F(Timepix3ParserTest, TDCAndPixelReadout) {
   EXPECT_EQ(counters.TDC1RisingReadouts, 1);
   EXPECT_EQ(counters.TDCReadoutCounter, 1);
   EXPECT_EQ(counters.PixelReadouts, 1);
+  EXPECT_EQ(pixelRecorder.Sequence, std::vector<int>({-1, 1}));
+  EXPECT_EQ(pixelRecorder.Batches[0][0], singlePixelReadout);
+}
+
+TEST_F(Timepix3ParserTest, PixelBatchesSplitAtOtherReadouts) {
+  tdcTestHandler.setData(tdc1RisingReadout);
+
+  std::vector<uint8_t> Packet;
+  for (auto Readout : {&singlePixelReadoutData, &singlePixelReadoutData,
+                       &tdc1RisingReadoutData, &singlePixelReadoutData}) {
+    Packet.insert(Packet.end(), Readout->begin(), Readout->end());
+  }
+  // type 7 control word
+  Packet.insert(Packet.end(), {0, 0, 0, 0, 0, 0, 0, 0x70});
+  Packet.insert(Packet.end(), singlePixelReadoutData.begin(),
+                singlePixelReadoutData.end());
+
+  auto Res = timepix3Parser.parse((char *)Packet.data(), Packet.size());
+  EXPECT_EQ(Res, 5);
+  EXPECT_EQ(counters.PixelReadouts, 4);
+  EXPECT_EQ(counters.TDCReadoutCounter, 1);
+  EXPECT_EQ(counters.UndefinedReadoutCounter, 1);
+  EXPECT_EQ(pixelRecorder.Sequence, std::vector<int>({2, -1, 1, 1}));
+  for (auto &Batch : pixelRecorder.Batches) {
+    for (auto &Readout : Batch) {
+      EXPECT_EQ(Readout, singlePixelReadout);
+    }
+  }
+}
+
+TEST_F(Timepix3ParserTest, VectorisedMatchesScalar) {
+  // random words, mostly pixel readouts, a packet size not a multiple of
+  // the sixteen words decoded at a time
+  std::mt19937_64 Generator(42);
+  std::vector<uint64_t> Words(1117);
+  for (size_t i = 0; i < Words.size(); i++) {
+    uint64_t Type = (i % 97 == 5) ? 0x6 : (i % 131 == 7) ? 0x7 : 0xB;
+    Words[i] = (Generator() & ~TYPE_MASK) | Type << TYPE_OFFS;
+  }
+
+  Counters Stats[2];
+  PixelBatchRecorder Recorders[2];
+  for (int Vectorised = 0; Vectorised < 2; Vectorised++) {
+    DataParser Parser{Stats[Vectorised]};
+    Parser.setVectorised(Vectorised);
+    Parser.DataEventObservable<PixelBatch>::subscribe(&Recorders[Vectorised]);
+    Parser.DataEventObservable<TDCReadout>::subscribe(&Recorders[Vectorised]);
+    // twice, to also parse into columns left from a previous packet
+    for (int Packet = 0; Packet < 2; Packet++) {
+      auto Res =
+          Parser.parse((char *)Words.data(), Words.size() * sizeof(uint64_t));
+      EXPECT_EQ(Res, 1117 - 9);
+    }
+  }
+  EXPECT_EQ(Stats[0].PixelReadouts, 2 * (1117 - 12 - 9));
+  EXPECT_EQ(Stats[1].PixelReadouts, Stats[0].PixelReadouts);
+  EXPECT_EQ(Stats[1].TDCReadoutCounter, Stats[0].TDCReadoutCounter);
+  EXPECT_EQ(Stats[1].UnknownTDCReadouts, Stats[0].UnknownTDCReadouts);
+  EXPECT_EQ(Stats[1].UndefinedReadoutCounter,
+            Stats[0].UndefinedReadoutCounter);
+  EXPECT_EQ(Recorders[1].Sequence, Recorders[0].Sequence);
+  EXPECT_EQ(Recorders[1].Batches, Recorders[0].Batches);
+}
+
+TEST_F(Timepix3ParserTest, BoundAndSubscribedHandlers) {
+  BasicDataParser<PixelBatchRecorder> Parser{counters};
+  PixelBatchRecorder Bound;
+  Parser.bind(&Bound);
+  Parser.DataEventObservable<PixelBatch>::subscribe(&pixelRecorder);
+  Parser.DataEventObservable<TDCReadout>::subscribe(&pixelRecorder);
+
+  auto Res = Parser.parse((char *)TDCAndPixelReadout.data(),
+                          TDCAndPixelReadout.size());
+  EXPECT_EQ(Res, 2);
+  EXPECT_EQ(Bound.Sequence, std::vector<int>({-1, 1}));
+  EXPECT_EQ(pixelRecorder.Sequence, Bound.Sequence);
+  EXPECT_EQ(Bound.Batches[0][0], singlePixelReadout);
+
+  Parser.bind(nullptr);
+  Parser.parse((char *)singlePixelReadoutData.data(),
+               singlePixelReadoutData.size());
+  EXPECT_EQ(Bound.Sequence.size(), 2);
+  EXPECT_EQ(pixelRecorder.Sequence, std::vector<int>({-1, 1, 1}));
 }
 
 int main(int argc, char **argv) {
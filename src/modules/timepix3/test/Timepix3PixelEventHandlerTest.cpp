@@ -130,6 +130,20 @@ class Timepix3PixelEventHandlerTest : public TestBase {
   }
 
   void TearDown() override {}
+
+  /// \brief apply a single pixel readout as a batch of one
+  void applyPixel(const PixelReadout &Readout) {
+    PixelColumns Columns;
+    Columns.resize(1);
+    Columns.dCol[0] = Readout.dCol;
+    Columns.sPix[0] = Readout.sPix;
+    Columns.pix[0] = Readout.pix;
+    Columns.ToT[0] = Readout.ToT;
+    Columns.fToA[0] = Readout.fToA;
+    Columns.toa[0] = Readout.toa;
+    Columns.spidrTime[0] = Readout.spidrTime;
+    testEventHandler.applyData(PixelBatch{Columns, 0, 1});
+  }
 };
 
 // Test cases below
@@ -142,7 +156,7 @@ TEST_F(Timepix3PixelEventHandlerTest, SerializerReferenceTimeUpdated) {
 
 TEST_F(Timepix3PixelEventHandlerTest, TestInvalidPixelReadout) {
   uint16_t INVALID_SPIX = 500;
-  testEventHandler.applyData(PixelReadout{
+  applyPixel(PixelReadout{
       TEST_DCOL, INVALID_SPIX, TEST_PIX, TEST_DEFAULT_PIXEL_TIME.ToT,
       TEST_DEFAULT_PIXEL_TIME.fToA, TEST_DEFAULT_PIXEL_TIME.ToA,
       TEST_DEFAULT_PIXEL_TIME.spidrTime});
@@ -159,7 +173,7 @@ TEST_F(Timepix3PixelEventHandlerTest, TestIfEventIsLaterThenNextTdc) {
   testEventHandler.applyData(
       {TEST_PULSE_TIME_NS, TEST_DEFAULT_PIXEL_TIME.tdcClockInPixelTime});
 
-  testEventHandler.applyData(
+  applyPixel(
       PixelReadout{TEST_DCOL, TEST_SPIX, TEST_PIX, TEST_DEFAULT_PIXEL_TIME.ToT,
                    TEST_DEFAULT_PIXEL_TIME.fToA, TEST_DEFAULT_PIXEL_TIME.ToA,
                    spidrLateArrival});
@@ -176,7 +190,7 @@ TEST_F(Timepix3PixelEventHandlerTest, TestEventTimeShortlyAfterTdcPublished) {
 
   testEventHandler.applyData(
       {TEST_PULSE_TIME_NS, TEST_DEFAULT_PIXEL_TIME.tdcClockInPixelTime});
-  testEventHandler.applyData(
+  applyPixel(
       PixelReadout{TEST_DCOL, TEST_SPIX, TEST_PIX, TEST_DEFAULT_PIXEL_TIME.ToT,
                    TEST_DEFAULT_PIXEL_TIME.fToA, TEST_DEFAULT_PIXEL_TIME.ToA,
                    TEST_DEFAULT_PIXEL_TIME.spidrTime});
@@ -199,7 +213,7 @@ TEST_F(Timepix3PixelEventHandlerTest, TestPixelIsAfterReset) {
 
   testEventHandler.applyData(
       {TEST_PULSE_TIME_NS, pixelAfterReset.tdcClockInPixelTime});
-  testEventHandler.applyData(PixelReadout{
+  applyPixel(PixelReadout{
       TEST_DCOL, TEST_SPIX, TEST_PIX, pixelAfterReset.ToT, pixelAfterReset.fToA,
       pixelAfterReset.ToA, pixelAfterReset.spidrTime});
 
@@ -211,6 +225,103 @@ TEST_F(Timepix3PixelEventHandlerTest, TestPixelIsAfterReset) {
   EXPECT_EQ(serializer.addEventCallCounter, 1);
 }
 
+TEST_F(Timepix3PixelEventHandlerTest, TestPixelBatch) {
+  serializer.pulseTimeToCompare = TEST_PULSE_TIME_NS;
+  serializer.pixelIdToCompare = TEST_PIXEL_ID;
+  serializer.eventTimeToCompare = TEST_DEFAULT_PIXEL_TIME.getEventTof();
+
+  // rows 0 and 2 have invalid sPix, row 2 is outside of the batch
+  PixelColumns Columns;
+  Columns.resize(3);
+  for (size_t Row = 0; Row < Columns.size(); Row++) {
+    Columns.dCol[Row] = TEST_DCOL;
+    Columns.sPix[Row] = Row == 1 ? TEST_SPIX : 500;
+    Columns.pix[Row] = TEST_PIX;
+    Columns.ToT[Row] = TEST_DEFAULT_PIXEL_TIME.ToT;
+    Columns.fToA[Row] = TEST_DEFAULT_PIXEL_TIME.fToA;
+    Columns.toa[Row] = TEST_DEFAULT_PIXEL_TIME.ToA;
+    Columns.spidrTime[Row] = TEST_DEFAULT_PIXEL_TIME.spidrTime;
+  }
+
+  testEventHandler.applyData(PixelBatch{Columns, 1, 2});
+  EXPECT_EQ(counters.NoGlobalTime, 1);
+
+  testEventHandler.applyData(
+      {TEST_PULSE_TIME_NS, TEST_DEFAULT_PIXEL_TIME.tdcClockInPixelTime});
+  testEventHandler.applyData(PixelBatch{Columns, 0, 2});
+
+  testEventHandler.pushDataToKafka();
+  EXPECT_EQ(counters.InvalidPixelReadout, 1);
+  EXPECT_EQ(counters.TofCount, 1);
+  EXPECT_EQ(counters.Events, 1);
+  EXPECT_EQ(serializer.addEventCallCounter, 1);
+}
+
+TEST_F(Timepix3PixelEventHandlerTest, FixedPointGlobalTimeMatchesDouble) {
+  // Global time as calculated before, with double arithmetic and branching
+  // on a pixel clock reset
+  auto referenceGlobalTime = [](uint16_t ToA, uint8_t fToA, uint32_t spidrTime,
+                                uint64_t pulseTime, uint64_t tdcClock) {
+    uint64_t pixelClockTime = 409600 * static_cast<uint64_t>(spidrTime) +
+                              25 * static_cast<uint64_t>(ToA) -
+                              1.5625 * static_cast<uint64_t>(fToA);
+    if (tdcClock > pixelClockTime) {
+      return pulseTime + PIXEL_MAX_TIMESTAMP_NS - tdcClock + pixelClockTime;
+    }
+    return pulseTime + pixelClockTime - tdcClock;
+  };
+
+  const std::vector<uint64_t> tdcClocks{
+      0, 1, TEST_DEFAULT_PIXEL_TIME.tdcClockInPixelTime,
+      PIXEL_MAX_TIMESTAMP_NS - 2000, PIXEL_MAX_TIMESTAMP_NS - 1};
+
+  PixelColumns Columns;
+  for (uint32_t spidrTime : {0, 1, 2, 41503, 65534, 65535}) {
+    for (uint32_t ToA = 0; ToA < 16384; ToA += 61) {
+      for (uint8_t fToA = 0; fToA < 16; fToA++) {
+        // negative pixel clock time, undefined in the double conversion,
+        // checked below
+        if (spidrTime == 0 and 25 * ToA < 1.5625 * fToA) {
+          continue;
+        }
+        size_t Row = Columns.size();
+        Columns.resize(Row + 1);
+        Columns.toa[Row] = ToA;
+        Columns.fToA[Row] = fToA;
+        Columns.spidrTime[Row] = spidrTime;
+      }
+    }
+  }
+
+  std::vector<uint64_t> globalTimes(Columns.size());
+  for (uint64_t tdcClock : tdcClocks) {
+    ESSGlobalTimeStamp epochTime{TEST_PULSE_TIME_NS, tdcClock};
+    PixelEventHandler::calculateGlobalTimes(
+        PixelBatch{Columns, 0, Columns.size()}, epochTime, globalTimes.data());
+
+    for (size_t Row = 0; Row < Columns.size(); Row++) {
+      uint64_t expected =
+          referenceGlobalTime(Columns.toa[Row], Columns.fToA[Row],
+                              Columns.spidrTime[Row], TEST_PULSE_TIME_NS,
+                              tdcClock);
+      ASSERT_EQ(globalTimes[Row], expected);
+      ASSERT_EQ(PixelEventHandler::globalTime(
+                    PixelEventHandler::pixelClockTime(Columns.toa[Row],
+                                                      Columns.fToA[Row],
+                                                      Columns.spidrTime[Row]),
+                    TEST_PULSE_TIME_NS, tdcClock),
+                expected);
+    }
+  }
+
+  // fToA correction before the pixel clock reset gives a time just before it
+  uint64_t tdcClock = TEST_DEFAULT_PIXEL_TIME.tdcClockInPixelTime;
+  ASSERT_EQ(PixelEventHandler::globalTime(
+                PixelEventHandler::pixelClockTime(0, 1, 0), TEST_PULSE_TIME_NS,
+                tdcClock),
+            TEST_PULSE_TIME_NS + PIXEL_MAX_TIMESTAMP_NS - tdcClock - 2);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   auto RetVal = RUN_ALL_TESTS();
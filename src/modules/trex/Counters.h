@@ -20,6 +20,7 @@ struct Counters {
 
   // ESSReadout parser
   struct ESSReadout::ESSHeaderStats ReadoutStats;
+  struct ESSReadout::ReorderStats ReorderStats;
   int64_t ErrorESSHeaders;
   // int64_t RingRx[24];
 
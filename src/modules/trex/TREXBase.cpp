@@ -12,7 +12,6 @@
 #include <common/detector/EFUArgs.h>
 #include <common/kafka/EV44Serializer.h>
 #include <common/kafka/KafkaConfig.h>
-#include <common/memory/SPSCFifo.h>
 #include <common/monitor/HistogramSerializer.h>
 #include <common/system/Socket.h>
 #include <common/time/TSCTimer.h>
@@ -42,6 +41,26 @@ TrexBase::TrexBase(BaseSettings const &settings) : Detector(settings) {
   Stats.create("receive.packets", ITCounters.RxPackets);
   Stats.create("receive.bytes", ITCounters.RxBytes);
   Stats.create("receive.dropped", ITCounters.FifoPushErrors);
+  for (int i = 0; i < RxBatchHistBins; i++) {
+    std::string statname = fmt::format("receive.batch_size.{:02}", i);
+    Stats.create(statname, ITCounters.RxBatchSize[i]);
+  }
+  Stats.create("receive.gro_calls", ITCounters.RxGroCalls);
+  Stats.create("receive.gro_segments", ITCounters.RxGroSegments);
+  Stats.create("receive.gro_segments_avg", ITCounters.RxGroSegmentsAvg);
+  Stats.create("receive.gro_copies", ITCounters.RxGroCopies);
+  Stats.create("receive.gro_oversize", ITCounters.RxGroOversize);
+  Stats.create("receive.queue_backing", ITCounters.RxQueueBacking);
+  Stats.create("receive.queue_bytes", ITCounters.RxQueueBytes);
+  Stats.create("receive.queue_locked", ITCounters.RxQueueLocked);
+  Stats.create("receive.queue_high_water", ITCounters.RxQueueHighWater);
+  for (int i = 0; i < RxQueueFillBins; i++) {
+    std::string statname = fmt::format("receive.queue_fill.{:02}", i);
+    Stats.create(statname, ITCounters.RxQueueFill[i]);
+  }
+  Stats.create("receive.kernel_drops", ITCounters.RxKernelDrops);
+  Stats.create("receive.kernel_drops_interval",
+               ITCounters.RxKernelDropsInterval);
   Stats.create("receive.fifo_seq_errors", Counters.FifoSeqErrors);
 
   // ESS Readout header stats
@@ -59,6 +78,9 @@ TrexBase::TrexBase(BaseSettings const &settings) : Detector(settings) {
   Stats.create("essheader.heartbeats", Counters.ReadoutStats.HeartBeats);
   Stats.create("essheader.version.v0", Counters.ReadoutStats.Version0Header);
   Stats.create("essheader.version.v1", Counters.ReadoutStats.Version1Header);
+  Stats.create("essheader.reorder.reordered", Counters.ReorderStats.Reordered);
+  Stats.create("essheader.reorder.timeouts", Counters.ReorderStats.Timeouts);
+  Stats.create("essheader.reorder.max_depth", Counters.ReorderStats.MaxDepth);
 
   //
   Stats.create("readouts.adc_max", Counters.MaxADC);
@@ -102,6 +124,12 @@ TrexBase::TrexBase(BaseSettings const &settings) : Detector(settings) {
   //
   Stats.create("thread.receive_idle", ITCounters.RxIdle);
   Stats.create("thread.processing_idle", Counters.ProcessingIdle);
+  Stats.create("thread.processing_idle_spin_ns", Idle.Stats.SpinNs);
+  Stats.create("thread.processing_idle_yield_ns", Idle.Stats.YieldNs);
+  Stats.create("thread.processing_idle_wait_ns", Idle.Stats.WaitNs);
+  Stats.create("thread.processing_idle_waits", Idle.Stats.Waits);
+  Stats.create("thread.processing_idle_wakeups", Idle.Stats.WaitWakeups);
+  createLatencyStats();
 
   // Produce cause call stats
   Stats.create("produce.cause.timeout", Counters.ProduceCauseTimeout);
@@ -147,7 +175,7 @@ TrexBase::TrexBase(BaseSettings const &settings) : Detector(settings) {
   Detector::AddThreadFunction(processingFunc, "processing");
 
   XTRACE(INIT, ALW, "Creating %d TREX Rx ringbuffers of size %d",
-         EthernetBufferMaxEntries, EthernetBufferSize);
+         InputQueue.getMaxElements(), EthernetBufferSize);
 }
 
 void TrexBase::processing_thread() {
@@ -160,6 +188,7 @@ void TrexBase::processing_thread() {
   KafkaConfig KafkaCfg(EFUSettings.KafkaConfigFile);
   Producer eventprod(EFUSettings.KafkaBroker, EFUSettings.KafkaTopic,
                      KafkaCfg.CfgParms);
+  eventprod.setDeliveryLatency(&Latency.SerializedDelivered);
   auto Produce = [&eventprod](auto DataBuffer, auto Timestamp) {
     eventprod.produce(DataBuffer, Timestamp);
   };
@@ -183,21 +212,29 @@ void TrexBase::processing_thread() {
   // Monitor these counters
   RuntimeStat RtStat({ITCounters.RxPackets, Counters.Events, Counters.KafkaStats.produce_bytes_ok});
 
+  TREX.ESSReadoutParser.Reorder.configure(
+      EFUSettings.ReorderDepth, EFUSettings.ReorderTimeoutUS * TSC_MHZ);
+  TREX.ESSReadoutParser.setHeaderVersion(EFUSettings.HeaderVersion,
+                                         ESSReadout::Parser::TREX);
+
   while (runThreads) {
-    if (InputFifo.pop(DataIndex)) { // There is data in the FIFO - do processing
-      auto DataLen = RxRingbuffer.getDataLength(DataIndex);
+    if (popInOrder(TREX.ESSReadoutParser, DataIndex)) { // There is data in the queue - do processing
+      Idle.reset();
+      Latency.dequeued(InputQueue.getArrivalTime(DataIndex));
+      auto DataLen = InputQueue.getDataLength(DataIndex);
       if (DataLen == 0) {
         Counters.FifoSeqErrors++;
         continue;
       }
 
       /// \todo use the Buffer<T> class here and in parser
-      auto DataPtr = RxRingbuffer.getDataBuffer(DataIndex);
+      auto DataPtr = InputQueue.getDataBuffer(DataIndex);
 
       int64_t SeqErrOld = Counters.ReadoutStats.ErrorSeqNum;
       auto Res = TREX.ESSReadoutParser.validate(DataPtr, DataLen,
                                                 ESSReadout::Parser::TREX);
       Counters.ReadoutStats = TREX.ESSReadoutParser.Stats;
+      Counters.ReorderStats = TREX.ESSReadoutParser.Reorder.Stats;
 
       if (SeqErrOld != Counters.ReadoutStats.ErrorSeqNum) {
         XTRACE(DATA, WAR, "SeqNum error at RxPackets %" PRIu64,
@@ -215,6 +252,7 @@ void TrexBase::processing_thread() {
 
       // We have good header information, now parse readout data
       Res = TREX.VMMParser.parse(TREX.ESSReadoutParser.Packet);
+      Latency.parsed();
       Counters.TimeStats = TREX.ESSReadoutParser.Packet.Time.Stats;
       Counters.VMMStats = TREX.VMMParser.Stats;
 
@@ -223,15 +261,20 @@ void TrexBase::processing_thread() {
       for (auto &builder : TREX.builders) {
         TREX.generateEvents(builder.Events);
       }
+      Latency.serialized();
 
     } else {
-      // There is NO data in the FIFO - increment idle counter and sleep a
+      // There is NO data in the queue - increment idle counter and sleep a
       // little
       Counters.ProcessingIdle++;
-      usleep(10);
+      Idle.idle(InputQueue);
     }
 
+    // Serve delivery reports also when nothing is being produced
+    eventprod.poll();
+
     if (ProduceTimer.timeout()) {
+      Latency.update();
       RuntimeStatusMask = RtStat.getRuntimeStatusMask(
           {ITCounters.RxPackets, Counters.Events, Counters.KafkaStats.produce_bytes_ok});
 
@@ -50,6 +50,8 @@ TREXInstrument::TREXInstrument(struct Counters &counters,
     throw std::runtime_error("Invalid InstrumentGeometry in config file");
   }
 
+  buildChannelMap();
+
   ESSReadoutParser.setMaxPulseTimeDiff(Conf.FileParameters.MaxPulseTimeNS);
 
   // Reinit histogram size (was set to 1 in class definition)
@@ -90,6 +92,37 @@ void TREXInstrument::loadConfigAndCalib() {
   }
 }
 
+void TREXInstrument::buildChannelMap() {
+  ChannelMap.build(Conf, [&](uint8_t Ring, uint8_t FEN, uint8_t HybridId,
+                             uint8_t Asic, uint8_t Channel,
+                             ESSReadout::Hybrid &Hybrid) {
+    bool Rotated = Conf.Rotated[Ring][FEN][HybridId];
+    ESSReadout::VMM3ChannelMap::Entry Entry;
+    // x and z coord is a combination of the X and Z coordinates that provides
+    // a unique wire identifier Adjacency of wires isn't needed as wires are
+    // well insulated and events don't span multiples of them
+    if (GeometryInstance->isWire(HybridId)) {
+      Entry.Coord = GeometryInstance->xAndzCoord(
+          Ring, FEN, HybridId, Asic, Channel, Hybrid.XOffset, Rotated);
+      Entry.Plane = 0;
+    } else { // implicit isYCoord
+      Entry.Coord = GeometryInstance->yCoord(HybridId, Asic, Channel,
+                                             Hybrid.YOffset, Rotated,
+                                             Conf.Short[Ring][FEN][HybridId]);
+      Entry.Plane = 1;
+    }
+    Entry.MinADC = Hybrid.MinADC;
+    Entry.Builder = Ring * Conf.MaxFEN + FEN;
+    // 65535 is used for invalid coordinate value
+    Entry.State = (Entry.Coord == Geometry::InvalidCoord)
+                      ? ESSReadout::VMM3ChannelMap::InvalidCoord
+                      : ESSReadout::VMM3ChannelMap::Valid;
+    return Entry;
+  });
+  XTRACE(INIT, ALW, "Channel map uses %zu bytes",
+         ChannelMap.getMemoryBytes());
+}
+
 void TREXInstrument::processReadouts(void) {
   // All readouts are potentially now valid, but rings and fens
   // could still be outside the configured range, also
@@ -117,10 +150,10 @@ void TREXInstrument::processReadouts(void) {
         readout.FiberId, Ring, readout.FENId, HybridId, readout.VMM,
         readout.Channel, readout.TimeLow);
 
-    ESSReadout::Hybrid const &Hybrid =
-        Conf.getHybrid(Ring, readout.FENId, HybridId);
+    const ESSReadout::VMM3ChannelMap::Entry &Channel =
+        ChannelMap.lookup(Ring, readout.FENId, readout.VMM, readout.Channel);
 
-    if (!Hybrid.Initialised) {
+    if (Channel.State == ESSReadout::VMM3ChannelMap::Unconfigured) {
       XTRACE(DATA, WAR,
              "Hybrid for Ring %d, FEN %d, VMM %d not defined in config file",
              Ring, readout.FENId, HybridId);
@@ -128,13 +161,6 @@ void TREXInstrument::processReadouts(void) {
       continue;
     }
 
-    uint8_t AsicId = readout.VMM & 0x1;
-    uint16_t XOffset = Hybrid.XOffset;
-    uint16_t YOffset = Hybrid.YOffset;
-    bool Rotated = Conf.Rotated[Ring][readout.FENId][HybridId];
-    bool Short = Conf.Short[Ring][readout.FENId][HybridId];
-    uint16_t MinADC = Hybrid.MinADC;
-
     //   VMM3Calibration & Calib = Hybrids[Hybrid].VMMs[Asic];
 
     uint64_t TimeNS =
@@ -151,13 +177,13 @@ void TREXInstrument::processReadouts(void) {
     // no calibration yet, so using raw ADC value
     uint16_t ADC = readout.OTADC & 0x3FF;
 
-    if (ADC < MinADC) {
+    if (ADC < Channel.MinADC) {
       XTRACE(DATA, ERR, "Under MinADC value, got %u, minimum is %u", ADC,
-             MinADC);
+             Channel.MinADC);
       counters.MinADC++;
       continue;
     } else {
-      XTRACE(DATA, DEB, "Valid ADC %u, min is %u", ADC, MinADC);
+      XTRACE(DATA, DEB, "Valid ADC %u, min is %u", ADC, Channel.MinADC);
     }
 
     //   XTRACE(DATA, DEB, "ADC calibration from %u to %u", readout.OTADC &
@@ -172,49 +198,16 @@ void TREXInstrument::processReadouts(void) {
 
     //   // Now we add readouts with the calibrated time and adc to the x,y
     //   builders
-    // x and z coord is a combination of the X and Z coordinates that provides a
-    // unique wire identifier Adjacency of wires isn't needed as wires are well
-    // insulated and events don't span multiples of them
-    if (GeometryInstance->isWire(HybridId)) {
-      XTRACE(DATA, DEB, "Is wire, calculating x and z coordinate");
-      uint16_t xAndzCoord =
-          GeometryInstance->xAndzCoord(Ring, readout.FENId, HybridId, AsicId,
-                                       readout.Channel, XOffset, Rotated);
-
-      if (xAndzCoord ==
-          GeometryInstance->InvalidCoord) { // 65535 is invalid xandzCoordinate
-        XTRACE(DATA, ERR, "Invalid X and Z Coord");
-        counters.MappingErrors++;
-        continue;
-      }
-
-      XTRACE(DATA, DEB, "XandZ: Coord %u, Channel %u, X: %u, Z: %u", xAndzCoord,
-             readout.Channel, xAndzCoord >> 4, xAndzCoord % 16);
-      builders[Ring * Conf.MaxFEN + readout.FENId].insert(
-          {TimeNS, xAndzCoord, ADC, 0});
-
-      //     uint32_t GlobalXChannel = Hybrid * GeometryBase::NumStrips +
-      //     readout.Channel; ADCHist.bin_x(GlobalXChannel, ADC);
-
-    } else { // implicit isYCoord
-      XTRACE(DATA, DEB, "Is grid, calculating y coordinate");
-      uint16_t yCoord = GeometryInstance->yCoord(
-          HybridId, AsicId, readout.Channel, YOffset, Rotated, Short);
-
-      if (yCoord ==
-          GeometryInstance->InvalidCoord) { // invalid coordinate is 65535
-        XTRACE(DATA, ERR, "Invalid Y Coord");
-        counters.MappingErrors++;
-        continue;
-      }
-
-      XTRACE(DATA, DEB, "Y: Coord %u, Channel %u", yCoord, readout.Channel);
-      builders[Ring * Conf.MaxFEN + readout.FENId].insert(
-          {TimeNS, yCoord, ADC, 1});
-
-      // uint32_t GlobalYChannel = Hybrid * GeometryBase::NumWires +
-      // readout.Channel; ADCHist.bin_y(GlobalYChannel, ADC);
+    if (Channel.State == ESSReadout::VMM3ChannelMap::InvalidCoord) {
+      XTRACE(DATA, ERR, "Invalid Coord");
+      counters.MappingErrors++;
+      continue;
     }
+
+    XTRACE(DATA, DEB, "Plane %u, Coord %u, Channel %u", Channel.Plane,
+           Channel.Coord, readout.Channel);
+    builders[Channel.Builder].insert(
+        {TimeNS, Channel.Coord, ADC, Channel.Plane});
   }
 
   for (auto &builder : builders) {
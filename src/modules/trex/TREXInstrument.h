@@ -15,6 +15,7 @@
 #include <common/readout/ess/Parser.h>
 #include <common/readout/vmm3/Hybrid.h>
 #include <common/readout/vmm3/Readout.h>
+#include <common/readout/vmm3/VMM3ChannelMap.h>
 #include <common/readout/vmm3/VMM3Parser.h>
 #include <common/reduction/Event.h>
 #include <common/reduction/EventBuilder2D.h>
@@ -40,6 +41,10 @@ public:
   /// files. This step will throw an exception upon errors.
   void loadConfigAndCalib();
 
+  /// \brief precompute coordinate, plane, builder and MinADC of all
+  /// channels of the configured hybrids
+  void buildChannelMap();
+
   /// \brief process parsed vmm data into clusters
   void processReadouts(void);
 
@@ -83,6 +88,9 @@ public:
 
   Geometry *GeometryInstance;
 
+  /// \brief channel mapping used by processReadouts()
+  ESSReadout::VMM3ChannelMap ChannelMap;
+
   //
   std::vector<ESSReadout::Hybrid> Hybrids;
 